@@ -1,5 +1,7 @@
 SOURCES += Audio/AudioDevice.cpp  Audio/BWFFile.cpp  Audio/soundin.cpp \
-	Audio/soundout.cpp
+	Audio/soundout.cpp Audio/AudioSnapshotWriter.cpp Audio/AudioClock.cpp \
+	Audio/Equalizer.cpp
 
 HEADERS += Audio/AudioDevice.hpp  Audio/BWFFile.hpp  Audio/soundin.h \
-	Audio/soundout.h
+	Audio/soundout.h Audio/AudioSnapshotWriter.hpp Audio/AudioClock.hpp \
+	Audio/Equalizer.hpp
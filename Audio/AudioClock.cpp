@@ -0,0 +1,104 @@
+#include "AudioClock.hpp"
+
+#include <cmath>
+
+#include <QtGlobal>
+
+namespace
+{
+  // time constant of the loop, the gains of each update are scaled by
+  // the time it covers so that the loop behaves the same whatever the
+  // block size
+  double constexpr time_constant_ms {4000.};
+  double constexpr jitter_time_constant_ms {8000.};
+
+  // no sound card is this far out, stops a bad start running away
+  double constexpr max_drift {1e-3};
+}
+
+double constexpr AudioClock::relock_ms;
+double constexpr AudioClock::lock_ms;
+
+AudioClock::AudioClock (double nominal_rate)
+  : nominal_rate_ {nominal_rate}
+{
+  reset ();
+}
+
+void AudioClock::reset (double nominal_rate)
+{
+  nominal_rate_ = nominal_rate;
+  reset ();
+}
+
+void AudioClock::reset ()
+{
+  anchor_frame_ = 0;
+  anchor_ms_ = 0.;
+  lock_frame_ = 0;
+  period_ = 1000. / nominal_rate_;
+  jitter2_ = 0.;
+  updates_ = 0;
+  relocks_ = 0;
+}
+
+void AudioClock::update (qint64 frames, double arrival_ms)
+{
+  auto const frames_since = frames - anchor_frame_;
+  if (!updates_ || frames_since <= 0)
+    {
+      // first block, or a count that went backwards
+      anchor_frame_ = frames;
+      anchor_ms_ = arrival_ms;
+      lock_frame_ = frames;
+      updates_ = 1;
+      return;
+    }
+
+  auto const predicted = anchor_ms_ + frames_since * period_;
+  auto const error = arrival_ms - predicted;
+  if (std::abs (error) > relock_ms)
+    {
+      // keep the rate, it is still the best estimate we have
+      anchor_frame_ = frames;
+      anchor_ms_ = arrival_ms;
+      lock_frame_ = frames;
+      jitter2_ = 0.;
+      updates_ = 1;
+      ++relocks_;
+      return;
+    }
+
+  // a critically damped second order loop
+  auto const interval = frames_since * period_;
+  auto const phase_gain = qMin (interval / time_constant_ms, .5);
+  auto const frequency_gain = phase_gain * phase_gain / 4.;
+  anchor_frame_ = frames;
+  anchor_ms_ = predicted + phase_gain * error;
+  auto const nominal_period = 1000. / nominal_rate_;
+  period_ = qBound (nominal_period * (1. - max_drift)
+                    , period_ + frequency_gain * error / frames_since
+                    , nominal_period * (1. + max_drift));
+  jitter2_ += qMin (interval / jitter_time_constant_ms, 1.) * (error * error - jitter2_);
+  ++updates_;
+}
+
+double AudioClock::utc (qint64 frame) const
+{
+  return anchor_ms_ + (frame - anchor_frame_) * period_;
+}
+
+bool AudioClock::locked () const
+{
+  return updates_ > 1 && (anchor_frame_ - lock_frame_) * period_ >= lock_ms;
+}
+
+double AudioClock::drift_ppm () const
+{
+  return (rate () / nominal_rate_ - 1.) * 1e6;
+}
+
+double AudioClock::jitter_ms () const
+{
+  return std::sqrt (jitter2_);
+}
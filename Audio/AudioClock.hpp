@@ -0,0 +1,63 @@
+// -*- Mode: C++ -*-
+#ifndef AUDIO_CLOCK_HPP__
+#define AUDIO_CLOCK_HPP__
+
+#include <QtGlobal>
+
+//
+// AudioClock - relates a sound card's sample clock to UTC
+//
+// Audio arrives in blocks whose delivery times jitter by the OS
+// scheduling and by the buffer size, so the system clock read when a
+// block arrives is a poor time stamp for its samples. The sample count
+// on the other hand is exact, only its rate differs a little from
+// nominal.
+//
+// update() is called as each block arrives with the running frame
+// count and the system clock's arrival time. A second order software
+// PLL fits a straight line through those points, so its phase follows
+// the mean arrival time and its slope the true sample rate. utc() then
+// gives the capture time of any frame with far less jitter than the
+// arrival times it was derived from.
+//
+// Arrivals that disagree with the model by more than relock_ms, as
+// after a stalled stream or a stepped system clock, restart the fit.
+//
+class AudioClock final
+{
+public:
+  explicit AudioClock (double nominal_rate = 48000.);
+
+  // forget everything, frame counts restart at zero
+  void reset ();
+  void reset (double nominal_rate);
+
+  // frames is the count of frames delivered so far, including the
+  // block that arrived at arrival_ms
+  void update (qint64 frames, double arrival_ms);
+
+  // UTC, in ms since the epoch, at which frame was captured
+  double utc (qint64 frame) const;
+
+  bool valid () const {return updates_ > 0;}
+  bool locked () const;         // settled since the last (re)start
+  double rate () const {return 1000. / period_;} // estimated frames per second
+  double drift_ppm () const;                     // rate error from nominal
+  double jitter_ms () const;                     // RMS arrival time residual
+  int relocks () const {return relocks_;}
+
+  static double constexpr relock_ms {250.};
+  static double constexpr lock_ms {12000.};
+
+private:
+  double nominal_rate_;
+  qint64 anchor_frame_;
+  double anchor_ms_;
+  qint64 lock_frame_;
+  double period_;               // ms per frame
+  double jitter2_;
+  int updates_;
+  int relocks_;
+};
+
+#endif
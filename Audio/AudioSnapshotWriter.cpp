@@ -0,0 +1,204 @@
+#include "AudioSnapshotWriter.hpp"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdlib>
+#include <utility>
+#include <vector>
+
+#include <QAudioFormat>
+#include <QFile>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QSaveFile>
+#include <QThread>
+
+#include "lib/flacio.h"
+#include "pimpl_impl.hpp"
+
+#include "moc_AudioSnapshotWriter.cpp"
+
+namespace
+{
+  int const sample_rate {12000};
+
+  QString write_wav (QString const& file_name, QVector<short> const& samples, BWFFile::InfoDictionary const& info)
+  {
+    QAudioFormat format;
+    format.setCodec ("audio/pcm");
+    format.setSampleRate (sample_rate);
+    format.setChannelCount (1);
+    format.setSampleSize (16);
+    format.setSampleType (QAudioFormat::SignedInt);
+    BWFFile wav {format, file_name, info};
+    if (!wav.open (BWFFile::WriteOnly)
+        || 0 > wav.write (reinterpret_cast<char const *> (samples.constData ())
+                          , sizeof (short) * samples.size ()))
+      {
+        return file_name + ": " + wav.errorString ();
+      }
+    return QString {};
+  }
+
+  QString write_flac (QString const& file_name, QVector<short> const& samples, BWFFile::InfoDictionary const& info)
+  {
+    QList<QByteArray> comments;
+    std::vector<char const *> pointers;
+    for (auto iter = info.constBegin (); iter != info.constEnd (); ++iter)
+      {
+        comments << QByteArray {iter.key ().data (), 4} + '=' + iter.value ();
+      }
+    for (auto const& comment : comments)
+      {
+        pointers.push_back (comment.constData ());
+      }
+
+    unsigned char * data {nullptr};
+    std::size_t size {0};
+    auto status = flac_encode (samples.constData (), samples.size (), sample_rate
+                               , pointers.data (), pointers.size (), &data, &size);
+    if (status)
+      {
+        return file_name + ": " + flac_error_string (status);
+      }
+    QSaveFile file {file_name};
+    auto ok = file.open (QIODevice::WriteOnly)
+      && static_cast<qint64> (size) == file.write (reinterpret_cast<char const *> (data), size)
+      && file.commit ();
+    std::free (data);
+    return ok ? QString {} : file_name + ": " + file.errorString ();
+  }
+}
+
+class AudioSnapshotWriter::impl final
+{
+public:
+  explicit impl (int queue_limit)
+    : queue_limit_ {queue_limit}
+    , queued_ {0}
+    , worker_ {new QObject}
+  {
+    thread_.setObjectName ("AudioSnapshotWriter");
+    worker_->moveToThread (&thread_);
+    QObject::connect (&thread_, &QThread::finished, worker_, &QObject::deleteLater);
+    thread_.start (QThread::LowPriority);
+  }
+
+  ~impl ()
+  {
+    thread_.quit ();
+    thread_.wait ();
+  }
+
+  // a buffer of count samples, from the pool if one is free
+  QVector<short> take (int count)
+  {
+    QVector<short> buffer;
+    {
+      QMutexLocker lock {&mutex_};
+      if (pool_.size ()) buffer = pool_.takeLast ();
+    }
+    buffer.resize (count);
+    return buffer;
+  }
+
+  void give_back (QVector<short> buffer)
+  {
+    QMutexLocker lock {&mutex_};
+    if (pool_.size () < queue_limit_) pool_.append (std::move (buffer));
+  }
+
+  int queue_limit_;
+  std::atomic<int> queued_;
+  QThread thread_;
+  QObject * worker_;
+  QMutex mutex_;
+  QVector<QVector<short>> pool_;
+};
+
+AudioSnapshotWriter::AudioSnapshotWriter (int queue_limit, QObject * parent)
+  : QObject {parent}
+  , m_ {queue_limit}
+{
+}
+
+AudioSnapshotWriter::~AudioSnapshotWriter ()
+{
+  flush ();                     // while error () may still be emitted
+}
+
+bool AudioSnapshotWriter::save (QString const& base_name, short const * samples, int count
+                                , BWFFile::InfoDictionary const& info, Container container)
+{
+  if (m_->queued_ >= m_->queue_limit_) return false;
+
+  auto buffer = m_->take (count);
+  std::copy (samples, samples + count, buffer.data ());
+  ++m_->queued_;
+  auto const name = file_name (base_name, container);
+  QMetaObject::invokeMethod (m_->worker_, [this, name, buffer, info, container] () mutable {
+      auto const result = Container::FLAC == container ? write_flac (name, buffer, info) : write_wav (name, buffer, info);
+      m_->give_back (std::move (buffer));
+      --m_->queued_;
+      if (result.size ()) Q_EMIT error (result);
+    }, Qt::QueuedConnection);
+  return true;
+}
+
+void AudioSnapshotWriter::remove (QString const& base_name)
+{
+  QMetaObject::invokeMethod (m_->worker_, [base_name] () {
+      QFile::remove (file_name (base_name, Container::WAV));
+      QFile::remove (file_name (base_name, Container::FLAC));
+    }, Qt::QueuedConnection);
+}
+
+void AudioSnapshotWriter::flush ()
+{
+  QMetaObject::invokeMethod (m_->worker_, [] () {}, Qt::BlockingQueuedConnection);
+}
+
+int AudioSnapshotWriter::queued () const
+{
+  return m_->queued_;
+}
+
+QString AudioSnapshotWriter::file_name (QString const& base_name, Container container)
+{
+  return base_name + (Container::FLAC == container ? ".flac" : ".wav");
+}
+
+QString AudioSnapshotWriter::read_flac (QString const& path, short * samples, int max_count
+                                        , int * count, int * rate, BWFFile::InfoDictionary * info)
+{
+  *count = 0;
+  *rate = 0;
+  QFile file {path};
+  if (!file.open (QIODevice::ReadOnly))
+    {
+      return path + ": " + file.errorString ();
+    }
+  auto const data = file.readAll ();
+  std::size_t samples_read {0};
+  unsigned sample_rate {0};
+  char * comments {nullptr};
+  auto status = flac_decode (reinterpret_cast<unsigned char const *> (data.constData ()), data.size ()
+                             , samples, max_count, &samples_read, &sample_rate, info ? &comments : nullptr);
+  *count = static_cast<int> (samples_read);
+  *rate = static_cast<int> (sample_rate);
+  if (comments)
+    {
+      for (auto const& comment : QByteArray {comments}.split ('\n'))
+        {
+          if (comment.size () > 5 && '=' == comment[4])
+            {
+              std::array<char, 4> id;
+              std::copy (comment.constData (), comment.constData () + 4, id.begin ());
+              (*info)[id] = comment.mid (5);
+            }
+        }
+      std::free (comments);
+    }
+  return status ? path + ": " + flac_error_string (status) : QString {};
+}
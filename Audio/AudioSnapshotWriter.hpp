@@ -0,0 +1,69 @@
+// -*- Mode: C++ -*-
+#ifndef AUDIO_SNAPSHOT_WRITER_HPP__
+#define AUDIO_SNAPSHOT_WRITER_HPP__
+
+#include <QObject>
+#include <QString>
+#include <QVector>
+
+#include "BWFFile.hpp"
+#include "pimpl_h.hpp"
+
+//
+// AudioSnapshotWriter - saves received periods to disk off the GUI
+// thread
+//
+// save() copies the period's samples into a buffer taken from a small
+// pool, so the caller may overwrite its capture straight away, and
+// queues the write to a thread of its own. At most queue_limit saves
+// may be outstanding, further ones are refused rather than letting a
+// slow disk hold an unbounded amount of audio in memory.
+//
+// Files are written either as BWF .wav files or as losslessly
+// compressed FLAC .flac files with the LIST-INFO metadata carried
+// over as FLAC comments. read_flac() reads them back.
+//
+// Saves and removes of the same name take effect in the order they
+// are queued, so removing a period that has not been written yet is
+// safe.
+//
+class AudioSnapshotWriter final
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+  enum class Container {WAV, FLAC};
+
+  explicit AudioSnapshotWriter (int queue_limit = 8, QObject * parent = nullptr);
+  ~AudioSnapshotWriter () override; // writes anything still queued
+
+  // write count samples to base_name plus the container's extension,
+  // false if too many saves are already queued
+  bool save (QString const& base_name, short const * samples, int count
+             , BWFFile::InfoDictionary const&, Container);
+
+  // delete base_name's audio files, written or queued
+  void remove (QString const& base_name);
+
+  // wait for everything queued to be written
+  void flush ();
+
+  int queued () const;
+
+  static QString file_name (QString const& base_name, Container);
+
+  // read at most max_count samples of a .flac file, returns an empty
+  // string or an error message
+  static QString read_flac (QString const& path, short * samples, int max_count
+                            , int * count, int * rate, BWFFile::InfoDictionary * = nullptr);
+
+  // emitted on the writer thread when a save fails
+  Q_SIGNAL void error (QString const& message) const;
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+#endif
@@ -0,0 +1,157 @@
+#include "Equalizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+#include <QFile>
+#include <QString>
+#include <QStringList>
+#include <QTextStream>
+
+namespace
+{
+  // as used by refspectrum() to measure the response
+  int constexpr nfft {6912};
+  int constexpr nh {nfft / 2};
+
+  int next_power_of_two (int n)
+  {
+    int size {1};
+    while (size < n) size <<= 1;
+    return size;
+  }
+}
+
+int constexpr Equalizer::taps;
+
+QVector<float> Equalizer::design (QString const& file_name)
+{
+  // the file is an optional header line followed by a line per FFT
+  // bin holding frequency, power, relative dB, gain and gain in dB
+  QFile file {file_name};
+  if (!file.open (QFile::ReadOnly | QFile::Text)) return {};
+  QTextStream stream {&file};
+  std::vector<double> gain {0.};
+  while (!stream.atEnd () && gain.size () <= nh)
+    {
+      auto const fields = stream.readLine ().simplified ().split (' ');
+      if (fields.size () != 5) continue;
+      bool ok;
+      auto const value = fields[3].toDouble (&ok);
+      if (!ok) return {};
+      gain.push_back (value);
+    }
+  if (gain.size () != nh + 1) return {};
+
+  // the inverse transform of the gain, with no DC, centred in the
+  // taps to make it causal
+  std::vector<double> cosine (nfft);
+  for (int i = 0; i < nfft; ++i) cosine[i] = std::cos (2. * M_PI * i / nfft);
+  QVector<float> result (taps);
+  for (int n = 0; n < taps; ++n)
+    {
+      auto const t = n - taps / 2 + nfft; // keep the index positive
+      double sum {0.};
+      for (int k = 1; k < nh; ++k) sum += 2. * gain[k] * cosine[k * t % nfft];
+      sum += gain[nh] * cosine[nh * t % nfft];
+      result[n] = sum / nfft;
+    }
+  return result;
+}
+
+void Equalizer::set_taps (QVector<float> const& taps)
+{
+  taps_ = taps;
+  transforms_.clear ();
+  overlap_.assign (taps_.isEmpty () ? 0 : taps_.size () - 1, 0.f);
+}
+
+void Equalizer::reset ()
+{
+  std::fill (overlap_.begin (), overlap_.end (), 0.f);
+}
+
+void Equalizer::process (short * samples, int count)
+{
+  if (!active () || count <= 0) return;
+
+  int const tail = taps_.size () - 1;
+  auto const& t = transform (next_power_of_two (count + tail));
+  work_.assign (t.size, complex {});
+  for (int i = 0; i < count; ++i) work_[i] = samples[i];
+  t.forward (work_.data ());
+  for (int i = 0; i < t.size; ++i) work_[i] *= t.filter[i];
+  t.inverse (work_.data ());
+
+  float const scale {1.f / t.size};
+  for (int i = 0; i < count; ++i)
+    {
+      auto const y = work_[i].real () * scale + (i < tail ? overlap_[i] : 0.f);
+      samples[i] = static_cast<short> (std::lround (qBound (-32768.f, y, 32767.f)));
+    }
+  // what spills past this block is added to the start of the next
+  for (int i = 0; i < tail; ++i)
+    {
+      overlap_[i] = work_[count + i].real () * scale + (count + i < tail ? overlap_[count + i] : 0.f);
+    }
+}
+
+auto Equalizer::transform (int size) -> Transform const&
+{
+  auto iter = transforms_.find (size);
+  if (iter == transforms_.end ())
+    {
+      iter = transforms_.emplace (size, Transform {size}).first;
+      auto& filter = iter->second.filter;
+      filter.assign (size, complex {});
+      std::copy (taps_.begin (), taps_.end (), filter.begin ());
+      iter->second.forward (filter.data ());
+    }
+  return iter->second;
+}
+
+Equalizer::Transform::Transform (int n)
+  : size {n}
+  , twiddle (n / 2)
+  , reversed (n)
+{
+  for (int i = 0; i < n / 2; ++i) twiddle[i] = std::polar (1.f, static_cast<float> (-2. * M_PI * i / n));
+  int bits {0};
+  while ((1 << bits) < n) ++bits;
+  for (int i = 0; i < n; ++i)
+    {
+      int r {0};
+      for (int b = 0; b < bits; ++b) r |= ((i >> b) & 1) << (bits - 1 - b);
+      reversed[i] = r;
+    }
+}
+
+void Equalizer::Transform::forward (complex * x) const
+{
+  for (int i = 0; i < size; ++i)
+    {
+      if (i < reversed[i]) std::swap (x[i], x[reversed[i]]);
+    }
+  for (int length = 2; length <= size; length <<= 1)
+    {
+      int const half {length / 2};
+      int const step {size / length};
+      for (int i = 0; i < size; i += length)
+        {
+          for (int j = 0; j < half; ++j)
+            {
+              auto const v = x[i + j + half] * twiddle[j * step];
+              x[i + j + half] = x[i + j] - v;
+              x[i + j] += v;
+            }
+        }
+    }
+}
+
+void Equalizer::Transform::inverse (complex * x) const
+{
+  // unscaled
+  for (int i = 0; i < size; ++i) x[i] = std::conj (x[i]);
+  forward (x);
+  for (int i = 0; i < size; ++i) x[i] = std::conj (x[i]);
+}
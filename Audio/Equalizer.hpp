@@ -0,0 +1,71 @@
+// -*- Mode: C++ -*-
+#ifndef EQUALIZER_HPP__
+#define EQUALIZER_HPP__
+
+#include <complex>
+#include <map>
+#include <vector>
+
+#include <QVector>
+
+class QString;
+
+//
+// Equalizer - applies a measured receiver response to captured audio
+//
+// "Measure reference spectrum" writes the amplitude correction that
+// flattens the receiver's pass band to refspec.dat. design() turns
+// that into the same 800 tap causal FIR the spectral code used to
+// build, with a delay of taps/2 samples, and process() applies it by
+// overlap and add to each block of 12 kHz audio as it is captured, so
+// every decoder sees equalized audio.
+//
+// Blocks may be of any size, the transform used and the filter's
+// spectrum for it are worked out once per size and kept. With no taps
+// set audio passes unchanged.
+//
+// The FFT is self contained as the FFTW planner is not thread safe
+// and this runs on the audio thread while decoders plan their own.
+//
+class Equalizer final
+{
+public:
+  static int constexpr taps {800};
+
+  // the FIR for a reference spectrum file, empty if there is no
+  // usable file
+  static QVector<float> design (QString const& file_name);
+
+  void set_taps (QVector<float> const&);
+  bool active () const {return !taps_.isEmpty ();}
+
+  // forget the overlap carried between blocks
+  void reset ();
+
+  // equalize count samples in place
+  void process (short * samples, int count);
+
+private:
+  using complex = std::complex<float>;
+
+  struct Transform
+  {
+    explicit Transform (int size);
+    void forward (complex *) const;
+    void inverse (complex *) const;
+
+    int size;
+    std::vector<complex> twiddle;
+    std::vector<int> reversed;
+    std::vector<complex> filter; // spectrum of the taps
+  };
+
+  Transform const& transform (int size);
+
+  QVector<float> taps_;
+  std::map<int, Transform> transforms_;
+  std::vector<complex> work_;
+  std::vector<float> overlap_;  // tail of the previous blocks
+};
+
+#endif
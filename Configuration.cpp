@@ -79,8 +79,8 @@
 // the accept()  operation, just  before hiding  the UI  and returning
 // control to the caller; the new  settings values are stored into the
 // settings database by a call to the write_settings() operation, thus
-// ensuring that  settings changes are  saved even if  the application
-// crashes or is subsequently killed.
+// ensuring that  settings changes are  saved, within a couple of
+// seconds, even if the application crashes or is subsequently killed.
 //
 // 6)  On  destruction,  which   only  happens  when  the  application
 // terminates,  the settings  are saved  to the  settings database  by
@@ -3432,7 +3432,7 @@ void Configuration::impl::write_settings ()
   settings_->setValue ("alert_DXcall", alert_DXcall_);
   settings_->setValue ("alert_QSYmessage", alert_QSYmessage_);
   settings_->setValue ("alert_Enabled", alert_Enabled_);
-  settings_->sync ();
+  // written by MultiSettings shortly, along with any other changes
 }
 
 void Configuration::impl::set_rig_invariants ()
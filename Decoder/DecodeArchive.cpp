@@ -0,0 +1,608 @@
+#include "DecodeArchive.hpp"
+
+#include <QFile>
+#include <QRegularExpression>
+#include <QSaveFile>
+#include <QSet>
+#include <QStringList>
+#include <QtEndian>
+
+#include <algorithm>
+
+#include "qt_helpers.hpp"
+#include "pimpl_impl.hpp"
+
+namespace
+{
+  //
+  // Segment block layout, all big endian:
+  //
+  //   quint32 magic, quint32 bytes in block, quint32 rows, quint32 strings
+  //   strings: quint16 length and UTF-8 bytes each
+  //   columns, rows values each, in the order of Column below
+  //
+  // Index layout, appended to as blocks are written, all big endian:
+  //
+  //   quint32 magic
+  //   per block: quint32 offset, quint32 bytes in block, quint16 keys
+  //              keys: quint16 length and UTF-8 bytes each
+  //
+  quint32 const block_magic {0x44434131}; // "DCA1"
+  quint32 const index_magic {0x44434932}; // "DCI2"
+  int const header_bytes {16};
+  int const max_block_rows {4096};
+  quint16 const no_string {0xffff};
+
+  enum Column {TimeColumn, DialColumn, AudioColumn, SnrColumn, DtColumn, TypeColumn
+               , BandColumn, ModeColumn, CallColumn, GridColumn, MessageColumn, Columns};
+  int const column_width[Columns] {4, 8, 2, 1, 2, 1, 2, 2, 2, 2, 2};
+
+  using Index = QHash<QString, QVector<quint32>>; // "C:call" or "G:grid" -> block offsets
+
+  QRegularExpression const grid_re {"^[A-R]{2}[0-9]{2}$"};
+  QRegularExpression const call_re {"^[A-Z0-9/]*[0-9][A-Z0-9/]*$"};
+  QRegularExpression const report_re {"^R?[+-][0-9]{2}$"};
+  QRegularExpression const annotation_re {"\\s{2,}"};
+  QRegularExpression const letter_re {"[A-Z]"};
+
+  bool is_grid (QString const& word)
+  {
+    return word != "RR73" && grid_re.match (word).hasMatch ();
+  }
+
+  bool is_call (QString const& word)
+  {
+    return word.size () >= 3 && word.size () <= 11 && word.contains (letter_re)
+      && call_re.match (word).hasMatch ();
+  }
+
+  QString segment_path (QDir const& directory, QDate const& day, char const * suffix)
+  {
+    return directory.absoluteFilePath (day.toString ("yyyyMMdd") + suffix);
+  }
+
+  template<typename T>
+  void append (QByteArray& data, T value)
+  {
+    uchar bytes[sizeof (T)];
+    qToBigEndian<T> (value, bytes);
+    data.append (reinterpret_cast<char const *> (bytes), sizeof (T));
+  }
+
+  template<typename T>
+  T take (QByteArray const& data, int offset)
+  {
+    return qFromBigEndian<T> (reinterpret_cast<uchar const *> (data.constData () + offset));
+  }
+
+  class Block
+  {
+  public:
+    // false if there is no complete block at offset
+    bool read (QFile& file, quint32 offset)
+    {
+      if (!file.seek (offset)) return false;
+      auto const header = file.read (header_bytes);
+      if (header.size () < header_bytes || take<quint32> (header, 0) != block_magic) return false;
+      auto const bytes = take<quint32> (header, 4);
+      rows = take<quint32> (header, 8);
+      if (bytes < quint32 (header_bytes) || offset + qint64 (bytes) > file.size ()) return false;
+      data = header + file.read (bytes - header_bytes);
+      if (data.size () != int (bytes)) return false;
+
+      auto const count = take<quint32> (header, 12);
+      strings.clear ();
+      strings.reserve (count);
+      int pos {header_bytes};
+      for (quint32 i = 0; i < count; ++i)
+        {
+          if (pos + 2 > data.size ()) return false;
+          auto const length = take<quint16> (data, pos);
+          pos += 2;
+          if (pos + length > data.size ()) return false;
+          strings << QString::fromUtf8 (data.constData () + pos, length);
+          pos += length;
+        }
+      int column_pos = pos;
+      for (int column = 0; column < Columns; ++column)
+        {
+          column_offset[column] = column_pos;
+          column_pos += rows * column_width[column];
+        }
+      return column_pos <= data.size ();
+    }
+
+    template<typename T>
+    T value (Column column, int row) const
+    {
+      return take<T> (data, column_offset[column] + row * column_width[column]);
+    }
+
+    char byte (Column column, int row) const
+    {
+      return data.at (column_offset[column] + row);
+    }
+
+    QString string (Column column, int row) const
+    {
+      auto const index = value<quint16> (column, row);
+      return index < strings.size () ? strings[index] : QString {};
+    }
+
+    // string table indices of strings accepted by match
+    template<typename Match>
+    QSet<quint16> find (Match const& match) const
+    {
+      QSet<quint16> found;
+      for (int i = 0; i < strings.size (); ++i)
+        {
+          if (match (strings[i])) found << quint16 (i);
+        }
+      return found;
+    }
+
+    quint32 rows {0};
+    QByteArray data;
+    QVector<QString> strings;
+    int column_offset[Columns];
+  };
+
+  // offsets of the complete blocks from offset from on
+  QVector<quint32> block_offsets (QFile& file, qint64 from = 0)
+  {
+    QVector<quint32> offsets;
+    qint64 offset {from};
+    while (offset + header_bytes <= file.size () && file.seek (offset))
+      {
+        auto const header = file.read (header_bytes);
+        if (header.size () < header_bytes || take<quint32> (header, 0) != block_magic) break;
+        auto const bytes = take<quint32> (header, 4);
+        if (bytes < quint32 (header_bytes) || offset + bytes > file.size ()) break; // being written
+        offsets << quint32 (offset);
+        offset += bytes;
+      }
+    return offsets;
+  }
+
+  // "C:call" and "G:grid" keys of the calls and grids in a block
+  QSet<QString> block_keys (Block const& block)
+  {
+    QSet<QString> keys;
+    for (quint32 row = 0; row < block.rows; ++row)
+      {
+        auto const call = block.string (CallColumn, row);
+        if (call.size ()) keys << "C:" + call;
+        auto const grid = block.string (GridColumn, row);
+        if (grid.size ()) keys << "G:" + grid;
+      }
+    return keys;
+  }
+
+  QByteArray index_entry (quint32 offset, quint32 bytes, QSet<QString> const& keys)
+  {
+    QByteArray entry;
+    append<quint32> (entry, offset);
+    append<quint32> (entry, bytes);
+    append<quint16> (entry, quint16 (keys.size ())); // at most two per row
+    for (auto const& key : keys)
+      {
+        auto const utf8 = key.toUtf8 ();
+        append<quint16> (entry, quint16 (utf8.size ()));
+        entry += utf8;
+      }
+    return entry;
+  }
+
+  // index entries of the complete blocks from offset from on
+  QByteArray index_blocks (QFile& segment, qint64 from)
+  {
+    QByteArray entries;
+    Block block;
+    for (auto offset : block_offsets (segment, from))
+      {
+        if (!block.read (segment, offset)) break;
+        entries += index_entry (offset, quint32 (block.data.size ()), block_keys (block));
+      }
+    return entries;
+  }
+
+  // adds the complete entries in data from pos on to index, returns
+  // the bytes used and sets covered to the segment bytes they cover
+  int parse_index (QByteArray const& data, int pos, Index& index, qint64& covered)
+  {
+    while (pos + 10 <= data.size ())
+      {
+        auto const offset = take<quint32> (data, pos);
+        auto const bytes = take<quint32> (data, pos + 4);
+        auto const count = take<quint16> (data, pos + 8);
+        QStringList keys;
+        int next = pos + 10;
+        for (int i = 0; i < count && next + 2 <= data.size (); ++i)
+          {
+            auto const length = take<quint16> (data, next);
+            if (next + 2 + length > data.size ()) break;
+            keys << QString::fromUtf8 (data.constData () + next + 2, length);
+            next += 2 + length;
+          }
+        if (keys.size () < count) break; // being written
+        for (auto const& key : keys)
+          {
+            index[key] << offset;
+          }
+        covered = std::max (covered, qint64 (offset) + bytes);
+        pos = next;
+      }
+    return pos;
+  }
+
+  bool save_index (QString const& path, QByteArray const& entries)
+  {
+    QSaveFile file {path};
+    if (!file.open (QIODevice::WriteOnly)) return false;
+    QByteArray magic;
+    append<quint32> (magic, index_magic);
+    return file.write (magic + entries) == magic.size () + entries.size () && file.commit ();
+  }
+
+  // the index of an open segment, blocks written since the index was
+  // last appended to are read from the segment
+  Index load_index (QDir const& directory, QDate const& day, QFile& segment)
+  {
+    Index index;
+    qint64 covered {0};
+    QByteArray data;
+    int used {0};
+    QFile file {segment_path (directory, day, ".idx")};
+    if (file.open (QIODevice::ReadOnly))
+      {
+        data = file.readAll ();
+        if (data.size () >= 4 && take<quint32> (data, 0) == index_magic)
+          {
+            used = parse_index (data, 4, index, covered);
+          }
+      }
+    if (covered < segment.size ())
+      {
+        auto const tail = index_blocks (segment, covered);
+        qint64 unused {0};
+        parse_index (tail, 0, index, unused);
+        if (day < QDateTime::currentDateTimeUtc ().date ())
+          {
+            // no more blocks will come, save the complete index
+            save_index (file.fileName (), (used ? data.mid (4, used - 4) : QByteArray {}) + tail);
+          }
+      }
+    return index;
+  }
+
+  char const * const type_names[] {"other", "cq", "grid", "report", "roger_report", "rrr", "rr73", "73"};
+}
+
+DecodeArchive::DecodeArchive (QDir const& directory)
+  : directory_ {directory}
+{
+}
+
+bool DecodeArchive::record (DecodeEvent const& event, Record * record)
+{
+  if (!event.is_new || event.off_air || !event.time.isValid ()) return false;
+
+  // the period may have started before midnight
+  auto const received = event.received.isValid () ? event.received.toUTC () : QDateTime::currentDateTimeUtc ();
+  auto date = received.date ();
+  if (event.time.secsTo (received.time ()) < -3600) date = date.addDays (-1);
+  record->time = QDateTime {date, event.time, Qt::UTC};
+  record->band = event.band;
+  record->mode = event.mode;
+  record->dial_frequency = event.dial_frequency;
+  record->frequency = event.frequency;
+  record->snr = event.snr;
+  record->dt = event.dt;
+  // drop any annotations after the message
+  record->message = event.message.trimmed ().section (annotation_re, 0, 0);
+  record->call.clear ();
+  record->grid.clear ();
+  record->type = MessageType::Other;
+
+  auto words = record->message.toUpper ().split (' ', SkipEmptyParts);
+  for (auto& word : words)
+    {
+      word.remove ('<').remove ('>');
+    }
+  if (words.size () >= 2 && (words[0] == "CQ" || words[0].startsWith ("CQ_")))
+    {
+      // CQ [modifier] call [grid]
+      int n {1};
+      if (words.size () >= 3 && !is_call (words[1]) && is_call (words[2])) n = 2;
+      if (is_call (words[n])) record->call = words[n];
+      if (words.size () > n + 1 && is_grid (words[n + 1])) record->grid = words[n + 1];
+      record->type = MessageType::CQ;
+    }
+  else if (words.size () >= 2 && is_call (words[1]))
+    {
+      // to de [exchange], to may be a hash not yet resolved
+      record->call = words[1];
+      if (words.size () == 3)
+        {
+          auto const& exchange = words[2];
+          if (is_grid (exchange))
+            {
+              record->grid = exchange;
+              record->type = MessageType::Grid;
+            }
+          else if (exchange == "RRR") record->type = MessageType::RRR;
+          else if (exchange == "RR73") record->type = MessageType::RR73;
+          else if (exchange == "73") record->type = MessageType::SeventyThree;
+          else if (report_re.match (exchange).hasMatch ())
+            {
+              record->type = exchange.startsWith ('R') ? MessageType::RogerReport : MessageType::Report;
+            }
+        }
+    }
+  return true;
+}
+
+QString DecodeArchive::type_name (MessageType type)
+{
+  return QString::fromLatin1 (type_names[static_cast<int> (type)]);
+}
+
+bool DecodeArchive::index (QDir const& directory, QDate const& day)
+{
+  QFile segment {segment_path (directory, day, ".dca")};
+  if (!segment.open (QIODevice::ReadOnly)) return false;
+  return save_index (segment_path (directory, day, ".idx"), index_blocks (segment, 0));
+}
+
+QVector<DecodeArchive::Record> DecodeArchive::query (Query const& query, bool * truncated) const
+{
+  QVector<Record> result;
+  if (truncated) *truncated = false;
+  auto const to = query.to.isValid () ? query.to.toUTC () : QDateTime::currentDateTimeUtc ();
+  auto const from = query.from.isValid () ? query.from.toUTC () : to.addDays (-30);
+  auto const call = query.call.trimmed ().toUpper ();
+  auto const grid = query.grid.trimmed ().toUpper ();
+  auto const band = query.band.trimmed ();
+  auto const mode = query.mode.trimmed ();
+  auto const limit = std::max (query.limit, 1);
+
+  for (auto day = to.date (); day >= from.date (); day = day.addDays (-1))
+    {
+      QFile segment {segment_path (directory_, day, ".dca")};
+      if (!segment.open (QIODevice::ReadOnly)) continue;
+
+      QVector<quint32> offsets;
+      if (call.size () || grid.size ())
+        {
+          // blocks mentioning both call and grid
+          auto const index = load_index (directory_, day, segment);
+          QSet<quint32> candidates;
+          bool first {true};
+          auto restrict_to = [&] (QSet<quint32> const& set) {
+            candidates = first ? set : candidates.intersect (set);
+            first = false;
+          };
+          if (call.size ())
+            {
+              QSet<quint32> blocks;
+              for (auto offset : index.value ("C:" + call)) blocks << offset;
+              restrict_to (blocks);
+            }
+          if (grid.size ())
+            {
+              QSet<quint32> blocks;
+              for (auto iter = index.constBegin (); iter != index.constEnd (); ++iter)
+                {
+                  if (iter.key ().startsWith ("G:" + grid))
+                    {
+                      for (auto offset : iter.value ()) blocks << offset;
+                    }
+                }
+              restrict_to (blocks);
+            }
+          offsets = candidates.values ().toVector ();
+          std::sort (offsets.begin (), offsets.end ());
+        }
+      else
+        {
+          offsets = block_offsets (segment);
+        }
+
+      Block block;
+      for (auto offset = offsets.crbegin (); offset != offsets.crend (); ++offset)
+        {
+          if (!block.read (segment, *offset)) continue;
+
+          // resolve the filters to string table indices first, a block
+          // without them is done with
+          QSet<quint16> calls, grids, bands, modes;
+          if (call.size () && (calls = block.find ([&] (QString const& s) {return s == call;})).isEmpty ()) continue;
+          if (grid.size () && (grids = block.find ([&] (QString const& s) {return s.startsWith (grid);})).isEmpty ()) continue;
+          if (band.size () && (bands = block.find ([&] (QString const& s) {return !s.compare (band, Qt::CaseInsensitive);})).isEmpty ()) continue;
+          if (mode.size () && (modes = block.find ([&] (QString const& s) {return !s.compare (mode, Qt::CaseInsensitive);})).isEmpty ()) continue;
+
+          for (int row = int (block.rows) - 1; row >= 0; --row)
+            {
+              if (call.size () && !calls.contains (block.value<quint16> (CallColumn, row))) continue;
+              if (grid.size () && !grids.contains (block.value<quint16> (GridColumn, row))) continue;
+              if (band.size () && !bands.contains (block.value<quint16> (BandColumn, row))) continue;
+              if (mode.size () && !modes.contains (block.value<quint16> (ModeColumn, row))) continue;
+              auto const time = QDateTime {day, QTime::fromMSecsSinceStartOfDay (block.value<quint32> (TimeColumn, row)), Qt::UTC};
+              if (time < from || time > to) continue;
+
+              if (result.size () >= limit)
+                {
+                  if (truncated) *truncated = true;
+                  return result;
+                }
+              Record record;
+              record.time = time;
+              record.band = block.string (BandColumn, row);
+              record.mode = block.string (ModeColumn, row);
+              record.dial_frequency = block.value<quint64> (DialColumn, row);
+              record.frequency = block.value<quint16> (AudioColumn, row);
+              record.snr = static_cast<qint8> (block.byte (SnrColumn, row));
+              record.dt = block.value<qint16> (DtColumn, row) / 100.f;
+              record.type = static_cast<MessageType> (std::min<int> (static_cast<quint8> (block.byte (TypeColumn, row))
+                                                                    , static_cast<int> (MessageType::SeventyThree)));
+              record.call = block.string (CallColumn, row);
+              record.grid = block.string (GridColumn, row);
+              record.message = block.string (MessageColumn, row);
+              result << record;
+            }
+        }
+    }
+  return result;
+}
+
+//
+// DecodeArchiveSink
+//
+class DecodeArchiveSink::impl
+{
+public:
+  explicit impl (QDir const& directory)
+    : directory_ {directory}
+  {
+  }
+
+  void write_block (QDate const& day, DecodeArchive::Record const * rows, int count);
+
+  QDir directory_;
+  QVector<DecodeArchive::Record> pending_;
+  QSet<QDate> indexed_days_;    // whose index is up to date with its segment
+};
+
+void DecodeArchiveSink::impl::write_block (QDate const& day, DecodeArchive::Record const * rows, int count)
+{
+  QHash<QString, quint16> string_index;
+  QStringList strings;
+  auto intern = [&] (QString const& s) -> quint16 {
+    if (s.isEmpty ()) return no_string;
+    auto iter = string_index.find (s);
+    if (iter == string_index.end ())
+      {
+        iter = string_index.insert (s, quint16 (strings.size ()));
+        strings << s;
+      }
+    return *iter;
+  };
+  QVector<quint16> ids[Columns];
+  for (int row = 0; row < count; ++row)
+    {
+      ids[BandColumn] << intern (rows[row].band);
+      ids[ModeColumn] << intern (rows[row].mode);
+      ids[CallColumn] << intern (rows[row].call);
+      ids[GridColumn] << intern (rows[row].grid);
+      ids[MessageColumn] << intern (rows[row].message.left (255));
+    }
+
+  QByteArray data;
+  append<quint32> (data, block_magic);
+  append<quint32> (data, 0);    // size, filled in below
+  append<quint32> (data, quint32 (count));
+  append<quint32> (data, quint32 (strings.size ()));
+  for (auto const& s : strings)
+    {
+      auto const utf8 = s.toUtf8 ();
+      append<quint16> (data, quint16 (utf8.size ()));
+      data += utf8;
+    }
+  for (int row = 0; row < count; ++row)
+    append<quint32> (data, quint32 (rows[row].time.time ().msecsSinceStartOfDay ()));
+  for (int row = 0; row < count; ++row)
+    append<quint64> (data, rows[row].dial_frequency);
+  for (int row = 0; row < count; ++row)
+    append<quint16> (data, quint16 (std::min<quint32> (rows[row].frequency, 0xffff)));
+  for (int row = 0; row < count; ++row)
+    data.append (static_cast<char> (qBound (-128, rows[row].snr, 127)));
+  for (int row = 0; row < count; ++row)
+    append<qint16> (data, qint16 (qBound (-32768, qRound (rows[row].dt * 100.f), 32767)));
+  for (int row = 0; row < count; ++row)
+    data.append (static_cast<char> (rows[row].type));
+  for (int column = BandColumn; column <= MessageColumn; ++column)
+    {
+      for (auto id : ids[column]) append<quint16> (data, id);
+    }
+  qToBigEndian<quint32> (quint32 (data.size ()), reinterpret_cast<uchar *> (data.data () + 4));
+
+  // a single write so that readers see whole blocks or none
+  QFile file {segment_path (directory_, day, ".dca")};
+  if (!file.open (QIODevice::WriteOnly | QIODevice::Append))
+    {
+      qWarning ("decode archive: cannot write %s: %s", qPrintable (file.fileName ())
+                , qPrintable (file.errorString ()));
+      return;
+    }
+  if (!indexed_days_.contains (day))
+    {
+      // blocks from earlier runs, or after a failed index write, are
+      // indexed once here rather than on every query
+      if (DecodeArchive::index (directory_, day)) indexed_days_ << day;
+    }
+  auto const offset = file.size ();
+  if (file.write (data) != data.size ())
+    {
+      qWarning ("decode archive: cannot write %s: %s", qPrintable (file.fileName ())
+                , qPrintable (file.errorString ()));
+      indexed_days_.remove (day);
+      return;
+    }
+
+  // then the block's index entry, queries read any block written
+  // but not yet indexed from the segment
+  QSet<QString> keys;
+  for (int row = 0; row < count; ++row)
+    {
+      if (rows[row].call.size ()) keys << "C:" + rows[row].call;
+      if (rows[row].grid.size ()) keys << "G:" + rows[row].grid;
+    }
+  auto const entry = index_entry (quint32 (offset), quint32 (data.size ()), keys);
+  QFile index {segment_path (directory_, day, ".idx")};
+  if (!index.open (QIODevice::WriteOnly | QIODevice::Append) || index.write (entry) != entry.size ())
+    {
+      indexed_days_.remove (day); // rebuilt before the next block
+    }
+}
+
+DecodeArchiveSink::DecodeArchiveSink (QDir const& directory)
+  : m_ {directory}
+{
+}
+
+DecodeArchiveSink::~DecodeArchiveSink ()
+{
+  flush ();
+}
+
+void DecodeArchiveSink::open ()
+{
+  if (!m_->directory_.mkpath ("."))
+    {
+      qWarning ("decode archive: cannot create %s", qPrintable (m_->directory_.absolutePath ()));
+    }
+}
+
+void DecodeArchiveSink::write (DecodeEvent const& event)
+{
+  DecodeArchive::Record record;
+  if (DecodeArchive::record (event, &record))
+    {
+      m_->pending_ << record;
+    }
+}
+
+void DecodeArchiveSink::flush ()
+{
+  auto const& pending = m_->pending_;
+  for (int first = 0; first < pending.size ();)
+    {
+      // a block holds one day
+      auto const day = pending[first].time.date ();
+      int last = first + 1;
+      while (last < pending.size () && last - first < max_block_rows && pending[last].time.date () == day) ++last;
+      m_->write_block (day, pending.constData () + first, last - first);
+      first = last;
+    }
+  m_->pending_.clear ();
+}
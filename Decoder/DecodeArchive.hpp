@@ -0,0 +1,105 @@
+// -*- Mode: C++ -*-
+#ifndef DECODE_ARCHIVE_HPP__
+#define DECODE_ARCHIVE_HPP__
+
+#include <QDate>
+#include <QDateTime>
+#include <QDir>
+#include <QHash>
+#include <QString>
+#include <QVector>
+
+#include "DecodeEventBus.hpp"
+#include "pimpl_h.hpp"
+
+//
+// DecodeArchive - columnar history of decodes
+//
+// One segment file per UTC day, yyyyMMdd.dca, holding blocks of rows
+// stored column by column with a per block string table for bands,
+// modes, calls, grids and messages. A query reads the string table
+// and then only the columns it filters on before it materializes any
+// rows, so blocks without the wanted call, grid, band or mode cost a
+// header read.
+//
+// Each day also has yyyyMMdd.idx, mapping every call and grid to the
+// blocks mentioning it, so a call or grid query skips days and blocks
+// without reading them. The writer appends a block's entry as it
+// writes the block, and a query reads only the blocks an index does
+// not cover yet from the segment.
+//
+// Queries may run on any thread and concurrently with the writer, but
+// one spanning many days reads many files, so keep them off the GUI
+// thread. Bands and modes match regardless of case.
+//
+class DecodeArchive
+{
+public:
+  enum class MessageType : quint8 {Other, CQ, Grid, Report, RogerReport, RRR, RR73, SeventyThree};
+
+  struct Record
+  {
+    QDateTime time;             // UTC period start
+    QString band;
+    QString mode;
+    quint64 dial_frequency {0}; // Hz
+    quint32 frequency {0};      // audio offset, Hz
+    qint32 snr {0};
+    float dt {0.f};
+    QString call;               // sender where known
+    QString grid;
+    MessageType type {MessageType::Other};
+    QString message;
+  };
+
+  struct Query
+  {
+    QDateTime from;             // invalid for 30 days before to
+    QDateTime to;               // invalid for now
+    QString call;               // empty for any, as are the others
+    QString grid;               // a 2 or 4 character prefix matches
+    QString band;
+    QString mode;
+    int limit {1000};
+  };
+
+  explicit DecodeArchive (QDir const& directory);
+
+  QDir directory () const {return directory_;}
+
+  // newest first, at most query.limit rows
+  QVector<Record> query (Query const&, bool * truncated = nullptr) const;
+
+  // the record archived for a decode, false for decodes not archived
+  static bool record (DecodeEvent const&, Record *);
+
+  static QString type_name (MessageType);
+
+  // rebuild the index of day's segment in directory
+  static bool index (QDir const& directory, QDate const& day);
+
+private:
+  QDir directory_;
+};
+
+//
+// DecodeArchiveSink - archives new on-air decodes from the decode
+// event bus, a block per bus batch
+//
+class DecodeArchiveSink final
+  : public DecodeSink
+{
+public:
+  explicit DecodeArchiveSink (QDir const& directory);
+  ~DecodeArchiveSink () override;
+
+  void open () override;
+  void write (DecodeEvent const&) override;
+  void flush () override;
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+#endif
@@ -0,0 +1,352 @@
+#include "DecodeEventBus.hpp"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QRegularExpression>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+
+#include "qt_helpers.hpp"
+#include "pimpl_impl.hpp"
+
+namespace
+{
+  std::size_t const queue_capacity {4096}; // a power of two
+  qint64 const max_client_backlog {1024 * 1024};
+
+  // time, snr, dt, audio frequency, optional mode marker and message,
+  // FT2 lines may have variable spacing after the marker
+  QRegularExpression const decode_re {
+    R"(^\s*(\d{4,6})\s+([+\-−]?\d+)\s+([+\-−]?\d+(?:\.\d+)?)\s+(\d+)\s*([~+@:#&\^`])?\s*(.*)$)"
+  };
+
+  QString ascii_minus (QString text)
+  {
+    return text.replace (QChar {0x2212}, QLatin1Char {'-'});
+  }
+}
+
+bool DecodeEvent::parse (QString const& line, DecodeEvent * event)
+{
+  auto const match = decode_re.match (line);
+  auto has_seconds = match.captured (1).size () > 4;
+  if (match.hasMatch ()
+      && (event->time = QTime::fromString (match.captured (1), has_seconds ? "hhmmss" : "hhmm")).isValid ())
+    {
+      event->snr = ascii_minus (match.captured (2)).toInt ();
+      event->dt = ascii_minus (match.captured (3)).toFloat ();
+      event->frequency = match.captured (4).toUInt ();
+      event->marker = match.captured (5);
+      event->message = match.captured (6);
+    }
+  else
+    {
+      // not in the usual layout, take the fixed columns as the UDP
+      // decode message always did
+      auto const parts = line.left (22).split (' ', SkipEmptyParts);
+      if (parts.size () < 5) return false;
+      has_seconds = parts[0].size () > 4;
+      event->time = QTime::fromString (parts[0], has_seconds ? "hhmmss" : "hhmm");
+      event->snr = ascii_minus (parts[1]).toInt ();
+      event->dt = ascii_minus (parts[2]).toFloat ();
+      event->frequency = parts[3].toUInt ();
+      event->marker = parts[4];
+      event->message = line.mid (has_seconds ? 24 : 22).trimmed ();
+    }
+  // the decoder flags a low confidence decode in a fixed column
+  event->low_confidence = QChar {'?'} == line.trimmed ().mid (has_seconds ? 24 + 36 : 22 + 36, 1);
+  event->line = line;
+  event->received = QDateTime::currentDateTimeUtc ();
+  return true;
+}
+
+QByteArray DecodeEvent::to_json () const
+{
+  QJsonObject object;
+  object["utc"] = received.toUTC ().toString (Qt::ISODateWithMs);
+  object["time"] = time.toString ("hhmmss");
+  object["snr"] = snr;
+  object["dt"] = qRound (dt * 10.f) / 10.;
+  object["freq"] = static_cast<qint64> (frequency);
+  object["marker"] = marker;
+  object["message"] = message.trimmed ();
+  object["low_confidence"] = low_confidence;
+  object["standard"] = standard;
+  object["new"] = is_new;
+  object["off_air"] = off_air;
+  object["mode"] = mode;
+  object["band"] = band;
+  object["dial"] = static_cast<qint64> (dial_frequency);
+  return QJsonDocument {object}.toJson (QJsonDocument::Compact);
+}
+
+//
+// JsonLinesFileSink
+//
+class JsonLinesFileSink::impl
+{
+public:
+  explicit impl (QString const& path)
+    : file_ {path}
+  {
+  }
+
+  QFile file_;
+  QByteArray pending_;
+};
+
+JsonLinesFileSink::JsonLinesFileSink (QString const& path)
+  : m_ {path}
+{
+}
+
+JsonLinesFileSink::~JsonLinesFileSink ()
+{
+  flush ();
+}
+
+void JsonLinesFileSink::open ()
+{
+  if (!m_->file_.open (QIODevice::WriteOnly | QIODevice::Append))
+    {
+      qWarning ("decode events: cannot open %s: %s", qPrintable (m_->file_.fileName ())
+                , qPrintable (m_->file_.errorString ()));
+    }
+}
+
+void JsonLinesFileSink::write (DecodeEvent const& event)
+{
+  if (!event.is_new || !m_->file_.isOpen ()) return;
+  m_->pending_ += event.to_json ();
+  m_->pending_ += '\n';
+}
+
+void JsonLinesFileSink::flush ()
+{
+  if (m_->pending_.isEmpty ()) return;
+  m_->file_.write (m_->pending_);
+  m_->file_.flush ();
+  m_->pending_.clear ();
+}
+
+//
+// DecodeStreamSink
+//
+class DecodeStreamSink::impl
+{
+public:
+  impl (QString const& local_name, quint16 tcp_port, QHostAddress const& address)
+    : local_name_ {local_name}
+    , tcp_port_ {tcp_port}
+    , address_ {address}
+  {
+  }
+
+  // server owns client
+  void add_client (QObject * server, QIODevice * client)
+  {
+    clients_ << client;
+    QObject::connect (client, &QObject::destroyed, server, [this, client] () {clients_.removeOne (client);});
+  }
+
+  QString local_name_;
+  quint16 tcp_port_;
+  QHostAddress address_;
+  std::unique_ptr<QLocalServer> local_server_;
+  std::unique_ptr<QTcpServer> tcp_server_;
+  QList<QIODevice *> clients_;
+};
+
+DecodeStreamSink::DecodeStreamSink (QString const& local_name, quint16 tcp_port, QHostAddress const& address)
+  : m_ {local_name, tcp_port, address}
+{
+}
+
+DecodeStreamSink::~DecodeStreamSink ()
+{
+  // servers own their connections
+  m_->clients_.clear ();
+}
+
+void DecodeStreamSink::open ()
+{
+  if (m_->local_name_.size ())
+    {
+      m_->local_server_.reset (new QLocalServer);
+      QLocalServer::removeServer (m_->local_name_); // left by a crash
+      auto * server = m_->local_server_.get ();
+      QObject::connect (server, &QLocalServer::newConnection, [this, server] () {
+          while (auto * client = server->nextPendingConnection ())
+            {
+              QObject::connect (client, &QLocalSocket::disconnected, client, &QObject::deleteLater);
+              m_->add_client (server, client);
+            }
+        });
+      if (!server->listen (m_->local_name_))
+        {
+          qWarning ("decode events: cannot listen on %s: %s", qPrintable (m_->local_name_)
+                    , qPrintable (server->errorString ()));
+        }
+    }
+  if (m_->tcp_port_)
+    {
+      m_->tcp_server_.reset (new QTcpServer);
+      auto * server = m_->tcp_server_.get ();
+      QObject::connect (server, &QTcpServer::newConnection, [this, server] () {
+          while (auto * client = server->nextPendingConnection ())
+            {
+              QObject::connect (client, &QTcpSocket::disconnected, client, &QObject::deleteLater);
+              m_->add_client (server, client);
+            }
+        });
+      if (!server->listen (m_->address_, m_->tcp_port_))
+        {
+          qWarning ("decode events: cannot listen on port %u: %s", m_->tcp_port_
+                    , qPrintable (server->errorString ()));
+        }
+    }
+}
+
+void DecodeStreamSink::write (DecodeEvent const& event)
+{
+  if (m_->clients_.isEmpty ()) return;
+  auto const line = event.to_json () + '\n';
+  for (auto * client : m_->clients_)
+    {
+      if (!client->isOpen ()) continue;
+      if (client->bytesToWrite () > max_client_backlog)
+        {
+          // not reading, let it go
+          client->close ();
+          continue;
+        }
+      client->write (line);
+    }
+}
+
+//
+// DecodeEventBus
+//
+
+// single producer, single consumer ring
+class DecodeEventBus::Queue
+{
+public:
+  Queue ()
+    : slots_ (queue_capacity)
+    , head_ {0}
+    , tail_ {0}
+  {
+  }
+
+  bool push (DecodeEvent const& event)
+  {
+    auto const head = head_.load (std::memory_order_relaxed);
+    if (head - tail_.load (std::memory_order_acquire) == slots_.size ()) return false;
+    slots_[head & (slots_.size () - 1)] = event;
+    head_.store (head + 1, std::memory_order_release);
+    return true;
+  }
+
+  bool pop (DecodeEvent * event)
+  {
+    auto const tail = tail_.load (std::memory_order_relaxed);
+    if (tail == head_.load (std::memory_order_acquire)) return false;
+    auto& slot = slots_[tail & (slots_.size () - 1)];
+    *event = std::move (slot);
+    slot = DecodeEvent {};      // release the strings
+    tail_.store (tail + 1, std::memory_order_release);
+    return true;
+  }
+
+private:
+  std::vector<DecodeEvent> slots_;
+  std::atomic<std::size_t> head_;       // written by the producer
+  std::atomic<std::size_t> tail_;       // written by the consumer
+};
+
+DecodeEventBus::DecodeEventBus (QObject * parent)
+  : QObject {parent}
+  , queue_ {new Queue}
+  , thread_ {new QThread {this}}
+  , worker_ {new QObject}
+  , drain_scheduled_ {false}
+  , dropped_ {0}
+  , published_ {0}
+{
+  thread_->setObjectName ("DecodeEventBus");
+  worker_->moveToThread (thread_);
+  connect (thread_, &QThread::finished, worker_, &QObject::deleteLater);
+  thread_->start ();
+}
+
+DecodeEventBus::~DecodeEventBus ()
+{
+  // deliver what is queued and close the sinks on their own thread
+  QMetaObject::invokeMethod (worker_, [this] () {
+      drain ();
+      sinks_.clear ();
+    }, Qt::BlockingQueuedConnection);
+  thread_->quit ();
+  thread_->wait ();
+}
+
+void DecodeEventBus::subscribe (Subscriber subscriber)
+{
+  subscribers_.push_back (std::move (subscriber));
+}
+
+void DecodeEventBus::add_sink (DecodeSink * sink)
+{
+  QMetaObject::invokeMethod (worker_, [this, sink] () {
+      sinks_.emplace_back (sink);
+      sink->open ();
+    }, Qt::QueuedConnection);
+}
+
+void DecodeEventBus::publish (DecodeEvent const& event)
+{
+  ++published_;
+  for (auto const& subscriber : subscribers_)
+    {
+      subscriber (event);
+    }
+
+  if (!queue_->push (event))
+    {
+      ++dropped_;
+      return;
+    }
+  // one queued drain serves everything pushed before it runs
+  if (!drain_scheduled_.exchange (true))
+    {
+      QMetaObject::invokeMethod (worker_, [this] () {drain ();}, Qt::QueuedConnection);
+    }
+}
+
+void DecodeEventBus::drain ()
+{
+  drain_scheduled_ = false;
+  DecodeEvent event;
+  bool any {false};
+  while (queue_->pop (&event))
+    {
+      for (auto const& sink : sinks_)
+        {
+          sink->write (event);
+        }
+      any = true;
+    }
+  if (any)
+    {
+      for (auto const& sink : sinks_)
+        {
+          sink->flush ();
+        }
+    }
+}
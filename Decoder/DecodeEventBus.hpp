@@ -0,0 +1,155 @@
+// -*- Mode: C++ -*-
+#ifndef DECODE_EVENT_BUS_HPP__
+#define DECODE_EVENT_BUS_HPP__
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QHostAddress>
+#include <QMetaType>
+#include <QString>
+#include <QTime>
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+
+#include "pimpl_h.hpp"
+
+class QThread;
+
+//
+// DecodeEvent - one decode as a typed record
+//
+// Built once from the decoder's text line and handed to every
+// consumer, so none of them have to pick the line apart again.
+//
+struct DecodeEvent
+{
+  QDateTime received;           // UTC when published
+  QTime time;                   // period start as decoded
+  qint32 snr {0};
+  float dt {0.f};
+  quint32 frequency {0};        // audio offset, Hz
+  QString marker;               // decoder's mode marker, e.g. "~"
+  QString message;              // decoded text and any annotations
+  bool low_confidence {false};
+  bool standard {false};        // a standard 77-bit message
+  bool is_new {true};           // false for replays
+  bool off_air {false};         // decoded from a file
+  QString mode;                 // e.g. "FT8"
+  QString band;                 // e.g. "20m"
+  quint64 dial_frequency {0};   // Hz
+  QString line;                 // as received from the decoder
+
+  // false if line is not a decode
+  static bool parse (QString const& line, DecodeEvent *);
+
+  // compact JSON object, no trailing newline
+  QByteArray to_json () const;
+};
+
+Q_DECLARE_METATYPE (DecodeEvent);
+
+//
+// DecodeSink - consumer running on the bus thread
+//
+// A sink is opened on the bus thread before its first event and
+// destroyed there, so it may own sockets and other thread affine
+// objects. flush() follows each batch of writes.
+//
+class DecodeSink
+{
+public:
+  virtual ~DecodeSink () {}
+  virtual void open () {}
+  virtual void write (DecodeEvent const&) = 0;
+  virtual void flush () {}
+};
+
+// appends new decodes, not replays, to path as JSON lines
+class JsonLinesFileSink final
+  : public DecodeSink
+{
+public:
+  explicit JsonLinesFileSink (QString const& path);
+  ~JsonLinesFileSink () override;
+
+  void open () override;
+  void write (DecodeEvent const&) override;
+  void flush () override;
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+//
+// streams JSON lines to clients of a local socket (a Unix domain
+// socket or a Windows named pipe) named local_name and/or a TCP port on
+// address, either may be left out with an empty name or port 0. Clients
+// that fall too far behind are dropped.
+//
+class DecodeStreamSink final
+  : public DecodeSink
+{
+public:
+  DecodeStreamSink (QString const& local_name, quint16 tcp_port
+                    , QHostAddress const& address = QHostAddress::LocalHost);
+  ~DecodeStreamSink () override;
+
+  void open () override;
+  void write (DecodeEvent const&) override;
+
+private:
+  class impl;
+  pimpl<impl> m_;
+};
+
+//
+// DecodeEventBus - publishes decodes to subscribers and sinks
+//
+// Subscribers are called synchronously by publish(), they are for
+// consumers that live on the publishing (GUI) thread. Sinks run on a
+// thread of the bus's own, fed through a lock-free single producer
+// queue, so a slow file or socket never holds up the publisher. If the
+// queue is full the event is dropped for the sinks only.
+//
+// publish() must always be called from the same thread.
+//
+class DecodeEventBus final
+  : public QObject
+{
+public:
+  using Subscriber = std::function<void (DecodeEvent const&)>;
+
+  explicit DecodeEventBus (QObject * parent = nullptr);
+  ~DecodeEventBus () override;
+
+  void subscribe (Subscriber);
+
+  // takes ownership
+  void add_sink (DecodeSink *);
+
+  void publish (DecodeEvent const&);
+
+  quint64 published () const {return published_;}
+  quint64 dropped () const {return dropped_.load ();}
+
+private:
+  class Queue;
+
+  void drain ();
+
+  std::vector<Subscriber> subscribers_;
+  std::unique_ptr<Queue> queue_;
+  QThread * thread_;
+  QObject * worker_;                    // lives on thread_
+  std::vector<std::unique_ptr<DecodeSink>> sinks_; // used on thread_ only
+  std::atomic<bool> drain_scheduled_;
+  std::atomic<quint64> dropped_;
+  quint64 published_;
+};
+
+#endif
@@ -1,3 +1,3 @@
-SOURCES += Decoder/decodedtext.cpp
+SOURCES += Decoder/decodedtext.cpp Decoder/DecodeEventBus.cpp Decoder/DecodeArchive.cpp
 
-HEADERS  += Decoder/decodedtext.h
+HEADERS  += Decoder/decodedtext.h Decoder/DecodeEventBus.hpp Decoder/DecodeArchive.hpp
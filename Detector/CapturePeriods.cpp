@@ -0,0 +1,35 @@
+#include "CapturePeriods.hpp"
+
+#include <cmath>
+
+#include "Audio/AudioClock.hpp"
+
+namespace
+{
+  double constexpr day_ms {86400000.};
+}
+
+qint64 CapturePeriods::per_day () const
+{
+  return static_cast<qint64> (std::ceil (day_ms / period_ms_));
+}
+
+qint64 CapturePeriods::index (double utc_ms) const
+{
+  auto const day = static_cast<qint64> (std::floor (utc_ms / day_ms));
+  return day * per_day () + static_cast<qint64> ((utc_ms - day * day_ms) / period_ms_);
+}
+
+double CapturePeriods::start (qint64 index) const
+{
+  auto const day = index / per_day ();
+  return day * day_ms + (index - day * per_day ()) * period_ms_;
+}
+
+qint64 CapturePeriods::split (AudioClock const& clock, qint64 first, qint64 count, qint64 index) const
+{
+  // the first frame captured at or after the boundary starts the
+  // new period
+  auto const to_boundary = (start (index) - clock.utc (first)) * clock.rate () / 1000.;
+  return static_cast<qint64> (qBound (0., std::ceil (to_boundary), double (count)));
+}
@@ -0,0 +1,40 @@
+// -*- Mode: C++ -*-
+#ifndef CAPTURE_PERIODS_HPP__
+#define CAPTURE_PERIODS_HPP__
+
+#include <QtGlobal>
+
+class AudioClock;
+
+//
+// CapturePeriods - the T/R period grid the Detector captures on
+//
+// Periods are numbered from the epoch and aligned to UTC midnight, so
+// when the period does not divide a day the last one of each day is
+// short. Times are in ms since the epoch on the same system clock
+// that schedules transmit and receive slots.
+//
+class CapturePeriods final
+{
+public:
+  explicit CapturePeriods (double period_seconds = 15.)
+    : period_ms_ {1000. * period_seconds}
+  {
+  }
+
+  void set_period (double period_seconds) {period_ms_ = 1000. * period_seconds;}
+
+  qint64 index (double utc_ms) const; // of the period utc_ms falls in
+  double start (qint64 index) const;  // UTC at which a period starts
+
+  // how many of count frames, the first being frame first as
+  // numbered by clock, were captured before period index started
+  qint64 split (AudioClock const& clock, qint64 first, qint64 count, qint64 index) const;
+
+private:
+  qint64 per_day () const;
+
+  double period_ms_;
+};
+
+#endif
@@ -1,9 +1,9 @@
 #include "Detector.hpp"
-#include <QDateTime>
 #include <QtAlgorithms>
 #include <QDebug>
 #include <math.h>
 #include "commons.h"
+#include "PrecisionTime.hpp"
 
 #include "moc_Detector.cpp"
 
@@ -11,7 +11,7 @@ extern "C" {
   void   fil4_(qint16*, qint32*, qint16*, qint32*);
 }
 
-extern dec_data_t dec_data;
+extern dec_data_t * dec_data;
 
 Detector::Detector (unsigned frameRate, double periodLengthInSeconds,
                     unsigned downSampleFactor, QObject * parent)
@@ -22,8 +22,9 @@ Detector::Detector (unsigned frameRate, double periodLengthInSeconds,
   , m_buffer ((downSampleFactor > 1) ?
               new short [max_buffer_size * downSampleFactor] : nullptr)
   , m_bufferPos (0)
+  , m_clock {double (frameRate) * downSampleFactor}
+  , m_periods {periodLengthInSeconds}
 {
-  (void)frameRate;
   clear ();
 }
 
@@ -32,6 +33,11 @@ void Detector::setBlockSize (unsigned n)
   m_samplesPerFFT = n;
 }
 
+void Detector::setEqualizer (QVector<float> const& taps)
+{
+  m_equalizer.set_taps (taps);
+}
+
 bool Detector::reset ()
 {
   clear ();
@@ -45,47 +51,76 @@ void Detector::clear ()
   // set index to roughly where we are in time (1ms resolution)
   // qint64 now (QDateTime::currentMSecsSinceEpoch ());
   // unsigned msInPeriod ((now % 86400000LL) % (m_period * 1000));
-  // dec_data.params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0])));
-  dec_data.params.kin = 0;
+  // dec_data->params.kin = qMin ((msInPeriod * m_frameRate) / 1000, static_cast<unsigned> (sizeof (dec_data->d2) / sizeof (dec_data->d2[0])));
+  restart_capture (dec_data);
   m_bufferPos = 0;
+  m_clock.reset ();
+  m_equalizer.reset ();
+  m_frames = 0;
+  m_periodIndex = -1;
 
   // fill buffer with zeros (G4WJS commented out because it might cause decoder hangs)
-  // qFill (dec_data.d2, dec_data.d2 + sizeof (dec_data.d2) / sizeof (dec_data.d2[0]), 0);
+  // qFill (dec_data->d2, dec_data->d2 + sizeof (dec_data->d2) / sizeof (dec_data->d2[0]), 0);
 }
 
 qint64 Detector::writeData (char const * data, qint64 maxSize)
+{
+  // no torn frames
+  Q_ASSERT (!(maxSize % static_cast<qint64> (bytesPerFrame ())));
+  auto const frames = static_cast<size_t> (maxSize / bytesPerFrame ());
+  if (!frames) return maxSize;
+
+  // the block has just arrived so its last frame was captured now
+  m_clock.update (m_frames + frames, preciseCurrentMSecsSinceEpoch ());
+  auto const index = m_periods.index (m_clock.utc (m_frames + frames - 1));
+  if (index != m_periodIndex)
+    {
+      // frames before the boundary finish the old period, the rest
+      // start the new one
+      size_t split {0};
+      if (m_periodIndex >= 0 && index > m_periodIndex)
+        {
+          split = static_cast<size_t> (m_periods.split (m_clock, m_frames, frames, index));
+        }
+      append (data, split);
+      restart_capture (dec_data);
+      m_bufferPos = 0;
+      m_periodIndex = index;
+      Q_EMIT clockStatistics (m_clock.drift_ppm (), m_clock.jitter_ms (), m_clock.locked ());
+      append (&data[split * bytesPerFrame ()], frames - split);
+    }
+  else
+    {
+      append (data, frames);
+    }
+  m_frames += frames;
+
+  // we drop any data past the end of the buffer on the floor until
+  // the next period starts
+  return maxSize;
+}
+
+void Detector::append (char const * data, size_t frames)
 {
   constexpr int kMaxKin = NTMAX * RX_SAMPLE_RATE;
-  static unsigned mstr0=999999;
-  qint64 ms0 = QDateTime::currentMSecsSinceEpoch() % 86400000;
-  unsigned mstr = ms0 % int(1000.0*m_period); // ms into the nominal Tx start time
-  if(mstr < mstr0) {              //When mstr has wrapped around to 0, restart the buffer
-    dec_data.params.kin = 0;
-    m_bufferPos = 0;
-  }
-  mstr0=mstr;
-
-  if (dec_data.params.kin < 0 || dec_data.params.kin > kMaxKin)
+  if (!frames) return;
+
+  if (dec_data->params.kin < 0 || dec_data->params.kin > kMaxKin)
     {
-      qWarning () << "Detector: clamping out-of-range kin:" << dec_data.params.kin;
-      dec_data.params.kin = qBound (0, dec_data.params.kin, kMaxKin);
+      qWarning () << "Detector: clamping out-of-range kin:" << dec_data->params.kin;
+      dec_data->params.kin = qBound (0, dec_data->params.kin, kMaxKin);
     }
-  Q_ASSERT (dec_data.params.kin >= 0);
+  Q_ASSERT (dec_data->params.kin >= 0);
 
-  // no torn frames
-  Q_ASSERT (!(maxSize % static_cast<qint64> (bytesPerFrame ())));
   // these are in terms of input frames (not down sampled)
-  size_t framesAcceptable ((sizeof (dec_data.d2) /
-                            sizeof (dec_data.d2[0]) - dec_data.params.kin) * m_downSampleFactor);
-  size_t framesAccepted (qMin (static_cast<size_t> (maxSize /
-                                                    bytesPerFrame ()), framesAcceptable));
+  size_t framesAcceptable ((sizeof (dec_data->d2) /
+                            sizeof (dec_data->d2[0]) - dec_data->params.kin) * m_downSampleFactor);
+  size_t framesAccepted (qMin (frames, framesAcceptable));
 
-  // Soundcard drift computation disabled per product requirement.
-
-  if (framesAccepted < static_cast<size_t> (maxSize / bytesPerFrame ())) {
-    qDebug () << "dropped " << maxSize / bytesPerFrame () - framesAccepted
+  if (framesAccepted < frames) {
+    qDebug () << "dropped " << frames - framesAccepted
                 << " frames of data on the floor!"
-                << dec_data.params.kin << mstr;
+                << dec_data->params.kin << m_periodIndex;
     }
 
     for (unsigned remaining = framesAccepted; remaining; ) {
@@ -100,36 +135,34 @@ qint64 Detector::writeData (char const * data, qint64 maxSize)
         if(m_bufferPos==m_samplesPerFFT*m_downSampleFactor) {
           qint32 framesToProcess (m_samplesPerFFT * m_downSampleFactor);
           qint32 framesAfterDownSample (m_samplesPerFFT);
-          int const boundedKin = qBound (0, dec_data.params.kin, kMaxKin);
+          int const boundedKin = qBound (0, dec_data->params.kin, kMaxKin);
           if(m_downSampleFactor > 1 &&
              boundedKin <= (kMaxKin - framesAfterDownSample)) {
-            fil4_(&m_buffer[0], &framesToProcess, &dec_data.d2[boundedKin],
+            fil4_(&m_buffer[0], &framesToProcess, &dec_data->d2[boundedKin],
                 &framesAfterDownSample);
-            dec_data.params.kin = boundedKin + framesAfterDownSample;
+            m_equalizer.process (&dec_data->d2[boundedKin], framesAfterDownSample);
+            publish_capture (dec_data, boundedKin + framesAfterDownSample);
           } else {
             // qDebug() << "framesToProcess     = " << framesToProcess;
-            // qDebug() << "dec_data.params.kin = " << dec_data.params.kin;
+            // qDebug() << "dec_data->params.kin = " << dec_data->params.kin;
             // qDebug() << "secondInPeriod      = " << secondInPeriod();
             // qDebug() << "framesAfterDownSample" << framesAfterDownSample;
           }
-          Q_EMIT framesWritten (dec_data.params.kin);
+          Q_EMIT framesWritten (dec_data->params.kin);
           m_bufferPos = 0;
         }
 
       } else {
         store (&data[(framesAccepted - remaining) * bytesPerFrame ()],
-               numFramesProcessed, &dec_data.d2[dec_data.params.kin]);
+               numFramesProcessed, &dec_data->d2[dec_data->params.kin]);
+        m_equalizer.process (&dec_data->d2[dec_data->params.kin], numFramesProcessed);
         m_bufferPos += numFramesProcessed;
-        dec_data.params.kin += numFramesProcessed;
+        publish_capture (dec_data, dec_data->params.kin + numFramesProcessed);
         if (m_bufferPos == static_cast<unsigned> (m_samplesPerFFT)) {
-          Q_EMIT framesWritten (dec_data.params.kin);
+          Q_EMIT framesWritten (dec_data->params.kin);
           m_bufferPos = 0;
         }
       }
       remaining -= numFramesProcessed;
     }
-
-    // we drop any data past the end of the buffer on the floor until
-    // the next period starts
-    return maxSize;
 }
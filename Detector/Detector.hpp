@@ -1,7 +1,11 @@
 #ifndef DETECTOR_HPP__
 #define DETECTOR_HPP__
 #include "Audio/AudioDevice.hpp"
+#include "Audio/AudioClock.hpp"
+#include "Audio/Equalizer.hpp"
+#include "Detector/CapturePeriods.hpp"
 #include <QScopedArrayPointer>
+#include <QVector>
 
 //
 // output device that distributes data in predefined chunks via a signal
@@ -9,6 +13,15 @@
 // the underlying device for this abstraction is just the buffer that
 // stores samples throughout a receiving period
 //
+// samples are time stamped by an AudioClock locked to the system
+// clock, the one the transmit and receive slots are scheduled on, a
+// new period's capture starts with the first sample captured at or
+// after the period boundary rather than with the first buffer to
+// arrive after it
+//
+// each block is equalized, if taps have been set, as it is written so
+// that all decoders see the corrected audio
+//
 class Detector : public AudioDevice
 {
   Q_OBJECT;
@@ -25,11 +38,15 @@ public:
   Detector (unsigned frameRate, double periodLengthInSeconds, unsigned downSampleFactor = 4u,
             QObject * parent = 0);
 
-  void setTRPeriod(double p) {m_period=p;}
+  void setTRPeriod(double p) {m_period=p; m_periods.set_period (p);}
   bool reset () override;
 
   Q_SIGNAL void framesWritten (qint64) const;
+  // emitted as each period's capture starts
+  Q_SIGNAL void clockStatistics (double drift_ppm, double jitter_ms, bool locked) const;
   Q_SLOT void setBlockSize (unsigned);
+  // an empty FIR turns equalization off
+  Q_SLOT void setEqualizer (QVector<float> const& taps);
 
 protected:
   qint64 readData (char * /* data */, qint64 /* maxSize */) override
@@ -41,6 +58,7 @@ protected:
 
 private:
   void clear ();		// discard buffer contents
+  void append (char const * data, size_t frames);
 
   double   m_period;
   unsigned m_downSampleFactor;
@@ -52,6 +70,11 @@ private:
   // data (a signals worth) at
   // the input sample rate
   unsigned m_bufferPos;
+  AudioClock m_clock;
+  CapturePeriods m_periods;
+  Equalizer m_equalizer;
+  qint64 m_frames;              // input frames since the clock started
+  qint64 m_periodIndex;         // of the last frame written
 
 };
 
@@ -0,0 +1,386 @@
+#include "LogSinks.hpp"
+
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+#include <boost/algorithm/string/predicate.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/locale/encoding_utf.hpp>
+#include <boost/log/core.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/text_file_backend.hpp>
+#include <boost/log/trivial.hpp>
+#include <boost/log/utility/formatting_ostream.hpp>
+#include <boost/log/utility/setup/filter_parser.hpp>
+#include <boost/log/utility/setup/formatter_parser.hpp>
+#include <boost/log/utility/setup/from_settings.hpp>
+#include <boost/make_shared.hpp>
+#include <boost/thread/locks.hpp>
+
+namespace logging = boost::log;
+namespace sinks = logging::sinks;
+namespace keywords = logging::keywords;
+namespace expr = logging::expressions;
+
+namespace Logger
+{
+  namespace
+  {
+    std::atomic<std::uint64_t> total_dropped {0};
+
+    std::size_t const default_queue_size {4096};
+    std::size_t const default_capacity {2000};
+  }
+
+  bounded_queue::bounded_queue ()
+    : capacity_ {default_queue_size}
+    , overflow_ {Overflow::DropOldest}
+    , interrupted_ {false}
+    , dropped_ {0}
+    , reported_ {0}
+  {
+  }
+
+  void bounded_queue::set_capacity (std::size_t capacity, Overflow overflow)
+  {
+    boost::lock_guard<boost::mutex> lock {mutex_};
+    capacity_ = capacity ? capacity : 1;
+    overflow_ = overflow;
+    space_.notify_all ();
+  }
+
+  void bounded_queue::enqueue (logging::record_view const& record)
+  {
+    boost::unique_lock<boost::mutex> lock {mutex_};
+    while (queue_.size () >= capacity_)
+      {
+        switch (overflow_)
+          {
+          case Overflow::Block:
+            space_.wait (lock);
+            continue;
+
+          case Overflow::DropOldest:
+            queue_.pop_front ();
+            break;
+
+          case Overflow::DropNewest:
+            ++dropped_;
+            ++total_dropped;
+            return;
+          }
+        ++dropped_;
+        ++total_dropped;
+      }
+    queue_.push_back (record);
+    if (1 == queue_.size ()) ready_.notify_one ();
+  }
+
+  bool bounded_queue::try_enqueue (logging::record_view const& record)
+  {
+    // the core retries a record refused here with enqueue (), so only
+    // refuse when that is the one that should wait, a record dropped
+    // here is counted like one dropped there
+    boost::unique_lock<boost::mutex> lock {mutex_, boost::try_to_lock};
+    if (!lock.owns_lock ()) return false;
+    if (queue_.size () >= capacity_)
+      {
+        switch (overflow_)
+          {
+          case Overflow::Block:
+            return false;
+
+          case Overflow::DropOldest:
+            queue_.pop_front ();
+            break;
+
+          case Overflow::DropNewest:
+            ++dropped_;
+            ++total_dropped;
+            return true;
+          }
+        ++dropped_;
+        ++total_dropped;
+      }
+    queue_.push_back (record);
+    if (1 == queue_.size ()) ready_.notify_one ();
+    return true;
+  }
+
+  bool bounded_queue::pop (logging::record_view& record)
+  {
+    if (queue_.empty ()) return false;
+    record.swap (queue_.front ());
+    queue_.pop_front ();
+    space_.notify_one ();
+    return true;
+  }
+
+  bool bounded_queue::try_dequeue_ready (logging::record_view& record)
+  {
+    return try_dequeue (record);
+  }
+
+  bool bounded_queue::try_dequeue (logging::record_view& record)
+  {
+    boost::lock_guard<boost::mutex> lock {mutex_};
+    return pop (record);
+  }
+
+  bool bounded_queue::dequeue_ready (logging::record_view& record)
+  {
+    boost::unique_lock<boost::mutex> lock {mutex_};
+    while (!interrupted_)
+      {
+        if (pop (record)) return true;
+        ready_.wait (lock);
+      }
+    interrupted_ = false;
+    return false;
+  }
+
+  void bounded_queue::interrupt_dequeue ()
+  {
+    boost::lock_guard<boost::mutex> lock {mutex_};
+    interrupted_ = true;
+    ready_.notify_one ();
+    space_.notify_all ();
+  }
+
+  std::uint64_t bounded_queue::take_unreported ()
+  {
+    auto const dropped = dropped_.load ();
+    auto const unreported = dropped - reported_;
+    reported_ = dropped;
+    return unreported;
+  }
+
+  flight_recorder_backend::flight_recorder_backend (boost::filesystem::path const& file_name, std::size_t capacity
+                                                    , logging::filter const& trigger
+                                                    , logging::formatter const& formatter)
+    : file_name_ {file_name}
+    , trigger_ {trigger}
+    , formatter_ {formatter}
+    , ring_ (capacity ? capacity : 1)
+    , next_ {0}
+    , full_ {false}
+  {
+  }
+
+  void flight_recorder_backend::consume (logging::record_view const& record)
+  {
+    // just hold on to the record, formatting is left until it is needed
+    ring_[next_] = record;
+    if (++next_ == ring_.size ())
+      {
+        next_ = 0;
+        full_ = true;
+      }
+    if (trigger_ (record.attribute_values ())) dump ();
+  }
+
+  void flight_recorder_backend::dump ()
+  {
+    boost::filesystem::ofstream file {file_name_, std::ios_base::out | std::ios_base::app};
+    file << "---- flight recorder, last " << size () << " records ----\n";
+    std::string line;
+    logging::formatting_ostream stream {line};
+    auto const write = [&] (std::size_t index) {
+      line.clear ();
+      formatter_ (ring_[index], stream);
+      stream.flush ();
+      file << line << '\n';
+      ring_[index] = logging::record_view {};
+    };
+    if (full_)
+      {
+        for (auto index = next_; index < ring_.size (); ++index) write (index);
+      }
+    for (std::size_t index = 0; index < next_; ++index) write (index);
+    file.flush ();
+    next_ = 0;
+    full_ = false;
+  }
+
+  std::uint64_t dropped_records ()
+  {
+    return total_dropped;
+  }
+
+  namespace
+  {
+    // a text file backend that notes where records were dropped
+    class bounded_text_file_backend
+      : public sinks::text_file_backend
+    {
+    public:
+      template<typename ArgsT>
+      explicit bounded_text_file_backend (ArgsT const& args)
+        : sinks::text_file_backend {args}
+        , queue_ {nullptr}
+      {
+      }
+
+      void set_queue (bounded_queue * queue) {queue_ = queue;}
+
+      void consume (logging::record_view const& record, string_type const& message)
+      {
+        if (queue_)
+          {
+            if (auto const dropped = queue_->take_unreported ())
+              {
+                sinks::text_file_backend::consume (record, "[" + std::to_string (dropped) + " log records dropped]");
+              }
+          }
+        sinks::text_file_backend::consume (record, message);
+      }
+
+    private:
+      bounded_queue * queue_;
+    };
+
+    using bounded_text_file_sink = sinks::asynchronous_sink<bounded_text_file_backend, bounded_queue>;
+    using settings_section = logging::wsettings_section;
+
+    // formats and filters are parsed as narrow strings as that is how
+    // the Severity, TimeStamp and Uptime factories are registered
+    std::string narrow (std::wstring const& s)
+    {
+      return boost::locale::conv::utf_to_utf<char> (s);
+    }
+
+    boost::optional<std::wstring> parameter (settings_section const& settings, char const * name)
+    {
+      return settings[name].get ();
+    }
+
+    template<typename T>
+    T parameter (settings_section const& settings, char const * name, T default_value)
+    {
+      if (auto value = parameter (settings, name))
+        {
+          return boost::lexical_cast<T> (narrow (*value));
+        }
+      return default_value;
+    }
+
+    bool flag (settings_section const& settings, char const * name, bool default_value)
+    {
+      if (auto value = parameter (settings, name))
+        {
+          return boost::iequals (*value, L"true") || *value == L"1";
+        }
+      return default_value;
+    }
+
+    std::wstring required (settings_section const& settings, char const * name)
+    {
+      if (auto value = parameter (settings, name))
+        {
+          return *value;
+        }
+      throw std::invalid_argument {std::string {"log sink parameter missing: "} + name};
+    }
+
+    logging::formatter formatter (settings_section const& settings)
+    {
+      if (auto value = parameter (settings, "Format"))
+        {
+          return logging::parse_formatter (narrow (*value));
+        }
+      return expr::stream << expr::smessage;
+    }
+
+    template<typename SinkT>
+    void set_filter (SinkT& sink, settings_section const& settings)
+    {
+      if (auto value = parameter (settings, "Filter"))
+        {
+          sink.set_filter (logging::parse_filter (narrow (*value)));
+        }
+    }
+
+    Overflow overflow (settings_section const& settings)
+    {
+      auto const policy = parameter (settings, "Overflow").get_value_or (L"DropOldest");
+      if (boost::iequals (policy, L"DropNewest")) return Overflow::DropNewest;
+      if (boost::iequals (policy, L"DropOldest")) return Overflow::DropOldest;
+      if (boost::iequals (policy, L"Block")) return Overflow::Block;
+      throw std::invalid_argument {"unknown log sink Overflow policy: " + narrow (policy)};
+    }
+
+    class bounded_text_file_factory
+      : public logging::sink_factory<wchar_t>
+    {
+    public:
+      boost::shared_ptr<sinks::sink> create_sink (settings_section const& settings) override
+      {
+        auto const append = flag (settings, "Append", false);
+        auto backend = boost::make_shared<bounded_text_file_backend>
+          ((
+            keywords::file_name = required (settings, "FileName")
+            , keywords::rotation_size = parameter (settings, "RotationSize", std::numeric_limits<std::uintmax_t>::max ())
+            , keywords::open_mode = append ? std::ios_base::out | std::ios_base::app : std::ios_base::out | std::ios_base::trunc
+            , keywords::auto_flush = flag (settings, "AutoFlush", false)
+            ));
+        if (auto target = parameter (settings, "Target"))
+          {
+            backend->set_file_collector
+              (
+               sinks::file::make_collector
+               (
+                keywords::target = *target
+                , keywords::max_size = parameter (settings, "MaxSize", std::numeric_limits<std::uintmax_t>::max ())
+                , keywords::min_free_space = parameter (settings, "MinFreeSpace", std::uintmax_t {0})
+                , keywords::max_files = parameter (settings, "MaxFiles", std::numeric_limits<std::uintmax_t>::max ())
+                )
+               );
+            backend->scan_for_files ();
+          }
+
+        // nothing reaches the sink before it is returned, so it is safe
+        // to configure it with the feeding thread already running
+        auto sink = boost::make_shared<bounded_text_file_sink> (backend);
+        sink->set_capacity (parameter (settings, "QueueSize", default_queue_size), overflow (settings));
+        backend->set_queue (sink.get ());
+        sink->set_formatter (formatter (settings));
+        set_filter (*sink, settings);
+        return sink;
+      }
+    };
+
+    class flight_recorder_factory
+      : public logging::sink_factory<wchar_t>
+    {
+    public:
+      boost::shared_ptr<sinks::sink> create_sink (settings_section const& settings) override
+      {
+        logging::filter trigger {logging::trivial::severity >= logging::trivial::error};
+        if (auto value = parameter (settings, "Trigger"))
+          {
+            trigger = logging::parse_filter (narrow (*value));
+          }
+        auto backend = boost::make_shared<flight_recorder_backend>
+          (required (settings, "FileName")
+           , parameter (settings, "Capacity", default_capacity)
+           , trigger
+           , formatter (settings));
+        // records are kept on a thread of their own too, a full queue
+        // only loses the oldest which would soon be overwritten anyway
+        auto sink = boost::make_shared<sinks::asynchronous_sink<flight_recorder_backend, bounded_queue>> (backend);
+        sink->set_capacity (parameter (settings, "QueueSize", default_queue_size), Overflow::DropOldest);
+        set_filter (*sink, settings);
+        return sink;
+      }
+    };
+  }
+
+  void register_sink_factories ()
+  {
+    logging::register_sink_factory ("BoundedTextFile", boost::make_shared<bounded_text_file_factory> ());
+    logging::register_sink_factory ("FlightRecorder", boost::make_shared<flight_recorder_factory> ());
+  }
+}
@@ -0,0 +1,120 @@
+#ifndef LOG_SINKS_HPP__
+#define LOG_SINKS_HPP__
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+#include <boost/filesystem/path.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/log/core/record_view.hpp>
+#include <boost/log/expressions/filter.hpp>
+#include <boost/log/expressions/formatter.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/shared_ptr.hpp>
+
+//
+// Log sinks that keep logging from disturbing the timing of the code
+// being logged
+//
+// BoundedTextFile is a text file sink written from a thread of its
+// own like an Asynchronous TextFile sink, but records queue in a
+// buffer of QueueSize entries. When a burst of trace records fills
+// it the Overflow policy decides whether the logging thread waits
+// (Block), the new record is dropped (DropNewest) or the oldest
+// queued one is (DropOldest, the default). Drops are counted and a
+// line saying how many were lost is written where they were lost.
+//
+// FlightRecorder keeps the last Capacity records in memory, which
+// costs the logging thread little more than queuing them, and only
+// formats and writes them to FileName when a record matching Trigger,
+// by default "%Severity% >= error", arrives. Detailed logging can then
+// be left on permanently to capture the lead up to a failure.
+//
+// Both are available as sink Destinations in wsjtx_log_config.ini,
+// see example_log_configurations/wsjtx_log_config.ini.rig_control.
+//
+namespace Logger
+{
+  enum class Overflow {Block, DropNewest, DropOldest};
+
+  // queueing strategy for boost::log::sinks::asynchronous_sink with a
+  // capacity and overflow policy chosen at run time, until they are
+  // set 4096 records dropping the oldest
+  class bounded_queue
+  {
+  public:
+    void set_capacity (std::size_t capacity, Overflow);
+    std::uint64_t dropped () const {return dropped_;}
+
+    // number of records dropped since the last call, for the feeding
+    // thread
+    std::uint64_t take_unreported ();
+
+  protected:
+    bounded_queue ();
+    template<typename ArgsT>
+    explicit bounded_queue (ArgsT const&)
+      : bounded_queue {}
+    {
+    }
+
+    // the interface asynchronous_sink requires
+    void enqueue (boost::log::record_view const&);
+    bool try_enqueue (boost::log::record_view const&);
+    bool try_dequeue_ready (boost::log::record_view&);
+    bool try_dequeue (boost::log::record_view&);
+    bool dequeue_ready (boost::log::record_view&);
+    void interrupt_dequeue ();
+
+  private:
+    bool pop (boost::log::record_view&);
+
+    boost::mutex mutex_;
+    boost::condition_variable ready_;
+    boost::condition_variable space_;
+    std::deque<boost::log::record_view> queue_;
+    std::size_t capacity_;
+    Overflow overflow_;
+    bool interrupted_;
+    std::atomic<std::uint64_t> dropped_;
+    std::uint64_t reported_;
+  };
+
+  // keeps recent records and writes them out when one matches the
+  // trigger
+  class flight_recorder_backend
+    : public boost::log::sinks::basic_sink_backend<boost::log::sinks::synchronized_feeding>
+  {
+  public:
+    flight_recorder_backend (boost::filesystem::path const& file_name, std::size_t capacity
+                             , boost::log::filter const& trigger
+                             , boost::log::formatter const&);
+
+    void consume (boost::log::record_view const&);
+
+    std::size_t size () const {return full_ ? ring_.size () : next_;}
+
+  private:
+    void dump ();
+
+    boost::filesystem::path file_name_;
+    boost::log::filter trigger_;
+    boost::log::formatter formatter_;
+    std::vector<boost::log::record_view> ring_;
+    std::size_t next_;
+    bool full_;
+  };
+
+  // records dropped by all BoundedTextFile sinks
+  std::uint64_t dropped_records ();
+
+  // make BoundedTextFile and FlightRecorder available to
+  // init_from_config ()
+  void register_sink_factories ();
+}
+
+#endif
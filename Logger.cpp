@@ -1,4 +1,5 @@
 #include "Logger.hpp"
+#include "LogSinks.hpp"
 
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost/date_time/posix_time/posix_time.hpp>
@@ -116,6 +117,8 @@ namespace Logger
         logging::register_formatter_factory ("TimeStamp", boost::make_shared<TimeStampFormatterFactory> ());
         // Allows %Uptime(format=\"%O:%M:%S.%f\")% to be used in ini config file for property Format.
         logging::register_formatter_factory ("Uptime", boost::make_shared<UptimeFormatterFactory> ());
+        // Allows Destination=BoundedTextFile and Destination=FlightRecorder in ini config file sinks.
+        register_sink_factories ();
       }
       ~CommonInitialization ()
       {
@@ -28,8 +28,8 @@
 #include <QMetaObject>
 
 #include "SettingsGroup.hpp"
+#include "SettingsWriteBehind.hpp"
 #include "qt_helpers.hpp"
-#include "SettingsGroup.hpp"
 #include "widgets/MessageBox.hpp"
 
 #include "pimpl_impl.hpp"
@@ -159,6 +159,7 @@ public:
   bool exit ();
 
   QSettings settings_;
+  SettingsWriteBehind write_behind_;
   QString current_;
 
   // switch to this configuration
@@ -287,6 +288,7 @@ bool MultiSettings::exit ()
 
 MultiSettings::impl::impl (MultiSettings const * parent, QString const& config_name)
   : settings_ {settings_path (), QSettings::IniFormat}
+  , write_behind_ {&settings_}
   , parent_ {parent}
   , main_window_ {nullptr}
   , name_change_emit_pending_ {true}
@@ -353,7 +355,6 @@ MultiSettings::impl::impl (MultiSettings const * parent, QString const& config_n
       reposition_type_ = RepositionType::save_and_replace;
       reposition ();
     }
-  settings_.sync ();
 }
 
 // do actions that can only be done once all the windows are closed
@@ -375,14 +376,19 @@ bool MultiSettings::impl::reposition ()
       }
       // fall through
     case RepositionType::replace:
-      // and purge current settings
-      for (auto const& key: settings_.allKeys ())
+      // and purge current settings, a whole group at a time as
+      // removing keys one by one is quadratic in the number of keys
+      for (auto const& group: settings_.childGroups ())
         {
-          if (!key.contains (multi_settings_root_group))
+          if (group != multi_settings_root_group)
             {
-              settings_.remove (key);
+              settings_.remove (group);
             }
         }
+      for (auto const& key: settings_.childKeys ())
+        {
+          settings_.remove (key);
+        }
       // insert the new settings
       load_from (new_settings_, false);
       if (!new_settings_.size ())
@@ -405,6 +411,7 @@ bool MultiSettings::impl::reposition ()
         // switch to the specified configuration name
         settings_.setValue (multi_settings_current_name_key, current_);
       }
+      // the only write of the whole switch
       settings_.sync ();
       // fall through
     case RepositionType::unchanged:
@@ -460,6 +467,7 @@ bool MultiSettings::impl::exit ()
 {
   // ensure that configuration name changed signal gets fired on restart
   name_change_emit_pending_ = true;
+  write_behind_.flush ();
 
   // do any configuration swap required and return exit flag
   return reposition ();
@@ -569,7 +577,6 @@ void MultiSettings::impl::load_from (Dictionary const& dictionary, bool add_plac
       // name from disappearing
       settings_.setValue (multi_settings_place_holder_key, QVariant {});
     }
-  settings_.sync ();
 }
 
 void MultiSettings::impl::select_configuration (QString const& target_name)
@@ -738,7 +745,6 @@ void MultiSettings::impl::reset_configuration (QMenu const * menu)
       // add a placeholder to stop alternative configuration name
       // being lost
       settings_.setValue (multi_settings_place_holder_key, QVariant {});
-      settings_.sync ();
       if (current_group.size ()) settings_.beginGroup (current_group);
     }
 }
@@ -764,7 +770,6 @@ void MultiSettings::impl::rename_configuration (QMenu * menu)
       if (target_name == current_)
         {
           settings_.setValue (multi_settings_current_name_key, dialog.new_name ());
-          settings_.sync ();
           current_ = dialog.new_name ();
           Q_EMIT parent_->configurationNameChanged (unescape_ampersands (current_));
         }
@@ -814,7 +819,6 @@ void MultiSettings::impl::delete_configuration (QMenu * menu)
       SettingsGroup target_group {&settings_, target_name};
       // purge the configuration data
       settings_.remove (QString {}); // purge entire group
-      settings_.sync ();
       if (current_group.size ()) settings_.beginGroup (current_group);
     }
   // update the menu
@@ -27,6 +27,11 @@ class QMenu;
 //  at the  root level a key  called CurrentMultiSettingsConfiguration
 //  is reserved to store the current configuration name.
 //
+//  Changes  are written  to the  file a  couple of  seconds after  the
+//  first unsaved one, so bursts of setValue() calls cost a single file
+//  write,  and at  the  latest when  exit()  is called.  Switching
+//  configuration writes the file once.
+//
 //
 // Example Usage:
 //
@@ -0,0 +1,490 @@
+// -*- Mode: C++ -*-
+#include "DXClusterClient.hpp"
+
+#include <QLocale>
+#include <QRegularExpression>
+#include <QTcpSocket>
+#include <QTime>
+#include <QTimer>
+
+namespace
+{
+int const kConnectTimeoutMs = 10 * 1000;
+int const kLoginPromptMs = 2500;      // log in anyway if no prompt by then
+int const kLoginSettleMs = 3500;
+int const kMinBackoffMs = 5 * 1000;
+int const kMaxBackoffMs = 2 * 60 * 1000;
+int const kMaxLineBytes = 64 * 1024;  // give up on a "line" this long
+
+bool contains_cluster_prompt (QByteArray const& buffer)
+{
+  auto const text = QString::fromLatin1 (buffer).simplified ();
+  auto const lower = text.toLower ();
+  return lower.contains (QStringLiteral ("login:"))
+      || lower.contains (QStringLiteral ("call:"))
+      || lower.contains (QStringLiteral ("callsign"))
+      || lower.contains (QStringLiteral ("enter your"))
+      || lower.contains (QStringLiteral ("please enter"))
+      || text.endsWith (QLatin1Char (':'))
+      || text.endsWith (QLatin1Char ('>'))
+      || (lower.contains (QStringLiteral (" de ")) && text.endsWith (QLatin1Char ('>')));
+}
+
+bool contains_cluster_error (QString const& line)
+{
+  auto const lower = line.toLower ();
+  return lower.contains (QStringLiteral ("need a callsign"))
+      || lower.contains (QStringLiteral ("invalid callsign"))
+      || lower.contains (QStringLiteral ("unknown command"))
+      || lower.contains (QStringLiteral ("sorry"));
+}
+
+// strip telnet commands from raw into buffer, answering option
+// negotiation, an incomplete command is held in telnet_pending
+void append_cluster_payload (QTcpSocket * socket, QByteArray * telnet_pending, QByteArray * buffer, QByteArray raw)
+{
+  if (!socket || !buffer) return;
+
+  if (telnet_pending && !telnet_pending->isEmpty ())
+    {
+      raw.prepend (*telnet_pending);
+      telnet_pending->clear ();
+    }
+
+  for (int i = 0; i < raw.size ();)
+    {
+      auto const byte = static_cast<unsigned char> (raw.at (i));
+      if (byte != 0xFF)
+        {
+          buffer->append (raw.at (i));
+          ++i;
+          continue;
+        }
+
+      if (i + 1 >= raw.size ())
+        {
+          if (telnet_pending) *telnet_pending = raw.mid (i);
+          break;
+        }
+
+      auto const cmd = static_cast<unsigned char> (raw.at (i + 1));
+      if (cmd == 0xFF)
+        {
+          buffer->append (char (0xFF));
+          i += 2;
+          continue;
+        }
+
+      if (cmd == 0xFA)
+        {
+          int end = -1;
+          for (int j = i + 2; j + 1 < raw.size (); ++j)
+            {
+              if (static_cast<unsigned char> (raw.at (j)) == 0xFF
+                  && static_cast<unsigned char> (raw.at (j + 1)) == 0xF0)
+                {
+                  end = j + 2;
+                  break;
+                }
+            }
+          if (end < 0)
+            {
+              if (telnet_pending) *telnet_pending = raw.mid (i);
+              break;
+            }
+          i = end;
+          continue;
+        }
+
+      if (cmd >= 0xFB && cmd <= 0xFE)
+        {
+          if (i + 2 >= raw.size ())
+            {
+              if (telnet_pending) *telnet_pending = raw.mid (i);
+              break;
+            }
+
+          auto const opt = static_cast<unsigned char> (raw.at (i + 2));
+          char reply[3] = {char (0xFF), 0, char (opt)};
+          bool const accepted = (opt == 1 || opt == 3);
+
+          if (cmd == 0xFB)
+            {
+              reply[1] = accepted ? char (0xFD) : char (0xFE);
+            }
+          else if (cmd == 0xFD)
+            {
+              reply[1] = accepted ? char (0xFB) : char (0xFC);
+            }
+          else
+            {
+              i += 3;
+              continue;
+            }
+
+          socket->write (reply, 3);
+          i += 3;
+          continue;
+        }
+
+      i += 2;
+    }
+}
+}
+
+DXClusterClient::DXClusterClient(QObject * parent)
+  : QObject {parent}
+  , backoffMs_ {kMinBackoffMs}
+{
+  qRegisterMetaType<DXClusterSpot> ("DXClusterSpot");
+  qRegisterMetaType<QVector<DXClusterSpot>> ("QVector<DXClusterSpot>");
+}
+
+DXClusterClient::~DXClusterClient()
+{
+  stop();
+}
+
+void DXClusterClient::start(QString const& host, int port, QString const& login)
+{
+  // children are created here rather than in the constructor so that
+  // they belong to the thread we have been moved to
+  if (!socket_)
+    {
+      socket_ = new QTcpSocket {this};
+      stateTimer_ = new QTimer {this};
+      stateTimer_->setSingleShot(true);
+      reconnectTimer_ = new QTimer {this};
+      reconnectTimer_->setSingleShot(true);
+      connect(socket_, &QTcpSocket::connected, this, &DXClusterClient::onConnected);
+      connect(socket_, &QTcpSocket::disconnected, this, &DXClusterClient::onDisconnected);
+      connect(socket_, &QTcpSocket::readyRead, this, &DXClusterClient::onReadyRead);
+#if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
+      connect(socket_, &QAbstractSocket::errorOccurred, this, [this] (QAbstractSocket::SocketError) {
+#else
+      connect(socket_, QOverload<QAbstractSocket::SocketError>::of (&QAbstractSocket::error), this, [this] (QAbstractSocket::SocketError) {
+#endif
+          Q_EMIT statusChanged(tr("Cluster connection error: %1").arg(socket_->errorString()), true);
+          if (QAbstractSocket::UnconnectedState == socket_->state() && State::Idle != state_)
+            {
+              scheduleReconnect(backoffMs_);
+            }
+        });
+      connect(stateTimer_, &QTimer::timeout, this, &DXClusterClient::onStateTimeout);
+      connect(reconnectTimer_, &QTimer::timeout, this, [this] {
+          paused_ = false;
+          connectToNode();
+        });
+    }
+
+  bool const changed = host != host_ || port != port_ || login != login_;
+  host_ = host;
+  port_ = port;
+  login_ = login;
+  if (changed || State::Idle == state_)
+    {
+      backoffMs_ = kMinBackoffMs;
+      if (!paused_)
+        {
+          connectToNode();
+        }
+    }
+}
+
+void DXClusterClient::stop()
+{
+  state_ = State::Idle;
+  paused_ = false;
+  if (!socket_) return;
+  stateTimer_->stop();
+  reconnectTimer_->stop();
+  if (QAbstractSocket::ConnectedState == socket_->state())
+    {
+      socket_->write(QByteArrayLiteral ("bye\r\n"));
+      socket_->disconnectFromHost();
+    }
+  else
+    {
+      socket_->abort();
+    }
+}
+
+void DXClusterClient::requestSpots(QString const& band, int count)
+{
+  requestBand_ = band.trimmed().toLower();
+  requestCount_ = count;
+  if (State::Online == state_)
+    {
+      sendPendingRequest();
+    }
+}
+
+void DXClusterClient::pause(int ms)
+{
+  if (!socket_ || State::Idle == state_) return;
+  paused_ = true;
+  stateTimer_->stop();
+  if (QAbstractSocket::UnconnectedState != socket_->state())
+    {
+      socket_->write(QByteArrayLiteral ("bye\r\n"));
+      socket_->disconnectFromHost();
+    }
+  state_ = State::Connecting;
+  reconnectTimer_->start(qMax(0, ms));
+}
+
+void DXClusterClient::connectToNode()
+{
+  reconnectTimer_->stop();
+  if (host_.isEmpty() || login_.isEmpty() || port_ <= 0)
+    {
+      state_ = State::Idle;
+      Q_EMIT statusChanged(host_.isEmpty() ? tr("empty cluster host") : tr("empty MyCall setting"), true);
+      return;
+    }
+  socket_->abort();
+  buffer_.clear();
+  telnetPending_.clear();
+  state_ = State::Connecting;
+  Q_EMIT statusChanged(tr("Connecting to %1:%2 ...").arg(host_).arg(port_), false);
+  socket_->connectToHost(host_, static_cast<quint16> (port_));
+  stateTimer_->start(kConnectTimeoutMs);
+}
+
+void DXClusterClient::scheduleReconnect(int ms)
+{
+  if (State::Idle == state_ || paused_ || reconnectTimer_->isActive()) return;
+  stateTimer_->stop();
+  state_ = State::Connecting;
+  reconnectTimer_->start(ms);
+  backoffMs_ = qMin(2 * backoffMs_, kMaxBackoffMs);
+}
+
+void DXClusterClient::onConnected()
+{
+  state_ = State::AwaitingLoginPrompt;
+  stateTimer_->start(kLoginPromptMs);
+}
+
+void DXClusterClient::onDisconnected()
+{
+  stateTimer_->stop();
+  if (State::Idle != state_ && !paused_)
+    {
+      Q_EMIT statusChanged(tr("Cluster node closed the connection, reconnecting in %1 s")
+                           .arg(backoffMs_ / 1000), true);
+      scheduleReconnect(backoffMs_);
+    }
+}
+
+void DXClusterClient::onStateTimeout()
+{
+  switch (state_)
+    {
+    case State::Connecting:
+      Q_EMIT statusChanged(tr("Cluster connection timed out"), true);
+      socket_->abort();
+      scheduleReconnect(backoffMs_);
+      break;
+
+    case State::AwaitingLoginPrompt:
+      sendLogin();              // some nodes send no recognizable prompt
+      break;
+
+    case State::LoggingIn:
+      goOnline();
+      break;
+
+    default:
+      break;
+    }
+}
+
+void DXClusterClient::onReadyRead()
+{
+  append_cluster_payload(socket_, &telnetPending_, &buffer_, socket_->readAll());
+  switch (state_)
+    {
+    case State::AwaitingLoginPrompt:
+      if (contains_cluster_prompt(buffer_))
+        {
+          sendLogin();
+        }
+      break;
+
+    case State::LoggingIn:
+      if (contains_cluster_prompt(buffer_))
+        {
+          goOnline();
+        }
+      break;
+
+    case State::Online:
+      processLines();
+      break;
+
+    default:
+      break;
+    }
+  if (buffer_.size() > kMaxLineBytes)
+    {
+      buffer_.clear();
+    }
+}
+
+void DXClusterClient::sendLine(QString const& line)
+{
+  socket_->write((line + QStringLiteral ("\r\n")).toUtf8());
+}
+
+void DXClusterClient::sendLogin()
+{
+  buffer_.clear();
+  sendLine(login_);
+  state_ = State::LoggingIn;
+  stateTimer_->start(kLoginSettleMs);
+}
+
+void DXClusterClient::goOnline()
+{
+  stateTimer_->stop();
+  buffer_.clear();
+  // no paging and make sure spot announcements are on, they are a
+  // per user setting that the node remembers
+  sendLine(QStringLiteral ("set/page 0"));
+  sendLine(QStringLiteral ("set/dx"));
+  state_ = State::Online;
+  backoffMs_ = kMinBackoffMs;
+  Q_EMIT statusChanged(tr("Connected to %1:%2 as %3").arg(host_).arg(port_).arg(login_), false);
+  sendPendingRequest();
+}
+
+void DXClusterClient::sendPendingRequest()
+{
+  if (requestBand_.isEmpty() || requestCount_ <= 0) return;
+  sendLine(QStringLiteral ("show/dx %1 on %2 real").arg(requestCount_).arg(requestBand_));
+  requestBand_.clear();
+}
+
+void DXClusterClient::processLines()
+{
+  auto const end = buffer_.lastIndexOf('\n');
+  if (end < 0) return;
+
+  QVector<DXClusterSpot> spots;
+  auto const nowUtc = QDateTime::currentDateTimeUtc();
+  auto const lines = buffer_.left(end).split('\n');
+  buffer_.remove(0, end + 1);
+  for (auto const& rawLine : lines)
+    {
+      auto const line = QString::fromUtf8(rawLine).trimmed();
+      if (line.isEmpty()) continue;
+      DXClusterSpot spot;
+      if (parseSpotLine(line, nowUtc, &spot))
+        {
+          spots.push_back(spot);
+        }
+      else if (contains_cluster_error(line))
+        {
+          Q_EMIT statusChanged(tr("Cluster: %1").arg(line), true);
+        }
+    }
+  if (!spots.isEmpty())
+    {
+      Q_EMIT spotsReceived(spots);
+    }
+}
+
+bool DXClusterClient::parseSpotLine(QString const& line, QDateTime const& nowUtc, DXClusterSpot * spot)
+{
+  static QRegularExpression const realTimeRe {
+    QStringLiteral (R"(^DX de\s+([^:]+):\s+([0-9.]+)\s+(\S+)\s*(.*?)\s+([0-9]{4})Z\s*$)")
+  };
+  static QRegularExpression const snapshotRe {
+    QStringLiteral (R"(^\s*([0-9.]+)\s+(\S+)\s+(\d{2}-[A-Za-z]{3}-\d{4})\s+([0-9]{4})Z\s*(.*?)\s+<([^>]+)>\s*$)")
+  };
+
+  if (!spot || line.startsWith('<') || line.startsWith("ERROR", Qt::CaseInsensitive))
+    {
+      return false;
+    }
+
+  auto match = realTimeRe.match(line);
+  if (match.hasMatch())
+    {
+      auto dt = QDateTime (nowUtc.date(), QTime::fromString(match.captured(5), QStringLiteral ("hhmm")), Qt::UTC);
+      if (dt.isValid() && dt > nowUtc.addSecs(300))
+        {
+          dt = dt.addDays(-1);
+        }
+      spot->spotter = match.captured(1).trimmed();
+      spot->frequency = match.captured(2).trimmed();
+      spot->dxCall = match.captured(3).trimmed();
+      spot->comment = match.captured(4).trimmed();
+      spot->time = dt;
+    }
+  else
+    {
+      match = snapshotRe.match(line);
+      if (!match.hasMatch())
+        {
+          return false;
+        }
+      auto const date = QLocale::c().toDate(match.captured(3), QStringLiteral ("dd-MMM-yyyy"));
+      auto const time = QTime::fromString(match.captured(4), QStringLiteral ("hhmm"));
+      spot->frequency = match.captured(1).trimmed();
+      spot->dxCall = match.captured(2).trimmed();
+      spot->time = QDateTime (date, time, Qt::UTC);
+      spot->comment = match.captured(5).trimmed();
+      spot->spotter = match.captured(6).trimmed();
+    }
+  spot->band = bandFromFrequencyKhz(spot->frequency);
+  spot->mode = modeFromComment(spot->comment);
+  return true;
+}
+
+QString DXClusterClient::bandFromFrequencyKhz(QString const& frequencyText)
+{
+  bool ok {false};
+  auto const khz = frequencyText.trimmed().toDouble(&ok);
+  if (!ok || khz <= 0.0)
+    {
+      return {};
+    }
+
+  if (khz >= 1800.0 && khz <= 2000.0) return QStringLiteral ("160M");
+  if (khz >= 3500.0 && khz <= 4000.0) return QStringLiteral ("80M");
+  if (khz >= 5300.0 && khz <= 5407.0) return QStringLiteral ("60M");
+  if (khz >= 7000.0 && khz <= 7300.0) return QStringLiteral ("40M");
+  if (khz >= 10100.0 && khz <= 10150.0) return QStringLiteral ("30M");
+  if (khz >= 14000.0 && khz <= 14350.0) return QStringLiteral ("20M");
+  if (khz >= 18068.0 && khz <= 18168.0) return QStringLiteral ("17M");
+  if (khz >= 21000.0 && khz <= 21450.0) return QStringLiteral ("15M");
+  if (khz >= 24890.0 && khz <= 24990.0) return QStringLiteral ("12M");
+  if (khz >= 28000.0 && khz <= 29700.0) return QStringLiteral ("10M");
+  if (khz >= 50000.0 && khz <= 54000.0) return QStringLiteral ("6M");
+  if (khz >= 70000.0 && khz <= 71000.0) return QStringLiteral ("4M");
+  if (khz >= 144000.0 && khz <= 148000.0) return QStringLiteral ("2M");
+  if (khz >= 420000.0 && khz <= 450000.0) return QStringLiteral ("70CM");
+  return {};
+}
+
+QString DXClusterClient::modeFromComment(QString const& comment)
+{
+  auto c = comment.simplified().toUpper();
+  if (c.contains("FT8")) return "FT8";
+  if (c.contains("FT4")) return "FT4";
+  if (c.contains("FT2")) return "FT2";
+  if (c.contains("Q65")) return "Q65";
+  if (c.contains("FST4")) return "FST4";
+  if (c.contains("JT65")) return "JT65";
+  if (c.contains("JT9")) return "JT9";
+  if (c.contains("MSK144") || c.contains(" MSK")) return "MSK144";
+  if (c.contains("RTTY")) return "RTTY";
+  if (c.contains("PSK")) return "PSK";
+  if (c.contains("CW")) return "CW";
+  if (c.contains("SSB") || c.contains("USB") || c.contains("LSB") || c.contains("PHONE")) return "SSB";
+  if (c.contains(" AM")) return "AM";
+  if (c.contains(" FM")) return "FM";
+  return "Other";
+}
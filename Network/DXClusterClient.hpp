@@ -0,0 +1,103 @@
+// -*- Mode: C++ -*-
+#ifndef DX_CLUSTER_CLIENT_HPP__
+#define DX_CLUSTER_CLIENT_HPP__
+
+#include <QObject>
+#include <QByteArray>
+#include <QDateTime>
+#include <QMetaType>
+#include <QString>
+#include <QVector>
+
+class QTcpSocket;
+class QTimer;
+
+struct DXClusterSpot
+{
+  QString spotter;
+  QString frequency;            // kHz as sent by the node
+  QString dxCall;
+  QString comment;
+  QDateTime time;               // UTC
+  QString lotw;
+  QString eqsl;
+  QString continent;
+  QString band;
+  QString country;
+  QString mode;
+};
+
+Q_DECLARE_METATYPE (DXClusterSpot);
+Q_DECLARE_METATYPE (QVector<DXClusterSpot>);
+
+//
+// DXClusterClient - persistent DX Spider telnet session
+//
+// Intended  to live on  its own thread,  nothing here blocks. Once
+// started it logs in, stays logged in and reconnects with back off if
+// the node drops the session. Spot lines, both "DX de" announcements
+// and show/dx replies, are parsed as they arrive and passed on in
+// batches of whatever each read delivered. Invoke the slots with
+// queued connections from other threads.
+//
+class DXClusterClient final
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit DXClusterClient(QObject * parent = nullptr);
+  ~DXClusterClient() override;
+
+  // (re)connect to host:port and log in as login
+  Q_SLOT void start(QString const& host, int port, QString const& login);
+  Q_SLOT void stop();
+
+  // ask the node for the latest count spots on band, sent as soon as
+  // the session is logged in
+  Q_SLOT void requestSpots(QString const& band, int count);
+
+  // leave the node alone for ms milliseconds, e.g. while another
+  // session logs in with the same call
+  Q_SLOT void pause(int ms);
+
+  Q_SIGNAL void spotsReceived(QVector<DXClusterSpot> const& spots);
+  Q_SIGNAL void statusChanged(QString const& status, bool error);
+
+  static QString bandFromFrequencyKhz(QString const& frequencyText);
+  static QString modeFromComment(QString const& comment);
+
+  // false if line is not a spot
+  static bool parseSpotLine(QString const& line, QDateTime const& nowUtc, DXClusterSpot * spot);
+
+private:
+  enum class State {Idle, Connecting, AwaitingLoginPrompt, LoggingIn, Online};
+
+  void connectToNode();
+  void scheduleReconnect(int ms);
+  void onConnected();
+  void onDisconnected();
+  void onReadyRead();
+  void onStateTimeout();
+  void sendLine(QString const& line);
+  void sendLogin();
+  void goOnline();
+  void sendPendingRequest();
+  void processLines();
+
+  QTcpSocket * socket_ {nullptr};
+  QTimer * stateTimer_ {nullptr};     // connect and login steps
+  QTimer * reconnectTimer_ {nullptr};
+  State state_ {State::Idle};
+  bool paused_ {false};
+  QString host_;
+  int port_ {0};
+  QString login_;
+  QString requestBand_;
+  int requestCount_ {0};
+  int backoffMs_;
+  QByteArray buffer_;                 // received text not yet parsed
+  QByteArray telnetPending_;          // incomplete telnet command
+};
+
+#endif
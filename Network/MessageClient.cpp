@@ -56,6 +56,7 @@ char const * message_type_name (NetworkMessage::Type type)
     case NetworkMessage::AnnotationInfo: return "AnnotationInfo";
     case NetworkMessage::SetupTx: return "SetupTx";
     case NetworkMessage::EnqueueDecode: return "EnqueueDecode";
+    case NetworkMessage::DecodeBatch: return "DecodeBatch";
     default: return "Unknown";
     }
 }
@@ -90,6 +91,12 @@ bool env_flag_enabled (char const * name, bool default_value = false)
   return default_value;
 }
 
+// DecodeBatch datagrams are kept below a typical Ethernet MTU
+int constexpr max_batch_datagram {1400};
+
+// decodes are held this long for a batch unless flushed sooner
+int constexpr batch_window_ms {250};
+
 bool constant_time_equals (QByteArray const& a, QByteArray const& b)
 {
   if (a.size () != b.size ())
@@ -124,8 +131,11 @@ public:
     , TTL_ {TTL}
     , schema_ {2}  // use 2 prior to negotiation not 1 which is broken
     , heartbeat_timer_ {new QTimer {this}}
+    , batch_timer_ {new QTimer {this}}
   {
     connect (heartbeat_timer_, &QTimer::timeout, this, &impl::heartbeat);
+    batch_timer_->setSingleShot (true);
+    connect (batch_timer_, &QTimer::timeout, this, &impl::flush_decodes);
     connect (this, &QIODevice::readyRead, this, &impl::pending_datagrams);
 
     auto key = qEnvironmentVariable ("WSJT_UDP_HMAC_KEY").trimmed ();
@@ -136,6 +146,13 @@ public:
       }
     require_hmac_ = !hmac_key_.isEmpty () && env_flag_enabled ("WSJT_UDP_HMAC_REQUIRED", false);
 
+    batch_decodes_ = env_flag_enabled ("WSJT_UDP_DECODE_BATCH", false);
+    auto fanout = qEnvironmentVariable ("WSJT_UDP_FANOUT").trimmed ();
+    if (!fanout.isEmpty ())
+      {
+        set_fanout_destinations (fanout.split (',', SkipEmptyParts));
+      }
+
     heartbeat_timer_->start (NetworkMessage::pulse * 1000);
   }
 
@@ -158,6 +175,8 @@ public:
   void pending_datagrams ();
   void heartbeat ();
   void closedown ();
+  void flush_decodes ();
+  void set_fanout_destinations (QStringList const&);
   StreamStatus check_status (QDataStream const&) const;
   void rebuild_trusted_senders ();
   bool is_trusted_sender (QHostAddress const&, port_type) const;
@@ -204,6 +223,34 @@ public:
   // hold messages sent before host lookup completes asynchronously
   QQueue<QByteArray> pending_messages_;
   QByteArray last_message_;
+
+  struct Destination
+  {
+    QHostAddress address_;
+    port_type port_;
+  };
+  std::vector<Destination> fanout_destinations_;
+
+  // decodes waiting to go out in a DecodeBatch message
+  struct BatchedDecode
+  {
+    // serialized size, see NetworkMessage.hpp
+    int wire_size () const {return 31 + mode_.size () + message_.size ();}
+
+    bool is_new_;
+    QTime time_;
+    qint32 snr_;
+    float delta_time_;
+    quint32 delta_frequency_;
+    QByteArray mode_;
+    QByteArray message_;
+    bool low_confidence_;
+    bool off_air_;
+  };
+  bool batch_decodes_ {false};
+  QTimer * batch_timer_;
+  std::vector<BatchedDecode> batched_decodes_;
+  quint32 batch_sequence_ {0};
 };
 
 #include "MessageClient.moc"
@@ -802,6 +849,7 @@ void MessageClient::impl::heartbeat ()
 
 void MessageClient::impl::closedown ()
 {
+   flush_decodes ();
    if (server_port_ && !server_.isNull ())
     {
       QByteArray message;
@@ -811,6 +859,73 @@ void MessageClient::impl::closedown ()
     }
 }
 
+void MessageClient::impl::flush_decodes ()
+{
+  batch_timer_->stop ();
+  if (batched_decodes_.empty ()) return;
+  if (server_port_ && !server_.isNull ())
+    {
+      // split into parts that fit in a datagram, a decode too big to
+      // share one is sent alone
+      int const header_size {28 + id_.toUtf8 ().size ()};
+      int const max_size = max_batch_datagram - (hmac_key_.isEmpty () ? 0 : udp_hmac_marker ().size () + 64);
+      std::vector<std::size_t> part_ends;
+      auto size = header_size;
+      for (std::size_t i = 0; i < batched_decodes_.size (); ++i)
+        {
+          auto const decode_size = batched_decodes_[i].wire_size ();
+          if (size > header_size && size + decode_size > max_size)
+            {
+              part_ends.push_back (i);
+              size = header_size;
+            }
+          size += decode_size;
+        }
+      part_ends.push_back (batched_decodes_.size ());
+
+      ++batch_sequence_;
+      std::size_t begin {0};
+      for (std::size_t part = 0; part < part_ends.size (); ++part)
+        {
+          QByteArray message;
+          NetworkMessage::Builder out {&message, NetworkMessage::DecodeBatch, id_, schema_};
+          out << batch_sequence_ << static_cast<quint16> (part) << static_cast<quint16> (part_ends.size ())
+              << static_cast<quint32> (part_ends[part] - begin);
+          for (auto i = begin; i < part_ends[part]; ++i)
+            {
+              auto const& decode = batched_decodes_[i];
+              out << decode.is_new_ << decode.time_ << decode.snr_ << decode.delta_time_
+                  << decode.delta_frequency_ << decode.mode_ << decode.message_
+                  << decode.low_confidence_ << decode.off_air_;
+            }
+          TRACE_UDP ("sequence:" << batch_sequence_ << "part:" << part << "of:" << part_ends.size () << "decodes:" << part_ends[part] - begin << "size:" << message.size ());
+          send_message (out, message);
+          begin = part_ends[part];
+        }
+    }
+  batched_decodes_.clear ();
+}
+
+void MessageClient::impl::set_fanout_destinations (QStringList const& destinations)
+{
+  fanout_destinations_.clear ();
+  for (auto const& destination : destinations)
+    {
+      // "address:port" with IPv6 addresses in brackets
+      auto const& spec = destination.trimmed ();
+      auto const colon = spec.lastIndexOf (':');
+      bool port_ok {false};
+      auto const port = colon > 0 ? spec.mid (colon + 1).toUShort (&port_ok) : 0u;
+      QHostAddress address {colon > 0 ? spec.left (colon).remove ('[').remove (']') : QString {}};
+      if (!port_ok || !port || address.isNull () || is_multicast_address (address) || is_broadcast_address (address))
+        {
+          Q_EMIT self_->error (QString {"Invalid UDP fan-out destination \"%1\", expected a unicast address:port"}.arg (spec));
+          continue;
+        }
+      fanout_destinations_.push_back ({address, static_cast<port_type> (port)});
+    }
+}
+
 void MessageClient::impl::send_message (QByteArray const& message, bool queue_if_pending, bool allow_duplicates)
 {
   if (server_port_)
@@ -840,6 +955,10 @@ void MessageClient::impl::send_message (QByteArray const& message, bool queue_if
                   // qDebug () << "Unicast UDP datagram sent to:" << server_ << "port:" << server_port_;
                   writeDatagram (wire_message, server_, server_port_);
                 }
+              for (auto const& destination : fanout_destinations_)
+                {
+                  writeDatagram (wire_message, destination.address_, destination.port_);
+                }
               last_message_ = message;
             }
         }
@@ -952,6 +1071,25 @@ void MessageClient::enable (bool flag)
   m_->enabled_ = flag;
 }
 
+void MessageClient::set_decode_batching (bool flag)
+{
+  if (!flag)
+    {
+      m_->flush_decodes ();
+    }
+  m_->batch_decodes_ = flag;
+}
+
+void MessageClient::flush_decodes ()
+{
+  m_->flush_decodes ();
+}
+
+void MessageClient::set_fanout_destinations (QStringList const& destinations)
+{
+  m_->set_fanout_destinations (destinations);
+}
+
 void MessageClient::status_update (Frequency f, QString const& mode, QString const& dx_call
                                    , QString const& report, QString const& tx_mode
                                    , bool tx_enabled, bool transmitting, bool decoding
@@ -993,6 +1131,16 @@ void MessageClient::decode (bool is_new, QTime time, qint32 snr, float delta_tim
 {
    if (m_->server_port_ && !m_->server_.isNull ())
     {
+      if (m_->batch_decodes_)
+        {
+          m_->batched_decodes_.push_back ({is_new, time, snr, delta_time, delta_frequency, mode.toUtf8 ()
+                , message_text.toUtf8 (), low_confidence, off_air});
+          if (!m_->batch_timer_->isActive ())
+            {
+              m_->batch_timer_->start (batch_window_ms);
+            }
+          return;
+        }
       QByteArray message;
       NetworkMessage::Builder out {&message, NetworkMessage::Decode, m_->id_, m_->schema_};
       out << is_new << time << snr << delta_time << delta_frequency << mode.toUtf8 ()
@@ -1043,6 +1191,7 @@ void MessageClient::WSPR_decode (bool is_new, QTime time, qint32 snr, float delt
 
 void MessageClient::decodes_cleared ()
 {
+   m_->flush_decodes ();        // held decodes go out before the Clear
    if (m_->server_port_ && !m_->server_.isNull ())
     {
       QByteArray message;
@@ -61,6 +61,17 @@ public:
   // enable incoming messages
   Q_SLOT void enable (bool);
 
+  // send decodes in DecodeBatch messages, collected for a short while
+  // or until flush_decodes() is called, rather than a Decode message
+  // each, only  enable this  if every  server  understands DecodeBatch
+  Q_SLOT void set_decode_batching (bool);
+  Q_SLOT void flush_decodes ();
+
+  // also send every outgoing message to these unicast "address:port"
+  // destinations, the datagram is built and signed once for all of
+  // them, incoming messages are not accepted from these destinations
+  Q_SLOT void set_fanout_destinations (QStringList const&);
+
   // outgoing messages
   Q_SLOT void status_update (Frequency, QString const& mode, QString const& dx_call, QString const& report
                              , QString const& tx_mode, bool tx_enabled, bool transmitting, bool decoding
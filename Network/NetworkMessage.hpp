@@ -529,6 +529,35 @@
  *      ffffffff will remove the sort-order value from the internal table.
  *      Callsigns without a sort order will be valued at zero for sorting purposes
  *      in the hound display.
+ *
+ *
+ * DecodeBatch    Out      19                     quint32
+ *                         Id (unique key)        utf8
+ *                         Sequence               quint32
+ *                         Part                   quint16
+ *                         Parts                  quint16
+ *                         Count                  quint32
+ *                         Count repeats of:
+ *                           New                  bool
+ *                           Time                 QTime
+ *                           snr                  qint32
+ *                           Delta time (S)       float (serialized as double)
+ *                           Delta frequency (Hz) quint32
+ *                           Mode                 utf8
+ *                           Message              utf8
+ *                           Low confidence       bool
+ *                           Off air              bool
+ *
+ *      When decode  batching is enabled  the client sends  this message
+ *      instead of one "Decode" message per decode. Each repeated group
+ *      has exactly  the fields and meaning  of a "Decode"  message. The
+ *      decodes of a  period are collected and sent  together, split over
+ *      as few datagrams as keep each one below a typical Ethernet MTU.
+ *      All  the parts  of a  batch share  a Sequence  number and  are
+ *      numbered from zero  to Parts-1, each part stands  alone so a lost
+ *      part only loses  the decodes it carries. Batching  is off by
+ *      default as servers that do not recognize this message would see
+ *      no decodes at all.
  */
 
 #include <QDataStream>
@@ -563,6 +592,7 @@ namespace NetworkMessage
       AnnotationInfo,
       SetupTx,                  //avt
       EnqueueDecode,            //avt
+      DecodeBatch,
       maximum_message_type_     // ONLY add new message types
                                 // immediately before here
     };
@@ -22,14 +22,15 @@
 #include <QDataStream>
 #include <QTimer>
 #include <QDir>
-#include <QMutex>
-#include <QMutexLocker>
+#include <QHash>
+#include <QVector>
 #if QT_VERSION >= QT_VERSION_CHECK(5, 15, 0)
 #include <QRandomGenerator>
 #endif
 
 #include "Logger.hpp"
 #include "Configuration.hpp"
+#include "models/Bands.hpp"
 #include "pimpl_impl.hpp"
 
 
@@ -49,12 +50,78 @@ namespace
   int MIN_PAYLOAD_LENGTH {508};
   int MAX_PAYLOAD_LENGTH {10000};
   int CACHE_TIMEOUT {300}; // default to 5 minutes for repeating spots
-  QMap<QString, time_t> spot_cache;
-  QMutex spot_cache_mutex;
-}
+  int CACHE_SLOT {30};     // spot cache timer wheel granularity in seconds
+
+  //
+  // Spot de-duplication cache
+  //
+  //  Remembers when a call was last spotted on a band and mode. Keys are
+  //  filed in a timer wheel of CACHE_SLOT second buckets spanning a bit
+  //  more than CACHE_TIMEOUT; as the wheel turns each bucket it passes
+  //  over  is emptied  of keys  that have  not been  seen  since, so
+  //  insertion and expiry are amortized O(1) per spot.
+  //
+  class SpotCache
+  {
+  public:
+    SpotCache ()
+      : buckets_ (CACHE_TIMEOUT / CACHE_SLOT + 2)
+      , current_slot_ {-1}
+    {
+    }
+
+    // true if key has been inserted within the last CACHE_TIMEOUT seconds
+    bool contains (QString const& key, qint64 now)
+    {
+      advance (now);
+      auto iter = last_seen_.constFind (key);
+      return iter != last_seen_.constEnd () && now - iter.value () <= CACHE_TIMEOUT;
+    }
+
+    void insert (QString const& key, qint64 now)
+    {
+      advance (now);
+      last_seen_[key] = now;
+      buckets_[slot (now) % buckets_.size ()].append (key);
+    }
+
+  private:
+    static qint64 slot (qint64 t) {return t / CACHE_SLOT;}
 
-static int added;
-static int removed;
+    void advance (qint64 now)
+    {
+      auto const target = slot (now);
+      if (current_slot_ < 0 || target - current_slot_ >= buckets_.size ())
+        {
+          // first use or idle for a whole turn of the wheel, everything
+          // held has expired
+          last_seen_.clear ();
+          for (auto& bucket : buckets_) bucket.clear ();
+          current_slot_ = target;
+          return;
+        }
+      while (current_slot_ < target) // a clock stepped backwards waits here
+        {
+          ++current_slot_;
+          auto& bucket = buckets_[current_slot_ % buckets_.size ()];
+          for (auto const& key : bucket)
+            {
+              // keys seen again since are also filed in a later bucket
+              auto iter = last_seen_.find (key);
+              if (iter != last_seen_.end () && slot (iter.value ()) <= current_slot_ - buckets_.size ())
+                {
+                  last_seen_.erase (iter);
+                }
+            }
+          bucket.clear ();
+        }
+    }
+
+    QVector<QVector<QString>> buckets_;
+    QHash<QString, qint64> last_seen_;
+    qint64 current_slot_;
+  };
+}
 
 class PSKReporter::impl final
   : public QObject
@@ -142,7 +209,9 @@ public:
         break;
 
       default:
+        statistics_.dropped += spots_.size ();
         spots_.clear ();
+        Q_EMIT self_->statisticsChanged ();
         Q_EMIT self_->errorOccurred (socket_->errorString ());
         break;
       }
@@ -265,6 +334,9 @@ public:
     QDateTime time_;
   };
   QQueue<Spot> spots_;
+  SpotCache spot_cache_;
+  Statistics statistics_;
+  int tx_spots_ {0};            // spots in tx_data_ and tx_residue_
   QTimer report_timer_;
   QTimer descriptor_timer_;
 };
@@ -542,6 +614,7 @@ void PSKReporter::impl::send_report (bool send_residue)
                                          spot.time_.toMSecsSinceEpoch () / 1000
 #endif
                                          );
+              ++tx_spots_;
             }
 
           auto len = payload_.size () + tx_data_.size ();
@@ -577,6 +650,10 @@ void PSKReporter::impl::send_report (bool send_residue)
 
               // Send data to PSK Reporter site
               socket_->write (payload_); // TODO: handle errors
+              // at most the last spot is held over as residue
+              auto held_over = tx_data_size < tx_data_.size () ? 1 : 0;
+              statistics_.sent += tx_spots_ - held_over;
+              tx_spots_ = held_over;
               LOG_LOG_LOCATION (logger_, debug, "sent spots");
               flush = false;    // break loop
               message.device ()->seek (0u);
@@ -590,6 +667,7 @@ void PSKReporter::impl::send_report (bool send_residue)
         }
       LOG_LOG_LOCATION (logger_, debug, "remaining spots: " << spots_.size ());
     }
+  Q_EMIT self_->statisticsChanged ();
 }
 
 PSKReporter::PSKReporter (Configuration const * config, QString const& program_info)
@@ -643,56 +721,38 @@ bool PSKReporter::addRemoteStation (QString const& call, QString const& grid, Ra
         {
            reconnect ();
         }
-      // remove any earlier spots of this call to reduce pskreporter load
-#ifdef DEBUGPSK
-      static std::fstream fs;
-      if (!fs.is_open()) fs.open("/temp/psk.log", std::fstream::in | std::fstream::out | std::fstream::app);
-#endif
-      added++;
-
-      QDateTime qdateNow = QDateTime::currentDateTime().toUTC();
-      QMutexLocker cache_lock {&spot_cache_mutex};
-      // we allow all spots through +/- 6 hours around an eclipse for the HamSCI group
-      if (!spot_cache.contains(call) || freq > 49000000 || eclipse_active(qdateNow)) // then it's a new spot
-      {
-        m_->spots_.enqueue ({call, grid, snr, freq, mode, QDateTime::currentDateTimeUtc ()});
-        spot_cache.insert(call, time(NULL));
-#ifdef DEBUGPSK
-        if (fs.is_open()) fs << "Adding   " << call << " freq=" << freq << " " << spot_cache[call] <<  " count=" << m_->spots_.count() << std::endl;
-#endif
-      }
-      else if (time(NULL) - spot_cache[call] > CACHE_TIMEOUT) // then the cache has expired  
-      {
-        m_->spots_.enqueue ({call, grid, snr, freq, mode, QDateTime::currentDateTimeUtc ()});
-#ifdef DEBUGPSK
-        if (fs.is_open()) fs << "Adding # " << call << spot_cache[call] << " count=" << m_->spots_.count() << std::endl;
+      auto now = QDateTime::currentDateTimeUtc ();
+#if QT_VERSION >= QT_VERSION_CHECK(5, 8, 0)
+      auto now_secs = now.toSecsSinceEpoch ();
+#else
+      auto now_secs = now.toMSecsSinceEpoch () / 1000;
 #endif
-        spot_cache[call] = time(NULL);
-      }
+      // suppress repeats of a call on the same band and mode to reduce
+      // pskreporter load, we allow all spots through above 6m and +/- 6
+      // hours around an eclipse for the HamSCI group
+      auto key = call + '|' + m_->config_->bands ()->find (freq) + '|' + mode;
+      if (freq > 49000000 || !m_->spot_cache_.contains (key, now_secs) || eclipse_active (now))
+        {
+          m_->spots_.enqueue ({call, grid, snr, freq, mode, now});
+          m_->spot_cache_.insert (key, now_secs);
+          ++m_->statistics_.queued;
+        }
       else
-      {
-        removed++;
-#ifdef DEBUGPSK
-        if (fs.is_open()) fs << "Removing " << call << " " << time(NULL) << " reduction=" << removed/(double)added*100 << "%" << std::endl;
-#endif
-      }
-      // remove cached items over 10 minutes old to save a little memory
-      QMapIterator<QString, time_t> i(spot_cache);
-      time_t tmptime = time(NULL);
-      QList<QString> expired;
-      while(i.hasNext()) {
-          i.next();
-          if (tmptime - i.value() > 600) expired.append (i.key ());
-      }
-      for (auto const& key : expired)
-      {
-        spot_cache.remove (key);
-      }
+        {
+          ++m_->statistics_.deduplicated;
+          LOG_LOG_LOCATION (m_->logger_, trace, "duplicate spot: " << key);
+        }
+      Q_EMIT statisticsChanged ();
       return true;
     }
   return false;
 }
 
+auto PSKReporter::statistics () const -> Statistics
+{
+  return m_->statistics_;
+}
+
 void PSKReporter::sendReport (bool last)
 {
   LOG_LOG_LOCATION (m_->logger_, trace, "last: " << last);
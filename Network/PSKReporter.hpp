@@ -32,11 +32,24 @@ public:
   //
   void sendReport (bool last = false);
 
+  //
+  // Spot counters since start up
+  //
+  struct Statistics
+  {
+    quint64 queued {0};         // accepted for upload
+    quint64 deduplicated {0};   // suppressed as repeats within the cache timeout
+    quint64 sent {0};           // written to the PSK Reporter socket
+    quint64 dropped {0};        // discarded after a socket error
+  };
+  Statistics statistics () const;
+
   //
   // True if current time falls withing a +/- window of a solar eclipse for HamSCI use
   bool eclipse_active(QDateTime now);
 
   Q_SIGNAL void errorOccurred (QString const& reason);
+  Q_SIGNAL void statisticsChanged ();
 
 private:
   class impl;
@@ -3,6 +3,7 @@
 
 #include <QDateTime>
 #include <QBuffer>
+#include <QFutureWatcher>
 #include <QHostInfo>
 #include <QImage>
 #include <QJsonArray>
@@ -16,11 +17,14 @@
 #include <QWebSocket>
 #include <QWebSocketServer>
 #include <QtMath>
+#include <QUrlQuery>
 #include <QUuid>
+#include <QtConcurrent/QtConcurrentRun>
 
 #include <algorithm>
 #include <limits>
 
+#include "Decoder/DecodeArchive.hpp"
 #include "PrecisionTime.hpp"
 #include "revision_utils.hpp"
 
@@ -3425,6 +3429,58 @@ void RemoteCommandServer::setRuntimeStateProvider(RuntimeStateProvider provider)
   runtimeProvider_ = provider;
 }
 
+void RemoteCommandServer::setDecodeArchive(DecodeArchive const& archive)
+{
+  decodeArchive_.reset(new DecodeArchive {archive});
+}
+
+QJsonObject RemoteCommandServer::queryDecodeArchive(DecodeArchive const& archive, QString const& path)
+{
+  // e.g. /api/v1/decodes?call=K1ABC&band=20m&days=30
+  QUrlQuery const params {path.section('?', 1)};
+  DecodeArchive::Query query;
+  query.call = params.queryItemValue(QStringLiteral("call"));
+  query.grid = params.queryItemValue(QStringLiteral("grid"));
+  query.band = params.queryItemValue(QStringLiteral("band"));
+  query.mode = params.queryItemValue(QStringLiteral("mode"));
+  query.to = QDateTime::fromString(params.queryItemValue(QStringLiteral("to")), Qt::ISODate);
+  query.from = QDateTime::fromString(params.queryItemValue(QStringLiteral("from")), Qt::ISODate);
+  bool daysOk {false};
+  auto const days = params.queryItemValue(QStringLiteral("days")).toInt(&daysOk);
+  if (!query.from.isValid() && daysOk && days > 0)
+    {
+      auto const to = query.to.isValid() ? query.to : QDateTime::currentDateTimeUtc();
+      query.from = to.addDays(-qMin(days, 3660));
+    }
+  bool limitOk {false};
+  auto const limit = params.queryItemValue(QStringLiteral("limit")).toInt(&limitOk);
+  query.limit = limitOk ? qBound(1, limit, 5000) : 500;
+
+  bool truncated {false};
+  QJsonArray decodes;
+  for (auto const& record : archive.query(query, &truncated))
+    {
+      decodes.append(QJsonObject {
+          {"time", record.time.toString(Qt::ISODate)},
+          {"band", record.band},
+          {"mode", record.mode},
+          {"dial_frequency_hz", static_cast<double>(record.dial_frequency)},
+          {"frequency_hz", static_cast<int>(record.frequency)},
+          {"snr", record.snr},
+          {"dt", qRound(record.dt * 10.f) / 10.},
+          {"call", record.call},
+          {"grid", record.grid},
+          {"type", DecodeArchive::type_name(record.type)},
+          {"message", record.message},
+        });
+    }
+  return QJsonObject {
+    {"decodes", decodes},
+    {"count", decodes.size()},
+    {"truncated", truncated},
+  };
+}
+
 void RemoteCommandServer::setGuardPreMs(int ms)
 {
   guardPreMs_ = qBound(50, ms, 1500);
@@ -4645,6 +4701,10 @@ void RemoteCommandServer::onHttpSocketReadyRead()
 
   auto & state = it.value();
   state.buffer.append(socket->readAll());
+  if (state.responding)
+    {
+      return;
+    }
 
   if (!state.headersParsed)
     {
@@ -4963,6 +5023,42 @@ void RemoteCommandServer::onHttpSocketReadyRead()
       return;
     }
 
+  if (state.method == QStringLiteral("GET") && route == QStringLiteral("/api/v1/decodes"))
+    {
+      if (!isHttpAuthorized(state))
+        {
+          sendHttpJson(socket, 401, QJsonObject {
+                        {"error", QStringLiteral("not_authorized")},
+                        {"requires_auth", isAuthRequired()},
+                      });
+        }
+      else if (!decodeArchive_)
+        {
+          sendHttpJson(socket, 404, QJsonObject {{"error", "no_decode_archive"}});
+        }
+      else
+        {
+          // a query may read months of segments, answer it when a
+          // worker thread has run it
+          state.responding = true;
+          auto * watcher = new QFutureWatcher<QJsonObject> {this};
+          QPointer<QTcpSocket> guarded_socket {socket};
+          connect(watcher, &QFutureWatcher<QJsonObject>::finished, this, [this, watcher, guarded_socket] {
+              if (guarded_socket)
+                {
+                  sendHttpJson(guarded_socket.data(), 200, watcher->result());
+                  guarded_socket->disconnectFromHost();
+                }
+              watcher->deleteLater();
+            });
+          watcher->setFuture(QtConcurrent::run(&RemoteCommandServer::queryDecodeArchive
+                                               , DecodeArchive {*decodeArchive_}, state.path));
+          return;
+        }
+      socket->disconnectFromHost();
+      return;
+    }
+
   if (route != QStringLiteral("/api/v1/commands"))
     {
       sendHttpJson(socket, 404, QJsonObject {{"error", "not_found"}});
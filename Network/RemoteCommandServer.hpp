@@ -16,11 +16,13 @@
 #include <QByteArray>
 
 #include <functional>
+#include <memory>
 
 class QWebSocket;
 class QWebSocketServer;
 class QTcpServer;
 class QTcpSocket;
+class DecodeArchive;
 
 class RemoteCommandServer : public QObject
 {
@@ -66,6 +68,8 @@ public:
   quint16 httpPort() const { return httpPort_; }
 
   void setRuntimeStateProvider(RuntimeStateProvider provider);
+  // serve GET /api/v1/decodes from archive
+  void setDecodeArchive(DecodeArchive const& archive);
   void setGuardPreMs(int ms);
   void setMaxCommandAgeMs(int ms);
   void setAuthUser(QString const& user);
@@ -131,6 +135,7 @@ private:
     QString method;
     QString path;
     QHash<QString, QString> headers;
+    bool responding {false};    // answer pending on a worker thread
   };
 
   RuntimeState runtimeState() const;
@@ -150,6 +155,7 @@ private:
   class QJsonObject makeRejectPayload(QString const& commandId, QString const& status, QString const& reason) const;
   void sendHttpJson(QTcpSocket * socket, int statusCode, class QJsonObject const& object);
   void sendHttpNoContent(QTcpSocket * socket, int statusCode, QByteArray const& extraHeaders = QByteArray {});
+  static class QJsonObject queryDecodeArchive(DecodeArchive const& archive, QString const& path);
   QString httpHeaderValue(HttpConnectionState const& state, QString const& key) const;
   QString httpAuthUser(HttpConnectionState const& state) const;
   QString httpBearerToken(HttpConnectionState const& state) const;
@@ -175,6 +181,7 @@ private:
   int maxRecentBandActivity_ {200};
 
   RuntimeStateProvider runtimeProvider_;
+  std::unique_ptr<DecodeArchive> decodeArchive_;
   int guardPreMs_ {300};
   int maxCommandAgeMs_ {7500};
   bool waterfallEnabled_ {false};
@@ -8,6 +8,8 @@
 
 #include <QTimer>
 #include <QFile>
+#include <QSaveFile>
+#include <QDateTime>
 #include <QRegularExpression>
 #include <QNetworkAccessManager>
 #include <QNetworkRequest>
@@ -22,6 +24,13 @@ namespace
   char const * const wsprNetUrl = "https://wsprnet.org/post/";
   //char const * const wsprNetUrl = "http://127.0.0.1:5000/post/";
 
+  int const default_max_in_flight {4};
+  int const min_backoff_ms {30 * 1000};
+  int const max_backoff_ms {15 * 60 * 1000};
+  int const max_backlog {20000};  // about a week of a busy band
+  int const save_delay_ms {1000};
+  qint64 const rate_window_ms {10 * 60 * 1000};
+
   //
   // tested with this python REST mock of WSPRNet.org
   //
@@ -65,10 +74,159 @@ with app.test_request_context ():
 WSPRNet::WSPRNet (QNetworkAccessManager * manager, QObject *parent)
   : QObject {parent}
   , network_manager_ {manager}
+  , url_ {wsprNetUrl}
+  , max_in_flight_ {default_max_in_flight}
   , spots_to_send_ {0}
+  , backoff_ms_ {min_backoff_ms}
+  , statistics_ {0, 0, 0, 0, 0, 0.}
+  , m_uploadType {0}
 {
+  bool ok;
+  auto concurrency = qEnvironmentVariableIntValue ("WSJT_WSPRNET_CONCURRENCY", &ok);
+  if (ok) set_max_concurrent (concurrency);
+  if (qEnvironmentVariableIsSet ("WSJT_WSPRNET_URL"))
+    {
+      url_ = QUrl {qEnvironmentVariable ("WSJT_WSPRNET_URL")};
+    }
+
   connect (network_manager_, &QNetworkAccessManager::finished, this, &WSPRNet::networkReply);
   connect (&upload_timer_, &QTimer::timeout, this, &WSPRNet::work);
+  retry_timer_.setSingleShot (true);
+  connect (&retry_timer_, &QTimer::timeout, this, [this] {
+      upload_timer_.start (200);
+    });
+  save_timer_.setSingleShot (true);
+  connect (&save_timer_, &QTimer::timeout, this, &WSPRNet::save_queue);
+}
+
+WSPRNet::~WSPRNet ()
+{
+  if (save_timer_.isActive ())
+    {
+      save_queue ();
+    }
+}
+
+void WSPRNet::set_url (QUrl const& url)
+{
+  url_ = url;
+}
+
+void WSPRNet::set_max_concurrent (int n)
+{
+  max_in_flight_ = qBound (1, n, 16);
+}
+
+void WSPRNet::set_queue_file (QString const& path)
+{
+  queue_file_ = path;
+  load_queue ();
+}
+
+auto WSPRNet::statistics () const -> Statistics
+{
+  return statistics_;
+}
+
+void WSPRNet::enqueue (SpotQueue::value_type const& spot)
+{
+  spot_queue_.enqueue (spot);
+  while (spot_queue_.size () > max_backlog)
+    {
+      spot_queue_.dequeue ();
+      ++statistics_.dropped;
+    }
+  queue_changed ();
+}
+
+void WSPRNet::queue_changed ()
+{
+  statistics_.backlog = spot_queue_.size () + in_flight_.size ();
+  auto const now = QDateTime::currentMSecsSinceEpoch ();
+  while (sent_times_.size () && sent_times_.head () < now - rate_window_ms)
+    {
+      sent_times_.dequeue ();
+    }
+  statistics_.per_minute = sent_times_.size () * 60000. / rate_window_ms;
+  if (queue_file_.size () && !save_timer_.isActive ())
+    {
+      save_timer_.start (save_delay_ms);
+    }
+  Q_EMIT statisticsChanged ();
+}
+
+void WSPRNet::retry_later ()
+{
+  upload_timer_.stop ();
+  if (!retry_timer_.isActive ())
+    {
+      retry_timer_.start (backoff_ms_);
+      Q_EMIT uploadStatus (QString {"Retrying in %1s, %2 spots queued"}
+                           .arg (backoff_ms_ / 1000).arg (spot_queue_.size () + in_flight_.size ()));
+      backoff_ms_ = qMin (2 * backoff_ms_, max_backoff_ms);
+    }
+}
+
+// The queue file holds one URL encoded spot per line, spots in flight
+// included as they are not acknowledged yet. Status only reports are
+// not kept, they mean nothing once the period has passed.
+void WSPRNet::load_queue ()
+{
+  QFile file {queue_file_};
+  if (!file.open (QIODevice::ReadOnly | QIODevice::Text))
+    {
+      return;
+    }
+  int loaded {0};
+  while (!file.atEnd ())
+    {
+      auto const line = QString::fromUtf8 (file.readLine ()).trimmed ();
+      if (!line.size ()) continue;
+      SpotQueue::value_type query {line};
+      if ("wspr" == query.queryItemValue ("function"))
+        {
+          enqueue (query);
+          ++loaded;
+        }
+    }
+  if (loaded)
+    {
+      qDebug () << "WSPRnet.org" << loaded << "spots left from previous session";
+      spots_to_send_ = spot_queue_.size ();
+      upload_timer_.start (200);
+    }
+}
+
+void WSPRNet::save_queue ()
+{
+  save_timer_.stop ();
+  if (!queue_file_.size ()) return;
+  if (!spot_queue_.size () && !in_flight_.size ())
+    {
+      QFile::remove (queue_file_);
+      return;
+    }
+  QSaveFile file {queue_file_};
+  if (!file.open (QIODevice::WriteOnly | QIODevice::Text))
+    {
+      qDebug () << "WSPRnet.org cannot write queue file:" << file.errorString ();
+      return;
+    }
+  auto write = [&file] (SpotQueue::value_type const& query) {
+    if ("wspr" == query.queryItemValue ("function"))
+      {
+        file.write (query.query (QUrl::FullyEncoded).toUtf8 () + '\n');
+      }
+  };
+  for (auto const& query : in_flight_)
+    {
+      write (query);
+    }
+  for (auto const& query : spot_queue_)
+    {
+      write (query);
+    }
+  file.commit ();
 }
 
 void WSPRNet::upload (QString const& call, QString const& grid, QString const& rfreq, QString const& tfreq,
@@ -92,7 +250,7 @@ void WSPRNet::upload (QString const& call, QString const& grid, QString const& r
       QFile wsprdOutFile (fileName);
       if (!wsprdOutFile.open (QIODevice::ReadOnly | QIODevice::Text) || !wsprdOutFile.size ())
         {
-          spot_queue_.enqueue (urlEncodeNoSpot ());
+          enqueue (urlEncodeNoSpot ());
           m_uploadType = 1;
         }
       else
@@ -107,7 +265,7 @@ void WSPRNet::upload (QString const& call, QString const& grid, QString const& r
                   float f = fabs (m_rfreq.toFloat() - query.queryItemValue ("tqrg", QUrl::FullyDecoded).toFloat());
                   if (f < 0.01)     // MHz
                     {
-                      spot_queue_.enqueue(urlEncodeSpot (query));
+                      enqueue (urlEncodeSpot (query));
                       m_uploadType = 2;
                     }
                 }
@@ -136,7 +294,7 @@ void WSPRNet::post (QString const& call, QString const& grid, QString const& rfr
     {
       if (!spot_queue_.size ())
         {
-          spot_queue_.enqueue (urlEncodeNoSpot ());
+          enqueue (urlEncodeNoSpot ());
           m_uploadType = 3;
         }
     }
@@ -165,7 +323,7 @@ void WSPRNet::post (QString const& call, QString const& grid, QString const& rfr
               query.addQueryItem ("drift", "0");
               query.addQueryItem ("tgrid", match.captured ("grid"));
               query.addQueryItem ("dbm", match.captured ("dBm"));
-              spot_queue_.enqueue (urlEncodeSpot (query));
+              enqueue (urlEncodeSpot (query));
               m_uploadType = 2;
             }
         }
@@ -175,41 +333,57 @@ void WSPRNet::post (QString const& call, QString const& grid, QString const& rfr
 void WSPRNet::networkReply (QNetworkReply * reply)
 {
   // check if request was ours
-  if (m_outstandingRequests.removeOne (reply))
+  auto in_flight = in_flight_.find (reply);
+  if (in_flight == in_flight_.end ())
+    {
+      return;
+    }
+  auto const spot = in_flight.value ();
+  in_flight_.erase (in_flight);
+
+  auto const status = reply->attribute (QNetworkRequest::HttpStatusCodeAttribute).toInt ();
+  if (QNetworkReply::NoError != reply->error ()
+      && (status < 400 || status >= 500 || 408 == status || 429 == status))
+    {
+      // network or server trouble, keep the spot and try again later
+      Q_EMIT uploadStatus (QString {"Error: %1"}.arg (reply->error ()));
+      spot_queue_.prepend (spot);
+      ++statistics_.retries;
+      retry_later ();
+    }
+  else
     {
-      if (QNetworkReply::NoError != reply->error ())
+      backoff_ms_ = min_backoff_ms;
+      QString serverResponse = reply->readAll ();
+      if (QNetworkReply::NoError != reply->error ()
+          || ("wspr" == spot.queryItemValue ("function")
+              && !wspr_spots_added_re.match (serverResponse).hasMatch ()))
         {
-          Q_EMIT uploadStatus (QString {"Error: %1"}.arg (reply->error ()));
-          // not clearing queue or halting queuing as it may be a
-          // transient one off request error
+          // the server does not want this spot, resending it will
+          // not change that
+          Q_EMIT uploadStatus (QString {"Upload Failed: %1"}.arg (serverResponse));
+          ++statistics_.rejected;
         }
       else
         {
-          QString serverResponse = reply->readAll ();
-          if (m_uploadType == 2)
-            {
-              if (!wspr_spots_added_re.match(serverResponse).hasMatch())
-                {
-                  Q_EMIT uploadStatus (QString {"Upload Failed: %1"}.arg (serverResponse));
-                  spot_queue_.clear ();
-                  upload_timer_.stop ();
-                }
-            }
+          ++statistics_.sent;
+          sent_times_.enqueue (QDateTime::currentMSecsSinceEpoch ());
+        }
 
-          if (!spot_queue_.size ())
-            {
-              Q_EMIT uploadStatus("done");
-              QFile f {m_file};
-              if (f.exists ()) f.remove ();
-              upload_timer_.stop ();
-            }
+      if (!spot_queue_.size () && !in_flight_.size ())
+        {
+          Q_EMIT uploadStatus("done");
+          QFile f {m_file};
+          if (f.exists ()) f.remove ();
+          upload_timer_.stop ();
         }
+    }
+  queue_changed ();
 
-      qDebug () << QString {"WSPRnet.org %1 outstanding requests"}.arg (m_outstandingRequests.size ());
+  qDebug () << QString {"WSPRnet.org %1 outstanding requests"}.arg (in_flight_.size ());
 
-      // delete request object instance on return to the event loop otherwise it is leaked
-      reply->deleteLater ();
-    }
+  // delete request object instance on return to the event loop otherwise it is leaked
+  reply->deleteLater ();
 }
 
 bool WSPRNet::decodeLine (QString const& line, SpotQueue::value_type& query) const
@@ -316,7 +490,7 @@ auto WSPRNet::urlEncodeSpot (SpotQueue::value_type& query) const -> SpotQueue::v
 
 void WSPRNet::work()
 {
-  if (spots_to_send_ && spot_queue_.size ())
+  if (spot_queue_.size () && !retry_timer_.isActive ())
     {
 #if QT_VERSION < QT_VERSION_CHECK (5, 15, 0)
       if (QNetworkAccessManager::Accessible != network_manager_->networkAccessible ()) {
@@ -324,11 +498,16 @@ void WSPRNet::work()
         network_manager_->setNetworkAccessible (QNetworkAccessManager::Accessible);
       }
 #endif
-      QNetworkRequest request (QUrl {wsprNetUrl});
+      QNetworkRequest request (url_);
       request.setHeader (QNetworkRequest::ContentTypeHeader, "application/x-www-form-urlencoded");
-      auto const& spot = spot_queue_.dequeue ();
-      m_outstandingRequests << network_manager_->post (request, spot.query (QUrl::FullyEncoded).toUtf8 ());
+      while (spot_queue_.size () && in_flight_.size () < max_in_flight_)
+        {
+          auto const& spot = spot_queue_.dequeue ();
+          in_flight_.insert (network_manager_->post (request, spot.query (QUrl::FullyEncoded).toUtf8 ()), spot);
+        }
+      spots_to_send_ = qMax (spots_to_send_, spot_queue_.size () + in_flight_.size ());
       Q_EMIT uploadStatus(QString {"Uploading Spot %1/%2"}.arg (spots_to_send_ - spot_queue_.size()).arg (spots_to_send_));
+      queue_changed ();
     }
   else
     {
@@ -336,9 +515,9 @@ void WSPRNet::work()
     }
 }
 
+// abandon the posts in flight, their spots are queued again
 void WSPRNet::abortOutstandingRequests () {
-  spot_queue_.clear ();
-  for (auto& request : m_outstandingRequests) {
+  for (auto const& request : in_flight_.keys ()) {
     request->abort ();
   }
 }
@@ -4,13 +4,27 @@
 #include <QObject>
 #include <QTimer>
 #include <QString>
-#include <QList>
+#include <QHash>
+#include <QUrl>
 #include <QUrlQuery>
 #include <QQueue>
 
 class QNetworkAccessManager;
 class QNetworkReply;
 
+//
+// WSPRNet - spot uploads to wsprnet.org
+//
+// Spots are posted concurrently, up to a limit, and a spot stays queued
+// until the server has acknowledged it. A spot whose post fails is
+// queued again and sending backs off until the network comes back. If
+// a queue file is set the backlog is kept there, so spots survive
+// restarts as well as outages.
+//
+// The concurrency limit defaults to 4 and may be set with the
+// WSJT_WSPRNET_CONCURRENCY environment variable, WSJT_WSPRNET_URL
+// overrides the server URL.
+//
 class WSPRNet : public QObject
 {
   Q_OBJECT
@@ -18,7 +32,25 @@ class WSPRNet : public QObject
   using SpotQueue = QQueue<QUrlQuery>;
 
 public:
+  struct Statistics
+  {
+    int backlog;                // spots queued or in flight
+    quint64 sent;
+    quint64 rejected;           // refused by the server, not retried
+    quint64 retries;
+    quint64 dropped;            // backlog overflow
+    double per_minute;          // sent over the last ten minutes
+  };
+
   explicit WSPRNet (QNetworkAccessManager *, QObject *parent = nullptr);
+  ~WSPRNet ();
+
+  void set_url (QUrl const&);
+  void set_max_concurrent (int);
+  // loads any spots left from a previous run and starts sending them
+  void set_queue_file (QString const& path);
+  Statistics statistics () const;
+
   void upload (QString const& call, QString const& grid, QString const& rfreq, QString const& tfreq,
                QString const& mode, float TR_peirod, QString const& tpct, QString const& dbm,
                QString const& version, QString const& fileName);
@@ -27,6 +59,7 @@ public:
              QString const& version, QString const& decode_text = QString {});
 signals:
   void uploadStatus (QString);
+  void statisticsChanged ();
 
 public slots:
   void networkReply (QNetworkReply *);
@@ -38,9 +71,16 @@ private:
   SpotQueue::value_type urlEncodeNoSpot () const;
   SpotQueue::value_type urlEncodeSpot (SpotQueue::value_type& spot) const;
   QString encode_mode () const;
+  void enqueue (SpotQueue::value_type const&);
+  void retry_later ();
+  void queue_changed ();
+  void load_queue ();
+  void save_queue ();
 
   QNetworkAccessManager * network_manager_;
-  QList<QNetworkReply *> m_outstandingRequests;
+  QUrl url_;
+  int max_in_flight_;
+  QHash<QNetworkReply *, SpotQueue::value_type> in_flight_;
   QString m_call;
   QString m_grid;;
   QString m_rfreq;
@@ -54,6 +94,12 @@ private:
   int spots_to_send_;
   SpotQueue spot_queue_;
   QTimer upload_timer_;
+  QTimer retry_timer_;
+  int backoff_ms_;
+  QString queue_file_;
+  QTimer save_timer_;
+  Statistics statistics_;
+  QQueue<qint64> sent_times_;   // for the rate, ms since epoch
   int m_uploadType;
 };
 
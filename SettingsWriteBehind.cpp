@@ -0,0 +1,48 @@
+#include "SettingsWriteBehind.hpp"
+
+#include <QSettings>
+#include <QEvent>
+
+#include "moc_SettingsWriteBehind.cpp"
+
+SettingsWriteBehind::SettingsWriteBehind (QSettings * settings, int delay_ms, QObject * parent)
+  : QObject {parent}
+  , settings_ {settings}
+  , pending_ {false}
+  , writes_ {0}
+{
+  timer_.setSingleShot (true);
+  timer_.setInterval (delay_ms);
+  connect (&timer_, &QTimer::timeout, this, &SettingsWriteBehind::flush);
+  settings_->installEventFilter (this);
+}
+
+SettingsWriteBehind::~SettingsWriteBehind ()
+{
+  settings_->removeEventFilter (this);
+  flush ();
+}
+
+void SettingsWriteBehind::flush ()
+{
+  timer_.stop ();
+  if (pending_)
+    {
+      settings_->sync ();
+      pending_ = false;
+      ++writes_;
+    }
+}
+
+bool SettingsWriteBehind::eventFilter (QObject * object, QEvent * event)
+{
+  if (object == settings_ && QEvent::UpdateRequest == event->type ())
+    {
+      // QSettings posts this once after the first change and no more
+      // until it is synced, so the delay runs from the first change
+      pending_ = true;
+      if (!timer_.isActive ()) timer_.start ();
+      return true;
+    }
+  return QObject::eventFilter (object, event);
+}
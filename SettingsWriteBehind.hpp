@@ -0,0 +1,50 @@
+#ifndef SETTINGS_WRITE_BEHIND_HPP_
+#define SETTINGS_WRITE_BEHIND_HPP_
+
+#include <QObject>
+#include <QTimer>
+
+class QSettings;
+class QEvent;
+
+//
+// Class SettingsWriteBehind
+//
+//	Coalesces the writes of a QSettings object.
+//
+//	QSettings holds its values in memory but writes the whole file
+//	back on the next pass of the event loop after any change. With
+//	all the alternative configurations in one INI file that is a
+//	lot of I/O for each burst of setValue() calls. This object
+//	intercepts those update requests and writes once, delay_ms
+//	after the first unsaved change, when flush() is called or
+//	when it is destroyed.
+//
+class SettingsWriteBehind final
+  : public QObject
+{
+  Q_OBJECT
+
+public:
+  explicit SettingsWriteBehind (QSettings *, int delay_ms = 2000, QObject * parent = nullptr);
+  SettingsWriteBehind (SettingsWriteBehind const&) = delete;
+  SettingsWriteBehind& operator = (SettingsWriteBehind const&) = delete;
+  ~SettingsWriteBehind ();
+
+  // write any unsaved changes now
+  void flush ();
+
+  bool pending () const {return pending_;}
+  int writes () const {return writes_;} // times the file was written
+
+protected:
+  bool eventFilter (QObject *, QEvent *) override;
+
+private:
+  QSettings * settings_;
+  QTimer timer_;
+  bool pending_;
+  int writes_;
+};
+
+#endif
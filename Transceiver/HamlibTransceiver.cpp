@@ -146,6 +146,7 @@ public:
     , freq_query_works_ {true}
     , mode_query_works_ {true}
     , split_query_works_ {true}
+    , vfo_info_works_ {false}
     , tickle_hamlib_ {false}
     , get_vfo_works_ {true}
     , set_vfo_works_ {true}
@@ -169,6 +170,7 @@ public:
     , freq_query_works_ {rig_ && rig_get_function_ptr (model_, RIG_FUNCTION_GET_FREQ)}
     , mode_query_works_ {rig_ && rig_get_function_ptr (model_, RIG_FUNCTION_GET_MODE)}
     , split_query_works_ {rig_ && rig_get_function_ptr (model_, RIG_FUNCTION_GET_SPLIT_VFO)}
+    , vfo_info_works_ {HAVE_HAMLIB_VFO_INFO && RIG_MODEL_NETRIGCTL == model_}
     , tickle_hamlib_ {false}
     , get_vfo_works_ {true}
     , set_vfo_works_ {true}
@@ -211,6 +213,8 @@ public:
   bool freq_query_works_;
   bool mode_query_works_;
   bool split_query_works_;
+  bool vfo_info_works_;         // frequency, mode and split in one
+                                // round trip (rigctld)
   bool tickle_hamlib_;          // Hamlib requires a
                                 // rig_set_split_vfo() call to
                                 // establish the Tx VFO
@@ -662,6 +666,7 @@ int HamlibTransceiver::do_start ()
   m_->freq_query_works_ = rig_get_function_ptr (m_->model_, RIG_FUNCTION_GET_FREQ);
   m_->mode_query_works_ = rig_get_function_ptr (m_->model_, RIG_FUNCTION_GET_MODE);
   m_->split_query_works_ = rig_get_function_ptr (m_->model_, RIG_FUNCTION_GET_SPLIT_VFO);
+  m_->vfo_info_works_ = HAVE_HAMLIB_VFO_INFO && RIG_MODEL_NETRIGCTL == m_->model_;
   m_->tickle_hamlib_ = false;
   m_->get_vfo_works_ = true;
   m_->set_vfo_works_ = true;
@@ -1143,7 +1148,45 @@ void HamlibTransceiver::do_poll ()
       m_->reversed_ = RIG_VFO_B == v;
     }
 
-  if ((WSJT_RIG_NONE_CAN_SPLIT || !m_->is_dummy_)
+  // batch the frequency, mode and split queries into one request
+  // where the back end supports it, this matters when the CAT port is
+  // shared with other applications through rigctld
+  bool batched {false};
+#if HAVE_HAMLIB_VFO_INFO
+  if (m_->vfo_info_works_ && (!state ().ptt () || !state ().split ()))
+    {
+      int satmode {0};
+      auto rc = rig_get_vfo_info (m_->rig_.data (), RIG_VFO_CURR, &f, &m, &w, &s, &satmode);
+      if (RIG_OK == rc)
+        {
+          CAT_TRACE ("rig_get_vfo_info frequency=" << Radio::frequency (f) << " mode=" << rig_strrmode (m) << " split=" << s);
+          // only believe what the individual queries would have, on
+          // rigs that cannot report split we keep the state we set
+          if ((WSJT_RIG_NONE_CAN_SPLIT || !m_->is_dummy_)
+              && rig_get_function_ptr (m_->model_, RIG_FUNCTION_GET_SPLIT_VFO) && m_->split_query_works_)
+            {
+              update_split (RIG_SPLIT_ON == s);
+            }
+          if (m_->freq_query_works_)
+            {
+              f = std::round (f);
+              update_rx_frequency (f);
+            }
+          if (m_->mode_query_works_)
+            {
+              update_mode (m_->map_mode (m));
+            }
+          batched = true;
+        }
+      else
+        {
+          CAT_TRACE ("rig_get_vfo_info failed with rc: " << rc << " using individual queries");
+          m_->vfo_info_works_ = false;
+        }
+    }
+#endif
+
+  if (!batched && (WSJT_RIG_NONE_CAN_SPLIT || !m_->is_dummy_)
       && rig_get_function_ptr (m_->model_, RIG_FUNCTION_GET_SPLIT_VFO) && m_->split_query_works_)
     {
       vfo_t v {RIG_VFO_NONE};		// so we can tell if it doesn't get updated :(
@@ -1175,7 +1218,7 @@ void HamlibTransceiver::do_poll ()
   if (m_->freq_query_works_)
     {
       // only read if possible and when receiving or simplex
-      if (!state ().ptt () || !state ().split ())
+      if (!batched && (!state ().ptt () || !state ().split ()))
         {
           m_->error_check (rig_get_freq (m_->rig_.data (), RIG_VFO_CURR, &f), tr ("getting current VFO frequency"));
           f = std::round (f);
@@ -1206,7 +1249,7 @@ void HamlibTransceiver::do_poll ()
     }
 
   // only read when receiving or simplex if direct VFO addressing unavailable
-  if ((!state ().ptt () || !state ().split ())
+  if (!batched && (!state ().ptt () || !state ().split ())
       && m_->mode_query_works_)
     {
       // We have to ignore errors here because Yaesu FTdx... rigs can
@@ -1,10 +1,12 @@
 #include "PollingTransceiver.hpp"
 
 #include <exception>
+#include <algorithm>
 
 #include <QObject>
 #include <QString>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QThread>
 #include <QDir>
 #include <QStandardPaths>
@@ -14,49 +16,114 @@ namespace
 {
   unsigned const polls_to_stabilize {3};
   unsigned const transient_poll_failures_to_tolerate {3};
+
+  // Adaptive poll schedule. The fast rate is also what the PWR and
+  // SWR display needs while transmitting.
+  int const fast_poll_interval {500}; // milliseconds
+  unsigned const fast_polls_after_change {6};
+  int const poll_backoff_percent {150};
+  unsigned const polls_per_latency_report {240};
 }
 
 PollingTransceiver::PollingTransceiver (logger_type * logger, int poll_interval, QObject * parent)
   : TransceiverBase {logger, parent}
-  , interval_ {poll_interval * 1000}
+  , interval_ {(poll_interval & 0x7fff) * 1000} // high bits are option flags
+  , current_interval_ {fast_poll_interval}
+  , fast_polls_ {0}
   , poll_timer_ {nullptr}
+  , latency_ {0, 0, 0}
   , retries_ {0}
   , poll_failures_ {0}
 {
+  interval_ = std::max (interval_, fast_poll_interval);
 }
 
 void PollingTransceiver::start_timer ()
 {
-  if (interval_)
+  if (!poll_timer_)
     {
-      if (!poll_timer_)
-        {
-          poll_timer_ = new QTimer {this}; // pass ownership to
-                                           // QObject which handles
-                                           // destruction for us
+      poll_timer_ = new QTimer {this}; // pass ownership to
+                                       // QObject which handles
+                                       // destruction for us
+
+      connect (poll_timer_, &QTimer::timeout, this,
+               &PollingTransceiver::handle_timeout);
+    }
+  poll_timer_->start (current_interval_);
+}
 
-          connect (poll_timer_, &QTimer::timeout, this,
-                   &PollingTransceiver::handle_timeout);
+void PollingTransceiver::stop_timer ()
+{
+  if (poll_timer_)
+    {
+      poll_timer_->stop ();
+    }
+}
+
+void PollingTransceiver::tighten ()
+{
+  fast_polls_ = fast_polls_after_change;
+  if (current_interval_ > fast_poll_interval)
+    {
+      current_interval_ = fast_poll_interval;
+      if (poll_timer_ && poll_timer_->isActive ()
+          && poll_timer_->remainingTime () > fast_poll_interval)
+        {
+          poll_timer_->start (current_interval_);
         }
-      poll_timer_->start (interval_);
+    }
+}
+
+void PollingTransceiver::schedule_next_poll (bool changed)
+{
+  if (changed || retries_ || state ().ptt ())
+    {
+      // stay at the fast rate while something is happening
+      fast_polls_ = changed ? fast_polls_after_change : std::max (fast_polls_, 1u);
+    }
+  if (fast_polls_)
+    {
+      --fast_polls_;
+      current_interval_ = fast_poll_interval;
     }
   else
     {
-      stop_timer ();
+      current_interval_ = std::min (interval_, current_interval_ * poll_backoff_percent / 100);
+    }
+  if (poll_timer_ && poll_timer_->isActive ())
+    {
+      poll_timer_->start (current_interval_);
     }
 }
 
-void PollingTransceiver::stop_timer ()
+void PollingTransceiver::poll_now ()
 {
-  if (poll_timer_)
+  tighten ();
+  if (poll_timer_ && poll_timer_->isActive ())
     {
-      poll_timer_->stop ();
+      poll_timer_->start (0);
+    }
+}
+
+void PollingTransceiver::record_poll_latency (qint64 elapsed_ns)
+{
+  ++latency_.count;
+  latency_.total_ns += elapsed_ns;
+  latency_.max_ns = std::max (latency_.max_ns, elapsed_ns);
+  if (latency_.count >= polls_per_latency_report)
+    {
+      CAT_DEBUG (metaObject ()->className () << " poll latency: polls=" << latency_.count
+                 << " mean=" << latency_.total_ns / latency_.count / 1000 << "us"
+                 << " max=" << latency_.max_ns / 1000 << "us"
+                 << " interval=" << current_interval_ << "ms");
+      latency_ = {0, 0, 0};
     }
 }
 
 void PollingTransceiver::do_post_start ()
 {
-  interval_ = 500;  // needed for displaying PWR and SWR
+  current_interval_ = fast_poll_interval;
+  fast_polls_ = fast_polls_after_change;
   start_timer ();
   if (!next_state_.online ())
     {
@@ -87,6 +154,7 @@ void PollingTransceiver::do_post_frequency (Frequency f, MODE m)
           next_state_.mode (m);
         }
       retries_ = polls_to_stabilize;
+      tighten ();
     }
 }
 
@@ -99,6 +167,7 @@ void PollingTransceiver::do_post_tx_frequency (Frequency f, MODE)
       next_state_.tx_frequency (f);
       next_state_.split (f); // setting non-zero TX frequency means split
       retries_ = polls_to_stabilize;
+      tighten ();
     }
 }
 
@@ -110,6 +179,7 @@ void PollingTransceiver::do_post_mode (MODE m)
       // update expected state with new mode and set poll count
       next_state_.mode (m);
       retries_ = polls_to_stabilize;
+      tighten ();
     }
 }
 
@@ -121,6 +191,7 @@ void PollingTransceiver::do_post_ptt (bool p)
       next_state_.ptt (p);
       retries_ = polls_to_stabilize;
       //retries_ = 0;             // fast feedback on PTT
+      tighten ();
     }
   else
     {
@@ -142,13 +213,18 @@ void PollingTransceiver::handle_timeout ()
 {
   QString message;
   bool force_signal {false};
+  bool changed {false};
 
   // we must catch all exceptions here since we are called by Qt and
   // inform our parent of the failure via the offline() message
   try
     {
+      QElapsedTimer round_trip;
+      round_trip.start ();
       do_poll ();              // tell sub-classes to update our state
+      record_poll_latency (round_trip.nsecsElapsed ());
       poll_failures_ = 0;      // poll path recovered/healthy
+      changed = state () != last_signalled_state_;
 
       // Signal new state if it what we expected or, hasn't become
       // what we expected after polls_to_stabilize polls. Unsolicited
@@ -190,6 +266,7 @@ void PollingTransceiver::handle_timeout ()
       CAT_WARNING ("poll failed: unexpected exception");
       message = tr ("Unexpected rig error");
     }
+  schedule_next_poll (changed || !message.isEmpty ());
   if (!message.isEmpty ())
     {
       // CAT backends can occasionally miss one poll (USB/serial jitter,
@@ -51,15 +51,33 @@ protected:
   void do_post_ptt (bool = true) override final;
   bool do_pre_update () override final;
 
+  // Sub-classes whose rig notifies changes call this to have the new
+  // state polled as soon as possible, bursts of calls coalesce into a
+  // single poll.
+  void poll_now ();
+
 private:
   void start_timer ();
   void stop_timer ();
+  void tighten ();
+  void schedule_next_poll (bool changed);
+  void record_poll_latency (qint64 elapsed_ns);
 
   Q_SLOT void handle_timeout ();
 
-  int interval_;    // polling interval in milliseconds
+  int interval_;    // idle (maximum) polling interval in milliseconds
+  int current_interval_;  // interval to the next poll in milliseconds
+  unsigned fast_polls_; // polls left at the fast rate
   QTimer * poll_timer_;
 
+  // poll round trip statistics, logged periodically
+  struct
+  {
+    unsigned count;
+    qint64 total_ns;
+    qint64 max_ns;
+  } latency_;
+
   // keep a record of the last state signalled so we can elide
   // duplicate updates
   Transceiver::TransceiverState last_signalled_state_;
@@ -24,6 +24,7 @@
 #include <QDebug>
 #include <QDateTime>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QReadLocker>
 
 namespace
@@ -302,6 +303,8 @@ namespace
   }
 }
 
+static constexpr quint32 AudioHeaderSize = 16u*sizeof(quint32);
+
 class TciSocketWorker final : public QObject
 {
   Q_OBJECT
@@ -311,6 +314,19 @@ public:
   {
   }
 
+  // Receive audio for the selected receiver is parsed here, on the
+  // socket thread, straight into ring rather than being queued to the
+  // transceiver thread frame by frame. audio_available() is signalled
+  // once per batch, when the consumer has drained the previous one.
+  void attachAudioRing (TciAudioRing * ring, TciAudioStats * stats,
+                        std::atomic<int> const * receiver, std::atomic<bool> * drain_pending)
+  {
+    audio_ring_ = ring;
+    audio_stats_ = stats;
+    audio_receiver_ = receiver;
+    audio_drain_pending_ = drain_pending;
+  }
+
 public slots:
   void openSocket (QUrl const& url)
   {
@@ -321,7 +337,7 @@ public slots:
         connect (socket_, &QWebSocket::connected, this, &TciSocketWorker::connected);
         connect (socket_, &QWebSocket::disconnected, this, &TciSocketWorker::disconnected);
         connect (socket_, &QWebSocket::textMessageReceived, this, &TciSocketWorker::textFrame);
-        connect (socket_, &QWebSocket::binaryMessageReceived, this, &TciSocketWorker::binaryFrame);
+        connect (socket_, &QWebSocket::binaryMessageReceived, this, &TciSocketWorker::onBinaryMessage);
         connect (socket_, QOverload<QAbstractSocket::SocketError>::of (&QWebSocket::error),
                  this, [this] (QAbstractSocket::SocketError err) {
                    Q_EMIT socketError (static_cast<int> (err), socket_->errorString ());
@@ -354,21 +370,95 @@ public slots:
       }
   }
 
+  void onBinaryMessage (QByteArray const& data)
+  {
+    if (!divert_audio (data))
+      {
+        Q_EMIT binaryFrame (data);
+      }
+  }
+
 signals:
   void connected ();
   void disconnected ();
   void textFrame (QString const& text);
   void binaryFrame (QByteArray const& data);
   void socketError (int err, QString const& message);
+  void audioAvailable ();
 
 private:
+  bool divert_audio (QByteArray const& data)
+  {
+    if (!audio_ring_ || data.size () < static_cast<int> (AudioHeaderSize))
+      {
+        return false;
+      }
+    auto const * stream = reinterpret_cast<Data_Stream const *> (data.constData ());
+    auto const receiver = audio_receiver_->load (std::memory_order_relaxed);
+    if (stream->type != RxAudioStream || receiver < 0
+        || stream->receiver != static_cast<quint32> (receiver))
+      {
+        return false;
+      }
+
+    ++audio_stats_->frames;
+    update_jitter (stream);
+    if (!checked_payload_size (stream->length, data.size () - static_cast<int> (AudioHeaderSize), nullptr)
+        || stream->length % 2 // stereo frames only
+        || !audio_ring_->write (stream->data, stream->length))
+      {
+        ++audio_stats_->frames_lost;
+        return true;
+      }
+    if (!audio_drain_pending_->exchange (true))
+      {
+        Q_EMIT audioAvailable ();
+      }
+    return true;
+  }
+
+  // Smoothed deviation of frame arrival intervals from the frame
+  // duration, as RFC 3550 does for RTP.
+  void update_jitter (Data_Stream const * stream)
+  {
+    auto const now_us = arrival_clock_.isValid () ? arrival_clock_.nsecsElapsed () / 1000 : 0;
+    if (!arrival_clock_.isValid ())
+      {
+        arrival_clock_.start ();
+      }
+    if (last_arrival_us_ >= 0 && stream->sampleRate)
+      {
+        qint64 const expected_us = 1000000LL * (stream->length / 2) / stream->sampleRate;
+        qint64 const interval_us = now_us - last_arrival_us_;
+        if (interval_us > 2 * expected_us)
+          {
+            ++audio_stats_->late_frames;
+          }
+        qint64 const deviation_us = qAbs (interval_us - expected_us);
+        jitter_us_ += (deviation_us - jitter_us_) / 16;
+        audio_stats_->jitter_us = static_cast<quint32> (jitter_us_);
+        if (deviation_us > static_cast<qint64> (audio_stats_->max_jitter_us.load ()))
+          {
+            audio_stats_->max_jitter_us = static_cast<quint32> (deviation_us);
+          }
+      }
+    last_arrival_us_ = now_us;
+  }
+
   QWebSocket * socket_ {nullptr};
+  TciAudioRing * audio_ring_ {nullptr};
+  TciAudioStats * audio_stats_ {nullptr};
+  std::atomic<int> const * audio_receiver_ {nullptr};
+  std::atomic<bool> * audio_drain_pending_ {nullptr};
+  QElapsedTimer arrival_clock_;
+  qint64 last_arrival_us_ {-1};
+  qint64 jitter_us_ {0};
 };
 
 extern "C" {
   void   fil4_(qint16*, qint32*, qint16*, qint32*, short int*);
 }
-extern dec_data dec_data;
+extern dec_data_t * dec_data;
 
 extern float gran();		// Noise generator (for tests only)
 
@@ -388,7 +478,6 @@ void TCITransceiver::register_transceivers (logger_type *, TransceiverFactory::T
   (*registry)[TCI_transceiver_2_name] = TransceiverFactory::Capabilities {id2, TransceiverFactory::Capabilities::tci, true};
 }
 
-static constexpr quint32 AudioHeaderSize = 16u*sizeof(quint32);
 
 TCITransceiver::TCITransceiver (logger_type * logger, std::unique_ptr<TransceiverBase> wrapped,QString const& rignr,
                                QString const& address, bool use_for_ptt,
@@ -539,6 +628,7 @@ void TCITransceiver::ensure_socket_worker ()
   socket_thread_->setObjectName (QStringLiteral ("TCIWebSocketThread"));
   auto * worker = new TciSocketWorker {};
   socket_worker_ = worker;
+  worker->attachAudioRing (&audio_ring_, &audio_stats_, &audio_receiver_, &audio_drain_pending_);
   worker->moveToThread (socket_thread_);
   connect (socket_thread_, &QThread::finished, worker, &QObject::deleteLater);
 
@@ -551,6 +641,7 @@ void TCITransceiver::ensure_socket_worker ()
   connect (worker, &TciSocketWorker::disconnected, this, &TCITransceiver::onDisconnected, Qt::QueuedConnection);
   connect (worker, &TciSocketWorker::textFrame, this, &TCITransceiver::onSocketTextFrame, Qt::QueuedConnection);
   connect (worker, &TciSocketWorker::binaryFrame, this, &TCITransceiver::onSocketBinaryFrame, Qt::QueuedConnection);
+  connect (worker, &TciSocketWorker::audioAvailable, this, &TCITransceiver::drain_audio_ring, Qt::QueuedConnection);
   connect (worker, &TciSocketWorker::socketError, this, [this] (int err, QString const& message) {
     auto const casted = static_cast<QAbstractSocket::SocketError> (err);
     onError (casted);
@@ -579,6 +670,9 @@ void TCITransceiver::shutdown_socket_worker ()
     }
   pending_text_frames_.clear ();
   pending_binary_frames_.clear ();
+  audio_receiver_ = -1;
+  audio_ring_.clear ();
+  audio_drain_pending_ = false;
 }
 
 void TCITransceiver::onConnected()
@@ -657,6 +751,39 @@ void TCITransceiver::process_pending_tci_frames()
     }
 }
 
+void TCITransceiver::drain_audio_ring ()
+{
+  // clear the flag first so that audio arriving while we drain raises
+  // a fresh notification
+  audio_drain_pending_ = false;
+  static constexpr std::size_t kMaxSamplesPerWrite = 16384;
+  float const * samples;
+  while (auto const available = audio_ring_.peek (&samples))
+    {
+      auto const count = std::min (available, kMaxSamplesPerWrite);
+      if (audio_)
+        {
+          writeAudioData (const_cast<float *> (samples), static_cast<qint32> (count));
+        }
+      audio_ring_.consume (count);
+    }
+
+  static constexpr qint64 kAudioStatsIntervalMs = 60000;
+  if (!audio_stats_timer_.isValid ())
+    {
+      audio_stats_timer_.start ();
+    }
+  else if (audio_stats_timer_.hasExpired (kAudioStatsIntervalMs))
+    {
+      audio_stats_timer_.restart ();
+      CAT_DEBUG ("TCI audio: frames=" << audio_stats_.frames.load ()
+                 << " lost=" << audio_stats_.frames_lost.load ()
+                 << " late=" << audio_stats_.late_frames.load ()
+                 << " jitter=" << audio_stats_.jitter_us.load () << "us"
+                 << " max_jitter=" << audio_stats_.max_jitter_us.load () << "us");
+    }
+}
+
 int TCITransceiver::do_start ()
 {
   if (tci_audio_) QThread::currentThread()->setPriority(QThread::HighPriority);
@@ -773,6 +900,7 @@ int TCITransceiver::do_start ()
   m_downSampleFactor =4;
   m_ns = 999;
   audio_ = false;
+  audio_receiver_ = -1;
   requested_stream_audio_ = false;
   stream_audio_ = false;
   _power_ = false;
@@ -913,6 +1041,7 @@ void TCITransceiver::onMessageReceived(const QString &str)
 {
   qDebug() << "From WEB" << str;
   QStringList const cmd_list = tci_split_escaped (str, QChar {';'}, SkipEmptyParts);
+  bool rig_state_pushed {false};
   for (QString const& cmds : cmd_list){
     QString command_name_raw;
     QString args_raw;
@@ -983,6 +1112,7 @@ void TCITransceiver::onMessageReceived(const QString &str)
         printf("%s Cmd_Power : %s %d\n",QDateTime::QDateTime::currentDateTimeUtc().toString("hh:mm:ss.zzz").toStdString().c_str(),args.join("|").toStdString().c_str(),power_);
         break;
       case Cmd_VFO:
+        rig_state_pushed = true;
         printf("%s Cmd_VFO : %s\n",QDateTime::QDateTime::currentDateTimeUtc().toString("hh:mm:ss.zzz").toStdString().c_str(),args.join("|").toStdString().c_str());
         printf("band_change:%d busy_other_frequency_:%d timer1_remaining:%d timer2_remaining:%d",band_change,busy_other_frequency_,tci_timer7_ ? tci_timer7_->remainingTime() : -1,tci_timer2_ ? tci_timer2_->remainingTime() : -1); //was timer1 and timer2
         if(arg (0) == rx_ && arg (1) == "0") {
@@ -1021,6 +1151,7 @@ void TCITransceiver::onMessageReceived(const QString &str)
         }
         break;
       case Cmd_Mode:
+        rig_state_pushed = true;
         printf("%s Cmd_Mode : %s\n",QDateTime::QDateTime::currentDateTimeUtc().toString("hh:mm:ss.zzz").toStdString().c_str(),args.join("|").toStdString().c_str());
         if(arg (0) == rx_) {
           if (ESDR3 || HPSDR) {
@@ -1037,6 +1168,7 @@ void TCITransceiver::onMessageReceived(const QString &str)
         }
         break;
       case Cmd_SplitEnable:
+        rig_state_pushed = true;
         printf("%s Cmd_SplitEnable : %s\n",QDateTime::QDateTime::currentDateTimeUtc().toString("hh:mm:ss.zzz").toStdString().c_str(),args.join("|").toStdString().c_str());
         if(arg (0) == rx_) {
           if (arg (1) == "false") split_ = false;
@@ -1061,6 +1193,7 @@ void TCITransceiver::onMessageReceived(const QString &str)
       case Cmd_Volume:
         break;
       case Cmd_Trx:
+        rig_state_pushed = true;
         printf("%s Cmd_Trx : %s\n",QDateTime::QDateTime::currentDateTimeUtc().toString("hh:mm:ss.zzz").toStdString().c_str(),args.join("|").toStdString().c_str());
         if(arg (0) == rx_) {
           if (arg (1) == "false") PTT_ = false;
@@ -1151,6 +1284,12 @@ void TCITransceiver::onMessageReceived(const QString &str)
         break;
     }
   }
+  if (rig_state_pushed)
+    {
+      // TCI pushes rig state changes, pick them up without waiting
+      // for the next scheduled poll
+      poll_now ();
+    }
 }
 
 void TCITransceiver::sendTextMessage(const QString &message)
@@ -1268,19 +1407,19 @@ quint32 TCITransceiver::writeAudioData (float * data, qint32 maxSize)
   qint64 ms0 = QDateTime::currentMSecsSinceEpoch() % 86400000;
   unsigned mstr = ms0 % int(1000.0*m_period); // ms into the nominal Tx start time
   if(mstr < mstr0/2) {              //When mstr has wrapped around to 0, restart the buffer
-    dec_data.params.kin = 0;
+    restart_capture (dec_data);
     m_bufferPos = 0;
   }
   mstr0=mstr;
 
   if (data && maxSize > 0)
     {
-      if (dec_data.params.kin < 0 || dec_data.params.kin > kMaxKin)
+      if (dec_data->params.kin < 0 || dec_data->params.kin > kMaxKin)
         {
-          qWarning () << "TCI: clamping out-of-range kin:" << dec_data.params.kin;
-          dec_data.params.kin = qBound (0, dec_data.params.kin, kMaxKin);
+          qWarning () << "TCI: clamping out-of-range kin:" << dec_data->params.kin;
+          dec_data->params.kin = qBound (0, dec_data->params.kin, kMaxKin);
         }
-      Q_ASSERT (dec_data.params.kin >= 0);
+      Q_ASSERT (dec_data->params.kin >= 0);
 
       // no torn frames
       Q_ASSERT (!(maxSize % static_cast<qint32> (bytesPerFrame)));
@@ -1296,7 +1435,7 @@ quint32 TCITransceiver::writeAudioData (float * data, qint32 maxSize)
           rx_scaled_buffer_[static_cast<int> (i)] = gain * data[i];
         }
 
-      int const boundedKin0 = qBound (0, dec_data.params.kin, kMaxKin);
+      int const boundedKin0 = qBound (0, dec_data->params.kin, kMaxKin);
       size_t const framesAcceptable ((static_cast<size_t> (kMaxKin - boundedKin0)) * m_downSampleFactor);
       size_t const framesInput = static_cast<size_t> (maxSize / bytesPerFrame);
       size_t const framesAccepted = qMin (framesInput, framesAcceptable);
@@ -1305,7 +1444,7 @@ quint32 TCITransceiver::writeAudioData (float * data, qint32 maxSize)
         {
           qDebug () << "dropped " << framesInput - framesAccepted
                     << " frames of data on the floor!"
-                    << dec_data.params.kin << mstr;
+                    << dec_data->params.kin << mstr;
         }
 
       for (size_t remaining = framesAccepted; remaining; )
@@ -1323,43 +1462,43 @@ quint32 TCITransceiver::writeAudioData (float * data, qint32 maxSize)
                 {
                   qint32 framesToProcess (m_samplesPerFFT * m_downSampleFactor);
                   qint32 framesAfterDownSample (m_samplesPerFFT);
-                  int const boundedKin = qBound (0, dec_data.params.kin, kMaxKin);
+                  int const boundedKin = qBound (0, dec_data->params.kin, kMaxKin);
                   if (boundedKin <= (kMaxKin - framesAfterDownSample))
                     {
-                      fil4_ (&m_buffer[0], &framesToProcess, &dec_data.d2[boundedKin],
-                             &framesAfterDownSample, &dec_data.d2[boundedKin]);
-                      dec_data.params.kin = boundedKin + framesAfterDownSample;
+                      fil4_ (&m_buffer[0], &framesToProcess, &dec_data->d2[boundedKin],
+                             &framesAfterDownSample, &dec_data->d2[boundedKin]);
+                      publish_capture (dec_data, boundedKin + framesAfterDownSample);
                     }
                   else
                     {
                       qWarning () << "TCI: dropping downsample block due to kin bounds"
                                   << boundedKin << framesAfterDownSample;
                     }
-                  Q_EMIT tciframeswritten (dec_data.params.kin);
+                  Q_EMIT tciframeswritten (dec_data->params.kin);
                   m_bufferPos = 0;
                 }
               remaining -= numFramesProcessed;
             }
           else
             {
-              int const boundedKin = qBound (0, dec_data.params.kin, kMaxKin);
+              int const boundedKin = qBound (0, dec_data->params.kin, kMaxKin);
               size_t const writableFrames = qMin (numFramesProcessed, static_cast<size_t> (kMaxKin - boundedKin));
               if (writableFrames == 0)
                 {
-                  qWarning () << "TCI: no writable frames left in dec_data.d2";
+                  qWarning () << "TCI: no writable frames left in dec_data->d2";
                   break;
                 }
               store (&rx_scaled_buffer_[static_cast<int> ((framesAccepted - remaining) * bytesPerFrame)],
-                     writableFrames, &dec_data.d2[boundedKin]);
+                     writableFrames, &dec_data->d2[boundedKin]);
               m_bufferPos += writableFrames;
-              dec_data.params.kin = boundedKin + static_cast<int> (writableFrames);
+              publish_capture (dec_data, boundedKin + static_cast<int> (writableFrames));
               if (writableFrames < numFramesProcessed)
                 {
-                  qWarning () << "TCI: truncated write to dec_data.d2 due to bounds";
+                  qWarning () << "TCI: truncated write to dec_data->d2 due to bounds";
                 }
               if (m_bufferPos >= static_cast<unsigned> (m_samplesPerFFT))
                 {
-                  Q_EMIT tciframeswritten (dec_data.params.kin);
+                  Q_EMIT tciframeswritten (dec_data->params.kin);
                   m_bufferPos = 0;
                 }
               remaining -= writableFrames;
@@ -1428,10 +1567,12 @@ void TCITransceiver::do_audio (bool on)
 {
   TRACE_CAT ("TCITransceiver", on << state ());
   if (on) {
-    dec_data.params.kin = 0;
+    restart_capture (dec_data);
     m_bufferPos = 0;
+    audio_ring_.clear ();
   }
   audio_ = on;
+  audio_receiver_ = on ? static_cast<int> (rx_.toUInt ()) : -1;
 }
 
 void TCITransceiver::do_period (double period)
@@ -5,12 +5,15 @@
 
 #include "TransceiverFactory.hpp"
 #include "PollingTransceiver.hpp"
+#include "TciAudioRing.hpp"
 #include "commons.h"
 
 #include <QtWebSockets/QWebSocket>
 #include <QTimer>
+#include <QElapsedTimer>
 #include <QVector>
 #include <QQueue>
+#include <atomic>
 #include <mutex>
 
 typedef float REAL;
@@ -139,6 +142,7 @@ private slots:
   void onSocketTextFrame(QString const& text);
   void onSocketBinaryFrame(QByteArray const& data);
   void process_pending_tci_frames();
+  void drain_audio_ring();
 
 signals:
   void sendIqData(int, quint32, float*, bool);
@@ -235,6 +239,11 @@ private:
   QTimer * parse_queue_timer_ {nullptr};
   QQueue<QString> pending_text_frames_;
   QQueue<QByteArray> pending_binary_frames_;
+  TciAudioRing audio_ring_;     // receive audio from the socket thread
+  TciAudioStats audio_stats_;
+  std::atomic<int> audio_receiver_ {-1}; // receiver to stream, -1 for none
+  std::atomic<bool> audio_drain_pending_ {false};
+  QElapsedTimer audio_stats_timer_;
   QLocale locale_;
   QTimer * tci_timer1_;
   QTimer * tci_timer2_;
@@ -0,0 +1,97 @@
+#ifndef TCI_AUDIO_RING_HPP__
+#define TCI_AUDIO_RING_HPP__
+
+#include <atomic>
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+#include <QtGlobal>
+
+//
+// TCI receive audio ring
+//
+//  Single producer, single  consumer lock free ring  of float samples.
+//  The TCI  socket worker thread  writes received audio  frames into
+//  it  as  they  are  parsed  and  the  transceiver  thread  drains  it
+//  into the decoder sample buffer. Storage is allocated once, nothing
+//  on the streaming path touches the heap.
+//
+class TciAudioRing
+{
+public:
+  explicit TciAudioRing (unsigned capacity_log2 = 18)
+    : buffer_ (std::size_t {1} << capacity_log2)
+    , mask_ {buffer_.size () - 1}
+  {
+  }
+
+  std::size_t capacity () const {return buffer_.size ();}
+
+  std::size_t size () const
+  {
+    return head_.load (std::memory_order_acquire) - tail_.load (std::memory_order_acquire);
+  }
+
+  // Producer side. Writes all count samples or, if there is not room
+  // for them, nothing.
+  bool write (float const * samples, std::size_t count)
+  {
+    auto const head = head_.load (std::memory_order_relaxed);
+    auto const tail = tail_.load (std::memory_order_acquire);
+    if (count > capacity () - (head - tail))
+      {
+        return false;
+      }
+    auto const offset = head & mask_;
+    auto const first = std::min (count, capacity () - offset);
+    std::memcpy (&buffer_[offset], samples, first * sizeof (float));
+    std::memcpy (&buffer_[0], samples + first, (count - first) * sizeof (float));
+    head_.store (head + count, std::memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Returns the number of samples readable in one
+  // contiguous span starting at *samples.
+  std::size_t peek (float const ** samples) const
+  {
+    auto const tail = tail_.load (std::memory_order_relaxed);
+    auto const head = head_.load (std::memory_order_acquire);
+    auto const offset = tail & mask_;
+    *samples = &buffer_[offset];
+    return std::min (head - tail, capacity () - offset);
+  }
+
+  void consume (std::size_t count)
+  {
+    tail_.store (tail_.load (std::memory_order_relaxed) + count, std::memory_order_release);
+  }
+
+  // Consumer side, discard everything queued so far.
+  void clear ()
+  {
+    tail_.store (head_.load (std::memory_order_acquire), std::memory_order_release);
+  }
+
+private:
+  std::vector<float> buffer_;
+  std::size_t mask_;
+  std::atomic<std::size_t> head_ {0}; // total samples written
+  std::atomic<std::size_t> tail_ {0}; // total samples read
+};
+
+//
+// TCI receive audio statistics, written by the socket worker thread
+// and read by anyone.
+//
+struct TciAudioStats
+{
+  std::atomic<quint64> frames {0};      // audio frames received
+  std::atomic<quint64> frames_lost {0}; // malformed or no room in ring
+  std::atomic<quint64> late_frames {0}; // arrived over a frame late
+  std::atomic<quint32> jitter_us {0};   // smoothed arrival jitter
+  std::atomic<quint32> max_jitter_us {0};
+};
+
+#endif
@@ -461,6 +461,24 @@ void ClientWidget::decode_added (bool /*is_new*/, ClientKey const& key, QTime /*
   decodes_table_view_->scrollToBottom ();
 }
 
+void ClientWidget::decode_batch_received (ClientKey const& key, quint32 sequence, quint16 /*part*/, quint16 parts)
+{
+  if (key != key_) return;
+  if (sequence != batch_sequence_)
+    {
+      // a new batch, count any parts of the last one that never came
+      batch_parts_lost_ += batch_parts_ - batch_parts_seen_;
+      batch_sequence_ = sequence;
+      batch_parts_ = parts;
+      batch_parts_seen_ = 0;
+    }
+  ++batch_parts_seen_;
+  if (batch_parts_lost_)
+    {
+      status_bar_->showMessage (tr ("Decode batch datagrams lost: %1").arg (batch_parts_lost_));
+    }
+}
+
 void ClientWidget::beacon_spot_added (bool /*is_new*/, ClientKey const& key, QTime /*time*/, qint32 /*snr*/
                                       , float /*delta_time*/, Frequency /*delta_frequency*/, qint32 /*drift*/
                                       , QString const& /*callsign*/, QString const& /*grid*/, qint32 /*power*/
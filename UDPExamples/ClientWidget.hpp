@@ -56,6 +56,7 @@ public:
   Q_SLOT void decode_added (bool is_new, ClientKey const& key, QTime, qint32 snr
                             , float delta_time, quint32 delta_frequency, QString const& mode
                             , QString const& message, bool low_confidence, bool off_air);
+  Q_SLOT void decode_batch_received (ClientKey const& key, quint32 sequence, quint16 part, quint16 parts);
   Q_SLOT void beacon_spot_added (bool is_new, ClientKey const& key, QTime, qint32 snr
                                  , float delta_time, Frequency delta_frequency, qint32 drift
                                  , QString const& callsign, QString const& grid, qint32 power
@@ -146,6 +147,12 @@ private:
   QStackedLayout * decodes_stack_;
 
   bool columns_resized_;
+
+  // DecodeBatch parts seen of the latest batch and parts lost overall
+  quint32 batch_sequence_ {0};
+  int batch_parts_ {0};
+  int batch_parts_seen_ {0};
+  quint64 batch_parts_lost_ {0};
 };
 
 #endif
@@ -338,6 +338,7 @@ void MessageAggregatorMainWindow::add_client (ClientKey const& key, QString cons
   addDockWidget (Qt::BottomDockWidgetArea, dock);
   connect (server_, &MessageServer::status_update, dock, &ClientWidget::update_status);
   connect (server_, &MessageServer::decode, dock, &ClientWidget::decode_added);
+  connect (server_, &MessageServer::decode_batch, dock, &ClientWidget::decode_batch_received);
   connect (server_, &MessageServer::WSPR_decode, dock, &ClientWidget::beacon_spot_added);
   connect (server_, &MessageServer::decodes_cleared, dock, &ClientWidget::decodes_cleared);
   connect (dock, &ClientWidget::do_clear_decodes, server_, &MessageServer::clear_decodes);
@@ -287,6 +287,39 @@ void MessageServer::impl::parse_message (QHostAddress const& sender, port_type s
               }
               break;
 
+            case NetworkMessage::DecodeBatch:
+              {
+                // unpack message, each decode is passed on as if it
+                // arrived in its own Decode message
+                quint32 sequence;
+                quint16 part;
+                quint16 parts;
+                quint32 count {0};
+                in >> sequence >> part >> parts >> count;
+                for (quint32 i = 0; i < count && OK == check_status (in); ++i)
+                  {
+                    bool is_new {true};
+                    QTime time;
+                    qint32 snr;
+                    float delta_time;
+                    quint32 delta_frequency;
+                    QByteArray mode;
+                    QByteArray message;
+                    bool low_confidence {false};
+                    bool off_air {false};
+                    in >> is_new >> time >> snr >> delta_time >> delta_frequency >> mode
+                       >> message >> low_confidence >> off_air;
+                    if (OK == check_status (in))
+                      {
+                        Q_EMIT self_->decode (is_new, client_key, time, snr, delta_time, delta_frequency
+                                              , QString::fromUtf8 (mode), QString::fromUtf8 (message)
+                                              , low_confidence, off_air);
+                      }
+                  }
+                Q_EMIT self_->decode_batch (client_key, sequence, part, parts);
+              }
+              break;
+
             case NetworkMessage::WSPRDecode:
               {
                 // unpack message
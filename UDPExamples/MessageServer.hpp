@@ -102,6 +102,9 @@ public:
   Q_SIGNAL void decode (bool is_new, ClientKey const&, QTime time, qint32 snr, float delta_time
                         , quint32 delta_frequency, QString const& mode, QString const& message
                         , bool low_confidence, bool off_air);
+  // emitted after the decode signals for one part of a DecodeBatch
+  // message
+  Q_SIGNAL void decode_batch (ClientKey const&, quint32 sequence, quint16 part, quint16 parts);
   Q_SIGNAL void WSPR_decode (bool is_new, ClientKey const&, QTime time, qint32 snr, float delta_time, Frequency
                              , qint32 drift, QString const& callsign, QString const& grid, qint32 power
                              , bool off_air);
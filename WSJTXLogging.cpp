@@ -28,6 +28,7 @@
 #include <QMessageLogContext>
 
 #include "Logger.hpp"
+#include "LogSinks.hpp"
 #include "qt_helpers.hpp"
 
 namespace logging = boost::log;
@@ -122,8 +123,11 @@ namespace
     // Sink intended for general use that passes everything above
     // selected severity levels per channel. Log file is appended
     // between sessions and rotated to limit storage space usage.
+    // Records queue for the writing thread in a bounded buffer, if a
+    // burst fills it the oldest are dropped rather than the logging
+    // thread made to wait.
     //
-    auto sys_sink = boost::make_shared<sinks::asynchronous_sink<sinks::text_file_backend>>
+    auto sys_sink = boost::make_shared<sinks::asynchronous_sink<sinks::text_file_backend, Logger::bounded_queue>>
       (
        keywords::auto_flush = false
 #if BOOST_VERSION / 100 >= 1070
@@ -245,6 +249,10 @@ WSJTXLogging::WSJTXLogging ()
 
 WSJTXLogging::~WSJTXLogging ()
 {
+  if (auto dropped = Logger::dropped_records ())
+    {
+      LOG_WARN ("Log records dropped by full sink queues: " << dropped);
+    }
   LOG_INFO ("Log Finish");
   auto core = logging::core::get ();
   core->flush ();
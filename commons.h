@@ -18,6 +18,7 @@
    */
 typedef struct dec_data {
   int   ipc[3];
+  int   kgen;                   //Bumped whenever the capture in d2 restarts
   float ss[184*NSMAX];
   float savg[NSMAX];
   float sred[5760];
@@ -110,6 +111,33 @@ typedef struct dec_data {
   } params;
 } dec_data_t;
 
+#ifdef __cplusplus
+#include <atomic>
+
+  /*
+   * Restart the capture in d2 from its first sample. The generation
+   * is bumped before any old sample is overwritten so jt9, which
+   * copies the samples it decodes straight out of the shared segment,
+   * can tell if that happened while it was copying.
+   */
+inline void restart_capture (dec_data_t * data)
+{
+  data->kgen = data->kgen + 1;
+  std::atomic_thread_fence (std::memory_order_release);
+  data->params.kin = 0;
+}
+
+  /*
+   * Advance the capture to kin once the samples before it are in d2,
+   * jt9 must never see kin ahead of the samples it covers.
+   */
+inline void publish_capture (dec_data_t * data, int kin)
+{
+  std::atomic_thread_fence (std::memory_order_release);
+  data->params.kin = kin;
+}
+#endif
+
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -1,6 +1,7 @@
 module packjt77
 
 use packjt77var, only : hash10var,hash12var,hash22var
+use hashing, only : hashcalls_save,hashcalls_lookup
   
 ! These variables are accessible from outside via "use packjt77":
   parameter (MAXHASH=1000,MAXRECENT=10)
@@ -19,13 +20,15 @@ use packjt77var, only : hash10var,hash12var,hash22var
 
 subroutine hash10(n10,c13)
 
-  character*13 c13
+  character*13 c13,cw
 
   c13='<...>'
   if(n10.lt.0 .or. n10.gt.1023) return
   if(len(trim(calls10(n10))).gt.0) then
      c13=calls10(n10)
      c13='<'//trim(c13)//'>'
+  else if(hashcalls_lookup(n10,10,cw).ne.0 .and. cw.ne.mycall13) then
+     c13='<'//trim(cw)//'>'    !Learned by another decoder or session
   endif
   return
 
@@ -33,13 +36,15 @@ end subroutine hash10
 
 subroutine hash12(n12,c13)
 
-  character*13 c13
+  character*13 c13,cw
   
   c13='<...>'
   if(n12.lt.0 .or. n12.gt.4095) return
   if(len(trim(calls12(n12))).gt.0) then
      c13=calls12(n12)
      c13='<'//trim(c13)//'>'
+  else if(hashcalls_lookup(n12,12,cw).ne.0 .and. cw.ne.mycall13) then
+     c13='<'//trim(cw)//'>'    !Learned by another decoder or session
   endif
   return
 
@@ -48,7 +53,7 @@ end subroutine hash12
 
 subroutine hash22(n22,c13)
 
-  character*13 c13
+  character*13 c13,cw
   
   c13='<...>'
   do i=1,nzhash
@@ -58,6 +63,7 @@ subroutine hash22(n22,c13)
         go to 900
      endif
   enddo
+  if(hashcalls_lookup(n22,22,cw).ne.0) c13='<'//trim(cw)//'>'
 
 900 return
 end subroutine hash22
@@ -82,6 +88,7 @@ end function ihashcall
 
 subroutine save_hash_call(c13,n10,n12,n22)
 
+  use iso_c_binding, only: c_size_t
   character*13 c13,cw
 
   cw=c13 
@@ -91,6 +98,7 @@ subroutine save_hash_call(c13,n10,n12,n22)
   if(i.gt.0) cw(i:)='         '
 
   if(len(trim(cw)) .lt. 3) return
+  call hashcalls_save(cw,len(cw,c_size_t))   !Share with other decoders
 
   n10=ihashcall(cw,10)
   if(n10.ge.0 .and. n10 .le. 1023 .and. cw.ne.mycall13) calls10(n10)=cw
@@ -2,7 +2,6 @@ subroutine ana64(iwave,npts,c0)
 
   integer*2 iwave(npts)                      !Raw data at 12000 Hz
   complex c0(0:npts-1)                       !Complex data at 6000 Hz
-  save
 
   nfft1=npts
   nfft2=nfft1/2
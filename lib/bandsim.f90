@@ -0,0 +1,235 @@
+program bandsim
+
+! Generate a reproducible synthetic band for decoder benchmarks: nsig
+! signals in Gaussian noise, each with its own SNR (uniform between snr1
+! and snr2), DT and audio frequency, optionally Watterson faded.
+! Writes a .wav file and a truth file listing what was transmitted.
+! Signal placement depends only on iseed; the noise and fading come from
+! gran(), which is deliberately left unseeded so that runs repeat.
+
+  use wavhdr
+  use packjt77
+  parameter (NMAXW=120*12000)            !Longest file (WSPR)
+  type(hdr) h
+  character*8 cmode,arg
+  character*80 fname
+  character*37 msg37,msgsent37
+  character*22 msg22,msgsent22
+  character*6 call1,call2
+  character*4 grid
+  character*77 c77
+  complex, allocatable :: c(:),cw(:)
+  real, allocatable :: wave(:),xjunk(:)
+  integer*2, allocatable :: iwave(:)
+  integer itone(162)
+  integer*1 msgbits(77)
+  integer, allocatable :: iseed(:)
+
+  nargs=iargc()
+  if(nargs.ne.8) then
+     print*,'Usage:   bandsim mode nsig snr1 snr2 fspread delay iseed fname'
+     print*,'Example: bandsim FT8   20   -20   -5    0.0    0.0     1  000000_000001'
+     print*,'         mode is one of FT8, FT4, FT2, Q65 (30 s, submode A), WSPR'
+     print*,'         fspread (Hz) and delay (ms) are Watterson parameters'
+     print*,'         Writes fname.wav and fname.txt: f0, DT, SNR and message'
+     go to 999
+  endif
+  call getarg(1,cmode)
+  call getarg(2,arg)
+  read(arg,*) nsig
+  call getarg(3,arg)
+  read(arg,*) snr1
+  call getarg(4,arg)
+  read(arg,*) snr2
+  call getarg(5,arg)
+  read(arg,*) fspread
+  call getarg(6,arg)
+  read(arg,*) delay
+  call getarg(7,arg)
+  read(arg,*) nseed
+  call getarg(8,fname)
+
+! Per-mode geometry: samples in file, symbols, samples per symbol,
+! occupied bandwidth, band edges, nominal start time and DT spread.
+  fs=12000.0
+  select case(cmode)
+  case('FT8')
+     npts=15*12000
+     nsym=79
+     nsps=1920
+     bw=50.0
+     fa=200.0
+     fb=2900.0
+     t0=0.5
+     dtmax=0.5
+  case('FT4')
+     npts=21*3456
+     nsym=103
+     nsps=576
+     bw=90.0
+     fa=200.0
+     fb=2900.0
+     t0=0.5
+     dtmax=0.3
+  case('FT2')
+     npts=45000
+     nsym=103
+     nsps=288
+     bw=170.0
+     fa=200.0
+     fb=2900.0
+     t0=0.5
+     dtmax=0.2
+  case('Q65')
+     npts=30*12000
+     nsym=85
+     nsps=3600
+     bw=65*12000.0/nsps
+     fa=200.0
+     fb=2900.0
+     t0=0.5
+     dtmax=0.5
+  case('WSPR')
+     npts=NMAXW
+     nsym=162
+     nsps=8192
+     bw=6.0
+     fa=1410.0
+     fb=1590.0
+     t0=1.0
+     dtmax=0.5
+  case default
+     print*,'Unknown mode ',trim(cmode)
+     go to 999
+  end select
+  if((cmode.eq.'Q65' .or. cmode.eq.'WSPR') .and.                        &
+       (fspread.ne.0.0 .or. delay.ne.0.0)) then
+     print*,'Fading is supported for FT8, FT4 and FT2 only'
+     go to 999
+  endif
+
+! Signals get equal frequency slots so that they never overlap
+  if(nsig.lt.1) nsig=1
+  slot=(fb-fa)/nsig
+  if(slot.lt.1.2*bw) then
+     print*,'Too many signals for the band'
+     go to 999
+  endif
+
+  call random_seed(size=n)
+  allocate(iseed(n))
+  iseed=nseed
+  call random_seed(put=iseed)
+
+  allocate(c(0:npts-1),cw(0:npts-1),wave(npts),xjunk(npts),iwave(npts))
+  c=0.
+  twopi=8.0*atan(1.0)
+  bandwidth_ratio=2500.0/(fs/2.0)
+  open(12,file=trim(fname)//'.txt',status='unknown')
+
+  do isig=1,nsig
+     call random_number(r)
+     snrdb=snr1 + r*(snr2-snr1)
+     call random_number(r)
+     f0=fa + (isig-1)*slot + 0.5*bw + r*(slot-bw)
+     call random_number(r)
+     xdt=dtmax*(2.0*r-1.0)
+
+! Unique, valid callsigns for every signal
+     call1='K0AAA'
+     call2='W0AAA'
+     call1(2:2)=char(ichar('0')+mod(isig,10))
+     call1(5:5)=char(ichar('A')+mod(isig,26))
+     call1(4:4)=char(ichar('A')+mod(isig/26,26))
+     call2(2:2)=char(ichar('0')+mod(isig+5,10))
+     call2(3:3)=char(ichar('A')+mod(7*isig,26))
+     call2(5:5)=char(ichar('A')+mod(isig/26+3,26))
+     grid='FN42'
+     grid(3:3)=char(ichar('0')+mod(isig,10))
+     msg37=trim(call1)//' '//trim(call2)//' '//grid
+     msg22=trim(call2)//' '//grid//' 37'
+
+     cw=0.
+     nwave=nsym*nsps
+     i3=-1
+     n3=-1
+     select case(cmode)
+     case('FT8')
+        call pack77(msg37,i3,n3,c77)
+        call genft8(msg37,i3,n3,msgsent37,msgbits,itone)
+        call gen_ft8wave(itone,nsym,nsps,2.0,fs,f0,cw,xjunk,1,nwave)
+        k0=nint((xdt+t0)*fs)
+     case('FT4')
+        nwave=(nsym+2)*nsps
+        call genft4(msg37,0,msgsent37,msgbits,itone)
+        call gen_ft4wave(itone,nsym,nsps,fs,f0,cw,xjunk,1,nwave)
+        k0=nint((xdt+t0)*fs)-nsps
+     case('FT2')
+        nwave=(nsym+2)*nsps
+        call genft2(msg37,0,msgsent37,msgbits,itone)
+        call gen_ft2wave(itone,nsym,nsps,fs,f0,cw,xjunk,1,nwave)
+        k0=nint((xdt+t0)*fs)-nsps
+     case('Q65')
+        call genq65(msg37,0,msgsent37,itone,i3,n3)
+        call bandsim_fsk(itone,nsym,nsps,f0,fs/nsps,cw)
+        k0=nint((xdt+t0)*fs)
+     case('WSPR')
+        call genwspr(msg22,msgsent22,itone)
+        msgsent37=msgsent22
+        call bandsim_fsk(itone,nsym,nsps,f0-1.5*fs/nsps,fs/nsps,cw)
+        k0=nint((xdt+t0)*fs)
+     end select
+
+     if(fspread.ne.0.0 .or. delay.ne.0.0) then
+        nfade=nwave+nsps                 !Room for the delayed path
+        call watterson(cw,nfade,nwave,fs,delay,fspread)
+     endif
+     cw=cshift(cw,-k0)
+     sig=sqrt(2*bandwidth_ratio) * 10.0**(0.05*snrdb)
+     c=c + sig*cw
+     write(12,1000) f0,xdt,snrdb,trim(msgsent37)
+1000 format(f8.1,f6.2,f6.1,2x,a)
+  enddo
+  close(12)
+
+  do i=1,npts
+     wave(i)=100.0*(aimag(c(i-1)) + gran())
+  enddo
+  if(any(abs(wave).gt.32767.0)) print*,"Warning - data will be clipped."
+  iwave=nint(max(-32767.0,min(32767.0,wave)))
+  h=default_header(12000,npts)
+  open(10,file=trim(fname)//'.wav',status='unknown',access='stream')
+  write(10) h,iwave
+  close(10)
+  write(*,1010) nsig,trim(cmode),snr1,snr2,fspread,delay,trim(fname)
+1010 format(i4,1x,a,' signals, SNR',f6.1,' to',f6.1,'  fspread',f6.2,   &
+          '  delay',f6.2,'  ',a,'.wav')
+
+999 continue
+
+contains
+
+  subroutine bandsim_fsk(itone,nsym,nsps,f0,spacing,cw)
+
+! Phase-continuous FSK for modes without a shaped waveform generator
+
+    integer itone(nsym)
+    complex cw(0:)
+    real*8 phi,dphi,twopi8
+
+    twopi8=8.d0*atan(1.d0)
+    phi=0.d0
+    k=0
+    do j=1,nsym
+       dphi=twopi8*(f0 + itone(j)*spacing)/12000.d0
+       do i=1,nsps
+          cw(k)=cmplx(cos(phi),sin(phi))
+          phi=mod(phi+dphi,twopi8)
+          k=k+1
+       enddo
+    enddo
+
+    return
+  end subroutine bandsim_fsk
+
+end program bandsim
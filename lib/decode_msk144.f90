@@ -19,6 +19,7 @@ subroutine decode_msk144(audio_samples, params, data_dir)
   logical :: btrain = .false. ! turns on training in MSK144 mode
   real*8 :: pcoeffs(5) = (/ 0.0, 0.0, 0.0, 0.0, 0.0 /); ! phase equalization
   logical :: bswl = .false.
+  logical*1 :: bpingonly = .false. ! every block gets the full analysis
   character(len = 80) :: line
   character(len = CALL_LENGTH) :: mycall 
   character(len = CALL_LENGTH) :: hiscall
@@ -39,7 +40,7 @@ subroutine decode_msk144(audio_samples, params, data_dir)
     tsec = position / REAL(SAMPLING_RATE)
 
     call mskrtd(buffer, params%nutc, tsec, params%ntol, params%nfqso, params%ndepth, &
-      mycall, hiscall, bshmsg, btrain, pcoeffs, bswl, data_dir, line)
+      mycall, hiscall, bshmsg, btrain, pcoeffs, bswl, bpingonly, data_dir, line)
 
     if (line(1:1) .ne. char(0)) then
       line = line(1:index(line, char(0))-1)
@@ -1198,7 +1198,7 @@ subroutine multimode_decoder(ss,id2,params,nfsample)
 
   if(params%nmode.eq.2) then
      if(params%nclearave) then
-        call ft2_clravg()
+        call my_ft2%clear_average()
         params%nclearave=.false.
      endif
      open(14,file=trim(temp_dir)//'/avemsg.txt',status='unknown')
@@ -31,6 +31,7 @@ subroutine extract(s3,nadd,mode65,ntrials,naggressive,ndepth,nflip,     &
   integer mrsym(63),mr2sym(63),mrprob(63),mr2prob(63)
   integer correct(63),tmp(63)
   logical first,ltext,ljt65apon
+  real, parameter :: TFTRSD=0.5  !Time limit (s) for each ftrsdap call
   common/chansyms65/correct
   data first/.true./
   save
@@ -157,7 +158,8 @@ subroutine extract(s3,nadd,mode65,ntrials,naggressive,ndepth,nflip,     &
      ntry=0
      call timer('ftrsd   ',0)
      param=0
-     call ftrsdap(mrsym,mrprob,mr2sym,mr2prob,ap,ntrials,correct,param,ntry)
+     call ftrsdap(mrsym,mrprob,mr2sym,mr2prob,ap,ntrials,TFTRSD,correct,   &
+          param,ntry)
      call timer('ftrsd   ',1)
      ncandidates=param(0)
      nhard=param(1)
@@ -221,6 +223,8 @@ end subroutine extract
 
 subroutine getpp(workdat,p)
 
+! Called from several threads at once by ftrsdap, s3a must only be read.
+
   use jt65_mod
   integer workdat(63)
   integer a(63)
@@ -232,10 +236,7 @@ subroutine getpp(workdat,p)
   psum=0.
   do j=1,63
      i=a(j)+1
-     x=s3a(i,j)
-     s3a(i,j)=0.
-     psum=psum + x
-     s3a(i,j)=x
+     psum=psum + s3a(i,j)
   enddo
   p=psum/63.0
 
@@ -48,6 +48,7 @@ subroutine fast_decode(id2,narg,trperiod,line,mycall_12,   &
      call fast9(id2,narg,line)
      go to 900
   endif
+  if(nmode.eq.104) go to 900     !MSK144 is decoded as it arrives, by mskrtd
 
   if(newdat.eq.1) then
      cdat2=cdat
@@ -0,0 +1,731 @@
+#include "flacio.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define BLOCK_SIZE 4096u
+#define MAX_FIXED_ORDER 4
+#define MAX_PARTITION_ORDER 8
+#define MAX_RICE_PARAMETER 14u  /* 15 is the escape code */
+
+enum {block_streaminfo = 0, block_vorbis_comment = 4};
+
+static char const vendor[] = "wsjtx flacio";
+
+/*
+ * CRCs of frame headers and frames
+ */
+static unsigned crc8 (unsigned char const * data, size_t size)
+{
+  unsigned crc = 0;
+  while (size--)
+    {
+      int i;
+      crc ^= *data++;
+      for (i = 0; i < 8; ++i) crc = crc & 0x80 ? ((crc << 1) ^ 0x07) & 0xff : (crc << 1) & 0xff;
+    }
+  return crc;
+}
+
+static unsigned crc16 (unsigned char const * data, size_t size)
+{
+  unsigned crc = 0;
+  while (size--)
+    {
+      int i;
+      crc ^= (unsigned)*data++ << 8;
+      for (i = 0; i < 8; ++i) crc = crc & 0x8000 ? ((crc << 1) ^ 0x8005) & 0xffff : (crc << 1) & 0xffff;
+    }
+  return crc;
+}
+
+/*
+ * big endian bit writer into a growing buffer
+ */
+struct writer
+{
+  unsigned char * data;
+  size_t size;
+  size_t capacity;
+  uint64_t acc;
+  unsigned bits;                /* pending in acc, always < 8 between calls */
+  int failed;
+};
+
+static void put_byte (struct writer * w, unsigned char byte)
+{
+  if (w->size == w->capacity)
+    {
+      size_t capacity = w->capacity ? 2 * w->capacity : 65536;
+      unsigned char * data = realloc (w->data, capacity);
+      if (!data)
+        {
+          w->failed = 1;
+          return;
+        }
+      w->data = data;
+      w->capacity = capacity;
+    }
+  w->data[w->size++] = byte;
+}
+
+static void put_bits (struct writer * w, uint32_t value, unsigned n) /* n <= 32 */
+{
+  if (!n) return;
+  w->acc = (w->acc << n) | (n < 32 ? value & ((1u << n) - 1) : value);
+  w->bits += n;
+  while (w->bits >= 8)
+    {
+      w->bits -= 8;
+      put_byte (w, (unsigned char)(w->acc >> w->bits));
+    }
+}
+
+static void put_signed (struct writer * w, int32_t value, unsigned n)
+{
+  put_bits (w, (uint32_t)value, n);
+}
+
+static void put_unary (struct writer * w, uint32_t zeros)
+{
+  while (zeros >= 32)
+    {
+      put_bits (w, 0, 32);
+      zeros -= 32;
+    }
+  put_bits (w, 1, zeros + 1);
+}
+
+static void align (struct writer * w)
+{
+  if (w->bits) put_bits (w, 0, 8 - w->bits);
+}
+
+/* frame numbers are coded like UTF-8 */
+static void put_utf8 (struct writer * w, uint32_t value)
+{
+  if (value < 0x80)
+    {
+      put_bits (w, value, 8);
+    }
+  else
+    {
+      unsigned bytes = value < 0x800 ? 2 : value < 0x10000 ? 3 : value < 0x200000 ? 4 : value < 0x4000000 ? 5 : 6;
+      unsigned shift = 6 * (bytes - 1);
+      put_bits (w, ((0xff00u >> bytes) & 0xff) | (value >> shift), 8);
+      while (shift)
+        {
+          shift -= 6;
+          put_bits (w, 0x80 | ((value >> shift) & 0x3f), 8);
+        }
+    }
+}
+
+static void put_le32 (struct writer * w, uint32_t value)
+{
+  put_bits (w, value & 0xff, 8);
+  put_bits (w, (value >> 8) & 0xff, 8);
+  put_bits (w, (value >> 16) & 0xff, 8);
+  put_bits (w, value >> 24, 8);
+}
+
+/*
+ * encoder
+ */
+static uint32_t fold (int32_t residual)
+{
+  return residual < 0 ? ((uint32_t)(-(residual + 1)) << 1) | 1u : (uint32_t)residual << 1;
+}
+
+static void fixed_residual (int32_t const * x, unsigned n, unsigned order, int32_t * r)
+{
+  unsigned i;
+  for (i = order; i < n; ++i)
+    {
+      switch (order)
+        {
+        case 0: r[i] = x[i]; break;
+        case 1: r[i] = x[i] - x[i-1]; break;
+        case 2: r[i] = x[i] - 2 * x[i-1] + x[i-2]; break;
+        case 3: r[i] = x[i] - 3 * x[i-1] + 3 * x[i-2] - x[i-3]; break;
+        default: r[i] = x[i] - 4 * x[i-1] + 6 * x[i-2] - 4 * x[i-3] + x[i-4]; break;
+        }
+    }
+}
+
+/* estimated bits and best parameter for m folded residuals summing to sum */
+static uint64_t rice_bits (uint64_t sum, unsigned m, unsigned * parameter)
+{
+  uint64_t best = (uint64_t)-1;
+  unsigned k;
+  for (k = 0; k <= MAX_RICE_PARAMETER; ++k)
+    {
+      uint64_t bits = (uint64_t)m * (k + 1) + (sum >> k);
+      if (bits < best)
+        {
+          best = bits;
+          *parameter = k;
+        }
+    }
+  return best + 4;
+}
+
+/* partition sums of the folded residuals */
+static void partition_sums (int32_t const * r, unsigned n, unsigned order, unsigned porder, uint64_t * sums)
+{
+  unsigned partitions = 1u << porder;
+  unsigned length = n >> porder;
+  unsigned p, i = order;
+  for (p = 0; p < partitions; ++p)
+    {
+      unsigned end = (p + 1) * length;
+      uint64_t sum = 0;
+      for (; i < end; ++i) sum += fold (r[i]);
+      sums[p] = sum;
+    }
+}
+
+static unsigned max_partition_order (unsigned n, unsigned order)
+{
+  unsigned porder = 0;
+  while (porder < MAX_PARTITION_ORDER && !(n & ((2u << porder) - 1)) && (n >> (porder + 1)) > order) ++porder;
+  return porder;
+}
+
+/* estimated bits of the best partitioning of a residual */
+static uint64_t residual_bits (int32_t const * r, unsigned n, unsigned order, unsigned * best_porder)
+{
+  uint64_t sums[1u << MAX_PARTITION_ORDER];
+  uint64_t best = (uint64_t)-1;
+  unsigned porder = max_partition_order (n, order);
+  partition_sums (r, n, order, porder, sums);
+  for (;;)
+    {
+      unsigned partitions = 1u << porder;
+      unsigned length = n >> porder;
+      uint64_t bits = 2 + 4;
+      unsigned p, k;
+      for (p = 0; p < partitions; ++p) bits += rice_bits (sums[p], p ? length : length - order, &k);
+      if (bits < best)
+        {
+          best = bits;
+          *best_porder = porder;
+        }
+      if (!porder) break;
+      --porder;
+      for (p = 0; p < partitions / 2; ++p) sums[p] = sums[2 * p] + sums[2 * p + 1];
+    }
+  return best;
+}
+
+static void put_residual (struct writer * w, int32_t const * r, unsigned n, unsigned order, unsigned porder)
+{
+  uint64_t sums[1u << MAX_PARTITION_ORDER];
+  unsigned partitions = 1u << porder;
+  unsigned length = n >> porder;
+  unsigned p, i = order;
+  partition_sums (r, n, order, porder, sums);
+  put_bits (w, 0, 2);           /* 4 bit Rice parameters */
+  put_bits (w, porder, 4);
+  for (p = 0; p < partitions; ++p)
+    {
+      unsigned k = 0;
+      unsigned end = (p + 1) * length;
+      rice_bits (sums[p], p ? length : length - order, &k);
+      put_bits (w, k, 4);
+      for (; i < end; ++i)
+        {
+          uint32_t u = fold (r[i]);
+          put_unary (w, u >> k);
+          put_bits (w, u, k);
+        }
+    }
+}
+
+static void put_subframe (struct writer * w, int32_t const * x, unsigned n, int32_t * r)
+{
+  uint64_t best = 8 + 16 * (uint64_t)n; /* verbatim */
+  unsigned best_order = MAX_FIXED_ORDER + 1;
+  unsigned best_porder = 0;
+  unsigned order, i;
+
+  for (i = 1; i < n && x[i] == x[0]; ++i) {}
+  if (i == n)
+    {
+      put_bits (w, 0, 8);       /* constant */
+      put_signed (w, x[0], 16);
+      return;
+    }
+
+  for (order = 0; order <= MAX_FIXED_ORDER && order < n; ++order)
+    {
+      unsigned porder = 0;
+      uint64_t bits;
+      fixed_residual (x, n, order, r);
+      bits = 8 + 16 * order + residual_bits (r, n, order, &porder);
+      if (bits < best)
+        {
+          best = bits;
+          best_order = order;
+          best_porder = porder;
+        }
+    }
+
+  if (best_order > MAX_FIXED_ORDER)
+    {
+      put_bits (w, 1 << 1, 8);  /* verbatim */
+      for (i = 0; i < n; ++i) put_signed (w, x[i], 16);
+      return;
+    }
+  put_bits (w, (8 | best_order) << 1, 8);
+  for (i = 0; i < best_order; ++i) put_signed (w, x[i], 16);
+  fixed_residual (x, n, best_order, r);
+  put_residual (w, r, n, best_order, best_porder);
+}
+
+int flac_encode (int16_t const * samples, size_t count, unsigned sample_rate,
+                 char const * const * comments, size_t comment_count,
+                 unsigned char ** data, size_t * size)
+{
+  struct writer w = {NULL, 0, 0, 0, 0, 0};
+  int32_t * x = malloc (2 * BLOCK_SIZE * sizeof (int32_t));
+  int32_t * r = x + BLOCK_SIZE;
+  size_t streaminfo, start, frame_size, min_frame_size = 0, max_frame_size = 0;
+  uint32_t comments_size = 4 + (sizeof vendor - 1) + 4;
+  uint32_t frame = 0;
+  size_t i;
+
+  if (!x) return FLAC_ERROR_MEMORY;
+  for (i = 0; i < comment_count; ++i) comments_size += 4 + (uint32_t)strlen (comments[i]);
+
+  put_bits (&w, 0x664c6143u, 32); /* "fLaC" */
+  put_bits (&w, block_streaminfo, 8);
+  put_bits (&w, 34, 24);
+  streaminfo = w.size;
+  put_bits (&w, BLOCK_SIZE, 16);
+  put_bits (&w, BLOCK_SIZE, 16);
+  put_bits (&w, 0, 24);         /* frame sizes, filled in below */
+  put_bits (&w, 0, 24);
+  put_bits (&w, sample_rate, 20);
+  put_bits (&w, 0, 3);          /* one channel */
+  put_bits (&w, 15, 5);         /* 16 bits per sample */
+  put_bits (&w, (uint32_t)((uint64_t)count >> 32) & 0xf, 4);
+  put_bits (&w, (uint32_t)count, 32);
+  for (i = 0; i < 4; ++i) put_bits (&w, 0, 32); /* no MD5 */
+
+  put_bits (&w, 0x80 | block_vorbis_comment, 8); /* last metadata block */
+  put_bits (&w, comments_size, 24);
+  put_le32 (&w, sizeof vendor - 1);
+  for (i = 0; i < sizeof vendor - 1; ++i) put_bits (&w, (unsigned char)vendor[i], 8);
+  put_le32 (&w, (uint32_t)comment_count);
+  for (i = 0; i < comment_count; ++i)
+    {
+      size_t length = strlen (comments[i]), j;
+      put_le32 (&w, (uint32_t)length);
+      for (j = 0; j < length; ++j) put_bits (&w, (unsigned char)comments[i][j], 8);
+    }
+
+  for (start = 0; start < count; start += BLOCK_SIZE, ++frame)
+    {
+      unsigned n = count - start < BLOCK_SIZE ? (unsigned)(count - start) : BLOCK_SIZE;
+      size_t header = w.size;
+      unsigned j;
+      put_bits (&w, 0xfff8, 16); /* sync, fixed block size */
+      put_bits (&w, n == BLOCK_SIZE ? 12 : 7, 4);
+      put_bits (&w, 0, 4);       /* sample rate from STREAMINFO */
+      put_bits (&w, 0, 4);       /* mono */
+      put_bits (&w, 4, 3);       /* 16 bits */
+      put_bits (&w, 0, 1);
+      put_utf8 (&w, frame);
+      if (n != BLOCK_SIZE) put_bits (&w, n - 1, 16);
+      if (w.failed) break;
+      put_bits (&w, crc8 (w.data + header, w.size - header), 8);
+      for (j = 0; j < n; ++j) x[j] = samples[start + j];
+      put_subframe (&w, x, n, r);
+      align (&w);
+      if (w.failed) break;
+      put_bits (&w, crc16 (w.data + header, w.size - header), 16);
+      frame_size = w.size - header;
+      if (!min_frame_size || frame_size < min_frame_size) min_frame_size = frame_size;
+      if (frame_size > max_frame_size) max_frame_size = frame_size;
+    }
+  free (x);
+  if (w.failed)
+    {
+      free (w.data);
+      return FLAC_ERROR_MEMORY;
+    }
+
+  for (i = 0; i < 3; ++i)
+    {
+      w.data[streaminfo + 4 + i] = (unsigned char)(min_frame_size >> (16 - 8 * i));
+      w.data[streaminfo + 7 + i] = (unsigned char)(max_frame_size >> (16 - 8 * i));
+    }
+  *data = w.data;
+  *size = w.size;
+  return FLAC_OK;
+}
+
+/*
+ * big endian bit reader
+ */
+struct reader
+{
+  unsigned char const * data;
+  size_t size;
+  size_t bit;                   /* position */
+  int failed;
+};
+
+static uint32_t get_bits (struct reader * r, unsigned n) /* n <= 32 */
+{
+  uint32_t value = 0;
+  if (r->bit + n > 8 * r->size)
+    {
+      r->failed = 1;
+      r->bit = 8 * r->size;
+      return 0;
+    }
+  while (n)
+    {
+      unsigned offset = r->bit & 7;
+      unsigned take = 8 - offset < n ? 8 - offset : n;
+      unsigned byte = r->data[r->bit >> 3];
+      value = (value << take) | ((byte >> (8 - offset - take)) & ((1u << take) - 1));
+      r->bit += take;
+      n -= take;
+    }
+  return value;
+}
+
+static int32_t get_signed (struct reader * r, unsigned n)
+{
+  uint32_t value = get_bits (r, n);
+  if (n && n < 32 && value & (1u << (n - 1))) return (int32_t)(value | ~((1u << n) - 1));
+  return (int32_t)value;
+}
+
+static uint32_t get_unary (struct reader * r)
+{
+  uint32_t zeros = 0;
+  while (!r->failed && !get_bits (r, 1)) ++zeros;
+  return zeros;
+}
+
+static uint32_t get_le32 (struct reader * r)
+{
+  uint32_t value = get_bits (r, 8);
+  value |= get_bits (r, 8) << 8;
+  value |= get_bits (r, 8) << 16;
+  return value | get_bits (r, 8) << 24;
+}
+
+static int get_utf8 (struct reader * r)
+{
+  uint32_t first = get_bits (r, 8);
+  unsigned extra = 0;
+  while (extra < 7 && first & (0x80u >> extra)) ++extra;
+  if (1 == extra || extra > 6) return 0; /* stray continuation byte */
+  for (extra = extra ? extra - 1 : 0; extra; --extra)
+    {
+      if (0x80 != (get_bits (r, 8) & 0xc0)) return 0;
+    }
+  return !r->failed;
+}
+
+static int get_residual (struct reader * r, int32_t * x, unsigned n, unsigned order)
+{
+  unsigned method = get_bits (r, 2);
+  unsigned parameter_bits = method ? 5 : 4;
+  unsigned escape = (1u << parameter_bits) - 1;
+  unsigned porder = get_bits (r, 4);
+  unsigned partitions = 1u << porder;
+  unsigned length = n >> porder;
+  unsigned p, i = order;
+  if (method > 1 || (n & (partitions - 1)) || length < order) return FLAC_ERROR_FORMAT;
+  for (p = 0; p < partitions && !r->failed; ++p)
+    {
+      unsigned k = get_bits (r, parameter_bits);
+      unsigned end = (p + 1) * length;
+      if (k == escape)
+        {
+          unsigned bits = get_bits (r, 5);
+          for (; i < end; ++i) x[i] = get_signed (r, bits);
+        }
+      else
+        {
+          for (; i < end && !r->failed; ++i)
+            {
+              uint32_t u = (get_unary (r) << k) | get_bits (r, k);
+              x[i] = (int32_t)(u >> 1) ^ -(int32_t)(u & 1);
+            }
+        }
+    }
+  return r->failed ? FLAC_ERROR_FORMAT : FLAC_OK;
+}
+
+static int get_subframe (struct reader * r, int32_t * x, unsigned n, unsigned bps)
+{
+  unsigned type, wasted = 0, i;
+  if (get_bits (r, 1)) return FLAC_ERROR_FORMAT;
+  type = get_bits (r, 6);
+  if (get_bits (r, 1)) wasted = get_unary (r) + 1;
+  if (wasted >= bps) return FLAC_ERROR_FORMAT;
+  bps -= wasted;
+
+  if (0 == type)
+    {
+      int32_t value = get_signed (r, bps);
+      for (i = 0; i < n; ++i) x[i] = value;
+    }
+  else if (1 == type)
+    {
+      for (i = 0; i < n; ++i) x[i] = get_signed (r, bps);
+    }
+  else if (type >= 8 && type <= 12)
+    {
+      unsigned order = type & 7;
+      int status;
+      if (order > n) return FLAC_ERROR_FORMAT;
+      for (i = 0; i < order; ++i) x[i] = get_signed (r, bps);
+      if ((status = get_residual (r, x, n, order))) return status;
+      for (i = order; i < n; ++i)
+        {
+          switch (order)
+            {
+            case 0: break;
+            case 1: x[i] += x[i-1]; break;
+            case 2: x[i] += 2 * x[i-1] - x[i-2]; break;
+            case 3: x[i] += 3 * x[i-1] - 3 * x[i-2] + x[i-3]; break;
+            default: x[i] += 4 * x[i-1] - 6 * x[i-2] + 4 * x[i-3] - x[i-4]; break;
+            }
+        }
+    }
+  else if (type >= 32)
+    {
+      unsigned order = (type & 31) + 1;
+      int32_t coefficients[32];
+      unsigned precision;
+      int shift, status;
+      if (order > n) return FLAC_ERROR_FORMAT;
+      for (i = 0; i < order; ++i) x[i] = get_signed (r, bps);
+      precision = get_bits (r, 4) + 1;
+      shift = get_signed (r, 5);
+      if (precision > 15 || shift < 0) return FLAC_ERROR_FORMAT;
+      for (i = 0; i < order; ++i) coefficients[i] = get_signed (r, precision);
+      if ((status = get_residual (r, x, n, order))) return status;
+      for (i = order; i < n; ++i)
+        {
+          int64_t sum = 0;
+          unsigned j;
+          for (j = 0; j < order; ++j) sum += (int64_t)coefficients[j] * x[i - 1 - j];
+          x[i] += (int32_t)(sum >> shift);
+        }
+    }
+  else
+    {
+      return FLAC_ERROR_FORMAT;
+    }
+  if (wasted)
+    {
+      for (i = 0; i < n; ++i) x[i] = (int32_t)((uint32_t)x[i] << wasted);
+    }
+  return r->failed ? FLAC_ERROR_FORMAT : FLAC_OK;
+}
+
+static int append (char ** text, size_t * length, unsigned char const * data, size_t size)
+{
+  char * grown = realloc (*text, *length + size + 2);
+  if (!grown) return FLAC_ERROR_MEMORY;
+  memcpy (grown + *length, data, size);
+  *length += size;
+  grown[(*length)++] = '\n';
+  grown[*length] = '\0';
+  *text = grown;
+  return FLAC_OK;
+}
+
+static int get_comments (struct reader * r, size_t end, char ** comments)
+{
+  uint32_t length = get_le32 (r), count, i;
+  size_t text_length = 0;
+  r->bit += 8 * (size_t)length;   /* vendor */
+  count = get_le32 (r);
+  for (i = 0; i < count && !r->failed; ++i)
+    {
+      int status;
+      length = get_le32 (r);
+      if (r->bit / 8 + length > end) return FLAC_ERROR_FORMAT;
+      if ((status = append (comments, &text_length, r->data + r->bit / 8, length))) return status;
+      r->bit += 8 * (size_t)length;
+    }
+  return r->failed || r->bit / 8 > end ? FLAC_ERROR_FORMAT : FLAC_OK;
+}
+
+int flac_decode (unsigned char const * data, size_t size,
+                 int16_t * samples, size_t max_samples, size_t * count,
+                 unsigned * sample_rate, char ** comments)
+{
+  struct reader r = {data, size, 0, 0};
+  unsigned stream_bps = 0, last;
+  int32_t * x = NULL;
+  int status = FLAC_OK;
+
+  *count = 0;
+  *sample_rate = 0;
+  if (comments) *comments = NULL;
+  if (get_bits (&r, 32) != 0x664c6143u) return FLAC_ERROR_FORMAT;
+
+  do
+    {
+      unsigned type;
+      size_t length, end;
+      last = get_bits (&r, 1);
+      type = get_bits (&r, 7);
+      length = get_bits (&r, 24);
+      end = r.bit / 8 + length;
+      if (r.failed || end > size) return FLAC_ERROR_FORMAT;
+      if (block_streaminfo == type)
+        {
+          r.bit += 80;
+          *sample_rate = get_bits (&r, 20);
+          if (get_bits (&r, 3)) return FLAC_ERROR_UNSUPPORTED;
+          stream_bps = get_bits (&r, 5) + 1;
+        }
+      else if (block_vorbis_comment == type && comments)
+        {
+          if ((status = get_comments (&r, end, comments))) goto done;
+        }
+      r.bit = 8 * end;
+    }
+  while (!last);
+
+  if (!(x = malloc (65536 * sizeof (int32_t))))
+    {
+      status = FLAC_ERROR_MEMORY;
+      goto done;
+    }
+
+  while (*count < max_samples && r.bit / 8 + 2 <= size)
+    {
+      size_t header = r.bit / 8;
+      unsigned code, rate_code, bps, n, i, crc;
+      if ((get_bits (&r, 15) << 1) != 0xfff8) break; /* trailing tags or junk */
+      get_bits (&r, 1);          /* blocking strategy */
+      code = get_bits (&r, 4);
+      rate_code = get_bits (&r, 4);
+      if (get_bits (&r, 4))
+        {
+          status = FLAC_ERROR_UNSUPPORTED;
+          break;
+        }
+      switch (get_bits (&r, 3))
+        {
+        case 0: bps = stream_bps; break;
+        case 1: bps = 8; break;
+        case 2: bps = 12; break;
+        case 4: bps = 16; break;
+        case 5: case 6: case 7: bps = 32; break;
+        default: bps = 0; break;
+        }
+      get_bits (&r, 1);
+      if (!get_utf8 (&r) || !code || 15 == rate_code)
+        {
+          status = FLAC_ERROR_FORMAT;
+          break;
+        }
+      if (bps > 16)
+        {
+          status = FLAC_ERROR_UNSUPPORTED;
+          break;
+        }
+      if (bps < 4)
+        {
+          status = FLAC_ERROR_FORMAT;
+          break;
+        }
+      if (1 == code) n = 192;
+      else if (code <= 5) n = 576u << (code - 2);
+      else if (6 == code) n = get_bits (&r, 8) + 1;
+      else if (7 == code) n = get_bits (&r, 16) + 1;
+      else n = 256u << (code - 8);
+      if (12 == rate_code) get_bits (&r, 8);
+      else if (rate_code > 12) get_bits (&r, 16);
+      crc = crc8 (data + header, r.bit / 8 - header);
+      if (r.failed || get_bits (&r, 8) != crc)
+        {
+          status = r.failed ? FLAC_ERROR_FORMAT : FLAC_ERROR_CRC;
+          break;
+        }
+
+      if ((status = get_subframe (&r, x, n, bps))) break;
+      r.bit = (r.bit + 7) & ~(size_t)7;
+      crc = crc16 (data + header, r.bit / 8 - header);
+      if (get_bits (&r, 16) != crc || r.failed)
+        {
+          status = r.failed ? FLAC_ERROR_FORMAT : FLAC_ERROR_CRC;
+          break;
+        }
+
+      for (i = 0; i < n && *count < max_samples; ++i)
+        {
+          samples[(*count)++] = (int16_t)(x[i] * (1 << (16 - bps)));
+        }
+    }
+
+ done:
+  free (x);
+  if (status && comments)
+    {
+      free (*comments);
+      *comments = NULL;
+    }
+  return status;
+}
+
+int flac_read (char const * path, int16_t * samples, int max_samples,
+               int * count, int * sample_rate)
+{
+  FILE * file = fopen (path, "rb");
+  unsigned char * data = NULL;
+  long size;
+  size_t n = 0;
+  unsigned rate = 0;
+  int status = FLAC_ERROR_IO;
+
+  *count = 0;
+  *sample_rate = 0;
+  if (!file) return FLAC_ERROR_IO;
+  if (!fseek (file, 0, SEEK_END) && (size = ftell (file)) > 0 && !fseek (file, 0, SEEK_SET))
+    {
+      if (!(data = malloc ((size_t)size)))
+        {
+          status = FLAC_ERROR_MEMORY;
+        }
+      else if (fread (data, 1, (size_t)size, file) == (size_t)size)
+        {
+          status = flac_decode (data, (size_t)size, samples, max_samples > 0 ? (size_t)max_samples : 0,
+                                &n, &rate, NULL);
+        }
+    }
+  fclose (file);
+  free (data);
+  *count = (int)n;
+  *sample_rate = (int)rate;
+  return status;
+}
+
+char const * flac_error_string (int error)
+{
+  switch (error)
+    {
+    case FLAC_OK: return "no error";
+    case FLAC_ERROR_MEMORY: return "out of memory";
+    case FLAC_ERROR_IO: return "cannot read file";
+    case FLAC_ERROR_FORMAT: return "not a FLAC stream or damaged";
+    case FLAC_ERROR_UNSUPPORTED: return "only single channel FLAC of up to 16 bits is supported";
+    case FLAC_ERROR_CRC: return "checksum mismatch";
+    }
+  return "unknown error";
+}
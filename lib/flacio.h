@@ -0,0 +1,64 @@
+#ifndef FLACIO_H__
+#define FLACIO_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /*
+   * Lossless FLAC coding of mono 16 bit audio, as saved by wsjtx
+   *
+   * The encoder writes a standard FLAC stream: a STREAMINFO and a
+   * VORBIS_COMMENT block followed by frames of 4096 samples, each
+   * coded with the best of the fixed predictors of order 0 to 4 and
+   * partitioned Rice coded residuals. Any FLAC tool can play, check or
+   * convert the files. The decoder reads any single channel FLAC
+   * stream of up to 16 bits per sample, including LPC subframes
+   * written by other encoders.
+   *
+   * Comments are "NAME=value" strings, wsjtx uses the WAV LIST-INFO
+   * ids (ISRC, ISFT, ICRD, ICMT) as names so the metadata of a BWF
+   * file survives conversion.
+   */
+
+  enum
+  {
+    FLAC_OK = 0,
+    FLAC_ERROR_MEMORY = -1,
+    FLAC_ERROR_IO = -2,
+    FLAC_ERROR_FORMAT = -3,       /* not a FLAC stream or truncated */
+    FLAC_ERROR_UNSUPPORTED = -4,  /* several channels or over 16 bits */
+    FLAC_ERROR_CRC = -5
+  };
+
+  /*
+   * encode count samples, on success *data is allocated with malloc()
+   * and belongs to the caller
+   */
+  int flac_encode (int16_t const * samples, size_t count, unsigned sample_rate,
+                   char const * const * comments, size_t comment_count,
+                   unsigned char ** data, size_t * size);
+
+  /*
+   * decode at most max_samples samples, if comments is not NULL
+   * *comments is set to a malloc() allocated string holding the
+   * comments one per line, or NULL if there are none
+   */
+  int flac_decode (unsigned char const * data, size_t size,
+                   int16_t * samples, size_t max_samples, size_t * count,
+                   unsigned * sample_rate, char ** comments);
+
+  /* read at most max_samples samples from a FLAC file, for Fortran */
+  int flac_read (char const * path, int16_t * samples, int max_samples,
+                 int * count, int * sample_rate);
+
+  char const * flac_error_string (int error);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -12,6 +12,7 @@ subroutine encode240_74(message,codeword)
    logical first
    data first/.true./
    save first,gen
+!$omp threadprivate(first,gen)
 
    if( first ) then ! fill the generator matrix
       gen=0
@@ -29,6 +29,7 @@ subroutine fastosd240_74(llr,k,apmask,ndeep,message74,cw,nhardmin,dmin)
    logical first
    data first/.true./,ksave/64/
    save first,ksave
+!$omp threadprivate(gen,first,ksave)   ! gen depends on k, which differs between threads
 
    allocate( genmrb(k,N), g2(N,k) )
    allocate( temp(k), temprow(n), m0(k), me(k), mi(k) )
@@ -23,9 +23,11 @@ subroutine get_fst4_bitmetrics(cd,nss,bitmetrics,s4,nsync_qual,badsync)
    data first/.true./,nss0/-1/
    save first,one,nss0
 
-   if(nss.ne.nss0 .and. allocated(ci)) deallocate(ci)
-
+! Always taken: its implied flushes make the tables built by one thread
+! visible to the others, testing first outside it would not.
+!$omp critical(fst4_bitmetrics_init)
    if(first .or. nss.ne.nss0) then
+      if(allocated(ci)) deallocate(ci)
       allocate(ci(nss,0:3))
       one=.false.
       do i=0,65535
@@ -43,8 +45,10 @@ subroutine get_fst4_bitmetrics(cd,nss,bitmetrics,s4,nsync_qual,badsync)
             phi=mod(phi+dp,twopi)
          enddo
       enddo
+      nss0=nss
       first=.false.
    endif
+!$omp end critical(fst4_bitmetrics_init)
 
    do k=1,NN
       i1=(k-1)*NSS
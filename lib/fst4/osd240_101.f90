@@ -29,6 +29,7 @@ subroutine osd240_101(llr,k,apmask,ndeep,message101,cw,nhardmin,dmin)
    logical first,reset
    data first/.true./
    save first
+!$omp threadprivate(gen,first)
 
    allocate( genmrb(k,N), g2(N,k) )
    allocate( temp(k), m0(k), me(k), mi(k), misub(k), e2sub(N-k), e2(N-k), ui(N-k) )
@@ -332,7 +333,8 @@ subroutine boxit101(reset,e2,ntau,npindex,i1,i2)
    integer*1 e2(1:ntau)
    integer   indexes(5000,2),fp(0:525000),np(5000)
    logical reset
-   common/boxes/indexes,fp,np
+   common/boxes101/indexes,fp,np
+!$omp threadprivate(/boxes101/)
 
    if(reset) then
       patterns=-1
@@ -369,8 +371,10 @@ subroutine fetchit101(reset,e2,ntau,i1,i2)
    integer   lastpat
    integer*1 e2(ntau)
    logical reset
-   common/boxes/indexes,fp,np
+   common/boxes101/indexes,fp,np
+!$omp threadprivate(/boxes101/)
    save lastpat,inext
+!$omp threadprivate(lastpat,inext)
 
    if(reset) then
       lastpat=-1
@@ -36,7 +36,9 @@ contains
       use timer_module, only: timer
       use packjt77
       use, intrinsic :: iso_c_binding
+!$    use omp_lib
       include 'fst4/fst4_params.f90'
+      include 'timer_common.inc'
       parameter (MAXCAND=100,MAXWCALLS=100)
       class(fst4_decoder), intent(inout) :: this
       procedure(fst4_decode_callback) :: callback
@@ -46,9 +48,9 @@ contains
       character*77 c77
       character*12 mycall,hiscall
       character*12 mycall0,hiscall0
-      complex, allocatable :: c2(:)
       complex, allocatable :: cframe(:)
       complex, allocatable :: c_bigfft(:)          !Complex waveform
+      complex, allocatable, save :: c2t(:,:)       !Downsampled signal, one per thread
       real llr(240),llrs(240,4)
       real candidates0(200,5),candidates(200,5)
       real bitmetrics(320,4)
@@ -70,6 +72,16 @@ contains
       logical new_callsign,plotspec_exists,wcalls_exists,do_k50_decode
       logical decdata_exists
       logical lprinthash22
+      logical near_nfqso
+
+      type candidate_decode                        !First decode of a candidate
+         logical decoded
+         character*37 msg
+         integer itone(NN)
+         integer iaptype,itry,ijitter,ntype,keff,nsync_qual,nharderrors,nhp
+         real dmin,hd,xsnr,xdt
+      end type candidate_decode
+      type(candidate_decode) cdec(200)
 
       integer*2 iwave(30*60*12000)
 
@@ -228,8 +240,6 @@ contains
       nh1=nfft1/2
 
       allocate( c_bigfft(0:nfft1/2) )
-      allocate( c2(0:nfft2-1) )
-      allocate( cframe(0:160*nss-1) )
 
       jittermax=2
       do_k50_decode=.false.
@@ -295,24 +305,45 @@ contains
       ndecodes=0
       decodes=' '
       new_callsign=.false.
+      near_nfqso=.false.
+      nthreads=1
+!$    nthreads=omp_get_max_threads()
+      if(allocated(c2t)) then
+         if(size(c2t,1).ne.nfft2 .or. size(c2t,2).lt.nthreads) deallocate(c2t)
+      endif
+      if(.not.allocated(c2t)) allocate(c2t(0:nfft2-1,0:nthreads-1))
+      if(iwspr.eq.1) nblock=4        ! 50-bit msgs, no ap decoding
       do inb=0,inb1,inb2
          if(nb.lt.0) npct=inb ! we are looping over blanker settings
+         call timer('blanker ',0)
          call blanker(iwave,nfft1,ndropmax,npct,c_bigfft)
+         call timer('blanker ',1)
 
 ! The big fft is done once and is used for calculating the smoothed spectrum
 ! and also for downconverting/downsampling each candidate.
+         call timer('bigfft  ',0)
          call four2a(c_bigfft,nfft1,1,-1,0)         !r2c
+         call timer('bigfft  ',1)
          nhicoh=1
          nsyncoh=8
          minsync=1.20
          if(ntrperiod.eq.15) minsync=1.15
 
 ! Get first approximation of candidate frequencies
+         call timer('getcand ',0)
          call get_candidates_fst4(c_bigfft,nfft1,nsps,hmod,fs,fa,fb,nfa,nfb,  &
             minsync,ncand,candidates0)
-         isbest=0
-         fc2=0.
+         call timer('getcand ',1)
+
+! From here on c_bigfft is only read. Each thread downsamples into its
+! own column of c2t, which keeps its FFTW plan from one call to the next.
+         call timer('fst4sync',0)
+!$omp parallel do schedule(dynamic) default(shared)                       &
+!$omp& private(icand,ith,fc0,detmet,sbest,fcbest,isbest)                    &
+!$omp& copyin(/timer_private/) if(ncand.gt.1)
          do icand=1,ncand
+            ith=0
+!$          ith=omp_get_thread_num()
             fc0=candidates0(icand,1)
             if(iwspr.eq.0 .and. nb.lt.0 .and. npct.ne.0 .and.            &
                abs(fc0-(nfqso+1.5*baud)).gt.ntol) cycle  ! blanker loop only near nfqso
@@ -320,21 +351,22 @@ contains
 
 ! Downconvert and downsample a slice of the spectrum centered on the
 ! rough estimate of the candidates frequency.
-! Output array c2 is complex baseband sampled at 12000/ndown Sa/sec.
-! The size of the downsampled c2 array is nfft2=nfft1/ndown
+! Output array c2t(:,ith) is complex baseband sampled at 12000/ndown Sa/sec.
+! The size of the downsampled array is nfft2=nfft1/ndown
             call timer('dwnsmpl ',0)
-            call fst4_downsample(c_bigfft,nfft1,ndown,fc0,sigbw,c2)
+            call fst4_downsample(c_bigfft,nfft1,ndown,fc0,sigbw,c2t(:,ith))
             call timer('dwnsmpl ',1)
 
             call timer('sync240 ',0)
-            call fst4_sync_search(c2,nfft2,hmod,fs2,nss,ntrperiod,nsyncoh,emedelay,sbest,fcbest,isbest)
+            isbest=0
+            call fst4_sync_search(c2t(:,ith),nfft2,hmod,fs2,nss,ntrperiod,nsyncoh,emedelay,sbest,fcbest,isbest)
             call timer('sync240 ',1)
 
-            fc_synced = fc0 + fcbest
-            dt_synced = (isbest-fs2)*dt2  !nominal dt is 1 second so frame starts at sample fs2
-            candidates0(icand,3)=fc_synced
+            candidates0(icand,3)=fc0 + fcbest
             candidates0(icand,4)=isbest
          enddo
+!$omp end parallel do
+         call timer('fst4sync',1)
 
 ! remove duplicate candidates
          do icand=1,ncand
@@ -382,7 +414,22 @@ contains
             candidates=candidates0
          endif
 
-         xsnr=0.
+! Try to decode the candidates in parallel. The first decode found for
+! each candidate is kept in cdec(); they are checked for duplicates and
+! reported below in candidate order, just as a serial search would.
+         call timer('fst4cand',0)
+         cdec(1:ncand)%decoded=.false.
+!$omp parallel default(shared)                                             &
+!$omp& private(icand,ith,sync,fc_synced,isbest,xdt,ijitter,ioffset,is0,iend, &
+!$omp& cframe,bitmetrics,s4,nsync_qual,badsync,il,llrs,llr,apmag,ntmax,       &
+!$omp& apmask,itry,iaptype,dmin,nharderrors,unpk77_success,maxosd,Keff,       &
+!$omp& norder,message101,message74,cw,ntype,c77,msg,wpart,n22tmp,i1,i2,       &
+!$omp& ifound,i,itone,xsig,base,snr_calfac,arg,xsnr,hdec)                    &
+!$omp& copyin(/timer_private/) if(ncand.gt.1)
+         allocate(cframe(0:160*nss-1))
+         ith=0
+!$       ith=omp_get_thread_num()
+!$omp do schedule(dynamic)
          do icand=1,ncand
             sync=candidates(icand,2)
             fc_synced=candidates(icand,3)
@@ -390,17 +437,17 @@ contains
             xdt=(isbest-nspsec)/fs2
             if(ntrperiod.eq.15) xdt=(isbest-real(nspsec)/2.0)/fs2
             call timer('dwnsmpl ',0)
-            call fst4_downsample(c_bigfft,nfft1,ndown,fc_synced,sigbw,c2)
+            call fst4_downsample(c_bigfft,nfft1,ndown,fc_synced,sigbw,c2t(:,ith))
             call timer('dwnsmpl ',1)
 
-            do ijitter=0,jittermax
+            jitter: do ijitter=0,jittermax
                if(ijitter.eq.0) ioffset=0
                if(ijitter.eq.1) ioffset=1
                if(ijitter.eq.2) ioffset=-1
                is0=isbest+ioffset
                iend=is0+160*nss-1
                if( is0.lt.0 .or. iend.gt.(nfft2-1) ) cycle
-               cframe=c2(is0:iend)
+               cframe=c2t(is0:iend,ith)
                bitmetrics=0
                call timer('bitmetrc',0)
                call get_fst4_bitmetrics(cframe,nss,bitmetrics, &
@@ -422,7 +469,6 @@ contains
                apmask=0
 
                if(iwspr.eq.1) then ! 50-bit msgs, no ap decoding
-                  nblock=4
                   ntmax=nblock
                endif
 
@@ -486,7 +532,9 @@ contains
                         cycle
                      endif
                      write(c77,'(77i1)') mod(message101(1:77)+rvec,2)
+!$omp critical(fst4_unpack77)
                      call unpack77(c77,1,msg,unpk77_success)
+!$omp end critical(fst4_unpack77)
                   elseif(iwspr.eq.1) then
 ! Try decoding with Keff=66
                      maxosd=2
@@ -503,7 +551,9 @@ contains
                      endif
                      write(c77,'(50i1)') message74(1:50)
                      c77(51:77)='000000000000000000000110000'
+!$omp critical(fst4_unpack77)
                      call unpack77(c77,1,msg,unpk77_success)
+!$omp end critical(fst4_unpack77)
                      if(lprinthash22 .and. unpk77_success .and. index(msg,'<...>').gt.0) then
                         read(c77,'(b22.22)') n22tmp
                         i1=index(msg,' ')
@@ -518,6 +568,7 @@ contains
                         wpart=trim(msg(1:i2))
 ! Only save callsigns/grids from type 1 messages
                         if(index(wpart,'/').eq.0 .and. index(wpart,'<').eq.0) then
+!$omp critical(fst4_wcalls)
                            ifound=0
                            do i=1,nwcalls
                               if(index(wcalls(i),wpart).ne.0) ifound=1
@@ -533,6 +584,7 @@ contains
                                  wcalls(nwcalls)=wpart
                               endif
                            endif
+!$omp end critical(fst4_wcalls)
                         endif
                      endif
 3465                 continue
@@ -553,42 +605,30 @@ contains
                         endif
                         write(c77,'(50i1)') message74(1:50)
                         c77(51:77)='000000000000000000000110000'
+!$omp critical(fst4_unpack77)
                         call unpack77(c77,1,msg,unpk77_success)
+!$omp end critical(fst4_unpack77)
 ! No CRC in this mode, so only accept the decode if call/grid have been seen before
                         if(unpk77_success) then
                            unpk77_success=.false.
+!$omp critical(fst4_wcalls)
                            do i=1,nwcalls
                               if(index(msg,trim(wcalls(i))).gt.0) then
                                  unpk77_success=.true.
                               endif
                            enddo
+!$omp end critical(fst4_wcalls)
                         endif
                      endif
 
                   endif
 
                   if(nharderrors .ge.0 .and. unpk77_success) then
-                     idupe=0
-                     do i=1,ndecodes
-                        if(decodes(i).eq.msg) idupe=1
-                     enddo
-                     if(idupe.eq.1) goto 800
-                     ndecodes=ndecodes+1
-                     decodes(ndecodes)=msg
-
                      if(iwspr.eq.0) then
                         call get_fst4_tones_from_bits(message101,itone,0)
                      else
                         call get_fst4_tones_from_bits(message74,itone,1)
                      endif
-                     inquire(file='plotspec',exist=plotspec_exists)
-                     fmid=-999.0
-                     call timer('dopsprd ',0)
-                     if(plotspec_exists) then
-                        call dopspread(itone,iwave,nsps,nmax,ndown,hmod,  &
-                           isbest,fc_synced,fmid,w50)
-                     endif
-                     call timer('dopsprd ',1)
                      xsig=0
                      do i=1,NN
                         xsig=xsig+s4(itone(i),i)
@@ -618,29 +658,84 @@ contains
                      else
                         xsnr=-99.9
                      endif
-                     nsnr=nint(xsnr)
-                     qual=0.0
-                     fsig=fc_synced - 1.5*baud
-                     inquire(file=trim(data_dir)//'/decdata',exist=decdata_exists)
-                     if(decdata_exists) then
-                        hdec=0
-                        where(llrs(:,1).ge.0.0) hdec=1
-                        nhp=count(hdec.ne.cw) ! # hard errors wrt N=1 soft symbols
-                        hd=sum(ieor(hdec,cw)*abs(llrs(:,1))) ! weighted distance wrt N=1 symbols
-                        open(21,file=trim(data_dir)//'/fst4_decodes.dat',status='unknown',position='append')
-                        write(21,3021) nutc,icand,itry,nsyncoh,iaptype,  &
-                           ijitter,npct,ntype,Keff,nsync_qual,nharderrors,dmin,nhp,hd,  &
-                           sync,xsnr,xdt,fsig,w50,trim(msg)
-3021                    format(i6.6,i4,6i3,3i4,f6.1,i4,f6.1,f9.2,f6.1,f6.2,f7.1,f7.3,1x,a)
-                        close(21)
-                     endif
-                     call this%callback(nutc,smax1,nsnr,xdt,fsig,msg,    &
-                        iaptype,qual,ntrperiod,fmid,w50)
-                     goto 800
+                     hdec=0
+                     where(llrs(:,1).ge.0.0) hdec=1
+                     cdec(icand)%decoded=.true.
+                     cdec(icand)%msg=msg
+                     cdec(icand)%itone=itone
+                     cdec(icand)%iaptype=iaptype
+                     cdec(icand)%itry=itry
+                     cdec(icand)%ijitter=ijitter
+                     cdec(icand)%ntype=ntype
+                     cdec(icand)%keff=Keff
+                     cdec(icand)%nsync_qual=nsync_qual
+                     cdec(icand)%nharderrors=nharderrors
+                     cdec(icand)%nhp=count(hdec.ne.cw) ! # hard errors wrt N=1 soft symbols
+                     cdec(icand)%hd=sum(ieor(hdec,cw)*abs(llrs(:,1))) ! weighted distance wrt N=1 symbols
+                     cdec(icand)%dmin=dmin
+                     cdec(icand)%xsnr=xsnr
+                     cdec(icand)%xdt=xdt
+                     exit jitter
                   endif
                enddo  ! metrics
-            enddo  ! istart jitter
-800      enddo !candidate list
+            enddo jitter
+         enddo !candidate list
+!$omp end do
+         deallocate(cframe)
+!$omp end parallel
+         call timer('fst4cand',1)
+
+         do icand=1,ncand
+            if(.not.cdec(icand)%decoded) cycle
+            if(abs(candidates(icand,3)-(nfqso+1.5*baud)).le.ntol) near_nfqso=.true.
+            msg=cdec(icand)%msg
+            idupe=0
+            do i=1,ndecodes
+               if(decodes(i).eq.msg) idupe=1
+            enddo
+            if(idupe.eq.1) cycle
+            ndecodes=ndecodes+1
+            decodes(ndecodes)=msg
+
+            sync=candidates(icand,2)
+            fc_synced=candidates(icand,3)
+            isbest=nint(candidates(icand,4))
+            inquire(file='plotspec',exist=plotspec_exists)
+            fmid=-999.0
+            call timer('dopsprd ',0)
+            if(plotspec_exists) then
+               call dopspread(cdec(icand)%itone,iwave,nsps,nmax,ndown,hmod,  &
+                  isbest,fc_synced,fmid,w50)
+            endif
+            call timer('dopsprd ',1)
+            xsnr=cdec(icand)%xsnr
+            nsnr=nint(xsnr)
+            xdt=cdec(icand)%xdt
+            iaptype=cdec(icand)%iaptype
+            qual=0.0
+            fsig=fc_synced - 1.5*baud
+            inquire(file=trim(data_dir)//'/decdata',exist=decdata_exists)
+            if(decdata_exists) then
+               open(21,file=trim(data_dir)//'/fst4_decodes.dat',status='unknown',position='append')
+               write(21,3021) nutc,icand,cdec(icand)%itry,nsyncoh,iaptype,  &
+                  cdec(icand)%ijitter,npct,cdec(icand)%ntype,cdec(icand)%keff, &
+                  cdec(icand)%nsync_qual,cdec(icand)%nharderrors,cdec(icand)%dmin, &
+                  cdec(icand)%nhp,cdec(icand)%hd,sync,xsnr,xdt,fsig,w50,trim(msg)
+3021           format(i6.6,i4,6i3,3i4,f6.1,i4,f6.1,f9.2,f6.1,f6.2,f7.1,f7.3,1x,a)
+               close(21)
+            endif
+            call this%callback(nutc,smax1,nsnr,xdt,fsig,msg,    &
+               iaptype,qual,ntrperiod,fmid,w50)
+         enddo
+
+! Skip the remaining blanker levels once they have nothing left to find.
+! In FST4 they only look near nfqso, so a decode there ends the search.
+! In FST4W they stop when every candidate has decoded.
+         if(nb.lt.0) then
+            if(iwspr.eq.0 .and. near_nfqso) exit
+            if(iwspr.eq.1 .and. ncand.gt.0 .and.                           &
+               count(cdec(1:ncand)%decoded).eq.ncand) exit
+         endif
       enddo ! noise blanker loop
 
       if(new_callsign .and. do_k50_decode) then ! re-write the fst4w_calls.txt file
@@ -671,6 +766,7 @@ contains
       data isyncword2/2,3,1,0,3,2,0,1/
       data f0save/-99.9/,nss0/-1/,ntr0/-1/
       save twopi,dt,fac,f0save,nss0,ntr0
+!$omp threadprivate(/sync240com/,twopi,dt,fac,f0save,nss0,ntr0)
 
       p(z1)=(real(z1*fac)**2 + aimag(z1*fac)**2)**0.5     !Compute power
 
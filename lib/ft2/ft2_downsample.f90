@@ -1,16 +1,20 @@
-subroutine ft2_downsample(dd,newdata,f0,c)
+subroutine ft2_downsample(dd,newdata,f0,c,cx)
+
+! The full-length spectrum cx belongs to the caller: it is computed when
+! newdata is set and reused for later candidates from the same dd.
 
    include 'ft2_params.f90'
    parameter (NFFT2=NMAX/NDOWN)
    real dd(NMAX)
    complex c(0:NMAX/NDOWN-1)
    complex c1(0:NFFT2-1)
-   complex cx(0:NMAX/2)
+   complex cx(0:NMAX/2), cx0(0:NMAX/2)
    real x(NMAX), window(0:NFFT2-1)
-   equivalence (x,cx)
+   equivalence (x,cx0)
    logical first, newdata
    data first/.true./
-   save first,window,x
+   save first,window
+!$omp threadprivate(first,window)
 
    df=12000.0/NMAX
    baud=12000.0/NSPS
@@ -31,7 +35,8 @@ subroutine ft2_downsample(dd,newdata,f0,c)
 
    if(newdata) then
       x=dd
-      call four2a(cx,NMAX,1,-1,0)             !r2c FFT to freq domain
+      call four2a(cx0,NMAX,1,-1,0)            !r2c FFT to freq domain
+      cx=cx0
    endif
    i0=nint(f0/df)
    c1=0.
@@ -6,6 +6,11 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
 ! Improvements over v1:
 !  - AP type 4: hiscall+mycall (61 AP bits)
 !  - Soft AP injection (weighted by confidence, not hard +/-1)
+!
+! Reentrant, so async windows may be decoded on several threads at
+! once: saved tables here and in the routines called are per thread,
+! and the packjt77 call and hash tables are used only inside
+! critical(packjt77).
 
   use packjt77
 
@@ -28,6 +33,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
   real dd(NMAX)
   real candidate(2,MAXCAND), savg(NH1), sbase(NH1)
   complex cd2(0:NDMAX-1), cb(0:NDMAX-1), cd(0:NN*NSS-1)
+  complex cxbig(0:NMAX/2)
   complex ctwk(2*NSS), ctwk2(2*NSS,-16:16)
   real bitmetrics(2*NN,3)
   real llr(2*ND), llra(2*ND), llrb(2*ND), llrc(2*ND)
@@ -61,6 +67,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
      0,1,0,1,0,1,1,0,1,1,1,1,1,0,0,0,1,0,1/
   data first/.true./
   save first, ctwk2
+!$omp threadprivate(first, ctwk2)
 
   nout = 0
   outlines = ' '
@@ -77,10 +84,6 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
     first = .false.
   endif
 
-! Initialize packjt77 context
-  dxcall13 = hiscall
-  mycall13 = mycall
-
   ndepth0 = iand(ndepth, 7)
   doosd = ndepth0.ge.3
   dd = iwave
@@ -98,6 +101,10 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
   mmycall = 0
   mhiscall = 0
 
+!$omp critical(packjt77)
+  dxcall13 = hiscall
+  mycall13 = mycall
+
 ! Pack CQ bit pattern
   apmsg = 'CQ K1JT FN20'
   nap_i3 = -1; nap_n3 = -1
@@ -131,6 +138,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
       apmask_hiscall(1:29) = 1
     endif
   endif
+!$omp end critical(packjt77)
 
 ! ============================================
 ! PHASE 1: Fast Costas Sync Scan
@@ -145,7 +153,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
     f0 = candidate(1, icand)
     snr0 = candidate(2, icand) - 1.0
 
-    call ft2_downsample(dd, dobigfft, f0, cd2)
+    call ft2_downsample(dd, dobigfft, f0, cd2, cxbig)
     if(dobigfft) dobigfft = .false.
 
     sum2 = sum(cd2*conjg(cd2))/(real(NMAX)/real(NDOWN))
@@ -188,7 +196,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
     idf0 = hit_idf(ihit)
     snr0 = hit_snr(ihit)
 
-    call ft2_downsample(dd, .false., f0, cd2)
+    call ft2_downsample(dd, .false., f0, cd2, cxbig)
     sum2 = sum(cd2*conjg(cd2))/(real(NMAX)/real(NDOWN))
     if(sum2.gt.0.0) cd2 = cd2/sqrt(sum2)
 
@@ -214,7 +222,7 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
     f1 = f0 + real(idfbest)
     if(f1.le.10.0 .or. f1.ge.4990.0) cycle
 
-    call ft2_downsample(dd, .false., f1, cb)
+    call ft2_downsample(dd, .false., f1, cb, cxbig)
     sum2 = sum(abs(cb)**2)/(real(NSS)*NN)
     if(sum2.gt.0.0) cb = cb/sqrt(sum2)
 
@@ -395,7 +403,11 @@ subroutine ft2_triggered_decode(iwave, nqsoprogress, nfqso, nfa, nfb, &
       if(nharderror.ge.0) then
         message77 = mod(message77 + rvec, 2)
         write(c77, '(77i1)') message77(1:77)
+!$omp critical(packjt77)
+        dxcall13 = hiscall
+        mycall13 = mycall
         call unpack77(c77, 1, message, unpk77_success)
+!$omp end critical(packjt77)
         if(.not.unpk77_success) cycle
 
 ! Check duplicate
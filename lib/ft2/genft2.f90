@@ -48,8 +48,10 @@ subroutine genft2(msg0,ichk,msgsent,msgbits,i4tone)
 
   i3=-1
   n3=-1
+!$omp critical(packjt77)
   call pack77(message,i3,n3,c77)
   call unpack77(c77,0,msgsent,unpk77_success) !Unpack to get msgsent
+!$omp end critical(packjt77)
 
   if(ichk.eq.1) go to 999
   read(c77,'(77i1)',err=1) msgbits
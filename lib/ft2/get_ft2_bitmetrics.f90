@@ -60,6 +60,7 @@ subroutine get_ft2_bitmetrics(cd,bitmetrics,badsync)
    data graymap/0,1,3,2/
    data first/.true./
    save first,one
+!$omp threadprivate(first,one)
 
    if(first) then
       one=.false.
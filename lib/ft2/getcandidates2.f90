@@ -14,6 +14,7 @@ subroutine getcandidates2(dd,fa,fb,syncmin,nfqso,maxcand,savg,candidate,   &
   logical first
   data first/.true./
   save first,window
+!$omp threadprivate(first,window)
 
   if(first) then
     first=.false.
@@ -11,13 +11,18 @@ subroutine subtractft2(dd,itone,f0,dt)
 
   parameter (NMAX=45000,NSPS=288,NFFT=NMAX,NFILT=700)
   parameter (NFRAME=(103+2)*NSPS)
-  real*4  dd(NMAX), window(-NFILT/2:NFILT/2), xjunk
-  complex cref,camp,cfilt,cw
+  real*4  dd(NMAX), window(-NFILT/2:NFILT/2)
+  real, allocatable :: xjunk(:)
+  complex, allocatable :: cref(:),camp(:),cfilt(:)
+  complex cw(NMAX)
   integer itone(103)
   logical first
   data first/.true./
-  common/heap2/cref(NFRAME),camp(NMAX),cfilt(NMAX),cw(NMAX),xjunk(NFRAME)
-  save first
+  save first,cw
+
+! Work arrays are per call so that concurrent decodes can subtract
+! independently; only the filter response cw is shared.
+  allocate(cref(NFRAME),camp(NMAX),cfilt(NMAX),xjunk(NFRAME))
 
   nstart=dt*12000+1-NSPS
   nsym=103
@@ -17,6 +17,7 @@ subroutine sync2d(cd0,i0,ctwk,itwk,sync)
   data icos4d/3,2,0,1/
   data first/.true./
   save first,twopi,csynca,csyncb,csyncc,csyncd,fac
+!$omp threadprivate(first,twopi,csynca,csyncb,csyncc,csyncd,fac)
 
   p(z1)=(real(z1*fac)**2 + aimag(z1*fac)**2)**0.5          !Statement function for power
 
@@ -1,16 +1,23 @@
 module ft2_decode
 
-! Multi-period averaging buffers (module-level, persist across calls)
    integer, parameter :: NN_AVG=103     !NN from ft2_params: NS(16)+ND(87)
-   real, save :: bm_avg(2*NN_AVG,3)    !Accumulated bitmetrics (EMA)
-   integer, save :: navg_ft2 = 0       !Number of periods accumulated
-   real, save :: f_avg = 0.0           !Frequency of averaged signal
-   real, save :: dt_avg = 0.0          !DT of averaged signal
+   integer, parameter :: ND_AP=87       !ND from ft2_params
 
+! Everything that must persist from one period to the next lives in the
+! decoder object rather than in module or SAVEd variables, so separate
+! instances (main decoder, async window, ...) do not disturb each other.
    type :: ft2_decoder
       procedure(ft2_decode_callback), pointer :: callback
+      integer :: apbits(2*ND_AP)=0         !AP bits for mycall0/hiscall0
+      character(len=12) :: mycall0=''
+      character(len=12) :: hiscall0=''
+      real :: bm_avg(2*NN_AVG,3)=0.0      !Accumulated bitmetrics (EMA)
+      integer :: navg_ft2=0               !Number of periods accumulated
+      real :: f_avg=0.0                   !Frequency of averaged signal
+      real :: dt_avg=0.0                  !DT of averaged signal
    contains
       procedure :: decode
+      procedure :: clear_average
    end type ft2_decoder
 
    abstract interface
@@ -44,12 +51,12 @@ contains
       character*37 decodes(100)
       character*17 cdatetime0
       character*12 mycall,hiscall
-      character*12 mycall0,hiscall0
       character*6 hhmmss
 
       complex cd2(0:NDMAX-1)                  !Complex waveform
       complex cb(0:NDMAX-1)
       complex cd(0:NN*NSS-1)                       !Complex waveform
+      complex cxbig(0:NMAX/2)                 !Spectrum of dd for ft2_downsample
       complex ctwk(2*NSS),ctwk2(2*NSS,-16:16)
 
       real a(5)
@@ -59,7 +66,6 @@ contains
       real candidate(2,MAXCAND)
       real savg(NH1),sbase(NH1)
 
-      integer apbits(2*ND)
       integer apmy_ru(28),aphis_fd(28)
       integer*2 iwave(NMAX)                 !Raw received data
       integer*1 message77(77),rvec(77),apmask(2*ND),cw(2*ND)
@@ -97,8 +103,7 @@ contains
       data rvec/0,1,0,0,1,0,1,0,0,1,0,1,1,1,1,0,1,0,0,0,1,0,0,1,1,0,1,1,0, &
          1,0,0,1,0,1,1,0,0,0,0,1,0,0,0,1,0,1,0,0,1,1,1,1,0,0,1,0,1, &
          0,1,0,1,0,1,1,0,1,1,1,1,1,0,0,0,1,0,1/
-      save fs,dt,tt,txt,twopi,h,first,apbits,nappasses,naptypes, &
-         mycall0,hiscall0,ctwk2
+      save fs,dt,tt,txt,twopi,h,first,nappasses,naptypes,ctwk2
 
       this%callback => callback
       hhmmss=cdatetime0(8:13)
@@ -154,8 +159,6 @@ contains
          naptypes(4,1:4)=(/3,4,5,6/) ! Tx4 — aggiunto RRR(4),73(5) come FT8
          naptypes(5,1:4)=(/3,1,2,0/) ! Tx5
 
-         mycall0=''
-         hiscall0=''
          first=.false.
       endif
 
@@ -163,22 +166,22 @@ contains
       if(l1.ne.0) mycall(l1:)=" "
       l1=index(hiscall,char(0))
       if(l1.ne.0) hiscall(l1:)=" "
-      if(mycall.ne.mycall0 .or. hiscall.ne.hiscall0) then
-         apbits=0
-         apbits(1)=99
-         apbits(30)=99
+      if(mycall.ne.this%mycall0 .or. hiscall.ne.this%hiscall0) then
+         this%apbits=0
+         this%apbits(1)=99
+         this%apbits(30)=99
          apmy_ru=0
          aphis_fd=0
 
          if(len(trim(mycall)) .lt. 3) go to 10
 
          nohiscall=.false.
-         hiscall0=hiscall
-         if(len(trim(hiscall0)).lt.3) then
-            hiscall0=mycall  ! use mycall for dummy hiscall - mycall won't be hashed.
+         this%hiscall0=hiscall
+         if(len(trim(this%hiscall0)).lt.3) then
+            this%hiscall0=mycall  ! use mycall for dummy hiscall - mycall won't be hashed.
             nohiscall=.true.
          endif
-         message=trim(mycall)//' '//trim(hiscall0)//' RR73'
+         message=trim(mycall)//' '//trim(this%hiscall0)//' RR73'
          i3=-1
          n3=-1
          call pack77(message,i3,n3,c77)
@@ -189,12 +192,12 @@ contains
          aphis_fd=2*mod(message77(30:57)+rvec(29:56),2)-1
          message77=mod(message77+rvec,2)
          call encode174_91(message77,cw)
-         apbits=2*cw-1
-         if(nohiscall) apbits(30)=99
+         this%apbits=2*cw-1
+         if(nohiscall) this%apbits(30)=99
 
 10       continue
-         mycall0=mycall
-         hiscall0=hiscall
+         this%mycall0=mycall
+         this%hiscall0=hiscall
       endif
       ndecodes=0
       decodes=' '
@@ -260,7 +263,7 @@ contains
             f0=candidate(1,icand)
             snr=candidate(2,icand)-1.0
             call timer('ft2_down',0)
-            call ft2_downsample(dd,dobigfft,f0,cd2)  !Downsample to 32 Sam/Sym
+            call ft2_downsample(dd,dobigfft,f0,cd2,cxbig)  !Downsample to 32 Sam/Sym
             call timer('ft2_down',1)
             if(dobigfft) dobigfft=.false.
             sum2=sum(cd2*conjg(cd2))/(real(NMAX)/real(NDOWN))
@@ -320,7 +323,7 @@ contains
                f1=f0+real(idfbest)
                if( f1.le.10.0 .or. f1.ge.4990.0 ) cycle
                call timer('ft2down ',0)
-               call ft2_downsample(dd,dobigfft,f1,cb) !Final downsample, corrected f0
+               call ft2_downsample(dd,dobigfft,f1,cb,cxbig) !Final downsample, corrected f0
                call timer('ft2down ',1)
                sum2=sum(abs(cb)**2)/(real(NSS)*NN)
                if(sum2.gt.0.0) cb=cb/sqrt(sum2)
@@ -420,8 +423,8 @@ contains
 ! Conditions that cause us to bail out of AP decoding
                      napwid=75
                      if(ncontest.le.5 .and. iaptype.ge.3 .and. (abs(f1-nfqso).gt.napwid) ) cycle
-                     if(iaptype.ge.2 .and. apbits(1).gt.1) cycle  ! No, or nonstandard, mycall
-                     if(iaptype.ge.3 .and. apbits(30).gt.1) cycle ! No, or nonstandard, dxcall
+                     if(iaptype.ge.2 .and. this%apbits(1).gt.1) cycle  ! No, or nonstandard, mycall
+                     if(iaptype.ge.3 .and. this%apbits(30).gt.1) cycle ! No, or nonstandard, dxcall
 
                      if(iaptype.eq.1) then  ! CQ or CQ TEST or CQ FD or CQ RU or CQ WW
                         apmask=0
@@ -438,13 +441,13 @@ contains
                         apmask=0
                         if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.5) then
                            apmask(1:29)=1
-                           llrd(1:29)=apmag*apbits(1:29)
+                           llrd(1:29)=apmag*this%apbits(1:29)
                         else if(ncontest.eq.2) then
                            apmask(1:28)=1
-                           llrd(1:28)=apmag*apbits(1:28)
+                           llrd(1:28)=apmag*this%apbits(1:28)
                         else if(ncontest.eq.3) then
                            apmask(1:28)=1
-                           llrd(1:28)=apmag*apbits(1:28)
+                           llrd(1:28)=apmag*this%apbits(1:28)
                         else if(ncontest.eq.4) then
                            apmask(2:29)=1
                            llrd(2:29)=apmag*apmy_ru(1:28)
@@ -455,15 +458,15 @@ contains
                         apmask=0
                         if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.2.or.ncontest.eq.5) then
                            apmask(1:58)=1
-                           llrd(1:58)=apmag*apbits(1:58)
+                           llrd(1:58)=apmag*this%apbits(1:58)
                         else if(ncontest.eq.3) then ! Field Day
                            apmask(1:56)=1
-                           llrd(1:28)=apmag*apbits(1:28)
+                           llrd(1:28)=apmag*this%apbits(1:28)
                            llrd(29:56)=apmag*aphis_fd(1:28)
                         else if(ncontest.eq.4) then
                            apmask(2:57)=1
                            llrd(2:29)=apmag*apmy_ru(1:28)
-                           llrd(30:57)=apmag*apbits(30:57)
+                           llrd(30:57)=apmag*this%apbits(30:57)
                         endif
                      endif
 
@@ -471,7 +474,7 @@ contains
                         apmask=0
                         if(ncontest.le.5) then
                            apmask(1:77)=1   ! mycall, hiscall, RRR|73|RR73
-                           if(iaptype.eq.6) llrd(1:77)=apmag*apbits(1:77)
+                           if(iaptype.eq.6) llrd(1:77)=apmag*this%apbits(1:77)
                         endif
                      endif
 
@@ -533,40 +536,40 @@ contains
 ! Multi-period averaging: accumulate and attempt averaged decode
 ! ----------------------------------------------------------------
       if(iand(ndepth,16).eq.16 .and. got_candidate) then
-         if(navg_ft2.eq.0 .or. abs(best_f1_avg-f_avg).gt.10.0) then
+         if(this%navg_ft2.eq.0 .or. abs(best_f1_avg-this%f_avg).gt.10.0) then
 ! First period or frequency changed: reset accumulator
-            bm_avg=best_bm
-            navg_ft2=1
-            f_avg=best_f1_avg
-            dt_avg=real(best_ibest_avg)/1333.33
+            this%bm_avg=best_bm
+            this%navg_ft2=1
+            this%f_avg=best_f1_avg
+            this%dt_avg=real(best_ibest_avg)/1333.33
          else
 ! Accumulate using EMA (Exponential Moving Average)
-            navg_ft2=navg_ft2+1
-            ntc=min(navg_ft2,6)
+            this%navg_ft2=this%navg_ft2+1
+            ntc=min(this%navg_ft2,6)
             u=1.0/real(ntc)
-            bm_avg=u*best_bm + (1.0-u)*bm_avg
-            f_avg=u*best_f1_avg + (1.0-u)*f_avg
-            dt_avg=u*real(best_ibest_avg)/1333.33 + (1.0-u)*dt_avg
+            this%bm_avg=u*best_bm + (1.0-u)*this%bm_avg
+            this%f_avg=u*best_f1_avg + (1.0-u)*this%f_avg
+            this%dt_avg=u*real(best_ibest_avg)/1333.33 + (1.0-u)*this%dt_avg
          endif
 
 ! Write averaging status to avemsg.txt (unit 14)
-         write(14,1200) navg_ft2,nint(f_avg),dt_avg
+         write(14,1200) this%navg_ft2,nint(this%f_avg),this%dt_avg
 1200     format('FT2 avg:  navg=',i3,'  f=',i5,' Hz  dt=',f6.2,' s')
 
 ! Try averaged decode if single-period failed and navg >= 2
-         if(ndecodes.eq.0 .and. navg_ft2.ge.2) then
+         if(ndecodes.eq.0 .and. this%navg_ft2.ge.2) then
             scalefac=2.83
-            llra(  1: 58)=bm_avg(  9: 66, 1)
-            llra( 59:116)=bm_avg( 75:132, 1)
-            llra(117:174)=bm_avg(141:198, 1)
+            llra(  1: 58)=this%bm_avg(  9: 66, 1)
+            llra( 59:116)=this%bm_avg( 75:132, 1)
+            llra(117:174)=this%bm_avg(141:198, 1)
             llra=scalefac*llra
-            llrb(  1: 58)=bm_avg(  9: 66, 2)
-            llrb( 59:116)=bm_avg( 75:132, 2)
-            llrb(117:174)=bm_avg(141:198, 2)
+            llrb(  1: 58)=this%bm_avg(  9: 66, 2)
+            llrb( 59:116)=this%bm_avg( 75:132, 2)
+            llrb(117:174)=this%bm_avg(141:198, 2)
             llrb=scalefac*llrb
-            llrc(  1: 58)=bm_avg(  9: 66, 3)
-            llrc( 59:116)=bm_avg( 75:132, 3)
-            llrc(117:174)=bm_avg(141:198, 3)
+            llrc(  1: 58)=this%bm_avg(  9: 66, 3)
+            llrc( 59:116)=this%bm_avg( 75:132, 3)
+            llrc(117:174)=this%bm_avg(141:198, 3)
             llrc=scalefac*llrc
 
 ! Multi-metrica: llrd = best-of (max |valore|), llre = media
@@ -605,9 +608,9 @@ contains
                   if(lapcqonly) iaptype=1
                   napwid=75
                   if(ncontest.le.5 .and. iaptype.ge.3 .and.      &
-                     (abs(f_avg-nfqso).gt.napwid) ) cycle
-                  if(iaptype.ge.2 .and. apbits(1).gt.1) cycle
-                  if(iaptype.ge.3 .and. apbits(30).gt.1) cycle
+                     (abs(this%f_avg-nfqso).gt.napwid) ) cycle
+                  if(iaptype.ge.2 .and. this%apbits(1).gt.1) cycle
+                  if(iaptype.ge.3 .and. this%apbits(30).gt.1) cycle
 
                   if(iaptype.eq.1) then
                      apmask=0
@@ -624,13 +627,13 @@ contains
                      apmask=0
                      if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.5) then
                         apmask(1:29)=1
-                        llrd(1:29)=apmag*apbits(1:29)
+                        llrd(1:29)=apmag*this%apbits(1:29)
                      else if(ncontest.eq.2) then
                         apmask(1:28)=1
-                        llrd(1:28)=apmag*apbits(1:28)
+                        llrd(1:28)=apmag*this%apbits(1:28)
                      else if(ncontest.eq.3) then
                         apmask(1:28)=1
-                        llrd(1:28)=apmag*apbits(1:28)
+                        llrd(1:28)=apmag*this%apbits(1:28)
                      else if(ncontest.eq.4) then
                         apmask(2:29)=1
                         llrd(2:29)=apmag*apmy_ru(1:28)
@@ -642,15 +645,15 @@ contains
                      if(ncontest.eq.0.or.ncontest.eq.1.or.         &
                         ncontest.eq.2.or.ncontest.eq.5) then
                         apmask(1:58)=1
-                        llrd(1:58)=apmag*apbits(1:58)
+                        llrd(1:58)=apmag*this%apbits(1:58)
                      else if(ncontest.eq.3) then
                         apmask(1:56)=1
-                        llrd(1:28)=apmag*apbits(1:28)
+                        llrd(1:28)=apmag*this%apbits(1:28)
                         llrd(29:56)=apmag*aphis_fd(1:28)
                      else if(ncontest.eq.4) then
                         apmask(2:57)=1
                         llrd(2:29)=apmag*apmy_ru(1:28)
-                        llrd(30:57)=apmag*apbits(30:57)
+                        llrd(30:57)=apmag*this%apbits(30:57)
                      endif
                   endif
 
@@ -659,7 +662,7 @@ contains
                      apmask=0
                      if(ncontest.le.5) then
                         apmask(1:77)=1
-                        if(iaptype.eq.6) llrd(1:77)=apmag*apbits(1:77)
+                        if(iaptype.eq.6) llrd(1:77)=apmag*this%apbits(1:77)
                      endif
                   endif
 
@@ -670,7 +673,7 @@ contains
 
                ndeep=3
                maxosd=3
-               if(abs(nfqso-f_avg).le.75.0 .and. ndepth0.ge.3) then
+               if(abs(nfqso-this%f_avg).le.75.0 .and. ndepth0.ge.3) then
                   maxosd=4
                endif
                if(.not.doosd) maxosd = -1
@@ -688,18 +691,18 @@ contains
                   ndecodes=ndecodes+1
                   decodes(ndecodes)=message
                   xsnr=-21.0
-                  xdt=dt_avg - 0.5
+                  xdt=this%dt_avg - 0.5
                   qual=1.0-(nharderror+dmin)/60.0
 ! Report averaged decode with "a" flag via callback
                   call this%callback(best_sync_avg,nint(xsnr),    &
-                       xdt,f_avg,message,iaptype,qual)
+                       xdt,this%f_avg,message,iaptype,qual)
 ! Write decoded message to avemsg.txt
-                  write(14,1210) navg_ft2,nint(f_avg),xdt,        &
+                  write(14,1210) this%navg_ft2,nint(this%f_avg),xdt,        &
                        trim(message)
 1210              format('FT2 avg:  navg=',i3,'  f=',i5,          &
                        '  dt=',f6.2,'  ',a)
-                  navg_ft2=0              !Reset after successful decode
-                  bm_avg=0.0
+                  this%navg_ft2=0              !Reset after successful decode
+                  this%bm_avg=0.0
                   exit
                endif
             enddo                         !ipass (averaged decode)
@@ -710,11 +713,12 @@ contains
    end subroutine decode
 
 ! Clear multi-period averaging buffers (called on mode/band change)
-   subroutine ft2_clravg()
-      navg_ft2=0
-      bm_avg=0.0
-      f_avg=0.0
-      dt_avg=0.0
-   end subroutine ft2_clravg
+   subroutine clear_average(this)
+      class(ft2_decoder), intent(inout) :: this
+      this%navg_ft2=0
+      this%bm_avg=0.0
+      this%f_avg=0.0
+      this%dt_avg=0.0
+   end subroutine clear_average
 
 end module ft2_decode
@@ -1,4 +1,51 @@
 subroutine ft8apset(mycall12,hiscall12,ncontest,apsym,aph10)
+
+! AP symbols depend only on the calls and the contest type, so keep the
+! last set built and skip the pack/unpack round trips until one of them
+! changes. Failed builds are not kept, they may succeed once the hash
+! tables know the calls.
+
+  use packjt77
+  character*12 mycall12,hiscall12,mycall0,hiscall0
+  character*13 hc13
+  integer apsym(58),aph10(10),apsym0(58),aph100(10)
+  logical lhit
+  data ncontest0/-1/
+  save mycall0,hiscall0,ncontest0,apsym0,aph100
+
+!$omp critical (ft8apset_cache)
+  lhit=ncontest.eq.ncontest0 .and. mycall12.eq.mycall0 .and. hiscall12.eq.hiscall0
+  if(lhit) then
+     apsym=apsym0
+     aph10=aph100
+  endif
+!$omp end critical (ft8apset_cache)
+
+  if(lhit) then
+! Keep both calls in the hash tables, as packing the messages would
+     hc13=mycall12
+     call save_hash_call(hc13,n10,n12,n22)
+     if(len(trim(hiscall12)).ge.3) then
+        hc13=hiscall12
+        call save_hash_call(hc13,n10,n12,n22)
+     endif
+     return
+  endif
+
+  call ft8apset0(mycall12,hiscall12,ncontest,apsym,aph10)
+  if(apsym(1).eq.99) return
+
+!$omp critical (ft8apset_cache)
+  mycall0=mycall12
+  hiscall0=hiscall12
+  ncontest0=ncontest
+  apsym0=apsym
+  aph100=aph10
+!$omp end critical (ft8apset_cache)
+  return
+end subroutine ft8apset
+
+subroutine ft8apset0(mycall12,hiscall12,ncontest,apsym,aph10)
   use packjt77
   character*77 c77
   character*37 msg,msgchk
@@ -59,4 +106,4 @@ subroutine ft8apset(mycall12,hiscall12,ncontest,apsym,aph10)
   apsym(30)=99
   return
 
-end subroutine ft8apset
+end subroutine ft8apset0
@@ -27,7 +27,10 @@ subroutine ft8b(dd0,newdat,nQSOProgress,nfqso,nftx,ndepth,nzhsym,lapon,     &
   integer icos7(0:6),ip(1)
   integer nappasses(0:5)  !Number of decoding passes to use for each QSO state
   integer naptypes(0:5,4) ! (nQSOProgress, decoding pass)  maximum of 4 passes for now
-  integer ncontest,ncontest0
+  integer ncontest,ncontest0,ncontestap
+  integer*1 apmasks(174,6)      !apmask for each iaptype
+  real apllrs(174,6)            !+/-1 for AP bits, 0 keeps the measured llr
+  integer apsym0(58),aph100(10)
   logical one(0:511,0:8)
   integer graymap(0:7)
   integer iloc(1)
@@ -47,9 +50,10 @@ subroutine ft8b(dd0,newdat,nQSOProgress,nfqso,nftx,ndepth,nzhsym,lapon,     &
   data   mrr73/0,1,1,1,1,1,1,0,0,1,1,1,0,1,0,1,0,0,1/
   data first/.true./
   data graymap/0,1,3,2,5,6,4,7/
-  save nappasses,naptypes,ncontest0,one
+  data ncontestap/-1/
+  save nappasses,naptypes,ncontest0,one,apmasks,apllrs,apsym0,aph100
 
-  if(first.or.(ncontest.ne.ncontest0)) then
+  if(first) then
      mcq=2*mcq-1
      mcqfd=2*mcqfd-1
      mcqru=2*mcqru-1
@@ -91,6 +95,108 @@ subroutine ft8b(dd0,newdat,nQSOProgress,nfqso,nftx,ndepth,nzhsym,lapon,     &
      ncontest0=ncontest
   endif
 
+! AP masks and hypotheses for each iaptype, rebuilt only when the calls
+! or contest type change rather than for every candidate and pass
+  if(ncontest.ne.ncontestap .or. any(apsym.ne.apsym0) .or. any(aph10.ne.aph100)) then
+     ncontestap=ncontest
+     apsym0=apsym
+     aph100=aph10
+     apmasks=0
+     apllrs=0.
+
+! 1: CQ or CQ RU or CQ TEST or CQ FD
+     apmasks(1:29,1)=1
+     if(ncontest.eq.0 .or. ncontest.eq.7) apllrs(1:29,1)=mcq
+     if(ncontest.eq.1 .or. ncontest.eq.2 .or. ncontest.eq.8) apllrs(1:29,1)=mcqtest
+     if(ncontest.eq.3) apllrs(1:29,1)=mcqfd
+     if(ncontest.eq.4) apllrs(1:29,1)=mcqru
+     if(ncontest.eq.5) apllrs(1:29,1)=mcqww
+     apmasks(75:77,1)=1
+     apllrs(75:76,1)=-1
+     apllrs(77,1)=+1
+
+! 2: MyCall,???,???
+     if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.5.or.ncontest.eq.8) then
+        apmasks(1:29,2)=1
+        apllrs(1:29,2)=apsym(1:29)
+        apmasks(75:77,2)=1
+        apllrs(75:76,2)=-1
+        apllrs(77,2)=+1
+     else if(ncontest.eq.2) then
+        apmasks(1:28,2)=1
+        apllrs(1:28,2)=apsym(1:28)
+        apmasks(72:74,2)=1
+        apllrs(72,2)=-1
+        apllrs(73,2)=+1
+        apllrs(74,2)=-1
+        apmasks(75:77,2)=1
+        apllrs(75:77,2)=-1
+     else if(ncontest.eq.3) then
+        apmasks(1:28,2)=1
+        apllrs(1:28,2)=apsym(1:28)
+        apmasks(75:77,2)=1
+        apllrs(75:77,2)=-1
+     else if(ncontest.eq.4) then
+        apmasks(2:29,2)=1
+        apllrs(2:29,2)=apsym(1:28)
+        apmasks(75:77,2)=1
+        apllrs(75,2)=-1
+        apllrs(76:77,2)=+1
+     else if(ncontest.eq.7) then ! ??? RR73; MyCall <Fox Call hash10> ???
+        apmasks(29:56,2)=1
+        apllrs(29:56,2)=apsym(1:28)
+        apmasks(57:66,2)=1
+        apllrs(57:66,2)=aph10(1:10)
+        apmasks(72:77,2)=1
+        apllrs(72:73,2)=-1
+        apllrs(74,2)=+1
+        apllrs(75:77,2)=-1
+     endif
+
+! 3: MyCall,DxCall,???
+     if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.2.or.ncontest.eq.5.or.ncontest.eq.7.or.ncontest.eq.8) then
+        apmasks(1:58,3)=1
+        apllrs(1:58,3)=apsym
+        apmasks(75:77,3)=1
+        apllrs(75:76,3)=-1
+        apllrs(77,3)=+1
+     else if(ncontest.eq.3) then ! Field Day
+        apmasks(1:56,3)=1
+        apllrs(1:28,3)=apsym(1:28)
+        apllrs(29:56,3)=apsym(30:57)
+        apmasks(72:74,3)=1        ! masked but left as measured
+        apmasks(75:77,3)=1
+        apllrs(75:77,3)=-1
+     else if(ncontest.eq.4) then
+        apmasks(2:57,3)=1
+        apllrs(2:29,3)=apsym(1:28)
+        apllrs(30:57,3)=apsym(30:57)
+        apmasks(75:77,3)=1
+        apllrs(75,3)=-1
+        apllrs(76:77,3)=+1
+     endif
+
+! 4, 5, 6: MyCall,DxCall,RRR|73|RR73
+     do k=4,6
+        if(ncontest.le.5 .or. (ncontest.eq.7.and.k.eq.6) .or. ncontest.eq.8) then
+           apmasks(1:77,k)=1
+           apllrs(1:58,k)=apsym
+           if(k.eq.4) apllrs(59:77,k)=mrrr
+           if(k.eq.5) apllrs(59:77,k)=m73
+           if(k.eq.6) apllrs(59:77,k)=mrr73
+        else if(ncontest.eq.7.and.k.eq.4) then ! Hound listens for MyCall RR73;...
+           apmasks(1:28,k)=1
+           apllrs(1:28,k)=apsym(1:28)
+           apmasks(57:66,k)=1
+           apllrs(57:66,k)=aph10(1:10)
+           apmasks(72:77,k)=1
+           apllrs(72:73,k)=-1
+           apllrs(74,k)=+1
+           apllrs(75:77,k)=-1
+        endif
+     enddo
+  endif
+
   dxcall13=hiscall12  ! initialize for use in packjt77
   mycall13=mycall12
 
@@ -319,106 +425,10 @@ subroutine ft8b(dd0,newdat,nQSOProgress,nfqso,nftx,ndepth,nzhsym,lapon,     &
         if(ncontest.eq.7 .and. iaptype.ge.2 .and. aph10(1).gt.1) cycle
         if(iaptype.ge.3 .and. apsym(30).gt.1) cycle ! No, or nonstandard, dxcall
 
-        if(iaptype.eq.1) then ! CQ or CQ RU or CQ TEST or CQ FD
-           apmask=0
-           apmask(1:29)=1  
-           if(ncontest.eq.0) llrz(1:29)=apmag*mcq(1:29)
-           if(ncontest.eq.1) llrz(1:29)=apmag*mcqtest(1:29)
-           if(ncontest.eq.2) llrz(1:29)=apmag*mcqtest(1:29)
-           if(ncontest.eq.3) llrz(1:29)=apmag*mcqfd(1:29)
-           if(ncontest.eq.4) llrz(1:29)=apmag*mcqru(1:29)
-           if(ncontest.eq.5) llrz(1:29)=apmag*mcqww(1:29)
-           if(ncontest.eq.7) llrz(1:29)=apmag*mcq(1:29)
-           if(ncontest.eq.8) llrz(1:29)=apmag*mcqtest(1:29)
-           apmask(75:77)=1 
-           llrz(75:76)=apmag*(-1)
-           llrz(77)=apmag*(+1)
-        endif
-
-        if(iaptype.eq.2) then ! MyCall,???,??? 
-           apmask=0
-           if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.5.or.ncontest.eq.8) then
-              apmask(1:29)=1  
-              llrz(1:29)=apmag*apsym(1:29)
-              apmask(75:77)=1 
-              llrz(75:76)=apmag*(-1)
-              llrz(77)=apmag*(+1)
-           else if(ncontest.eq.2) then
-              apmask(1:28)=1  
-              llrz(1:28)=apmag*apsym(1:28)
-              apmask(72:74)=1
-              llrz(72)=apmag*(-1)
-              llrz(73)=apmag*(+1)
-              llrz(74)=apmag*(-1)
-              apmask(75:77)=1 
-              llrz(75:77)=apmag*(-1)
-           else if(ncontest.eq.3) then
-              apmask(1:28)=1  
-              llrz(1:28)=apmag*apsym(1:28)
-              apmask(75:77)=1 
-              llrz(75:77)=apmag*(-1)
-           else if(ncontest.eq.4) then
-              apmask(2:29)=1  
-              llrz(2:29)=apmag*apsym(1:28)
-              apmask(75:77)=1 
-              llrz(75)=apmag*(-1)
-              llrz(76:77)=apmag*(+1)
-           else if(ncontest.eq.7) then ! ??? RR73; MyCall <Fox Call hash10> ???
-              apmask(29:56)=1  
-              llrz(29:56)=apmag*apsym(1:28)
-              apmask(57:66)=1
-              llrz(57:66)=apmag*aph10(1:10)
-              apmask(72:77)=1 
-              llrz(72:73)=apmag*(-1)
-              llrz(74)=apmag*(+1)
-              llrz(75:77)=apmag*(-1)
-           endif
-        endif
-
-        if(iaptype.eq.3) then ! MyCall,DxCall,??? 
-           apmask=0
-           if(ncontest.eq.0.or.ncontest.eq.1.or.ncontest.eq.2.or.ncontest.eq.5.or.ncontest.eq.7.or.ncontest.eq.8) then
-              apmask(1:58)=1  
-              llrz(1:58)=apmag*apsym
-              apmask(75:77)=1 
-              llrz(75:76)=apmag*(-1)
-              llrz(77)=apmag*(+1)
-           else if(ncontest.eq.3) then ! Field Day
-              apmask(1:56)=1  
-              llrz(1:28)=apmag*apsym(1:28)
-              llrz(29:56)=apmag*apsym(30:57)
-              apmask(72:74)=1 
-              apmask(75:77)=1 
-              llrz(75:77)=apmag*(-1)
-           else if(ncontest.eq.4) then 
-              apmask(2:57)=1  
-              llrz(2:29)=apmag*apsym(1:28)
-              llrz(30:57)=apmag*apsym(30:57)
-              apmask(75:77)=1 
-              llrz(75)=apmag*(-1)
-              llrz(76:77)=apmag*(+1)
-           endif
-        endif
-
         if(iaptype.eq.5.and.ncontest.eq.7) cycle !Hound
-        if(iaptype.eq.4 .or. iaptype.eq.5 .or. iaptype.eq.6) then  
-           apmask=0
-           if(ncontest.le.5 .or. (ncontest.eq.7.and.iaptype.eq.6) .or. ncontest.eq.8) then
-              apmask(1:77)=1   ! mycall, hiscall, RRR|73|RR73
-              llrz(1:58)=apmag*apsym
-              if(iaptype.eq.4) llrz(59:77)=apmag*mrrr 
-              if(iaptype.eq.5) llrz(59:77)=apmag*m73 
-              if(iaptype.eq.6) llrz(59:77)=apmag*mrr73 
-           else if(ncontest.eq.7.and.iaptype.eq.4) then ! Hound listens for MyCall RR73;...
-              apmask(1:28)=1
-              llrz(1:28)=apmag*apsym(1:28)
-              apmask(57:66)=1
-              llrz(57:66)=apmag*aph10(1:10)
-              apmask(72:77)=1
-              llrz(72:73)=apmag*(-1)
-              llrz(74)=apmag*(1)
-              llrz(75:77)=apmag*(-1)
-           endif             
+        if(iaptype.ge.1 .and. iaptype.le.6) then
+           apmask=apmasks(:,iaptype)
+           where(apllrs(:,iaptype).ne.0.0) llrz=apmag*apllrs(:,iaptype)
         endif
      endif
 
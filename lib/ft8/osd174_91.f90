@@ -11,6 +11,9 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
 ! be set to 77+p1.
 !
 ! Valid values for k are in the range [77,91].
+!
+! Reentrant: the pattern boxes are allocated per call, as in
+! osd174_91var, and the generator matrix is built once under a lock.
 !
    character*14 c14
    integer, parameter:: N=174
@@ -19,6 +22,8 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
    integer*1, allocatable :: genmrb(:,:),g2(:,:)
    integer*1, allocatable :: temp(:),m0(:),me(:),mi(:),misub(:),e2sub(:),e2(:),ui(:)
    integer*1, allocatable :: r2pat(:)
+   integer, allocatable :: indexes(:,:),fp(:),np(:)
+   integer lastpat,inext
    integer indices(N),nxor(N)
    integer*1 cw(N),ce(N),c0(N),hdec(N)
    integer*1, allocatable :: decoded(:)
@@ -29,12 +34,15 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
    logical first,reset
    data first/.true./
    save first
+!$omp threadprivate(first)
 
    allocate( genmrb(k,N), g2(N,k) )
    allocate( temp(k), m0(k), me(k), mi(k), misub(k), e2sub(N-k), e2(N-k), ui(N-k) )
    allocate( r2pat(N-k), decoded(k) )
 
-   if( first ) then ! fill the generator matrix
+   if( first ) then
+!$omp critical(osd174_91_gen)
+   if( .not.allocated(gen) ) then ! fill the generator matrix
 !
 ! Create generator matrix for partial CRC cascaded with LDPC code.
 ! 
@@ -60,7 +68,8 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
          call encode174_91_nocrc(message91,cw)
          gen(i,:)=cw
       enddo
-
+   endif
+!$omp end critical(osd174_91_gen)
       first=.false.
    endif
 
@@ -228,13 +237,14 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
    enddo
 
    if(npre2.eq.1) then
+      allocate( indexes(5000,2), fp(0:525000), np(5000) )
       reset=.true.
       ntotal=0
       do i1=k,1,-1
          do i2=i1-1,1,-1
             ntotal=ntotal+1
             mi(1:ntau)=ieor(g2(k+1:k+ntau,i1),g2(k+1:k+ntau,i2))
-            call boxit91(reset,mi(1:ntau),ntau,ntotal,i1,i2)
+            call boxit91(indexes,fp,np,reset,mi(1:ntau),ntau,ntotal,i1,i2)
          enddo
       enddo
 
@@ -255,7 +265,8 @@ subroutine osd174_91(llr,k,apmask,ndeep,message91,cw,nhardmin,dmin)
             if(i2.gt.0) ui(i2)=1
             r2pat=ieor(e2sub,ui)
 778         continue
-            call fetchit91(reset,r2pat(1:ntau),ntau,in1,in2)
+            call fetchit91(indexes,fp,np,lastpat,inext,reset,r2pat(1:ntau),  &
+                 ntau,in1,in2)
             if(in1.gt.0.and.in2.gt.0) then
                ncount2=ncount2+1
                mi=misub
@@ -333,11 +344,10 @@ subroutine nextpat91(mi,k,iorder,iflag)
    return
 end subroutine nextpat91
 
-subroutine boxit91(reset,e2,ntau,npindex,i1,i2)
+subroutine boxit91(indexes,fp,np,reset,e2,ntau,npindex,i1,i2)
    integer*1 e2(1:ntau)
    integer   indexes(5000,2),fp(0:525000),np(5000)
    logical reset
-   common/boxes/indexes,fp,np
 
    if(reset) then
       patterns=-1
@@ -369,13 +379,11 @@ subroutine boxit91(reset,e2,ntau,npindex,i1,i2)
    return
 end subroutine boxit91
 
-subroutine fetchit91(reset,e2,ntau,i1,i2)
+subroutine fetchit91(indexes,fp,np,lastpat,inext,reset,e2,ntau,i1,i2)
    integer   indexes(5000,2),fp(0:525000),np(5000)
    integer   lastpat
    integer*1 e2(ntau)
    logical reset
-   common/boxes/indexes,fp,np
-   save lastpat,inext
 
    if(reset) then
       lastpat=-1
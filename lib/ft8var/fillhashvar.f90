@@ -2,6 +2,8 @@ subroutine fillhashvar(numthreads,lfill)
 
   use packjt77var ! also setting mycall13,dxcall13
   use ft8_mod1, only : mycall,hiscall
+  use hashing, only : hashcalls_save
+  use iso_c_binding, only : c_size_t
   integer, intent(in) :: numthreads
   logical, intent(in) :: lfill
   character*13 cw
@@ -12,6 +14,7 @@ subroutine fillhashvar(numthreads,lfill)
         nposition=nthrindex(i)+m
         cw=last_calls(nposition)
 !print *,i,m,cw
+        call hashcalls_save(cw,len(cw,c_size_t))   !Share with other decoders
         n10=ihashcall(cw,10)
         if(n10.ge.0 .and. n10 .le. 1023 .and. cw.ne.mycall13) calls10(n10)=cw
 
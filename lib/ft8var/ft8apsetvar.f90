@@ -7,14 +7,27 @@ subroutine ft8apsetvar(lmycallstd,lhiscallstd,numthreads)
   character*77 c77
   character*37 msg,msgchk
   character*12 hiscallt,mycallprev,hiscallprev
+  character*4 hisgrid4prev
   logical lnohiscall,unpk77_success,first
-  logical(1) lhoundprev
+  logical(1) lhoundprev,lmycallstdprev,lhiscallstdprev
   logical(1), intent(in) :: lmycallstd,lhiscallstd
   data mycallprev/'QQ2QQ'/
   data hiscallprev/'QQ1QQ'/
+  data hisgrid4prev/'    '/
   data lhoundprev/.false./
+  data lmycallstdprev/.false./
+  data lhiscallstdprev/.false./
   data first/.true./
-  save hiscallprev,mycallprev,lhoundprev,first
+  save hiscallprev,mycallprev,lhoundprev,first,hisgrid4prev,lmycallstdprev,lhiscallstdprev
+
+! The hypotheses are shared read-only by all decoder threads and kept
+! until an input changes: the calls, DX grid, Hound mode or whether
+! the calls are standard
+  if(hisgrid4.ne.hisgrid4prev .or. (lmycallstd.neqv.lmycallstdprev) .or.     &
+       (lhiscallstd.neqv.lhiscallstdprev)) then
+    hisgrid4prev=hisgrid4; lmycallstdprev=lmycallstd; lhiscallstdprev=lhiscallstd
+    hiscallprev='QQ1QQ'; mycallprev='QQ2QQ'   ! rebuild everything
+  endif
 
   if(hiscall.ne.hiscallprev .or. mycall.ne.mycallprev .or. (lhound.neqv.lhoundprev) .or. first) then ! first for lhound triggered
 
@@ -1,6 +1,7 @@
 module packjt77var
 
 ! use packjt77, only : hash10,hash12,hash22
+use hashing, only : hashcalls_lookup
 
 ! These variables are accessible from outside via "use packjt77var":
   parameter (MAXHASH=1000,MAXTXHASH=5,MAXRECENT=10)
@@ -35,7 +36,7 @@ module packjt77var
 
 subroutine hash10var(n10,c13,nthr)
 
-  character*13 c13
+  character*13 c13,cw
   integer, intent(in) :: nthr
 
   c13='<...>'
@@ -49,6 +50,8 @@ subroutine hash10var(n10,c13,nthr)
     if(len(trim(calls10(n10))).gt.0) then
       c13=calls10(n10)
       c13='<'//trim(c13)//'>'
+    else if(hashcalls_lookup(n10,10,cw).ne.0 .and. cw.ne.mycall13) then
+      c13='<'//trim(cw)//'>'
     endif
   endif
   return
@@ -57,7 +60,7 @@ end subroutine hash10var
 
 subroutine hash12var(n12,c13,nthr)
 
-  character*13 c13
+  character*13 c13,cw
   integer, intent(in) :: nthr
   
   c13='<...>'
@@ -71,6 +74,8 @@ subroutine hash12var(n12,c13,nthr)
     if(len(trim(calls12(n12))).gt.0) then
       c13=calls12(n12)
       c13='<'//trim(c13)//'>'
+    else if(hashcalls_lookup(n12,12,cw).ne.0 .and. cw.ne.mycall13) then
+      c13='<'//trim(cw)//'>'
     endif
   endif
 
@@ -81,7 +86,7 @@ end subroutine hash12var
 
 subroutine hash22var(n22,c13,nthr)
 
-  character*13 c13
+  character*13 c13,cw
   integer, intent(in) :: nthr
   
   c13='<...>'
@@ -101,6 +106,7 @@ subroutine hash22var(n22,c13,nthr)
         go to 900
       endif
     enddo
+    if(hashcalls_lookup(n22,22,cw).ne.0) c13='<'//trim(cw)//'>'
   endif
 
 900 return
@@ -13,6 +13,15 @@
 
 #define	min(a,b)	((a) < (b) ? (a) : (b))
 
+// The syndrome is kept between calls so that a soft-decision decoder
+// can compute it once and try many erasure vectors against it. It is
+// kept per thread so that the trials can run on several threads.
+#if defined(_MSC_VER)
+#define RS_THREAD_LOCAL __declspec(thread)
+#else
+#define RS_THREAD_LOCAL __thread
+#endif
+
 #ifdef FIXED
 #include "fixed.h"
 #elif defined(BIGSYM)
@@ -34,7 +43,7 @@ int DECODE_RS(
     int i, j, r,k;
     DTYPE u,q,tmp,num1,num2,den,discr_r;
     DTYPE lambda[NROOTS+1];	// Err+Eras Locator poly
-    static DTYPE s[51];					 // and syndrome poly
+    static RS_THREAD_LOCAL DTYPE s[51];		 // and syndrome poly
     DTYPE b[NROOTS+1], t[NROOTS+1], omega[NROOTS+1];
     DTYPE root[NROOTS], reg[NROOTS+1], loc[NROOTS];
     int syn_error, count;
@@ -19,13 +19,108 @@
 #include <unistd.h>
 #include <time.h>
 #include <string.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
 #include "../ftrsd/rs2.h"
 
-static void *rs;
 void getpp_(int workdat[], float *pp);
 
+/*
+The trials run in blocks of up to BLOCK, in parallel when built with
+OpenMP. Trial k always uses the same erasure vector, the one the
+original sequential generator gave it, and the block's results are
+merged in trial order, so the outcome does not depend on the number
+of threads. Trials beyond one whose candidate would end the search are
+skipped, and only run later if the merge finds they are needed.
+*/
+#define BLOCK 256
+
+// LCG of the POSIX.1-2001 rand() example
+#define LCG_A 1103515245u
+#define LCG_C 12345u
+
+typedef struct {
+  int run;
+  int nerr;
+  int numera;
+  int nhard;
+  int nsoft;
+  int ntotal;
+  float pp;
+  int workdat[63];
+} trial_t;
+
+static double wall_time(void)
+{
+#ifdef _OPENMP
+  return omp_get_wtime();
+#else
+  return (double)clock()/CLOCKS_PER_SEC;
+#endif
+}
+
+/*
+Run one trial with the generator state seed. Erasures are drawn for
+the ranked symbols from the worst; draw i is A[i]*seed+C[i], i.e. the
+generator stepped i+1 times, so the loop has no carried dependency.
+*/
+static void trial(void *rs, unsigned int seed, unsigned int const A[],
+		  unsigned int const C[], int const thresh0[],
+		  int const indexes[], int const rxdat[], int const rxdat2[],
+		  int const rxprob[], int nsum, trial_t *t)
+{
+  int era_pos[51];
+  int erase[63];
+  int i, nn=63, numera;
+
+  for (i=0; i<nn; i++) {
+    unsigned int ir = ((A[i]*seed + C[i])/65536) % 32768;
+    erase[i] = (100*ir)/32768 < (unsigned int)thresh0[i];
+  }
+  memset(era_pos,0,51*sizeof(int));
+  numera=0;
+  for (i=0; i<nn && numera<51; i++) {
+    if(erase[i]) era_pos[numera++]=indexes[62-i];
+  }
+
+  memcpy(t->workdat,rxdat,63*sizeof(int));
+  t->numera=numera;
+  t->nerr=decode_rs_int(rs,t->workdat,era_pos,numera,0);
+  if( t->nerr >= 0 ) {
+    // We have a candidate codeword.  Find its hard and soft distance from
+    // the received word.  Also find pp from the full array s3(64,63) of
+    // synchronized symbol spectra.
+    int nhard=0, nsoft=0;
+    for (i=0; i<63; i++) {
+      int differs = t->workdat[i] != rxdat[i];
+      nhard += differs;
+      nsoft += (differs && t->workdat[i] != rxdat2[i]) ? rxprob[i] : 0;
+    }
+    t->nhard=nhard;
+    t->nsoft=63*nsoft/nsum;
+    t->ntotal=t->nsoft+nhard;
+    getpp_(t->workdat,&t->pp);
+  }
+}
+
+// Set up the next block of trials, returns the number of them.
+static int next_block(int k0, int ntrials, unsigned int *nseed,
+		      unsigned int const A[], unsigned int const C[],
+		      unsigned int seeds[], trial_t trials[])
+{
+  int i, nblock = ntrials-k0+1 < BLOCK ? ntrials-k0+1 : BLOCK;
+  for (i=0; i<nblock; i++) {
+    seeds[i]=*nseed;
+    *nseed=A[62]*(*nseed) + C[62];
+    trials[i].run=0;
+  }
+  return nblock;
+}
+
 void ftrsdap_(int mrsym[], int mrprob[], int mr2sym[], int mr2prob[], 
-	     int ap[], int* ntrials0, int correct[], int param[], int ntry[])
+	      int ap[], int* ntrials0, float* tmax0, int correct[],
+	      int param[], int ntry[])
 {
   int rxdat[63], rxprob[63], rxdat2[63], rxprob2[63];
   int workdat[63];
@@ -33,11 +128,12 @@ void ftrsdap_(int mrsym[], int mrprob[], int mr2sym[], int mr2prob[],
   int era_pos[51];
   int i, j, numera, nerr, nn=63;
   int ntrials = *ntrials0;
-  int nhard=0,nhard_min=32768,nsoft=0,nsoft_min=32768;
-  int ntotal=0,ntotal_min=32768,ncandidates;
+  float tmax = *tmax0;
+  int nhard=0,nhard_min=32768,nsoft_min=32768;
+  int ntotal_min=32768,ncandidates;
   int nera_best=0;
-  float pp,pp1,pp2;
-  static unsigned int nseed;
+  float pp1,pp2;
+  void *rs;
   
 // Power-percentage symbol metrics - composite gnnf/hf 
   int perr[8][8] = {
@@ -54,6 +150,7 @@ void ftrsdap_(int mrsym[], int mrprob[], int mr2sym[], int mr2prob[],
 // Initialize the KA9Q Reed-Solomon encoder/decoder
   unsigned int symsize=6, gfpoly=0x43, fcr=3, prim=1, nroots=51;
   rs=init_rs_int(symsize, gfpoly, fcr, prim, nroots, 0);
+  if(!rs) return;
 
 // Reverse the received symbol vectors for BM decoder
   for (i=0; i<63; i++) {
@@ -111,6 +208,7 @@ void ftrsdap_(int mrsym[], int mrprob[], int mr2sym[], int mr2prob[],
     param[5]=0;
     param[7]=1000*1000;
     ntry[0]=0;
+    free_rs_int(rs);
     return;
   }
 
@@ -125,9 +223,8 @@ symbol spectra, and using these to decide which candidate
 codeword is "best".
 */
 
-  nseed=1;                                 //Seed for random numbers
   float ratio;
-  int thresh, nsum;
+  int nsum;
   int thresh0[63];
   ncandidates=0;
   nsum=0;
@@ -146,78 +243,122 @@ codeword is "best".
 //printf("%d %d %d\n",i,j,rxdat[i]);
   }
 
-  if(nsum<=0) return;
+  if(nsum<=0) {
+    free_rs_int(rs);
+    return;
+  }
+
+/*
+Each trial takes 63 random numbers, 0 <= ir < 100, from a generator
+seeded with 1 (see POSIX.1-2001 example). A[i], C[i] step the generator
+i+1 times and A[62], C[62] step it from one trial to the next.
+*/
+  unsigned int A[63], C[63];
+  A[0]=LCG_A;
+  C[0]=LCG_C;
+  for (i=1; i<nn; i++) {
+    A[i]=LCG_A*A[i-1];
+    C[i]=LCG_A*C[i-1] + LCG_C;
+  }
+
+  trial_t *trials = malloc(BLOCK*sizeof(trial_t));
+  unsigned int *seeds = malloc(BLOCK*sizeof(unsigned int));
+  if(!trials || !seeds) {
+    free(trials);
+    free(seeds);
+    free_rs_int(rs);
+    return;
+  }
+  unsigned int nseed=1;
+  int k0=1, nblock, nstop, done;
+  double t0=wall_time();
+  nblock=next_block(k0,ntrials,&nseed,A,C,seeds,trials);
+  nstop=nblock;
+  done=nblock<=0;
 
   pp1=0.0;
   pp2=0.0;
-  for (k=1; k<=ntrials; k++) {
+#pragma omp parallel default(shared) private(i,workdat,era_pos)
+  {
+// This thread's copy of the syndrome; hard-decision decoding has
+// already failed so the result is of no interest.
     memset(era_pos,0,51*sizeof(int));
     memcpy(workdat,rxdat,sizeof(rxdat));
+    decode_rs_int(rs,workdat,era_pos,0,1);
 
-/* 
-Mark a subset of the symbols as erasures.
-Run through the ranked symbols, starting with the worst, i=0.
-NB: j is the symbol-vector index of the symbol with rank i.
-*/
-    numera=0;
-    for (i=0; i<nn; i++) {
-      j = indexes[62-i];
-      thresh=thresh0[i];
-      long int ir;
-
-// Generate a random number ir, 0 <= ir < 100 (see POSIX.1-2001 example).
-      nseed = nseed * 1103515245 + 12345;
-      ir = (unsigned)(nseed/65536) % 32768;
-      ir = (100*ir)/32768;
-
-      if((ir < thresh ) && numera < 51) {
-        era_pos[numera]=j;
-        numera=numera+1;
+// done is only changed by the merge below, after every thread has
+// seen its previous value.
+    while(!done) {
+#pragma omp for schedule(dynamic,4)
+      for (i=0; i<nblock; i++) {
+        int stop;
+#pragma omp atomic read
+        stop = nstop;
+        if(i > stop) continue;
+        trial(rs,seeds[i],A,C,thresh0,indexes,rxdat,rxdat2,rxprob,nsum,
+              &trials[i]);
+        trials[i].run=1;
+        if(trials[i].nerr >= 0 && trials[i].nhard <= 41
+           && trials[i].ntotal <= 71) {
+#pragma omp critical(ftrsdap_stop)
+          if(i < nstop) {
+#pragma omp atomic write
+            nstop = i;
+          }
+        }
       }
-    }
 
-    nerr=decode_rs_int(rs,workdat,era_pos,numera,0);        
-    if( nerr >= 0 ) {
-      // We have a candidate codeword.  Find its hard and soft distance from
-      // the received word.  Also find pp1 and pp2 from the full array 
-      // s3(64,63) of synchronized symbol spectra.
-      ncandidates=ncandidates+1;
-      nhard=0;
-      nsoft=0;
-      for (i=0; i<63; i++) {
-        if(workdat[i] != rxdat[i]) {
-          nhard=nhard+1;
-          if(workdat[i] != rxdat2[i]) {
-            nsoft=nsoft+rxprob[i];
+// Merge in trial order exactly as the trials would have been run one
+// at a time.
+#pragma omp single
+      {
+        int n, k;
+        for (n=0; n<nblock && !done && trials[n].run; n++) {
+          trial_t *t = &trials[n];
+          k = k0+n;
+          if( t->nerr >= 0 ) {
+            ncandidates=ncandidates+1;
+            if(t->pp>pp1) {
+              pp2=pp1;
+              pp1=t->pp;
+              nsoft_min=t->nsoft;
+              nhard_min=t->nhard;
+              ntotal_min=t->ntotal;
+              memcpy(correct,t->workdat,63*sizeof(int));
+              nera_best=t->numera;
+              ntry[0]=k;
+            } else {
+              if(t->pp>pp2 && t->pp!=pp1) pp2=t->pp;
+            }
+            if(nhard_min <= 41 && ntotal_min <= 71) done=1;
           }
+          if(k == ntrials) ntry[0]=k;
+        }
+// Carry on from the first trial skipped, if any.
+        if(n < nblock) nseed=seeds[n];
+        k0 += n;
+// Out of time, report the trials tried as if they were all there were.
+        if(!done && k0<=ntrials && tmax>0.0 && wall_time()-t0 >= tmax) {
+          ntry[0]=k0-1;
+          done=1;
+        }
+        if(!done) {
+          nblock=next_block(k0,ntrials,&nseed,A,C,seeds,trials);
+          nstop=nblock;
+          done=nblock<=0;
         }
       }
-      nsoft=63*nsoft/nsum;
-      ntotal=nsoft+nhard;
-
-      getpp_(workdat,&pp);
-      if(pp>pp1) {
-        pp2=pp1;
-        pp1=pp;
-        nsoft_min=nsoft;
-        nhard_min=nhard;
-        ntotal_min=ntotal;
-        memcpy(correct,workdat,63*sizeof(int));
-        nera_best=numera;
-        ntry[0]=k;
-      } else {
-        if(pp>pp2 && pp!=pp1) pp2=pp;
-      }
-      if(nhard_min <= 41 && ntotal_min <= 71) break;
     }
-    if(k == ntrials) ntry[0]=k;
   }
+  free(trials);
+  free(seeds);
+  free_rs_int(rs);
   
   param[0]=ncandidates;
   param[1]=nhard_min;
   param[2]=nsoft_min;
   param[3]=nera_best;
-  param[4]=1000.0*pp2/pp1;
+  param[4]=pp1>0.0 ? 1000.0*pp2/pp1 : 0;
   param[5]=ntotal_min;
   param[6]=ntry[0];
   param[7]=1000.0*pp2;
@@ -0,0 +1,477 @@
+#include "hashcalls.h"
+
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "wsprd/nhash.h"
+
+/*
+ * The table is a single fixed size structure so that it can be mapped
+ * straight from a file. Calls live in an open addressing hash table
+ * keyed by their 22 bit hash. The 10, 12 and 15 bit hashes are too
+ * short to key on, most values have several calls over a busy
+ * session, so they are direct mapped to the slot of the most recent
+ * call, which is what the decoders want anyway. Calls are only ever
+ * removed by rebuilding the whole table, so a slot never moves under
+ * the direct maps between rebuilds.
+ */
+
+#define SLOTS 4096u             /* power of two, fits a uint16_t index */
+#define MAX_LIVE (SLOTS / 4u * 3u)
+#define DEFAULT_MAX_AGE (30u * 24u * 60u * 60u)
+#define SPINS_BEFORE_STEAL 1000000u
+
+static char const magic[8] = {'W', 'S', 'J', 'T', 'H', 'S', 'H', '1'};
+
+enum {slot_empty, slot_used};
+enum {no_wspr_hash = 1};        /* entry flags */
+
+struct entry
+{
+  char call[HASHCALLS_CALL_CAP];
+  uint8_t state;
+  uint8_t flags;
+  uint16_t n15;
+  uint32_t n22;
+  uint32_t seen;                /* time (), for aging */
+  uint32_t order;               /* save sequence, for eviction */
+};
+
+struct table
+{
+  char magic[8];
+  uint32_t size;                /* sizeof (struct table), layout check */
+  uint32_t lock;                /* token of the holder, 0 if free */
+  uint32_t live;
+  uint32_t serial;
+  uint16_t index10[1024];       /* slot + 1 of the latest call, 0 if none */
+  uint16_t index12[4096];
+  uint16_t index15[32768];
+  struct entry slots[SLOTS];
+};
+
+static struct table * table;
+static int table_mapped;
+
+/*
+ * Guards the table pointer within this process, open and close
+ * replace the table and must not free it under a thread that is
+ * using it. Every use holds it shared from fetching the table until
+ * done with it, open and close hold it exclusively. It is always
+ * taken before the table's own lock.
+ */
+#ifdef _WIN32
+static SRWLOCK guard = SRWLOCK_INIT;
+static void guard_shared (void) {AcquireSRWLockShared (&guard);}
+static void unguard_shared (void) {ReleaseSRWLockShared (&guard);}
+static void guard_exclusive (void) {AcquireSRWLockExclusive (&guard);}
+static void unguard_exclusive (void) {ReleaseSRWLockExclusive (&guard);}
+#else
+static pthread_rwlock_t guard = PTHREAD_RWLOCK_INITIALIZER;
+static void guard_shared (void) {pthread_rwlock_rdlock (&guard);}
+static void unguard_shared (void) {pthread_rwlock_unlock (&guard);}
+static void guard_exclusive (void) {pthread_rwlock_wrlock (&guard);}
+static void unguard_exclusive (void) {pthread_rwlock_unlock (&guard);}
+#endif
+
+static void yield (void)
+{
+#ifdef _WIN32
+  SwitchToThread ();
+#else
+  sched_yield ();
+#endif
+}
+
+/* a lock token, different for every acquisition in any process */
+static uint32_t new_token (void)
+{
+  static uint32_t counter;
+#ifdef _WIN32
+  uint32_t pid = (uint32_t)GetCurrentProcessId ();
+#else
+  uint32_t pid = (uint32_t)getpid ();
+#endif
+  uint32_t token = pid * 2654435761u + __atomic_add_fetch (&counter, 1u, __ATOMIC_RELAXED);
+  return token ? token : 1u;
+}
+
+/*
+ * The table lock is shared by every process using the file. A holder
+ * that has kept it for SPINS_BEFORE_STEAL tries died holding it, the
+ * critical sections are far too short for anything else, and the lock
+ * is taken from it. The steal only succeeds if the lock still holds
+ * the token that was waited on, so only one waiter can win it.
+ */
+static uint32_t lock (struct table * t)
+{
+  uint32_t const token = new_token ();
+  uint32_t owner = 0, waited_on = 0;
+  unsigned spins = 0;
+  while (!__atomic_compare_exchange_n (&t->lock, &owner, token, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      if (owner != waited_on)
+        {
+          waited_on = owner;    /* a new holder, start counting again */
+          spins = 0;
+        }
+      else if (++spins > SPINS_BEFORE_STEAL
+               && __atomic_compare_exchange_n (&t->lock, &owner, token, 0, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+        {
+          break;
+        }
+      owner = 0;
+      yield ();
+    }
+  return token;
+}
+
+static void unlock (struct table * t, uint32_t token)
+{
+  /* leave it alone if it was stolen */
+  __atomic_compare_exchange_n (&t->lock, &token, 0u, 0, __ATOMIC_RELEASE, __ATOMIC_RELAXED);
+}
+
+static void clear_table (struct table * t)
+{
+  memset (t->index10, 0, sizeof t->index10);
+  memset (t->index12, 0, sizeof t->index12);
+  memset (t->index15, 0, sizeof t->index15);
+  memset (t->slots, 0, sizeof t->slots);
+  t->live = 0;
+}
+
+static void init_table (struct table * t)
+{
+  clear_table (t);
+  t->serial = 0;
+  t->size = sizeof *t;
+  memcpy (t->magic, magic, sizeof magic);
+}
+
+static struct table * map_table (char const * path)
+{
+  void * p;
+#ifdef _WIN32
+  HANDLE file, mapping;
+  file = CreateFileA (path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE
+                      , NULL, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (INVALID_HANDLE_VALUE == file) return NULL;
+  mapping = CreateFileMappingA (file, NULL, PAGE_READWRITE, 0, sizeof (struct table), NULL);
+  CloseHandle (file);
+  if (!mapping) return NULL;
+  p = MapViewOfFile (mapping, FILE_MAP_ALL_ACCESS, 0, 0, sizeof (struct table));
+  CloseHandle (mapping);        /* the view keeps it open */
+#else
+  struct stat st;
+  int fd = open (path, O_RDWR | O_CREAT, 0644);
+  if (fd < 0) return NULL;
+  if (fstat (fd, &st) || (st.st_size != (off_t)sizeof (struct table) && ftruncate (fd, sizeof (struct table))))
+    {
+      close (fd);
+      return NULL;
+    }
+  p = mmap (NULL, sizeof (struct table), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close (fd);
+  if (MAP_FAILED == p) return NULL;
+#endif
+  return (struct table *)p;
+}
+
+static void release_table (struct table * t, int mapped)
+{
+  if (!t) return;
+  if (mapped)
+    {
+#ifdef _WIN32
+      UnmapViewOfFile (t);
+#else
+      munmap (t, sizeof *t);
+#endif
+    }
+  else
+    {
+      free (t);
+    }
+}
+
+static struct table * get_table (void)
+{
+  struct table * t = __atomic_load_n (&table, __ATOMIC_ACQUIRE);
+  if (!t)
+    {
+      struct table * fresh = malloc (sizeof *fresh);
+      if (!fresh) return NULL;
+      init_table (fresh);
+      fresh->lock = 0;
+      if (__atomic_compare_exchange_n (&table, &t, fresh, 0, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+        {
+          t = fresh;
+        }
+      else
+        {
+          free (fresh);         /* another thread beat us to it */
+        }
+    }
+  return t;
+}
+
+/* copy the call out of a blank padded, possibly <> enclosed, field */
+static size_t normalize (char const * call, size_t length, char * out)
+{
+  size_t i = 0, n = 0;
+  if (i < length && '<' == call[i]) ++i;
+  for (; i < length && n < HASHCALLS_CALL_CAP - 1; ++i)
+    {
+      if (!call[i] || ' ' == call[i] || '>' == call[i]) break;
+      out[n++] = call[i];
+    }
+  out[n] = '\0';
+  if (n >= 3 && !strncmp (out, "...", 3)) n = 0;
+  return n;
+}
+
+int hashcalls_ihashcall (char const * call, size_t length, int bits)
+{
+  static char const alphabet[] = " 0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZ/";
+  uint64_t n8 = 0;
+  size_t i;
+  for (i = 0; i < 11; ++i)
+    {
+      char c = i < length && call[i] ? call[i] : ' ';
+      char const * p = strchr (alphabet, c);
+      /* same arithmetic as packjt77, an invalid character counts as -1 */
+      n8 = 38u * n8 + (p ? (uint64_t)(p - alphabet) : (uint64_t)-1);
+    }
+  return (int)((47055833459ull * n8) >> (64 - bits));
+}
+
+static int find_slot (struct table const * t, uint32_t n22)
+{
+  uint32_t i, probe;
+  for (i = 0, probe = n22 & (SLOTS - 1); i < SLOTS; ++i, probe = (probe + 1) & (SLOTS - 1))
+    {
+      struct entry const * e = &t->slots[probe];
+      if (slot_empty == e->state) break;
+      if (slot_used == e->state && e->n22 == n22) return (int)probe;
+    }
+  return -1;
+}
+
+static void insert (struct table * t, char const * call, uint32_t n22, uint16_t n15, uint8_t flags
+                    , uint32_t seen, uint32_t order)
+{
+  int slot = find_slot (t, n22);
+  struct entry * e;
+  if (slot < 0)
+    {
+      uint32_t probe = n22 & (SLOTS - 1);
+      while (slot_used == t->slots[probe].state) probe = (probe + 1) & (SLOTS - 1);
+      slot = (int)probe;
+      ++t->live;
+    }
+  /* an existing entry takes the most recently received call */
+  e = &t->slots[slot];
+  strncpy (e->call, call, sizeof e->call - 1);
+  e->call[sizeof e->call - 1] = '\0';
+  e->state = slot_used;
+  e->n22 = n22;
+  e->n15 = n15;
+  e->flags = flags;
+  e->seen = seen;
+  e->order = order;
+  t->index10[n22 >> 12] = (uint16_t)(slot + 1);
+  t->index12[n22 >> 10] = (uint16_t)(slot + 1);
+  if (!(flags & no_wspr_hash)) t->index15[n15 & 32767] = (uint16_t)(slot + 1);
+}
+
+static int by_order (void const * lhs, void const * rhs)
+{
+  uint32_t a = ((struct entry const *)lhs)->order;
+  uint32_t b = ((struct entry const *)rhs)->order;
+  return a < b ? -1 : a > b;
+}
+
+/*
+ * Reinsert the live calls, dropping those older than max_age (0 for
+ * no limit) and then the evict least recently saved. The direct maps
+ * are rebuilt oldest first so that the newest call still wins.
+ */
+static void rebuild (struct table * t, uint32_t now, uint32_t max_age, uint32_t evict)
+{
+  struct entry * keep = malloc (SLOTS * sizeof *keep);
+  uint32_t n = 0, i;
+  if (!keep) return;
+  for (i = 0; i < SLOTS; ++i)
+    {
+      struct entry const * e = &t->slots[i];
+      if (slot_used == e->state && (!max_age || e->seen > now || now - e->seen <= max_age))
+        {
+          keep[n++] = *e;
+        }
+    }
+  qsort (keep, n, sizeof *keep, by_order);
+  clear_table (t);
+  for (i = evict < n ? evict : n; i < n; ++i)
+    {
+      insert (t, keep[i].call, keep[i].n22, keep[i].n15, keep[i].flags, keep[i].seen, keep[i].order);
+    }
+  free (keep);
+}
+
+static void save (struct table * t, char const * call, uint32_t seen, uint8_t flags)
+{
+  uint32_t n22 = (uint32_t)hashcalls_ihashcall (call, strlen (call), 22);
+  uint16_t n15 = (uint16_t)(nhash (call, strlen (call), 146u) & 32767);
+  if (t->live >= MAX_LIVE && find_slot (t, n22) < 0)
+    {
+      rebuild (t, seen, 0, MAX_LIVE / 8);
+    }
+  insert (t, call, n22, n15, flags, seen, t->serial++);
+}
+
+int hashcalls_open (char const * path)
+{
+  struct table * t = map_table (path);
+  struct table * old;
+  int old_mapped;
+  uint32_t i, token, now = (uint32_t)time (NULL);
+  if (!t) return -1;
+  guard_exclusive ();
+  token = lock (t);
+  if (memcmp (t->magic, magic, sizeof magic) || t->size != sizeof *t)
+    {
+      init_table (t);
+    }
+  rebuild (t, now, DEFAULT_MAX_AGE, 0);
+
+  /* keep anything learned before the table was opened */
+  old = __atomic_exchange_n (&table, t, __ATOMIC_ACQ_REL);
+  old_mapped = table_mapped;
+  table_mapped = 1;
+  if (old)
+    {
+      for (i = 0; i < SLOTS; ++i)
+        {
+          if (slot_used == old->slots[i].state) save (t, old->slots[i].call, old->slots[i].seen, old->slots[i].flags);
+        }
+    }
+  unlock (t, token);
+  release_table (old, old_mapped);
+  unguard_exclusive ();
+  return 0;
+}
+
+void hashcalls_close (void)
+{
+  struct table * t;
+  guard_exclusive ();
+  t = __atomic_exchange_n (&table, NULL, __ATOMIC_ACQ_REL);
+  release_table (t, table_mapped);
+  table_mapped = 0;
+  unguard_exclusive ();
+}
+
+void hashcalls_save (char const * call, size_t length)
+{
+  char cw[HASHCALLS_CALL_CAP];
+  struct table * t;
+  uint32_t token;
+  if (normalize (call, length, cw) < 3) return;
+  guard_shared ();
+  if ((t = get_table ()))
+    {
+      token = lock (t);
+      /* seeing the call again makes its WSPR hash known again */
+      save (t, cw, (uint32_t)time (NULL), 0);
+      unlock (t, token);
+    }
+  unguard_shared ();
+}
+
+int hashcalls_lookup (int hash, int bits, char * call)
+{
+  struct table * t;
+  struct entry const * e = NULL;
+  int slot = -1;
+  uint32_t token;
+  if (hash < 0 || bits < 10 || bits > 22 || hash >= 1 << bits) return 0;
+  guard_shared ();
+  if (!(t = get_table ()))
+    {
+      unguard_shared ();
+      return 0;
+    }
+  token = lock (t);
+  switch (bits)
+    {
+    case 10: slot = t->index10[hash] - 1; break;
+    case 12: slot = t->index12[hash] - 1; break;
+    case 15: slot = t->index15[hash] - 1; break;
+    case 22: slot = find_slot (t, (uint32_t)hash); break;
+    }
+  if (slot >= 0)
+    {
+      /* the direct maps can point at a slot since taken by another call */
+      e = &t->slots[slot];
+      if (slot_used != e->state
+          || (10 == bits && (int)(e->n22 >> 12) != hash)
+          || (12 == bits && (int)(e->n22 >> 10) != hash)
+          || (15 == bits && (e->n15 != hash || e->flags & no_wspr_hash)))
+        {
+          e = NULL;
+        }
+    }
+  if (e)
+    {
+      size_t n = strlen (e->call);
+      memcpy (call, e->call, n);
+      memset (call + n, ' ', HASHCALLS_CALL_CAP - 1 - n);
+    }
+  unlock (t, token);
+  unguard_shared ();
+  return NULL != e;
+}
+
+void hashcalls_expire (uint32_t max_age)
+{
+  struct table * t;
+  uint32_t token;
+  guard_shared ();
+  if ((t = get_table ()))
+    {
+      token = lock (t);
+      rebuild (t, (uint32_t)time (NULL), max_age, 0);
+      unlock (t, token);
+    }
+  unguard_shared ();
+}
+
+void hashcalls_forget_wspr (void)
+{
+  struct table * t;
+  uint32_t i, token;
+  guard_shared ();
+  if ((t = get_table ()))
+    {
+      /* flagged rather than just unmapped so that rebuilding the
+         table, as every open does, does not bring them back */
+      token = lock (t);
+      for (i = 0; i < SLOTS; ++i) t->slots[i].flags |= no_wspr_hash;
+      memset (t->index15, 0, sizeof t->index15);
+      unlock (t, token);
+    }
+  unguard_shared ();
+}
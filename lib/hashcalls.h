@@ -0,0 +1,62 @@
+#ifndef HASHCALLS_H__
+#define HASHCALLS_H__
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+  /*
+   * Shared table of callsigns seen in full, used to resolve hashed
+   * <...> calls in any decoder
+   *
+   * Each call is indexed by the 10, 12 and 22 bit hashes of the 77-bit
+   * message formats (packjt77 ihashcall) and by the 15 bit WSPR type 3
+   * hash (nhash), so a call learned in one mode resolves in all the
+   * others. The table is a file mapped into memory, shared by every
+   * process that opens the same path and kept across sessions. Until
+   * hashcalls_open() succeeds a private in-memory table is used.
+   *
+   * All functions are safe to call from multiple threads and
+   * processes.
+   */
+
+#define HASHCALLS_CALL_CAP 14   /* 13 characters and a NUL */
+
+  /* map the table stored at path, 0 on success */
+  int hashcalls_open (char const * path);
+  void hashcalls_close (void);
+
+  /*
+   * remember call as the most recently seen call for its hashes, call
+   * may be blank padded and enclosed in <> and need not be NUL
+   * terminated
+   */
+  void hashcalls_save (char const * call, size_t length);
+
+  /*
+   * look up a 10, 12 or 22 bit hash, or a 15 bit WSPR hash with bits
+   * == 15, returns non-zero and the call blank padded to 13 characters
+   * (not NUL terminated) if found
+   */
+  int hashcalls_lookup (int hash, int bits, char * call);
+
+  /* drop calls not seen for max_age seconds */
+  void hashcalls_expire (uint32_t max_age);
+
+  /*
+   * forget the WSPR hashes only, the calls remain, a call's WSPR hash
+   * is known again once it is saved again
+   */
+  void hashcalls_forget_wspr (void);
+
+  /* the packjt77 hash of call as used by hashcalls_lookup() */
+  int hashcalls_ihashcall (char const * call, size_t length, int bits);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
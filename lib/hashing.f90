@@ -6,5 +6,24 @@ module hashing
        integer(c_size_t), intent(in), value :: length
        integer(c_int32_t), intent(in), value :: initval
      end function nhash
+
+! Shared table of full callsigns for resolving hashed calls, see hashcalls.h
+     integer(c_int) function hashcalls_open (path) bind(C, name="hashcalls_open")
+       use iso_c_binding, only: c_char, c_int
+       character(kind=c_char), dimension(*), intent(in) :: path
+     end function hashcalls_open
+
+     subroutine hashcalls_save (c13, length) bind(C, name="hashcalls_save")
+       use iso_c_binding, only: c_char, c_size_t
+       character(kind=c_char), dimension(*), intent(in) :: c13
+       integer(c_size_t), intent(in), value :: length
+     end subroutine hashcalls_save
+
+     integer(c_int) function hashcalls_lookup (n, nbits, c13) bind(C, name="hashcalls_lookup")
+       use iso_c_binding, only: c_char, c_int
+       integer(c_int), intent(in), value :: n
+       integer(c_int), intent(in), value :: nbits
+       character(kind=c_char), dimension(*), intent(out) :: c13
+     end function hashcalls_lookup
   end interface
 end module hashing
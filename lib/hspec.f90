@@ -18,19 +18,28 @@ subroutine hspec(id2,k,nutc0,ntrpdepth,nrxfreq,ntol,bmsk144,             &
 !  s()       spectrum for horizontal spectrogram
 !  jh        index of most recent data in green(), s()
 
+! In MSK144 mode hspec is called every NZ/8 samples. The full mskrtd
+! analysis runs every NZ/2 samples as before; in between, a running
+! energy detector on the spectrogram blocks watches for pings and
+! runs just the short ping decoders as soon as one arrives.
+
   parameter (JZ=703)
+  parameter (NZ=7168)                          !mskrtd block size
+  parameter (PTHRESH=2.0)                      !Ping threshold, 3 dB over floor
+  parameter (TFLOOR=2.0)                       !Floor rise time constant (s)
   character*(*) line1
   character*80  line0
   character*(*) datadir
   character*(*) mycall,hiscall
   integer*2 id2(0:120*12000-1)
   logical*1 bmsk144,bshmsg,btrain,bswl
+  logical*1 bping,bfull,bpingonly
   real green(0:JZ-1)
   real s(0:63,0:JZ-1)
   real x(512)
   real*8 pcoeffs(5)
   complex cx(0:256)
-  data rms/999.0/,k0/99999999/
+  data rms/999.0/,k0/99999999/,pfloor/0.0/,kfull/0/
   equivalence (x,cx)
   save ja,rms0
 
@@ -55,9 +64,11 @@ subroutine hspec(id2,k,nutc0,ntrpdepth,nrxfreq,ntol,bmsk144,             &
      ja=-nstep
      jh=-1
      rms0=0.0
+     kfull=0
   endif
 
   pxmax = 0;
+  bping=.false.
   do iblk=1,nblks
      if(jh.lt.JZ-1) jh=jh+1
      ja=ja+nstep
@@ -70,6 +81,16 @@ subroutine hspec(id2,k,nutc0,ntrpdepth,nrxfreq,ntol,bmsk144,             &
      if (xmax.gt.0.0) pxmax=20.0*log10(xmax);
      rms=sqrt(gain*sq/nfft)
      rms2=sqrt(sq/nfft);
+     if(bmsk144 .and. sq.gt.0.0) then
+! Noise floor is slow to rise and quick to fall
+        p=sq/nfft
+        if(pfloor.le.0.0 .or. p.lt.pfloor) then
+           pfloor=p
+        else
+           if(p.gt.PTHRESH*pfloor) bping=.true.
+           pfloor=pfloor + (p-pfloor)*nstep/(TFLOOR*12000.0)
+        endif
+     endif
      green(jh)=0.
      if(rms.gt.0.0) then
         green(jh)=20.0*log10(rms)
@@ -89,15 +110,19 @@ subroutine hspec(id2,k,nutc0,ntrpdepth,nrxfreq,ntol,bmsk144,             &
   k0=k
 
   if(bmsk144) then
-     if(k.ge.7168) then
-        tsec=(k-7168)/12000.0
-        k0=k-7168
-        tt1=sum(float(abs(id2(k0:k0+3583))))
-        k0=k-3584
-        tt2=sum(float(abs(id2(k0:k0+3583))))
+     bfull=k-kfull.ge.NZ/2
+     if(k.ge.NZ .and. (bfull .or. bping)) then
+        if(bfull) kfull=k
+        bpingonly=.not.bfull
+        tsec=(k-NZ)/12000.0
+        k0=k-NZ
+        tt1=sum(float(abs(id2(k0:k0+NZ/2-1))))
+        k0=k-NZ/2
+        tt2=sum(float(abs(id2(k0:k0+NZ/2-1))))
         if(tt1.ne.0.0 .and. tt2.ne.0) then
-           call mskrtd(id2(k-7168+1:k),nutc0,tsec,ntol,nrxfreq,ndepth,   &
-                mycall,hiscall,bshmsg,btrain,pcoeffs,bswl,datadir,line0)
+           call mskrtd(id2(k-NZ+1:k),nutc0,tsec,ntol,nrxfreq,ndepth,     &
+                mycall,hiscall,bshmsg,btrain,pcoeffs,bswl,bpingonly,     &
+                datadir,line0)
            if(line0(1:1).eq.char(0)) then 
               line1(1:1)=char(0)
            else
@@ -12,10 +12,12 @@ program jt9
   use readwav
   use ft8_mod1, only : dd8
   use jt65_mod6, only : dd
+  use hashing, only : hashcalls_open
 
   include 'jt9com.f90'
 
   integer*2 id2a(180000)
+  integer*2, allocatable :: flacbuf(:)
   integer(C_INT) iret
   type(wav_header) wav
   real*4 s(NSMAX)
@@ -30,8 +32,9 @@ program jt9
   logical :: read_files = .true., tx9 = .false., display_help = .false.,     &
        bLowSidelobes = .false., nexp_decode_set = .false.,                   &
        have_ntol = .false.,multift8 = .false.,hidedupes = .false.,           &
-       lft8lowth = .true.,lft8subpass = .true.,lwidedxcsearch = .true.
-  type (option) :: long_options(41) = [                                      &
+       lft8lowth = .true.,lft8subpass = .true.,lwidedxcsearch = .true.,      &
+       flac = .false.
+  type (option) :: long_options(42) = [                                      &
     option ('help', .false., 'h', 'Display this help message', ''),          &
     option ('shmem',.true.,'s','Use shared memory for sample data','KEY'),   &
     option ('tr-period', .true., 'p', 'Tx/Rx period, default SECONDS=60',    &
@@ -79,6 +82,7 @@ program jt9
         'START_TIME'),                                                       &
     option ('Skip-MTft8-WideDxCallSearch', .false., 'Z',                     & 
         'SKIP MTft8 Wideband DX Call Search', ''),                           &        
+    option ('ft2', .false., '2', 'FT2 mode', ''),                            &
     option ('q65', .false., '3', 'Q65 mode', ''),                            &
     option ('jt4', .false., '4', 'JT4 mode', ''),                            &
     option ('ft4', .false., '5', 'FT4 mode', ''),                            &
@@ -117,7 +121,7 @@ program jt9
   TRperiod=60.d0
 
   do
-     call getopt('hs:e:a:b:r:m:p:d:f:F:w:t:9876543WYqkTMUSZL:S:H:c:G:x:g:X:Q:C:R:N:E:D:',     &
+     call getopt('hs:e:a:b:r:m:p:d:f:F:w:t:98765432WYqkTMUSZL:S:H:c:G:x:g:X:Q:C:R:N:E:D:',     &
           long_options,c,optarg,arglen,stat,offset,remain,.true.)
      if (stat .ne. 0) then
         exit
@@ -175,6 +179,8 @@ program jt9
            mode = 144
         case ('Q')
            read (optarg(:arglen), *) nQSOProg
+        case ('2')
+           mode = 2
         case ('3')
            mode = 66
         case ('4')
@@ -216,7 +222,7 @@ program jt9
        .or. (read_files .and. remain .lt. 1)) then
 
      print *, 'Usage: jt9 [OPTIONS] file1 [file2 ...]'
-     print *, '       Reads data from *.wav files.'
+     print *, '       Reads data from *.wav or *.flac files.'
      print *, ''
      print *, '       jt9 -s <key> [-w patience] [-m threads] [-e path] [-a path] [-t path]'
      print *, '       Gets data from shared memory region with key==<key>'
@@ -238,6 +244,10 @@ program jt9
   wisfile=trim(data_dir)//'/jt9_wisdom.dat'// C_NULL_CHAR
   iret=fftwf_import_wisdom_from_filename(wisfile)
 
+! Hashed callsigns are resolved from a table shared with the other
+! decoders and kept across sessions
+  iret=hashcalls_open(trim(data_dir)//'/hashcalls.dat'//C_NULL_CHAR)
+
   ntry65a=0
   ntry65b=0
   n65a=0
@@ -277,10 +287,19 @@ program jt9
   do iarg = offset + 1, offset + remain
      call get_command_argument (iarg, optarg, arglen)
      infile = optarg(:arglen)
-     call wav%read (infile)
-     nfsample=wav%audio_format%sample_rate
-     i1=index(infile,'.wav')
-     if(i1.lt.1) i1=index(infile,'.WAV')
+     i1=index(infile,'.flac')
+     if(i1.lt.1) i1=index(infile,'.FLAC')
+     flac=i1.ge.1
+     if(flac) then
+        if(.not.allocated(flacbuf)) allocate(flacbuf(size(shared_data%id2)))
+        call read_flac(infile,flacbuf,nflac,nfsample,ierr)
+        if(ierr.ne.0) print*,'Error reading FLAC file ',trim(infile),ierr
+     else
+        call wav%read (infile)
+        nfsample=wav%audio_format%sample_rate
+        i1=index(infile,'.wav')
+        if(i1.lt.1) i1=index(infile,'.WAV')
+     endif
      if(infile(i1-5:i1-5).eq.'_') then
         read(infile(i1-4:i1-1),*,err=1) nutc
      else
@@ -299,13 +318,20 @@ program jt9
         call timer('jt9     ',0)
      endif
      shared_data%id2=0          !??? Why is this necessary ???
+     if(mode.eq.2) npts=45000
      if(mode.eq.5) npts=21*3456
      if(mode.eq.66) npts=TRperiod*12000
      do iblk=1,npts/kstep
         k=iblk*kstep
         if(mode.eq.8 .and. k.gt.179712) exit
         call timer('read_wav',0)
-        read(unit=wav%lun,end=3) shared_data%id2(k-kstep+1:k)
+        if(flac) then
+           if(k-kstep.ge.nflac) go to 3
+           n=min(k,nflac)
+           shared_data%id2(k-kstep+1:n)=flacbuf(k-kstep+1:n)
+        else
+           read(unit=wav%lun,end=3) shared_data%id2(k-kstep+1:k)
+        endif
         go to 4
 3       call timer('read_wav',1)
         print*,'EOF on input file ',trim(infile)
@@ -327,7 +353,7 @@ program jt9
               mode.ne.242 .and. mode.ne.66) exit
         endif
      enddo
-     close(unit=wav%lun)
+     if(.not.flac) close(unit=wav%lun)
 
      shared_data%params%nutc=nutc
      shared_data%params%ndiskdat=.true.
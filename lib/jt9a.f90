@@ -10,6 +10,8 @@ subroutine jt9a()
   include 'jt9com.f90'
 
   integer*2 id2a(180000)
+  integer*2, allocatable :: id2(:)       !Private copy of the samples to decode
+  real, allocatable :: ss(:,:)           !Private copy of the JT9 spectra
 ! Multiple instances:
   type(dec_data), pointer, volatile :: shared_data !also makes target volatile
   type(params_block) :: local_params
@@ -26,6 +28,10 @@ subroutine jt9a()
   if(.not.ok) call abort
   msdelay=10
   call c_f_pointer(shmem_address(),shared_data)
+  allocate(id2(NMAX),ss(184,NSMAX))
+  id2=0
+  ss=0.
+  nhigh=0
 
 ! Terminate if ipc(2) is 999
 10 ok=shmem_lock()
@@ -51,8 +57,27 @@ subroutine jt9a()
      go to 999
   endif
   local_params=shared_data%params !save a copy because wsjtx carries on accessing  
+  kgen=shared_data%kgen
   ok=shmem_unlock()
   if(.not.ok) call abort
+
+! wsjtx keeps capturing into the shared segment while we decode, take
+! a copy of just the samples (and spectra) this decode needs and check
+! that the capture did not restart while we were copying. Decoding
+! again (newdat=0) reuses the copy of the previous period.
+  if(local_params%newdat) then
+     nwin=min(NMAX,max(180000,12000*(local_params%ntr+1)))
+     npts=min(max(local_params%kin,0),nwin)
+     id2(1:npts)=shared_data%id2(1:npts)
+     id2(npts+1:max(nwin,nhigh))=0
+     nhigh=nwin
+     if(local_params%nmode.eq.9 .or. local_params%nmode.eq.(65+9)) ss=shared_data%ss
+     ok=shmem_lock()
+     if(.not.ok) call abort
+     if(shared_data%kgen.ne.kgen) id2(1:npts)=0   !Overwritten, nothing to decode
+     ok=shmem_unlock()
+     if(.not.ok) call abort
+  endif
   call flush(6)
   call timer('decoder ',0)
   if(local_params%nmode.eq.8 .and. local_params%ndiskdat .and.    &
@@ -60,14 +85,14 @@ subroutine jt9a()
 ! Early decoding pass, FT8 only, when wsjtx reads from disk
      nearly=41
      local_params%nzhsym=nearly
-     id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+     id2a(1:nearly*3456)=id2(1:nearly*3456)
      id2a(nearly*3456+1:)=0
-     call multimode_decoder(shared_data%ss,id2a,local_params,12000)
+     call multimode_decoder(ss,id2a,local_params,12000)
      nearly=47
      local_params%nzhsym=nearly
-     id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+     id2a(1:nearly*3456)=id2(1:nearly*3456)
      id2a(nearly*3456+1:)=0
-     call multimode_decoder(shared_data%ss,id2a,local_params,12000)
+     call multimode_decoder(ss,id2a,local_params,12000)
      local_params%nzhsym=50
   endif
   
@@ -79,48 +104,41 @@ subroutine jt9a()
         nearly=41
         local_params%lmultift8=.false.
         local_params%nzhsym=nearly
-        id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        id2a(1:nearly*3456)=id2(1:nearly*3456)
         id2a(nearly*3456+1:)=0
-        call multimode_decoder(shared_data%ss,id2a,local_params,12000)
+        call multimode_decoder(ss,id2a,local_params,12000)
         if(local_params%ndecoderstart.lt.2) then
            nearly=46
            local_params%lmultift8=.false.
            local_params%nzhsym=nearly
-           id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+           id2a(1:nearly*3456)=id2(1:nearly*3456)
            id2a(nearly*3456+1:)=0
-           call multimode_decoder(shared_data%ss,id2a,local_params,12000)
+           call multimode_decoder(ss,id2a,local_params,12000)
         endif
         if(local_params%ndecoderstart.eq.0) nearly=49
         if(local_params%ndecoderstart.eq.1) nearly=50
         local_params%lmultift8=.true.
-        shared_data%params%nzhsym=nearly
-        id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        id2a(1:nearly*3456)=id2(1:nearly*3456)
         id2a(nearly*3456+1:)=0
-        dd(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        dd(1:nearly*3456)=id2(1:nearly*3456)
         dd(nearly*3456+1:)=0
-        dd8(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        dd8(1:nearly*3456)=id2(1:nearly*3456)
         dd8(nearly*3456+1:)=0
-        if(local_params%ndecoderstart.eq.0) shared_data%params%nzhsym=49
-        if(local_params%ndecoderstart.eq.1) shared_data%params%nzhsym=50
      else
         nearly=50
         if(local_params%ndecoderstart.eq.2) nearly=48
         if(local_params%ndecoderstart.eq.3) nearly=49
         if(local_params%ndecoderstart.eq.4) nearly=50
-        shared_data%params%nzhsym=nearly
-        id2a(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        id2a(1:nearly*3456)=id2(1:nearly*3456)
         id2a(nearly*3456+1:)=0
-        dd(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        dd(1:nearly*3456)=id2(1:nearly*3456)
         dd(nearly*3456+1:)=0
-        dd8(1:nearly*3456)=shared_data%id2(1:nearly*3456)
+        dd8(1:nearly*3456)=id2(1:nearly*3456)
         dd8(nearly*3456+1:)=0
-        if(local_params%ndecoderstart.eq.2) shared_data%params%nzhsym=48
-        if(local_params%ndecoderstart.eq.3) shared_data%params%nzhsym=49
-        if(local_params%ndecoderstart.eq.4) shared_data%params%nzhsym=50
      endif
   elseif (local_params%nmode.eq.8 .and. local_params%lmultift8 .and. .not. &
        local_params%ndiskdat) then
-     dd(1:npts1)=shared_data%id2(1:npts1)
+     dd(1:npts1)=id2(1:npts1)
      rms=sum(abs(dd(1:10))) + sum(abs(dd(76001:76010))) + sum(abs(dd(151670:151680)))
      dd8(1:npts1)=dd(1:npts1)
 
@@ -140,10 +158,10 @@ subroutine jt9a()
 
   if(local_params%nmode .eq. 144) then
     ! MSK144
-     call decode_msk144(shared_data%id2, shared_data%params, data_dir)
+     call decode_msk144(id2, local_params, data_dir)
   else
     ! Normal decoding pass
-     call multimode_decoder(shared_data%ss,shared_data%id2,local_params,12000)
+     call multimode_decoder(ss,id2,local_params,12000)
   endif
 
   call timer('decoder ',1)
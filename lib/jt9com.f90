@@ -93,6 +93,7 @@
 
   type, bind(C) :: dec_data
      integer(c_int) :: ipc(3)
+     integer(c_int) :: kgen       !Bumped whenever the capture in id2 restarts
      real(c_float) :: ss(184,NSMAX)
      real(c_float) :: savg(NSMAX)
      real(c_float) :: sred(5760)
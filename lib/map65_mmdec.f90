@@ -18,8 +18,6 @@ subroutine map65_mmdec(nutc,id2,nqd,ntrperiod, nsubmode,nfa,nfb,nfqso,   &
 !  type(params_block) :: params
   character(len=12) :: mycall, hiscall
   character(len=6) :: hisgrid
-  data ntr0/-1/
-  save
   type(counting_q65_decoder) :: my_q65
 
 ! Cast C character arrays to Fortran character strings
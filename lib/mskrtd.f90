@@ -1,9 +1,14 @@
 subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
-     bshmsg,btrain,pcoeffs,bswl,datadir,line)
+     bshmsg,btrain,pcoeffs,bswl,bpingonly,datadir,line)
 
 ! Real-time decoder for MSK144.  
 ! Analysis block size = NZ = 7168 samples, t_block = 0.597333 s 
-! Called from hspec() at half-block increments, about 0.3 s
+! Called from hspec() at half-block increments, about 0.3 s, and with
+! bpingonly set as soon as a ping arrives in between. Then only the
+! short ping decoders are tried and the noise estimate is left alone.
+! Those calls overlap each other and the full ones, so a message seen
+! again in a block overlapping the one it was reported from is not
+! reported again if either call was ping only.
 
   use packjt77
 
@@ -38,12 +43,13 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
   real xmc(NPATTERNS)
   real*8 pcoeffs(5)
 
-  logical*1 bshmsg,btrain,bswl
+  logical*1 bshmsg,btrain,bswl,bpingonly
   logical*1 first
   logical*1 bshdecode
   logical*1 seenb4
   logical*1 bflag
   logical*1 bvar
+  logical*1 bpinglast,bpinglastswl
  
   data first/.true./
   data iavpatterns/ &
@@ -53,7 +59,8 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
        1,1,1,1,1,1,1,0/
   data xmc/2.0,4.5,2.5,3.5/     !Used to set time at center of averaging mask
   save first,tsec0,nutc00,pnoise,cdat,msglast,msglastswl,     &
-       nsnrlast,nsnrlastswl,nhasharray,recent_shmsgs
+       nsnrlast,nsnrlastswl,nhasharray,recent_shmsgs,             &
+       tseclast,tseclastswl,bpinglast,bpinglastswl
 !       nsnrlast,nsnrlastswl,nhasharray,recent_shmsgs,mycall13
 
   if(first) then
@@ -70,6 +77,10 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
      msglastswl='                                     '
      nsnrlast=-99
      nsnrlastswl=-99
+     tseclast=-99.0
+     tseclastswl=-99.0
+     bpinglast=.false.
+     bpinglastswl=.false.
 !     mycall13=mycall//' '
 !     dxcall13=hiscall//' '
      mycall13=' '
@@ -90,9 +101,12 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
     msglastswl='                                     '
     nsnrlast=-99
     nsnrlastswl=-99
+    tseclast=-99.0
+    tseclastswl=-99.0
     nutc00=nutc0
   endif
   
+  tblock=float(NZ)/12000.0
   tframe=float(NSPM)/12000.0 
   line(1:1)=char(0)
   msgreceived='                                     '
@@ -138,6 +152,7 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
     is=0
     goto 900
   endif 
+  if( bpingonly ) go to 999
 
 ! If short ping decoder doesn't find a decode, 
 ! Fast - short ping decoder only. 
@@ -210,9 +225,13 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
 ! Dupe check. 
   bflag=ndecodesuccess.eq.1 .and.                                              &
         (msgreceived.ne.msglast .or. nsnr.gt.nsnrlast .or. tsec.lt.tsec0)
+  if(bflag .and. msgreceived.eq.msglast .and. tsec.lt.tseclast+tblock .and.    &
+       (bpingonly .or. bpinglast)) bflag=.false.   !Same ping, overlapping block
   if(bflag) then
      msglast=msgreceived
      nsnrlast=nsnr
+     tseclast=tsec
+     bpinglast=bpingonly
      if(.not. bshdecode) then
         call update_msk40_hasharray(nhasharray)
      endif
@@ -229,9 +248,14 @@ subroutine mskrtd(id2,nutc0,tsec,ntol,nrxfreq,ndepth,mycall,hiscall,      &
     bflag=seenb4 .and.                                                        &
       (msgreceived.ne.msglastswl .or. nsnr.gt.nsnrlastswl .or. tsec.lt.tsec0) & 
       .and. nsnr.gt.-6
+    if(bflag .and. msgreceived.eq.msglastswl .and.                            &
+         tsec.lt.tseclastswl+tblock .and. (bpingonly .or. bpinglastswl))       &
+         bflag=.false.
     if(bflag) then
       msglastswl=msgreceived
       nsnrlastswl=nsnr
+      tseclastswl=tsec
+      bpinglastswl=bpingonly
       write(line,1021) nutc0,nsnr,tdec,nint(fest),decsym,msgreceived,char(0)
     endif
   endif
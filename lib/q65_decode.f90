@@ -3,6 +3,7 @@ module q65_decode
   integer nsnr0,nfreq0
   real xdt0
   character msg0*37,cq0*3
+!$omp threadprivate(nsnr0,nfreq0,xdt0,msg0,cq0)
 
   type :: q65_decoder
      procedure(q65_decode_callback), pointer :: callback
@@ -68,7 +69,6 @@ contains
     character*37 decoded                  !Decoded message
     character*37 decodes(100)
     character*77 c77
-    character*78 c78
     character*6 cutc
     character c6*6,c4*4,cmode*4
     character*80 fmt
@@ -83,11 +83,12 @@ contains
     integer time
     logical lclearave,lnewdat0,lapcqonly,unpk77_success
     logical single_decode,lagain
-    complex c00(0:3600000)                !Analytic signal, 6000 Sa/s
+    complex, allocatable, save :: c00(:)  !Analytic signal, 6000 Sa/s
     type(q3list) callers(MAX_CALLERS)
-    save c00
+!$omp threadprivate(c00)
 
 ! Start by setting some parameters and allocating storage for large arrays
+    if(.not.allocated(c00)) allocate(c00(0:NMAX))
     call sec0(0,tdecode)
     stageno=0
     ndecodes=0
@@ -114,6 +115,7 @@ contains
     mycall13=mycall
     if(ncontest.eq.1) then
 ! NA VHF, WW-Digi, or ARRL Digi Contest
+!$omp critical(q65_hist)
        open(24,file=trim(data_dir)//'/tsil.3q',status='unknown',     &
             form='unformatted')
        read(24,end=2) nhist2
@@ -131,6 +133,7 @@ contains
           nhist2=0
        endif
 2      close(24)
+!$omp end critical(q65_hist)
     endif
 
 ! Determine the T/R sequence: iseq=0 (even), or iseq=1 (odd)
@@ -145,7 +148,9 @@ contains
     allocate(dd(npts))
 
     if(lagain) then
+!$omp critical(q65_hist)
        call q65_hist(nfqso,dxcall=hiscall,dxgrid=hisgrid)
+!$omp end critical(q65_hist)
     endif
 
     nsps=1800
@@ -187,12 +192,14 @@ contains
     if(ichar(hisgrid(1:1)).eq.0) hisgrid=' '
     ncw=0
     if(nqd.eq.1 .or. lagain .or. ncontest.eq.1) then
+!$omp critical(q65_packjt77)
        if(ncontest.eq.1) then
           call q65_set_list2(mycall,hiscall,hisgrid,callers,nhist2,   &
                codewords,ncw)
        else
           call q65_set_list(mycall,hiscall,hisgrid,codewords,ncw)
        endif
+!$omp end critical(q65_packjt77)
     endif
     dgen=0
     call q65_enc(dgen,codewords)         !Initialize the Q65 codec
@@ -200,7 +207,9 @@ contains
     iavg=0
 
 ! W3SZ patch: Initialize AP params here, rather than afer the call to ana64().
+!$omp critical(q65_packjt77)
     call ft8apset(mycall,hiscall,ncontest,apsym0,aph10) ! Generate ap symbols
+!$omp end critical(q65_packjt77)
     where(apsym0.eq.-1) apsym0=0
     npasses=2
     if(nQSOprogress.eq.5) npasses=3
@@ -235,12 +244,8 @@ contains
           ! Subsequent passes use AP information appropiate for nQSOprogress
           call q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
                apsym0,apmask1,apsymbols1)
-          write(c78,1050) apmask1
-1050      format(78i1)
-          read(c78,1060) apmask
-1060      format(13b6.6)
-          write(c78,1050) apsymbols1
-          read(c78,1060) apsymbols
+          call q65_ap_pack(apmask1,apmask)
+          call q65_ap_pack(apsymbols1,apsymbols)
        endif
 
        call timer('q65loop1',0)
@@ -314,7 +319,9 @@ contains
 ! Unpack decoded message for display to user
        write(c77,1000) dat4(1:12),dat4(13)/2
 1000   format(12b6.6,b5.5)
+!$omp critical(q65_packjt77)
        call unpack77(c77,1,decoded,unpk77_success) !Unpack to get decoded
+!$omp end critical(q65_packjt77)
        idupe=0
        do i=1,ndecodes
           if(decodes(i).eq.decoded) idupe=1
@@ -328,14 +335,17 @@ contains
           nsnr=nint(snr2)
           call this%callback(nutc,snr1,nsnr,dtdec,f0dec,decoded,    &
                idec,nused,ntrperiod)
+!$omp critical(q65_hist)
           if(ncontest.eq.1) then
              call q65_hist2(nint(f0dec),decoded,callers,nhist2)
           else
              call q65_hist(nint(f0dec),msg0=decoded)
           endif
+!$omp end critical(q65_hist)
           if(iand(ndepth,128).ne.0 .and. .not.lagain .and.      &
                int(abs(f0dec-nfqso)).le.ntol ) call q65_clravg    !AutoClrAvg
           call sec0(1,tdecode)
+!$omp critical(q65_decodes_txt)
           open(22,file=trim(data_dir)//'/q65_decodes.txt',status='unknown',  &
                position='append',iostat=ios)
           if(ios.eq.0) then
@@ -355,6 +365,7 @@ contains
                   f0,snr2,plog,tdecode,mycall(1:6),c6,c4,trim(decoded)
              close(22)
           endif
+!$omp end critical(q65_decodes_txt)
        endif
     endif
     navg0=1000*navg(0) + navg(1)
@@ -389,7 +400,9 @@ contains
        if(ntrperiod.le.30) jpk0=(xdt+0.5)*6000  !For shortest sequences
        if(jpk0.lt.0) jpk0=0
        call ana64(iwave,npts,c00)       !Convert to complex c00() at 6000 Sa/s
+!$omp critical(q65_packjt77)
        call ft8apset(mycall,hiscall,ncontest,apsym0,aph10) ! Generate ap symbols
+!$omp end critical(q65_packjt77)
        where(apsym0.eq.-1) apsym0=0
 
        npasses=2
@@ -405,10 +418,8 @@ contains
           ! Subsequent passes use AP information appropiate for nQSOprogress
              call q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
                   apsym0,apmask1,apsymbols1)
-             write(c78,1050) apmask1
-             read(c78,1060) apmask
-             write(c78,1050) apsymbols1
-             read(c78,1060) apsymbols
+             call q65_ap_pack(apmask1,apmask)
+             call q65_ap_pack(apsymbols1,apsymbols)
           endif
 
           call timer('q65loop2',0)
@@ -427,7 +438,9 @@ contains
        if(idec.ge.0) then
 ! Unpack decoded message for display to user
           write(c77,1000) dat4(1:12),dat4(13)/2
+!$omp critical(q65_packjt77)
           call unpack77(c77,1,decoded,unpk77_success) !Unpack to get decoded
+!$omp end critical(q65_packjt77)
           idupe=0
           do i=1,ndecodes
              if(decodes(i).eq.decoded) idupe=1
@@ -440,15 +453,18 @@ contains
              nsnr=nint(snr2)
              call this%callback(nutc,snr1,nsnr,dtdec,f0dec,decoded,    &
                   idec,nused,ntrperiod)
+!$omp critical(q65_hist)
              if(ncontest.eq.1) then
                 call q65_hist2(nint(f0dec),decoded,callers,nhist2)
              else
                 call q65_hist(nint(f0dec),msg0=decoded)
              endif
+!$omp end critical(q65_hist)
              if(iand(ndepth,128).ne.0 .and. .not.lagain .and.      &
                   int(abs(f0dec-nfqso)).le.ntol ) call q65_clravg    !AutoClrAvg
              call sec0(1,tdecode)
              ios=1
+!$omp critical(q65_decodes_txt)
              open(22,file=trim(data_dir)//'/q65_decodes.txt',status='unknown',&
                   position='append',iostat=ios)
              if(ios.eq.0) then
@@ -469,6 +485,7 @@ contains
                      trim(decoded)
                 close(22)
              endif
+!$omp end critical(q65_decodes_txt)
           endif
        endif
 800    continue
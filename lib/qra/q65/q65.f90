@@ -2,6 +2,7 @@ module q65
 
   parameter (NSTEP=8)          !Number of time bins per symbol in s1, s1a, s1b
   parameter (PLOG_MIN=-242.0)        !List decoding threshold
+  parameter (NBLK22=64)        !Freq bins per parallel block in q65_ccf_22
   integer iz0,jz0
 !  integer listutc(10)
   integer apsym0(58),aph10(10)
@@ -24,6 +25,15 @@ module q65
   real, allocatable,save :: ccf2_avg(:)  !Like ccf2, but for avg (red curve)
   real sync(85)                          !sync vector
   real df,dtstep,dtdec,f0dec,ftol,plog,drift
+! Each thread decodes with its own copy of the state above, so that
+! qmap can decode several candidates at once.  Parallel regions inside
+! the module must copy in every one of these they read, loop bounds
+! included, or their worker threads see stale values.
+!$omp threadprivate(iz0,jz0,apsym0,aph10,apmask1,apsymbols1,apmask,         &
+!$omp& apsymbols,codewords,ibwa,ibwb,ncw,nsps,mode_q65,nfa,nfb,nqd,idfbest,  &
+!$omp& idtbest,ibw,ndistbest,maxiters,max_drift,istep,nsmo,lag1,lag2,        &
+!$omp& npasses,iseq,ncand,nrc,i0,j0,navg,lnewdat,candidates,s1,s1w,s1a,      &
+!$omp& ccf2,ccf2_avg,sync,df,dtstep,dtdec,f0dec,ftol,plog,drift)
 
 contains
 
@@ -67,6 +77,7 @@ subroutine q65_dec0(iavg,iwave,ntrperiod,nfqso,ntol,lclearave,  &
   real, allocatable :: ccf1(:)           !CCF(freq) at fixed lag (red)
   data first/.true./
   save first,LL0
+!$omp threadprivate(first,LL0)
 
   integer w3t
   integer w3f
@@ -202,7 +213,9 @@ subroutine q65_dec0(iavg,iwave,ntrperiod,nfqso,ntol,lclearave,  &
   enddo
   width=df*(i2-i1)
   if(ncw.eq.0) ccf1=0.
+!$omp critical(q65_write_red)
   call q65_write_red(iz,xdt,ccf2_avg,ccf2)   !### Need this call for WSJT-X
+!$omp end critical(q65_write_red)
 
   if(idec.lt.0 .and. (iavg.eq.0 .or. iavg.eq.2)) then
      call q65_dec_q012(s3,LL,snr2,dat4,idec,decoded)
@@ -268,9 +281,10 @@ subroutine q65_symspec(iwave,nmax,iz,jz,s1)
   
   integer*2 iwave(0:nmax-1)              !Raw data
   real s1(iz,jz)
-  complex c0(0:41472)                    !Largest requirement, Q65-300x
-  save c0
+  complex, allocatable, save :: c0(:)
+!$omp threadprivate(c0)
 
+  if(.not.allocated(c0)) allocate(c0(0:41472)) !Largest requirement, Q65-300x
   nfft=nsps
   fac=1/32767.0
   do j=1,jz,2                     !Compute symbol spectra at 2*step size
@@ -345,7 +359,6 @@ subroutine q65_dec_q012(s3,LL,snr2,dat4,idec,decoded)
 ! Do separate passes attempting q0, q1, q2 decodes.
   
   character*37 decoded
-  character*78 c78
   integer dat4(13)
   real s3(-64:LL-65,63)
   logical lapcqonly
@@ -369,12 +382,8 @@ subroutine q65_dec_q012(s3,LL,snr2,dat4,idec,decoded)
         ! Subsequent passes use AP information appropiate for nQSOprogress
         call q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
              apsym0,apmask1,apsymbols1)
-        write(c78,1050) apmask1
-1050    format(78i1)
-        read(c78,1060) apmask
-1060    format(13b6.6)
-        write(c78,1050) apsymbols1
-        read(c78,1060) apsymbols
+        call q65_ap_pack(apmask1,apmask)
+        call q65_ap_pack(apsymbols1,apsymbols)
      endif
 
      do ibw=ibwa,ibwb
@@ -398,66 +407,58 @@ subroutine q65_ccf_85(s1,iz,jz,nfqso,ia,ia2,ipk,jpk,f0,xdt,imsg_best,   &
 
 ! Attempt synchronization using all 85 symbols, in advance of an
 ! attempt at q3 decoding.  Return ccf1 for the "red sync curve".
+! List messages are independent, so they are correlated in parallel;
+! the best one is then chosen serially, in message order, so that the
+! result does not depend on the number of threads.
   
   real s1(iz,jz)
   real, allocatable :: ccf(:,:)          !CCF(freq,lag)
   real, allocatable :: best(:)           !best(imsg) -- for checking 2nd best
+  integer, allocatable :: ipkm(:),jpkm(:) !Peak freq and lag for each imsg
   real ccf1(-ia2:ia2)
   integer ijpk(2)
-  integer itone(85)
 
-  allocate(ccf(-ia2:ia2,-53:214))
   allocate(best(ncw))
+  allocate(ipkm(ncw))
+  allocate(jpkm(ncw))
   ipk=0
   jpk=0
   ccf_best=0.
   imsg_best=-1
-  do imsg=1,ncw
-     i=1
-     k=0
-     do j=1,85
-        if(j.eq.isync(i)) then
-           i=i+1
-           itone(j)=0
-        else
-           k=k+1
-           itone(j)=codewords(k,imsg) + 1
-        endif
-     enddo
+  iia=200.0/df
 
-! Compute 2D ccf using all 85 symbols in the list message
-     ccf=0.
-     iia=200.0/df
-
-     do lag=lag1,lag2
-        do k=1,85
-           j=j0 + NSTEP*(k-1) + 1 + lag
-           if(j.ge.1 .and. j.le.jz) then
-              do i=-ia2,ia2
-                 ii=i0+mode_q65*itone(k)+i
-                 if(ii.ge.iia .and. ii.le.iz) ccf(i,lag)=ccf(i,lag) + s1(ii,j)
-              enddo
-           endif
-        enddo
-     enddo
+!$omp parallel default(shared) private(imsg,ccf,ijpk)                       &
+!$omp& copyin(codewords,ncw,lag1,lag2,i0,j0,mode_q65) if(ncw.gt.1)
+  allocate(ccf(-ia2:ia2,-53:214))
+!$omp do schedule(dynamic)
+  do imsg=1,ncw
+     call q65_ccf_85_msg(s1,iz,jz,ia2,iia,imsg,ccf)
+     best(imsg)=maxval(ccf(-ia:ia,:))
+     ijpk=maxloc(ccf(-ia:ia,:))
+     ipkm(imsg)=ijpk(1)-ia-1
+     jpkm(imsg)=ijpk(2)-53-1
+  enddo  ! imsg
+!$omp end do
+  deallocate(ccf)
+!$omp end parallel
 
-     ccfmax=maxval(ccf(-ia:ia,:))
-     if(ccfmax.gt.ccf_best) then
-        ccf_best=ccfmax
-        ijpk=maxloc(ccf(-ia:ia,:))
-        ipk=ijpk(1)-ia-1
-        jpk=ijpk(2)-53-1
-        f0=nfqso + ipk*df
-        xdt=jpk*dtstep
+  do imsg=1,ncw
+     if(best(imsg).gt.ccf_best) then
+        ccf_best=best(imsg)
+        ipk=ipkm(imsg)
+        jpk=jpkm(imsg)
         imsg_best=imsg
-        ccf1=ccf(:,jpk)
      endif
-     best(imsg)=ccfmax
-  enddo  ! imsg
+  enddo
 
-  deallocate(ccf)
   better=0.
   if(imsg_best.gt.0) then
+     f0=nfqso + ipk*df
+     xdt=jpk*dtstep
+     allocate(ccf(-ia2:ia2,-53:214))
+     call q65_ccf_85_msg(s1,iz,jz,ia2,iia,imsg_best,ccf)
+     ccf1=ccf(:,jpk)
+     deallocate(ccf)
      best(imsg_best)=0.
      better=ccf_best/maxval(best)
   endif
@@ -465,10 +466,50 @@ subroutine q65_ccf_85(s1,iz,jz,nfqso,ia,ia2,ipk,jpk,f0,xdt,imsg_best,   &
   return
 end subroutine q65_ccf_85
 
+subroutine q65_ccf_85_msg(s1,iz,jz,ia2,iia,imsg,ccf)
+
+! Compute 2D ccf using all 85 symbols of list message imsg.  The inner
+! loop runs over a contiguous range of frequency bins so that it
+! vectorizes; summation order is the same as a bin-by-bin loop.
+
+  real s1(iz,jz)
+  real ccf(-ia2:ia2,-53:214)             !CCF(freq,lag)
+  integer itone(85)
+
+  i=1
+  k=0
+  do j=1,85
+     if(j.eq.isync(i)) then
+        i=i+1
+        itone(j)=0
+     else
+        k=k+1
+        itone(j)=codewords(k,imsg) + 1
+     endif
+  enddo
+
+  ccf=0.
+  do lag=lag1,lag2
+     do k=1,85
+        j=j0 + NSTEP*(k-1) + 1 + lag
+        if(j.lt.1 .or. j.gt.jz) cycle
+        ii0=i0+mode_q65*itone(k)
+        ilo=max(-ia2,iia-ii0)
+        ihi=min(ia2,iz-ii0)
+        if(ilo.gt.ihi) cycle
+        ccf(ilo:ihi,lag)=ccf(ilo:ihi,lag) + s1(ii0+ilo:ii0+ihi,j)
+     enddo
+  enddo
+
+  return
+end subroutine q65_ccf_85_msg
+
 subroutine q65_ccf_22(s1,iz,jz,nfqso,ntol,ipk,jpk,f0,xdt,ccf2)
 
 ! Attempt synchronization using only the 22 sync symbols.  Return ccf2
-! for the "orange sync curve".
+! for the "orange sync curve".  The frequency range is split into blocks
+! of NBLK22 bins that are searched in parallel; the best candidate is
+! then chosen serially, in frequency order.
 
   real s1(iz,jz)
   real ccf2(iz)                               !Orange sync curve
@@ -476,10 +517,16 @@ subroutine q65_ccf_22(s1,iz,jz,nfqso,ntol,ipk,jpk,f0,xdt,ccf2)
   real, allocatable :: xdt2(:)
   real, allocatable :: s1avg(:)
   integer, allocatable :: indx(:)
+  integer, allocatable :: lagpk(:)            !Best lag for each freq bin
+  integer, allocatable :: idpk(:)             !Best drift for each freq bin
+  integer, allocatable :: ioff(:,:)           !Drift offsets ioff(kk,idrift)
 
   allocate(xdt2(iz))
   allocate(s1avg(iz))
   allocate(indx(iz))
+  allocate(lagpk(iz))
+  allocate(idpk(iz))
+  allocate(ioff(22,-max_drift:max_drift))
 
   ia=max(nfa,100)/df
   ib=min(nfb,4900)/df
@@ -493,44 +540,33 @@ subroutine q65_ccf_22(s1,iz,jz,nfqso,ntol,ipk,jpk,f0,xdt,ccf2)
      s1avg(i)=sum(s1(i,1:jz))
   enddo
 
+  do idrift=-max_drift,max_drift
+     do kk=1,22
+        ioff(kk,idrift)=nint(idrift*(isync(kk)-43)/85.0)
+     enddo
+  enddo
+
+  nblk=(ib-ia)/NBLK22 + 1
+!$omp parallel do schedule(dynamic) default(shared) private(iblk,i1,i2) &
+!$omp& copyin(lag1,lag2,j0,max_drift) if(nblk.gt.1)
+  do iblk=1,nblk
+     i1=ia + NBLK22*(iblk-1)
+     i2=min(ib,i1+NBLK22-1)
+     call q65_ccf_22_blk(s1,iz,jz,i1,i2,ioff,s1avg,ccf2,lagpk,idpk)
+  enddo
+!$omp end parallel do
+
   ccfbest=0.
   ibest=0
-  lagpk=0
   lagbest=0
-  idrift_max=0
   idrift_best=0
-
   do i=ia,ib
-     ccfmax=0.
-     do lag=lag1,lag2
-        do idrift=-max_drift,max_drift
-           ccft=0.
-           do kk=1,22
-              k=isync(kk)
-              ii=i + nint(idrift*(k-43)/85.0)
-              if(ii.lt.1 .or. ii.gt.iz) cycle
-              n=NSTEP*(k-1) + 1
-              j=n+lag+j0
-              if(j.ge.1 .and. j.le.jz) ccft=ccft + s1(ii,j)
-           enddo  ! kk
-           ccft=ccft - (22.0/jz)*s1avg(i)
-           if(ccft.gt.ccfmax) then
-              ccfmax=ccft
-              lagpk=lag
-              idrift_max=idrift
-           endif
-        enddo  ! idrift
-     enddo  ! lag
-
-     ccf2(i)=ccfmax
-     xdt2(i)=lagpk*dtstep
-
-     if(ccfmax.gt.ccfbest .and. abs(i*df-nfqso).le.ftol) then
-        ccfbest=ccfmax
-        snrbest=snr
+     xdt2(i)=lagpk(i)*dtstep
+     if(ccf2(i).gt.ccfbest .and. abs(i*df-nfqso).le.ftol) then
+        ccfbest=ccf2(i)
         ibest=i
-        lagbest=lagpk
-        idrift_best=idrift_max
+        lagbest=lagpk(i)
+        idrift_best=idpk(i)
      endif
   enddo  ! i
 
@@ -581,6 +617,52 @@ subroutine q65_ccf_22(s1,iz,jz,nfqso,ntol,ipk,jpk,f0,xdt,ccf2)
   return
 end subroutine q65_ccf_22
 
+subroutine q65_ccf_22_blk(s1,iz,jz,i1,i2,ioff,s1avg,ccf2,lagpk,idpk)
+
+! Sync-symbol ccf for frequency bins i1:i2, maximized over lag and drift.
+! For fixed lag and drift each sync symbol contributes a contiguous slice
+! of one s1 column, so the work is done as vector adds over frequency.
+
+  real s1(iz,jz)
+  integer ioff(22,-max_drift:max_drift)
+  real s1avg(iz)
+  real ccf2(iz)
+  integer lagpk(iz),idpk(iz)
+  real ccft(NBLK22)
+  real ccfmax(NBLK22)
+
+  nb=i2-i1+1
+  ccfmax(1:nb)=0.
+  lagpk(i1:i2)=0
+  idpk(i1:i2)=0
+  do lag=lag1,lag2
+     do idrift=-max_drift,max_drift
+        ccft(1:nb)=0.
+        do kk=1,22
+           j=NSTEP*(isync(kk)-1) + 1 + lag + j0
+           if(j.lt.1 .or. j.gt.jz) cycle
+           ioffk=ioff(kk,idrift)
+           ilo=max(i1,1-ioffk)
+           ihi=min(i2,iz-ioffk)
+           if(ilo.gt.ihi) cycle
+           ccft(ilo-i1+1:ihi-i1+1)=ccft(ilo-i1+1:ihi-i1+1) +             &
+                s1(ilo+ioffk:ihi+ioffk,j)
+        enddo  ! kk
+        do n=1,nb
+           c=ccft(n) - (22.0/jz)*s1avg(i1+n-1)
+           if(c.gt.ccfmax(n)) then
+              ccfmax(n)=c
+              lagpk(i1+n-1)=lag
+              idpk(i1+n-1)=idrift
+           endif
+        enddo
+     enddo  ! idrift
+  enddo  ! lag
+  ccf2(i1:i2)=ccfmax(1:nb)
+
+  return
+end subroutine q65_ccf_22_blk
+
 subroutine q65_dec1(s3,nsubmode,b90ts,esnodb,irc,dat4,decoded)
 
 ! Attmpt a full-AP list decode.
@@ -600,7 +682,9 @@ subroutine q65_dec1(s3,nsubmode,b90ts,esnodb,irc,dat4,decoded)
   if(irc.ge.0 .and. plog.gt.PLOG_MIN) then
      write(c77,1000) dat4(1:12),dat4(13)/2
 1000 format(12b6.6,b5.5)
+!$omp critical(q65_packjt77)
      call unpack77(c77,0,decoded,unpk77_success) !Unpack to get msgsent
+!$omp end critical(q65_packjt77)
   else
      irc=-1
   endif
@@ -629,7 +713,9 @@ subroutine q65_dec2(s3,nsubmode,b90ts,esnodb,irc,dat4,decoded)
   if(irc.ge.0) then
      write(c77,1000) dat4(1:12),dat4(13)/2
 1000 format(12b6.6,b5.5)
+!$omp critical(q65_packjt77)
      call unpack77(c77,0,decoded,unpk77_success) !Unpack to get msgsent
+!$omp end critical(q65_packjt77)
   endif
 
   return
@@ -39,7 +39,14 @@
 // maximum number of weights for the fast-fading metric evaluation
 #define Q65_FASTFADING_MAXWEIGTHS 65
 
-extern float q65_llh;
+// one per thread so that several decodes can run at once
+#if defined(_MSC_VER)
+#define Q65_THREAD_LOCAL __declspec(thread)
+#else
+#define Q65_THREAD_LOCAL __thread
+#endif
+
+extern Q65_THREAD_LOCAL float q65_llh;
 
 typedef struct {
 	const qracode *pQraCode; // qra code to be used by the codec
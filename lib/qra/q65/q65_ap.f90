@@ -18,6 +18,7 @@ subroutine q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
   data ncontest0/99/
   data first/.true./
   save naptypes,ncontest0
+!$omp threadprivate(naptypes,ncontest0,first)
 
 ! nQSOprogress
 !   0  CALLING
@@ -27,6 +28,12 @@ subroutine q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
 !   4  ROGERS
 !   5  SIGNOFF
 
+! No cache of the AP hypotheses is kept here, unlike ft8apset() and
+! ft8b(). apsym0 comes from ft8apset(), which already rebuilds it only
+! when the calls or contest type change, and naptypes is set once per
+! contest type. What is left is a few array copies, which cost no more
+! than comparing apsym0 against a cached copy would.
+
   if(first.or.(ncontest.ne.ncontest0)) then
 ! iaptype
 !------------------------
@@ -164,3 +171,20 @@ subroutine q65_ap(nQSOprogress,ipass,ncontest,lapcqonly,iaptype,   &
 
 900 return
 end subroutine q65_ap
+
+subroutine q65_ap_pack(ap78,ap13)
+
+! Pack the 78 AP bits from q65_ap() into 13 6-bit Q65 symbols, most
+! significant bit first.
+
+  integer ap78(78),ap13(13)
+
+  do k=1,13
+     ap13(k)=0
+     do i=6*k-5,6*k
+        ap13(k)=2*ap13(k) + ap78(i)
+     enddo
+  enddo
+
+  return
+end subroutine q65_ap_pack
@@ -0,0 +1,140 @@
+program q65_bench
+
+! Time the Q65 sync-correlation kernels q65_ccf_85 and q65_ccf_22 on
+! synthetic symbol spectra: Gaussian-like noise plus one list message
+! placed at 1500 Hz and DT=0.
+
+  use q65
+  !$ use omp_lib
+
+  character*8 arg
+  character*1 csubmode
+  integer itone(85)
+  integer*8 count0,count1,clkfreq
+  real, allocatable :: ccf1(:)
+  real, allocatable :: ccf22(:)
+  integer, allocatable :: iseed(:)
+
+  nargs=iargc()
+  if(nargs.ne.5) then
+     print*,'Usage:   q65_bench TRp A-E ntol max_drift niter'
+     print*,'Example: q65_bench  60  A  1000    50      10'
+     go to 999
+  endif
+  call getarg(1,arg)
+  read(arg,*) ntrperiod
+  call getarg(2,csubmode)
+  call getarg(3,arg)
+  read(arg,*) ntol
+  call getarg(4,arg)
+  read(arg,*) max_drift
+  call getarg(5,arg)
+  read(arg,*) niter
+
+  if(ntrperiod.eq.15) then
+     nsps=1800
+  else if(ntrperiod.eq.30) then
+     nsps=3600
+  else if(ntrperiod.eq.60) then
+     nsps=7200
+  else if(ntrperiod.eq.120) then
+     nsps=16000
+  else if(ntrperiod.eq.300) then
+     nsps=41472
+  else
+     stop 'Invalid TR period'
+  endif
+  mode_q65=2**(ichar(csubmode)-ichar('A'))
+  nthreads=1
+  !$ nthreads=omp_get_max_threads()
+
+! Same geometry as q65_dec0
+  nfqso=1500
+  nfa=100
+  nfb=4900
+  df=12000.0/nsps
+  istep=nsps/NSTEP
+  iz=5000.0/df
+  txt=85.0*nsps/12000.0
+  jz=(txt+1.0)*12000.0/istep
+  if(nsps.ge.6912) jz=(txt+2.0)*12000.0/istep
+  ftol=ntol
+  ia=ntol/df
+  ia2=max(ia,10*mode_q65,nint(100.0/df))
+  dtstep=nsps/(NSTEP*12000.0)
+  lag1=-1.0/dtstep
+  lag2=1.0/dtstep + 0.9999
+  j0=0.5/dtstep
+  if(nsps.ge.7200) j0=1.0/dtstep
+  i0=nint(nfqso/df)
+
+  call random_seed(size=n)
+  allocate(iseed(n))
+  iseed=12345
+  call random_seed(put=iseed)
+
+! Fill the list with random codewords; message 1 is the one transmitted.
+  ncw=206
+  do imsg=1,ncw
+     do k=1,63
+        call random_number(r)
+        codewords(k,imsg)=int(64*r)
+     enddo
+  enddo
+
+  if(allocated(s1)) deallocate(s1)
+  allocate(s1(iz,jz))
+  allocate(ccf1(-ia2:ia2))
+  allocate(ccf22(iz))
+  call random_number(s1)
+  i=1
+  k=0
+  do j=1,85
+     if(j.eq.isync(i)) then
+        i=i+1
+        itone(j)=0
+     else
+        k=k+1
+        itone(j)=codewords(k,1) + 1
+     endif
+  enddo
+  do k=1,85
+     j=j0 + NSTEP*(k-1) + 1
+     ii=i0 + mode_q65*itone(k)
+     s1(ii,j:min(jz,j+NSTEP-1))=s1(ii,j:min(jz,j+NSTEP-1)) + 1.0
+  enddo
+
+  write(*,1000) ntrperiod,csubmode,ntol,max_drift,iz,jz,lag2-lag1+1,nthreads
+1000 format('Q65-',i0,a1,'  ntol:',i5,'  max_drift:',i4,'  iz:',i5,    &
+          '  jz:',i5,'  lags:',i4,'  threads:',i3)
+
+  call system_clock(count0,clkfreq)
+  call cpu_time(t0)
+  do iter=1,niter
+     ccf1=0.
+     call q65_ccf_85(s1,iz,jz,nfqso,ia,ia2,ipk,jpk,f0,xdt,imsg_best,   &
+          better,ccf1)
+  enddo
+  call cpu_time(t1)
+  call system_clock(count1)
+  wall=1000.0*(count1-count0)/(real(clkfreq)*niter)
+  cpu=1000.0*(t1-t0)/niter
+  write(*,1010) 'ccf_85',wall,cpu,imsg_best,f0,xdt
+1010 format(a6,'  wall:',f10.3,' ms  cpu:',f10.3,' ms  imsg:',i4,   &
+          '  f0:',f8.1,'  xdt:',f6.2)
+
+  call system_clock(count0)
+  call cpu_time(t0)
+  do iter=1,niter
+     ccf22=0.
+     call q65_ccf_22(s1,iz,jz,nfqso,ntol,ipk,jpk,f0,xdt,ccf22)
+  enddo
+  call cpu_time(t1)
+  call system_clock(count1)
+  wall=1000.0*(count1-count0)/(real(clkfreq)*niter)
+  cpu=1000.0*(t1-t0)/niter
+  write(*,1020) 'ccf_22',wall,cpu,ncand,f0,xdt
+1020 format(a6,'  wall:',f10.3,' ms  cpu:',f10.3,' ms  ncand:',i3,   &
+          '  f0:',f8.1,'  xdt:',f6.2)
+
+999 end program q65_bench
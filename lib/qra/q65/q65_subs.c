@@ -27,12 +27,14 @@
 #include <stdio.h>
 #include <stdlib.h>
 
-static q65_codec_ds codec;
+// Each thread decoding Q65 gets a codec of its own, the codec holds
+// the decoder's working storage.
+static Q65_THREAD_LOCAL q65_codec_ds codec;
+static Q65_THREAD_LOCAL int first=1;
 
 void q65_enc_(int x[], int y[])
 {
 
-  static int first=1;
   if (first) {
     // Set the QRA code, allocate memory, and initialize
     int rc = q65_init(&codec,&qra15_65_64_irr_e23);
@@ -58,7 +60,6 @@ void q65_intrinsics_ff_(float s3[], int* submode, float* B90Ts,
  */
 
   int rc;
-  static int first=1;
 
   if (first) {
     // Set the QRA code, allocate memory, and initialize
@@ -16,6 +16,9 @@
 !    ! process sample
 !  end do
 !
+! read_flac reads the samples of a FLAC format file, as saved by wsjtx,
+! in one go.
+!
 module readwav
   implicit none
 
@@ -36,8 +39,33 @@ module readwav
      procedure :: read
   end type wav_header
 
+  interface
+     function flac_read (path, samples, max_samples, count, sample_rate) &
+          bind(C, name="flac_read")
+       use, intrinsic :: iso_c_binding, only: c_int, c_char, c_short
+       integer(c_int) :: flac_read
+       character(kind=c_char), intent(in) :: path(*)
+       integer(c_short), intent(out) :: samples(*)
+       integer(c_int), value, intent(in) :: max_samples
+       integer(c_int), intent(out) :: count, sample_rate
+     end function flac_read
+  end interface
+
   private
+  public :: read_flac
 contains
+  subroutine read_flac (filename, samples, count, sample_rate, ierr)
+    use, intrinsic :: iso_c_binding, only: c_null_char
+    implicit none
+
+    character(len=*), intent(in) :: filename
+    integer*2, intent(out) :: samples(:)
+    integer, intent(out) :: count, sample_rate, ierr
+
+    ierr = flac_read (trim(filename)//c_null_char, samples, size(samples), count, sample_rate)
+  end subroutine read_flac
+
+
   subroutine read (this, filename)
     implicit none
 
@@ -3,12 +3,13 @@ subroutine refspectrum(id2,bclear,brefspec,buseref,fname)
 ! Input:
 !  id2       i*2        Raw 16-bit integer data, 12000 Hz sample rate
 !  brefspec  logical    True when accumulating a reference spectrum
+!  buseref   logical    True when the saved spectrum should be displayed
+!  fname     char       Reference spectrum file, written or read
 
   parameter (NFFT=6912,NH=NFFT/2,NPOLYLOW=400,NPOLYHIGH=2600)
   integer*2 id2(NFFT)
   logical*1 bclear,brefspec,buseref,blastuse
   
-  real xs(0:NH-1)                         !Saved upper half of input chunk convolved with h(t) 
   real x(0:NFFT-1)                        !Work array
   real*4 w(0:NFFT-1)                      !Window function
   real*4 s(0:NH)                          !Average spectrum
@@ -16,11 +17,11 @@ subroutine refspectrum(id2,bclear,brefspec,buseref,fname)
   real*8 xfit(1500),yfit(1500),sigmay(1500),a(5),chisqr !Polyfit arrays
   logical first
   complex cx(0:NH)                        !Complex frequency-domain work array
-  complex cfil(0:NH)
   character*(*) fname
+  character*256 lastname
   common/spectra/syellow(6827),ref(0:NH),filter(0:NH)
   equivalence(x,cx)
-  data first/.true./,blastuse/.false./
+  data first/.true./,blastuse/.false./,lastname/' '/
   save
 
   if(first) then
@@ -32,7 +33,6 @@ subroutine refspectrum(id2,bclear,brefspec,buseref,fname)
      nsave=0
      s=0.0
      filter=1.0
-     xs=0.
      first=.false.
   endif
   if(bclear) s=0.
@@ -121,36 +121,21 @@ subroutine refspectrum(id2,bclear,brefspec,buseref,fname)
      return
   endif
 
+! The filter itself is applied to the captured audio by the
+! Equalizer, here the saved spectrum is only read back for display.
   if(buseref) then
-     if(blastuse.neqv.buseref) then !just enabled so read filter
-        fil=1.0
+     if(blastuse.neqv.buseref .or. fname.ne.lastname) then
+        lastname=fname
+        blastuse=buseref
         open(16,file=fname,status='old',err=999)
         read(16,1003,err=20,end=999) ndummy,ndummy,nterms,a
         goto 30
 20      rewind(16)              !allow for old style refspec.dat with no header
 30      do i=1,NH
-           read(16,1005,err=999,end=999) freq,s(i),ref(i),fil(i),filter(i)
+           read(16,1005,err=40,end=40) freq,s(i),ref(i),fil(i),filter(i)
         enddo
-! Make the filter causal for overlap and add.
-        cx(0)=0.0
-        cx(1:NH)=fil(1:NH)/NFFT
-        call four2a(cx,NFFT,1,1,-1)
-        x=cshift(x,-400)
-        x(800:NH)=0.0
-        call four2a(cx,NFFT,1,-1,0)
-        cfil=cx
-        close(16)
+40      close(16)
      endif
-! Use overlap and add method to apply causal reference filter.
-     x(0:NH-1)=id2(1:NH)
-     x(NH:NFFT-1)=0.0
-     x=x/NFFT
-     call four2a(cx,NFFT,1,-1,0)
-     cx=cfil*cx
-     call four2a(cx,NFFT,1,1,-1)
-     x(0:NH-1)=x(0:NH-1)+xs    
-     xs=x(NH:NFFT-1)
-     id2(1:NH)=nint(x(0:NH-1))
   endif
   blastuse=buseref
 
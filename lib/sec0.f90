@@ -8,6 +8,7 @@ subroutine sec0(n,t)
 
   integer*8 count0,count1,clkfreq
   save count0
+!$omp threadprivate(count0)
 
   call system_clock(count1,clkfreq)
   if(n.eq.0) then
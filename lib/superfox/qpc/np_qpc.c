@@ -66,35 +66,6 @@ static void   pdfarray_conv(float* dstarray, float* pdf1array, float* pdf2array,
 
 }
 
-static float _pdfuniform[QPC_Q];
-static const float* _pdf_uniform1();
-static const float* _pdf_uniform0();
-typedef const float*(*ptr_pdfuniform)(void);
-
-static ptr_pdfuniform _ptr_pdf_uniform = _pdf_uniform0;
-
-static const float* _pdf_uniform1() 
-{
-    return _pdfuniform;
-};
-static const float* _pdf_uniform0() 
-{
-    // compute uniform pdf once for all
-    int k;
-    for (k = 0; k < QPC_Q; k++)
-        _pdfuniform[k] = knorm;
-
-    // next call to _qpc_pdfuniform
-    // will be handled directly by _pqc_pdfuniform1
-    _ptr_pdf_uniform = _pdf_uniform1;
-
-    return _pdfuniform;
-};
-static const float*  pdf_uniform()
-{
-    return _ptr_pdf_uniform();
-}
-
 static float * pdf_mul(float *dst, float* pdf1, float* pdf2)
 {
     int k;
@@ -107,8 +78,10 @@ static float * pdf_mul(float *dst, float* pdf1, float* pdf2)
     }
     // if norm of the result is not positive
     // return in dst a uniform distribution
-    if (norm <= 0)
-        memcpy(dst, pdf_uniform(), QPC_Q * sizeof(float));
+    if (norm <= 0) {
+        for (k = 0; k < QPC_Q; k++)
+            dst[k] = knorm;
+    }
     else {
         norm = 1.0f / norm;
         for (k = 0; k < QPC_Q; k++)
@@ -172,18 +145,25 @@ static unsigned char pdf_max(const float* pdf)
 }
 
 // local stack functions ---------------------------------------
-static float _qpc_stack[QPC_N * QPC_Q * 2];
-static float* _qpc_stack_base = _qpc_stack;
+// one stack per thread so that several decodes can run at once
+#if defined(_MSC_VER)
+#define QPC_THREAD_LOCAL __declspec(thread)
+#else
+#define QPC_THREAD_LOCAL __thread
+#endif
+
+static QPC_THREAD_LOCAL float _qpc_stack[QPC_N * QPC_Q * 2];
+static QPC_THREAD_LOCAL int _qpc_stack_top = 0;
 
 static float* _qpc_stack_push(int numfloats)
 {
-    float* addr = _qpc_stack_base;
-    _qpc_stack_base += numfloats;
+    float* addr = _qpc_stack + _qpc_stack_top;
+    _qpc_stack_top += numfloats;
     return addr;
 }
 static void _qpc_stack_pop(int numfloats)
 {
-    _qpc_stack_base -= numfloats;
+    _qpc_stack_top -= numfloats;
 }
 
 // qpc encoder function (internal use) ----------------------------------------------------------
@@ -4,24 +4,18 @@ subroutine qpc_likelihoods2(py,s3,EsNo,No)
   parameter(QQ=128,QN=128)
   real py(0:QQ-1,0:QN-1)
   real s3(0:QQ-1,0:QN-1)
-  real No,norm,normpwr,normpwrmax
+  real No,norm,normpwrmax
 
   norm=(EsNo/(EsNo+1.0))/No
 
-! Compute likelihoods for symbol values, from the symbol power spectra
+! Compute likelihoods for symbol values, from the symbol power spectra.
+! Whole-column array operations so that the compiler can vectorize them.
+  py=norm*s3
   do k=0,QN-1
-     normpwrmax=0.
-     do j=0,QQ-1
-        normpwr=norm*s3(j,k)
-        py(j,k)=normpwr
-        normpwrmax=max(normpwr,normpwrmax)
-     enddo
-     pynorm=0.
-     do j=0,QQ-1
-        py(j,k)=exp(py(j,k)-normpwrmax)
-        pynorm=pynorm + py(j,k)
-     enddo
-     py(0:QQ-1,k)=py(0:QQ-1,k)/pynorm         !Normalize to probabilities
+     normpwrmax=max(maxval(py(:,k)),0.0)
+     py(:,k)=exp(py(:,k)-normpwrmax)
+     pynorm=sum(py(:,k))
+     py(:,k)=py(:,k)*(1.0/pynorm)             !Normalize to probabilities
   enddo
 
   return
@@ -0,0 +1,86 @@
+program test_mskrtd
+
+! Feed a single MSK144 ping through hspec() in the NZ/8 sample steps
+! used while monitoring and check that it is reported exactly once,
+! although the ping only and full mskrtd blocks overlap it several
+! times. With a ping at 2.15 s a ping only block reports it and later
+! ones see it at a higher SNR.
+
+  parameter (NMAX=15*12000)
+  parameter (NSTEP=7*128)             !Samples per hspec() call
+  parameter (JZ=703)
+  character*37 msg,msgsent
+  character*80 line
+  character*12 mycall,hiscall
+  character*8 arg
+  integer*2 id2(0:120*12000-1)
+  integer itone(144)
+  logical*1 bmsk144,btrain,bshmsg,bswl
+  real green(0:JZ-1)
+  real s(0:63,0:JZ-1)
+  real*8 pcoeffs(5)
+  real*8 twopi,phi,dphi0,dphi1
+
+  nargs=iargc()
+  if(nargs.ne.2) then
+     print*,'Usage:   test_mskrtd ping_time snr'
+     print*,'Example: test_mskrtd 2.15 10'
+     go to 999
+  endif
+  call getarg(1,arg)
+  read(arg,*) tping
+  call getarg(2,arg)
+  read(arg,*) snrdb
+
+  msg='K1ABC W9XYZ EN37'
+  call genmsk_128_90(msg,0,msgsent,itone,itype)
+
+! One ping, shaped as by makepings(), in noise
+  twopi=8.d0*atan(1.d0)
+  dphi0=twopi*(1500.d0-500.d0)/12000.d0
+  dphi1=twopi*(1500.d0+500.d0)/12000.d0
+  sig=sqrt(2.0)*10.0**(0.05*snrdb)
+  width=0.05
+  fac=sqrt(6000.0/2500.0)
+  phi=0.d0
+  id2=0
+  do i=0,NMAX-1
+     j=mod(i/6,144) + 1
+     if(itone(j).eq.0) then
+        phi=mod(phi+dphi0,twopi)
+     else
+        phi=mod(phi+dphi1,twopi)
+     endif
+     t=(i/12000.0 - tping)/width
+     a=0.
+     if(t.ge.0.0 .and. t.le.10.0) a=sig*2.718*t*exp(-t)
+     id2(i)=nint(30.0*(a*cos(phi) + fac*gran()))
+  enddo
+
+  mycall='K1ABC'
+  hiscall='W9XYZ'
+  bmsk144=.true.
+  btrain=.false.
+  bshmsg=.false.
+  bswl=.false.
+  pcoeffs=0.d0
+  nlines=0
+  do k=NSTEP,NMAX,NSTEP
+     line(1:1)=char(0)
+     call hspec(id2,k,0,15+3000,1500,100,bmsk144,btrain,pcoeffs,0,       &
+          mycall,hiscall,bshmsg,bswl,'.',green,s,jh,pxmax,dbNoGain,line)
+     if(line(1:1).ne.char(0)) then
+        write(*,'(a)') trim(line(1:61))
+        if(index(line,trim(msgsent)).gt.0) nlines=nlines+1
+     endif
+  enddo
+
+  write(*,1000) nlines
+1000 format('Reports of the ping:',i3)
+  if(nlines.eq.1) then
+     write(*,'(a)') 'PASS'
+  else
+     write(*,'(a)') 'FAIL'
+  endif
+
+999 end program test_mskrtd
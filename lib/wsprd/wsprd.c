@@ -40,6 +40,7 @@
 #include "fano.h"
 #include "jelinek.h"
 #include "nhash.h"
+#include "../hashcalls.h"
 #include "wsprd_utils.h"
 #include "wsprsim_utils.h"
 
@@ -743,7 +744,7 @@ int main(int argc, char *argv[])
     char *ptr_to_infile,*ptr_to_infile_suffix;
     char *data_dir=".";
     char wisdom_fname[200],all_fname[200],spots_fname[200];
-    char timer_fname[200],hash_fname[200];
+    char timer_fname[200],hash_fname[200],hashcalls_fname[200];
     char uttime[5],date[7];
     int c,delta,maxpts=65536,verbose=0,quickmode=0,more_candidates=0, stackdecoder=0;
     int usehashtable=1,wspr_type=2, ipass, nblocksize;
@@ -907,18 +908,21 @@ int main(int argc, char *argv[])
     strcpy(spots_fname,".");
     strcpy(timer_fname,".");
     strcpy(hash_fname,".");
+    strcpy(hashcalls_fname,".");
     if(data_dir != NULL) {
       strncpy(wisdom_fname,data_dir, sizeof wisdom_fname);
       strncpy(all_fname,data_dir, sizeof all_fname);
       strncpy(spots_fname,data_dir, sizeof spots_fname);
       strncpy(timer_fname,data_dir, sizeof timer_fname);
       strncpy(hash_fname,data_dir, sizeof hash_fname);
+      strncpy(hashcalls_fname,data_dir, sizeof hashcalls_fname);
     }
     strncat(wisdom_fname,"/wspr_wisdom.dat",20);
     strncat(all_fname,"/ALL_WSPR.TXT",20);
     strncat(spots_fname,"/wspr_spots.txt",20);
     strncat(timer_fname,"/wspr_timer.out",20);
     strncat(hash_fname,"/hashtable.txt",20);
+    strncat(hashcalls_fname,"/hashcalls.dat",20);
     if ((fp_fftwf_wisdom_file = fopen(wisdom_fname, "r"))) {  //Open FFTW wisdom
         fftwf_import_wisdom_from_file(fp_fftwf_wisdom_file);
         fclose(fp_fftwf_wisdom_file);
@@ -982,6 +986,8 @@ int main(int argc, char *argv[])
     
     if( usehashtable ) {
         char line[80], hcall[13], hgrid[5];
+        // calls learned by the other decoders, private if it can't be opened
+        hashcalls_open(hashcalls_fname);
         if( (fhash=fopen(hash_fname,"r+")) ) {
             while (fgets(line, sizeof(line), fhash) != NULL) {
                 hgrid[0]='\0';
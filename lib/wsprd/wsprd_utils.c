@@ -27,6 +27,7 @@
  along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "wsprd_utils.h"
+#include "../hashcalls.h"
 
 #ifndef int32_t
 #define int32_t int
@@ -272,7 +273,7 @@ int floatcomp(const void* elem1, const void* elem2)
 int unpk_(signed char *message, char *hashtab, char *loctab, char *call_loc_pow, char *callsign)
 {
     int n1,n2,n3,ndbm,ihash,nadd,noprint=0;
-    char grid[5],grid6[7],cdbm[4];
+    char grid[5],grid6[7],cdbm[4],hcall[HASHCALLS_CALL_CAP];
     
     unpack50(message,&n1,&n2);
     if( !unpackcall(n1,callsign) ) return 1;
@@ -303,6 +304,7 @@ int unpk_(signed char *message, char *hashtab, char *loctab, char *call_loc_pow,
             ihash=nhash(callsign,strlen(callsign),(uint32_t)146);
             snprintf(hashtab+ihash*13, WSPR_CALLSIGN_CAP, "%s", callsign);
             snprintf(loctab+ihash*5, WSPR_GRID_CAP, "%s", grid);
+            hashcalls_save(callsign, strlen(callsign));
         } else {
             nadd=nu;
             if( nu > 3 ) nadd=nu-3;
@@ -316,6 +318,7 @@ int unpk_(signed char *message, char *hashtab, char *loctab, char *call_loc_pow,
             if( nu == 0 || nu == 3 || nu == 7 || nu == 10 ) { //make sure power is OK
                 ihash=nhash(callsign,strlen(callsign),(uint32_t)146);
                 snprintf(hashtab+ihash*13, WSPR_CALLSIGN_CAP, "%s", callsign);
+                hashcalls_save(callsign, strlen(callsign));
             } else noprint=1;
         }
     } else if ( ntype < 0 ) {
@@ -338,6 +341,11 @@ int unpk_(signed char *message, char *hashtab, char *loctab, char *call_loc_pow,
         ihash=(n2-ntype-64)/128;
         if( strncmp(hashtab+ihash*13,"\0",1) != 0 ) {
             snprintf(callsign, WSPR_CALLSIGN_CAP, "<%.10s>", hashtab+ihash*13);
+        } else if( hashcalls_lookup(ihash, 15, hcall) ) {
+            // learned in another mode or by another program
+            hcall[HASHCALLS_CALL_CAP-1]='\0';
+            hcall[strcspn(hcall," ")]='\0';
+            snprintf(callsign, WSPR_CALLSIGN_CAP, "<%.10s>", hcall);
         } else {
             snprintf(callsign, WSPR_CALLSIGN_CAP, "%5s", "<...>");
         }
@@ -62,6 +62,8 @@ extern "C" {
   void four2a_(_Complex float *, int * nfft, int * ndim, int * isign, int * iform, int len);
 }
 
+extern dec_data_t * dec_data;
+
 namespace
 {
 #if QT_VERSION < QT_VERSION_CHECK (5, 15, 0)
@@ -428,12 +430,12 @@ int main(int argc, char *argv[])
             }
           if (!mem_jt9.attach ())
             {
-              if (!mem_jt9.create (sizeof (dec_data)))
+              if (!mem_jt9.create (sizeof (dec_data_t)))
                 {
                   auto const key = mem_jt9.nativeKey ().isEmpty () ? mem_jt9.key () : mem_jt9.nativeKey ();
                   auto reason = mem_jt9.errorString ();
                   LOG_ERROR ("Unable to create shared memory segment; key=" << key
-                            << ", size=" << sizeof (dec_data)
+                            << ", size=" << sizeof (dec_data_t)
                             << ", error=" << reason);
                   MessageBox::critical_message (nullptr, a.translate ("main", "Shared memory error"),
                                                 a.translate ("main", "Unable to create shared memory segment")
@@ -448,12 +450,12 @@ int main(int argc, char *argv[])
               // On some systems an old shared-memory segment may persist
               // even after jt9 has exited. Reuse it instead of aborting.
               LOG_WARN ("Shared memory segment already present after orphan shutdown attempts; reusing existing segment");
-              if (mem_jt9.size () < static_cast<int> (sizeof (dec_data)))
+              if (mem_jt9.size () < static_cast<int> (sizeof (dec_data_t)))
                 {
                   auto const key = mem_jt9.nativeKey ().isEmpty () ? mem_jt9.key () : mem_jt9.nativeKey ();
                   auto reason = "Existing segment is smaller than required: size="
                     + QString::number (mem_jt9.size ())
-                    + " bytes, required=" + QString::number (sizeof (dec_data)) + " bytes";
+                    + " bytes, required=" + QString::number (sizeof (dec_data_t)) + " bytes";
                   LOG_ERROR ("Shared memory segment size mismatch; key=" << key << ", error=" << reason);
                   MessageBox::critical_message (nullptr, a.translate ("main", "Shared memory error"),
                                                 a.translate ("main", "Unable to create shared memory segment")
@@ -470,6 +472,9 @@ int main(int argc, char *argv[])
           if (auto * shared = reinterpret_cast<dec_data_t *> (mem_jt9.data ()))
             {
               *shared = dec_data_t {};
+              // capture, spectra and decoder parameters all live in
+              // the segment, starting a decode only signals jt9
+              dec_data = shared;
             }
           mem_jt9.unlock ();
 
@@ -409,7 +409,10 @@ subroutine map65a(dd,ss,savg,newdat,nutc,fcenter,ntol,idphi,nfa,nfb,        &
      if(nqd.eq.1 .and. nagain.eq.1) go to 900
 
      if(nqd.eq.0 .and. bq65) then
-! Do the wideband Q65 decode        
+! Do the wideband Q65 decode. Candidates are done one at a time: q65b
+! keeps its state in saved locals and common blocks and writes its
+! results as it goes, and libm65 links the serial wsjt_fort. QMAP's
+! qmapa decodes them in parallel.
         do icand=1,ncand
            if(cand(icand)%iflip.ne.0) cycle    !Do only Q65 candidates here
            if(candec(icand)) cycle             !Skip if already decoded
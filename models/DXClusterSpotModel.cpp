@@ -0,0 +1,214 @@
+// -*- Mode: C++ -*-
+#include "DXClusterSpotModel.hpp"
+
+#include <algorithm>
+
+#include <QFont>
+
+namespace
+{
+QString yes_no_flag (QString const& flag)
+{
+  auto f = flag.trimmed ().toUpper ();
+  if (f == "L" || f == "E" || f == "Y" || f == "YES" || f == "1")
+    {
+      return "Yes";
+    }
+  return QString {};
+}
+}
+
+DXClusterSpotModel::DXClusterSpotModel(QObject * parent)
+  : QAbstractTableModel {parent}
+{
+}
+
+QString DXClusterSpotModel::keyOf(DXClusterSpot const& spot)
+{
+  return spot.dxCall.toUpper() + '|' + spot.band;
+}
+
+void DXClusterSpotModel::addSpots(QVector<DXClusterSpot> const& spots)
+{
+  QVector<DXClusterSpot> added;
+  QHash<QString, int> addedByKey;
+  for (auto const& spot : spots)
+    {
+      auto const key = keyOf(spot);
+      auto row = rowByKey_.constFind(key);
+      if (row != rowByKey_.constEnd())
+        {
+          // show/dx backfills can deliver spots older than the one we
+          // already have
+          auto& current = spots_[*row];
+          if (spot.time >= current.time)
+            {
+              current = spot;
+              Q_EMIT dataChanged(index(*row, 0), index(*row, column_count - 1));
+            }
+          continue;
+        }
+      auto pending = addedByKey.constFind(key);
+      if (pending == addedByKey.constEnd())
+        {
+          addedByKey.insert(key, added.size());
+          added << spot;
+        }
+      else if (spot.time >= added[*pending].time)
+        {
+          added[*pending] = spot;
+        }
+    }
+
+  if (!added.isEmpty())
+    {
+      int const first = spots_.size();
+      beginInsertRows(QModelIndex {}, first, first + added.size() - 1);
+      for (auto iter = addedByKey.constBegin(); iter != addedByKey.constEnd(); ++iter)
+        {
+          rowByKey_.insert(iter.key(), first + iter.value());
+        }
+      spots_ << added;
+      endInsertRows();
+    }
+
+  // evict in chunks so that a busy cluster does not cost a removal
+  // for every spot received
+  if (spots_.size() > capacity_ + capacity_ / 8)
+    {
+      QVector<QDateTime> times;
+      times.reserve(spots_.size());
+      for (auto const& spot : spots_)
+        {
+          times << spot.time;
+        }
+      auto const excess = spots_.size() - capacity_;
+      std::nth_element(times.begin(), times.begin() + excess - 1, times.end());
+      auto const cutoff = times[excess - 1];
+      removeRowsWhere([&cutoff] (DXClusterSpot const& spot) {
+          return spot.time <= cutoff;
+        });
+    }
+}
+
+void DXClusterSpotModel::expire(QDateTime const& nowUtc)
+{
+  auto const cutoff = nowUtc.addSecs(-maxAgeSecs_);
+  removeRowsWhere([&cutoff] (DXClusterSpot const& spot) {
+      return spot.time.isValid() && spot.time < cutoff;
+    });
+}
+
+void DXClusterSpotModel::clear()
+{
+  beginResetModel();
+  spots_.clear();
+  rowByKey_.clear();
+  endResetModel();
+}
+
+void DXClusterSpotModel::removeRowsWhere(std::function<bool (DXClusterSpot const&)> const& predicate)
+{
+  // remove contiguous runs from the end so that earlier row numbers
+  // stay valid
+  bool removed {false};
+  for (int last = spots_.size() - 1; last >= 0; --last)
+    {
+      if (!predicate(spots_[last])) continue;
+      int first = last;
+      while (first > 0 && predicate(spots_[first - 1])) --first;
+      beginRemoveRows(QModelIndex {}, first, last);
+      spots_.remove(first, last - first + 1);
+      endRemoveRows();
+      removed = true;
+      last = first;
+    }
+  if (removed)
+    {
+      reindex();
+    }
+}
+
+void DXClusterSpotModel::reindex()
+{
+  rowByKey_.clear();
+  rowByKey_.reserve(spots_.size());
+  for (int row = 0; row < spots_.size(); ++row)
+    {
+      rowByKey_.insert(keyOf(spots_[row]), row);
+    }
+}
+
+int DXClusterSpotModel::rowCount(QModelIndex const& parent) const
+{
+  return parent.isValid() ? 0 : spots_.size();
+}
+
+int DXClusterSpotModel::columnCount(QModelIndex const& parent) const
+{
+  return parent.isValid() ? 0 : column_count;
+}
+
+QVariant DXClusterSpotModel::data(QModelIndex const& index, int role) const
+{
+  if (!index.isValid() || index.row() >= spots_.size()) return {};
+  auto const& spot = spots_[index.row()];
+  switch (role)
+    {
+    case BandRole: return spot.band;
+    case ModeRole: return spot.mode;
+
+    case Qt::UserRole:          // sort key
+      switch (index.column())
+        {
+        case utc: return spot.time;
+        case frequency: return spot.frequency.toDouble();
+        default: return data(index, Qt::DisplayRole);
+        }
+
+    case Qt::FontRole:
+      if (dx_call == index.column())
+        {
+          QFont font;
+          font.setBold(true);
+          return font;
+        }
+      break;
+
+    case Qt::DisplayRole:
+      switch (index.column())
+        {
+        case utc: return spot.time.isValid() ? spot.time.toString(QStringLiteral ("yyyy-MM-dd HH:mm")) : QString {};
+        case frequency: return spot.frequency;
+        case dx_call: return spot.dxCall;
+        case spotter: return spot.spotter;
+        case mode: return spot.mode;
+        case comment: return spot.comment;
+        case continent: return spot.continent;
+        case country: return spot.country;
+        case lotw: return yes_no_flag(spot.lotw);
+        case eqsl: return yes_no_flag(spot.eqsl);
+        }
+      break;
+    }
+  return {};
+}
+
+QVariant DXClusterSpotModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+  if (Qt::Horizontal != orientation || Qt::DisplayRole != role) return {};
+  switch (section)
+    {
+    case utc: return tr("UTC");
+    case frequency: return tr("Freq (kHz)");
+    case dx_call: return tr("DX Call");
+    case spotter: return tr("Spotter");
+    case mode: return tr("Mode");
+    case comment: return tr("Comment");
+    case continent: return tr("Cont");
+    case country: return tr("Country");
+    case lotw: return tr("LoTW");
+    case eqsl: return tr("eQSL");
+    }
+  return {};
+}
@@ -0,0 +1,57 @@
+// -*- Mode: C++ -*-
+#ifndef DX_CLUSTER_SPOT_MODEL_HPP__
+#define DX_CLUSTER_SPOT_MODEL_HPP__
+
+#include <functional>
+
+#include <QAbstractTableModel>
+#include <QHash>
+#include <QVector>
+
+#include "Network/DXClusterClient.hpp"
+
+//
+// DXClusterSpotModel - bounded store of recent DX cluster spots
+//
+// One row per DX call and band, a new spot for a call already listed
+// on that band replaces the old one in place. Spots older than the
+// maximum age are expired by expire() and the oldest spots are evicted
+// when the store is over capacity, so a busy contest weekend cannot
+// grow it without limit. Sort with Qt::UserRole and filter on
+// BandRole/ModeRole in a proxy model.
+//
+class DXClusterSpotModel final
+  : public QAbstractTableModel
+{
+  Q_OBJECT
+
+public:
+  enum Column {utc, frequency, dx_call, spotter, mode, comment, continent, country, lotw, eqsl, column_count};
+  enum Role {BandRole = Qt::UserRole + 1, ModeRole};
+
+  explicit DXClusterSpotModel(QObject * parent = nullptr);
+
+  void setCapacity(int spots) {capacity_ = qMax(1, spots);}
+  void setMaxAgeSecs(qint64 secs) {maxAgeSecs_ = secs;}
+
+  void addSpots(QVector<DXClusterSpot> const& spots);
+  void expire(QDateTime const& nowUtc);
+  void clear();
+
+  int rowCount(QModelIndex const& parent = QModelIndex {}) const override;
+  int columnCount(QModelIndex const& parent = QModelIndex {}) const override;
+  QVariant data(QModelIndex const& index, int role = Qt::DisplayRole) const override;
+  QVariant headerData(int section, Qt::Orientation, int role = Qt::DisplayRole) const override;
+
+private:
+  static QString keyOf(DXClusterSpot const& spot);
+  void removeRowsWhere(std::function<bool (DXClusterSpot const&)> const& predicate);
+  void reindex();
+
+  QVector<DXClusterSpot> spots_;
+  QHash<QString, int> rowByKey_;
+  int capacity_ {2000};
+  qint64 maxAgeSecs_ {60 * 60};
+};
+
+#endif
@@ -1,12 +1,14 @@
-subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
-     ntrperiod,iseq,mycall0,hiscall0,hisgrid,mode_q65,f0,fqso,nkhz_center,  &
-     newdat,nagain,bClickDecode,max_drift,offset,ndepth,datetime,nCFOM,     &
-     ndop00,nhsym,idec)
+subroutine q65b(nutc,nqd,ntol,ntrperiod,iseq,mycall,hiscall,hisgrid,       &
+     mode_q65,f0,fqso,nkhz_center,newdat,nagain,max_drift,ndepth,k0,nsnr,   &
+     xdt,nfreq,msg,idec)
 
 ! This routine provides an interface between QMAP and the Q65 decoder
-! in WSJT-X.  All arguments are input data obtained from the QMAP GUI.
-! Raw Rx data are available as the 96 kHz complex spectrum ca(MAXFFT1)
-! in common/cacb.  Decoded messages are sent back to the GUI.
+! in WSJT-X.  Raw Rx data are available as the 96 kHz complex spectrum
+! ca(MAXFFT1) in common/cacb.  The candidate at f0 is downconverted and
+! decoded; results are returned in k0, nsnr, xdt, nfreq and msg, with
+! idec=0 for a decode and -1 for none.  q65b_report() passes them on to
+! the GUI.  qmapa calls this routine from several threads at once, so
+! the large arrays are one per thread.
 
   use q65_decode
   use wavhdr
@@ -15,34 +17,20 @@ subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
   parameter (MAXFFT1=5376000)              !56*96000
   parameter (MAXFFT2=336000)               !56*6000 (downsampled by 1/16)
   parameter (NMAX=60*12000)
-  parameter (RAD=57.2957795)
   type(hdr) h
-  integer*2 iwave(60*12000)
-  integer offset
+  integer*2, allocatable, save :: iwave(:)
   complex ca(MAXFFT1)                      !FFT of raw I/Q data from Linrad
-  complex cx(0:MAXFFT2-1),cz(0:MAXFFT2)
-  real*8 fcenter,freq0,freq1
-  logical*1 bClickDecode
-  character*12 mycall0,hiscall0
+  complex, allocatable, save :: cz(:)
   character*12 mycall,hiscall
   character*6 hisgrid
-  character*4 grid4
-  character*3 csubmode
   character*17 fname
-  character*72 result,ctmp
-  character*8 result2                      !liveCQ
-  character*20 datetime,datetime1
-  character*1 c1
-  common/decodes/ndecodes,ncand2,nQDecoderDone,nWDecoderBusy,              &
-       nWTransmitting,kHzRequested,result(50)
-  common/decodes2/result2(50)              !liveCQ
+  character*37 msg
   common/cacb/ca
   data ifile/0/
-  save
-  
-  if(mycall0(1:1).ne.' ') mycall=mycall0
-  if(hiscall0(1:1).ne.' ') hiscall=hiscall0
-  if(hisgrid(1:4).ne.'    ') grid4=hisgrid(1:4)
+!$omp threadprivate(iwave,cz)
+
+  if(.not.allocated(cz)) allocate(cz(0:MAXFFT2),iwave(NMAX))
+  idec=-1
 
 ! Find best frequency from sync_dat, the "orange sync curve".
   df3=96000.0/32768.0
@@ -55,9 +43,10 @@ subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
   k0=nint((ipk*df3-1000.0)/df)
   if(k0.lt.nh .or. k0.gt.MAXFFT1-nfft2+1) go to 900
   fac=1.0/nfft2
-  cx(0:nfft2-1)=fac*ca(k0:k0+nfft2-1)
+  cz(0:nfft2-1)=fac*ca(k0:k0+nfft2-1)
+  cz(nfft2)=0.
 
-! Here cx is frequency-domain data around the selected
+! Here cz is frequency-domain data around the selected
 ! QSO frequency, taken from the full-length FFT computed in fftbig().
 ! Values for fsample, nfft1, nfft2, df, and the downsampled data rate
 ! are as follows:
@@ -67,8 +56,6 @@ subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
 !----------------------------------------------------
 !   96000  5376000  0.017857143  336000   6000.000
 
-  cz(0:MAXFFT2-1)=cx
-  cz(MAXFFT2)=0.
 ! Roll off below 500 Hz and above 2500 Hz.
   ja=nint(500.0/df)
   jb=nint(2500.0/df)
@@ -99,18 +86,8 @@ subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
 
   if(iseq.eq.1) iwave(1:360000)=iwave(360001:720000)
 
-  csubmode(1:2)='60'
-  csubmode(3:3)=char(ichar('A')+nsubmode)
-  nhhmmss=100*nutc
   nutc1=nutc
-  datetime(12:13)='00'
-  datetime1=datetime
-  if(ntrperiod.eq.30) then
-     csubmode(1:2)='30'
-     nhhmmss=100*nutc + iseq*30
-     nutc1=nhhmmss
-     if(iseq.eq.1) datetime1(12:13)='30'
-  endif
+  if(ntrperiod.eq.30) nutc1=100*nutc + iseq*30
 
   if(nagain.ge.2) then
      ifile=ifile+1
@@ -139,40 +116,79 @@ subroutine q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,          &
   nagain2=0
   call map65_mmdec(nutc1,iwave,nqd,ntrperiod,nsubmode,nfa,nfb,1000,ntol,     &
        newdat,nagain2,max_drift,ndepth,mycall,hiscall,hisgrid)
+  if(nsnr0.gt.-99) then
+     nsnr=nsnr0
+     xdt=xdt0
+     nfreq=nfreq0
+     msg=msg0
+     idec=0
+  endif
+
+900 return
+end subroutine q65b
+
+subroutine q65b_report(nutc,fcenter,nfcal,ikhz,ntrperiod,iseq,mode_q65,     &
+     nkhz_center,bClickDecode,offset,datetime,ndop00,nhsym,k0,nsnr,xdt,     &
+     nfreq,msg,idec)
+
+! Send a decode returned by q65b() to the GUI, unless it is a dupe.
+
+  parameter (MAXFFT1=5376000)              !56*96000
+  real*8 fcenter,freq0,freq1
+  integer offset
+  logical*1 bClickDecode
+  character*3 csubmode
+  character*37 msg
+  character*72 result,ctmp
+  character*8 result2                      !liveCQ
+  character*20 datetime,datetime1
+  common/decodes/ndecodes,ncand2,nQDecoderDone,nWDecoderBusy,              &
+       nWTransmitting,kHzRequested,result(50)
+  common/decodes2/result2(50)              !liveCQ
+
+  df=96000.0/MAXFFT1
+  nsubmode=mode_q65-1
+  csubmode(1:2)='60'
+  csubmode(3:3)=char(ichar('A')+nsubmode)
+  nhhmmss=100*nutc
+  datetime(12:13)='00'
+  datetime1=datetime
+  if(ntrperiod.eq.30) then
+     csubmode(1:2)='30'
+     nhhmmss=100*nutc + iseq*30
+     if(iseq.eq.1) datetime1(12:13)='30'
+  endif
   MHz=fcenter
   freq0=MHz + 0.001d0*ikhz
 
-  if(nsnr0.gt.-99) then
-
-     do i=1,ndecodes                        !Check for dupes
-        i1=index(result(i)(42:),trim(msg0))
+  do i=1,ndecodes                        !Check for dupes
+     i1=index(result(i)(42:),trim(msg))
 !          If this is a dupe, don't save it again:
-        if(i1.gt.0 .and. (.not.bClickDecode .or. nhsym.eq.390)) go to 800
-     enddo
-     
-     nq65df=nint(1000*(0.001*k0*df+nkhz_center-48.0+1.000-1.27046-ikhz))-nfcal
-     nq65df=nq65df + nfreq0 - 1000
-     ikhz1=ikhz
-     ndf=nq65df
-     if(ndf.gt.500) ikhz1=ikhz + (nq65df+500)/1000
-     if(ndf.lt.-500) ikhz1=ikhz + (nq65df-500)/1000
-     ndf=nq65df - 1000*(ikhz1-ikhz)
-     freq1=freq0 + 0.001d0*(ikhz1-ikhz)
-     frx=0.001*k0*df+nkhz_center-48.0+1.0 - 0.001*nfcal
-     fsked=frx - 0.001*ndop00/2.0 - 0.001*offset
-     ctmp=csubmode//'  '//trim(msg0)
-     ndecodes=min(ndecodes+1,50)
-     write(result(ndecodes),1120) nhhmmss,frx,fsked,xdt0,nsnr0,trim(ctmp)
+     if(i1.gt.0 .and. (.not.bClickDecode .or. nhsym.eq.390)) go to 800
+  enddo
+
+  nq65df=nint(1000*(0.001*k0*df+nkhz_center-48.0+1.000-1.27046-ikhz))-nfcal
+  nq65df=nq65df + nfreq - 1000
+  ikhz1=ikhz
+  ndf=nq65df
+  if(ndf.gt.500) ikhz1=ikhz + (nq65df+500)/1000
+  if(ndf.lt.-500) ikhz1=ikhz + (nq65df-500)/1000
+  ndf=nq65df - 1000*(ikhz1-ikhz)
+  freq1=freq0 + 0.001d0*(ikhz1-ikhz)
+  frx=0.001*k0*df+nkhz_center-48.0+1.0 - 0.001*nfcal
+  fsked=frx - 0.001*ndop00/2.0 - 0.001*offset
+  ctmp=csubmode//'  '//trim(msg)
+  ndecodes=min(ndecodes+1,50)
+  write(result(ndecodes),1120) nhhmmss,frx,fsked,xdt,nsnr,trim(ctmp)
 1120 format(i6.6,f9.3,f7.1,f7.2,i5,2x,a)
-     write(result2(ndecodes),1125) fsked    !liveCQ
+  write(result2(ndecodes),1125) fsked    !liveCQ
 1125 format(f7.3)                           !liveCQ & changed from(f7.1) to give fsked Hz accuracy
-     write(12,1130) datetime1,trim(result(ndecodes)(7:))
+  write(12,1130) datetime1,trim(result(ndecodes)(7:))
 1130 format(a13,1x,a)
-     result(ndecodes)=trim(result(ndecodes))//char(0)
-     result2(ndecodes)=trim(result2(ndecodes))//char(0)
-800  idec=0
-  endif
+  result(ndecodes)=trim(result(ndecodes))//char(0)
+  result2(ndecodes)=trim(result2(ndecodes))//char(0)
+800 idec=0
+  flush(12)
 
-900 flush(12)
   return
-end subroutine q65b
+end subroutine q65b_report
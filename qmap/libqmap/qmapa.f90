@@ -21,6 +21,15 @@ subroutine qmapa(dd,ss,savg,newdat,nutc,fcenter,ntol,nfa,nfb,         &
      integer :: iseq      !0 for first half-minute, 1 for second half
   end type good_decode
 
+  type candidate_decode
+     integer :: idec      !0 for a decode, -1 for none
+     integer :: k0        !Start of the candidate's spectrum in ca()
+     integer :: nsnr      !S/N of the decode (dB)
+     real :: xdt          !DT of the decode (s)
+     integer :: nfreq     !Audio frequency of the decode (Hz)
+     character*37 :: msg  !Decoded message
+  end type candidate_decode
+
   parameter (NFFT=32768)             !Size of FFTs done in symspec()
   parameter (MAX_CANDIDATES=50)
   parameter (MAXMSG=1000)            !Size of decoded message list
@@ -30,15 +39,19 @@ subroutine qmapa(dd,ss,savg,newdat,nutc,fcenter,ntol,nfa,nfb,         &
   real savg(NFFT)                    !Average spectrum
   real*8 fcenter                     !Center RF frequency, MHz
   logical*1 bAlso30,bClickDecode
+  logical ldone
   character mycall*12,hiscall*12,hisgrid*6
+  character mycall0*12,hiscall0*12
   type(candidate) :: cand(MAX_CANDIDATES)
   type(good_decode) found(MAX_CANDIDATES)
+  type(candidate_decode) cdec(MAX_CANDIDATES)
   character*72 result
   character*8 result2                !liveCQ
   character*20 datetime
   common/decodes/ndecodes,ncand2,nQDecoderDone,nWDecoderBusy,              &
        nWTransmitting,kHzRequested,result(50)
   common/decodes2/result2(50)        !liveCQ
+  include 'timer_common.inc'
   save
 
   tsec0=sec_midn()
@@ -65,6 +78,8 @@ subroutine qmapa(dd,ss,savg,newdat,nutc,fcenter,ntol,nfa,nfb,         &
   fqso=mousefqso + foffset - 0.5*(nfa+nfb) + nfshift !fqso at baseband (khz)
   nqd=0
   bClickDecode=(nagain.ge.1)
+  if(mycall(1:1).ne.' ') mycall0=mycall
+  if(hiscall(1:1).ne.' ') hiscall0=hiscall
 
   call timer('fftbig  ',0)
   call fftbig(dd,NSMAX) !Do the full-length FFT
@@ -75,14 +90,27 @@ subroutine qmapa(dd,ss,savg,newdat,nutc,fcenter,ntol,nfa,nfb,         &
      fqso=fselected
   endif
 
+! Candidates are independent, so they are decoded in parallel, each
+! thread with its own downconversion buffers, FFT plans and Q65 decoder
+! state.  Decodes are then reported serially, in candidate order, so the
+! dupe checks and the list sent to the GUI do not depend on the number
+! of threads.  Click-to-decode stops at the first decode and runs
+! serially.
+  cdec(1:ncand2)%idec=-1
+  ldone=.false.
+  call timer('q65cands',0)
+!$omp parallel do schedule(dynamic) default(shared)                       &
+!$omp& private(icand,tsec,f0,ntrperiod,iseq,j,mode_q65_tmp)                  &
+!$omp& copyin(/timer_private/) if(ncand2.gt.1 .and. .not.bClickDecode)
   do icand=1,ncand2                        !Attempt to decode each candidate
+     if(ldone) cycle
      tsec=sec_midn() - tsec0
      if(ndiskdat.eq.0) then
         ! No more realtime decode attempts if it's nearly too late, already
-        if(nhsym.eq.130 .and. tsec.gt.6.0) exit
-        if(nhsym.eq.200 .and. tsec.gt.10.0) exit
-        if(nhsym.eq.330 .and. tsec.gt.6.0) exit
-        if(nhsym.eq.390 .and. tsec.gt.16.0) exit
+        if(nhsym.eq.130 .and. tsec.gt.6.0) cycle
+        if(nhsym.eq.200 .and. tsec.gt.10.0) cycle
+        if(nhsym.eq.330 .and. tsec.gt.6.0) cycle
+        if(nhsym.eq.390 .and. tsec.gt.16.0) cycle
      endif
      f0=cand(icand)%f
      ntrperiod=cand(icand)%ntrperiod
@@ -99,24 +127,38 @@ subroutine qmapa(dd,ss,savg,newdat,nutc,fcenter,ntol,nfa,nfb,         &
 
      mode_q65_tmp=mode_q65
      if(ntrperiod.eq.30) mode_q65_tmp=max(1,mode_q65-1)
-     freq=f0+nkhz_center-48.0-1.27046
-     ikhz=nint(freq)
-     idec=-1
      call timer('q65b    ',0)
-     call q65b(nutc,nqd,fcenter,nfcal,nfsample,ikhz,mousedf,ntol,           &
-          ntrperiod,iseq,mycall,hiscall,hisgrid,mode_q65_tmp,f0,fqso,       &
-          nkhz_center,newdat,nagain,bClickDecode,max_drift,offset,         &
-          ndepth,datetime,nCFOM,ndop00,nhsym,idec)
+     call q65b(nutc,nqd,ntol,ntrperiod,iseq,mycall0,hiscall0,hisgrid,      &
+          mode_q65_tmp,f0,fqso,nkhz_center,newdat,nagain,max_drift,ndepth, &
+          cdec(icand)%k0,cdec(icand)%nsnr,cdec(icand)%xdt,                 &
+          cdec(icand)%nfreq,cdec(icand)%msg,cdec(icand)%idec)
      call timer('q65b    ',1)
-     if(bClickDecode .and. idec.ge.0) exit
-     if(idec.ge.0) then
-        ! Save some details on good decodes, to avoid duplicated effort
-        found(ndecodes)%f=f0
-        found(ndecodes)%ntrperiod=ntrperiod
-        found(ndecodes)%iseq=iseq
-     end if
+     if(bClickDecode .and. cdec(icand)%idec.ge.0) ldone=.true.
 10   continue
   enddo  ! icand
+!$omp end parallel do
+  call timer('q65cands',1)
+
+  call timer('q65_rept',0)
+  do icand=1,ncand2
+     if(cdec(icand)%idec.lt.0) cycle
+     f0=cand(icand)%f
+     ntrperiod=cand(icand)%ntrperiod
+     iseq=cand(icand)%iseq
+     mode_q65_tmp=mode_q65
+     if(ntrperiod.eq.30) mode_q65_tmp=max(1,mode_q65-1)
+     freq=f0+nkhz_center-48.0-1.27046
+     ikhz=nint(freq)
+     call q65b_report(nutc,fcenter,nfcal,ikhz,ntrperiod,iseq,mode_q65_tmp,  &
+          nkhz_center,bClickDecode,offset,datetime,ndop00,nhsym,           &
+          cdec(icand)%k0,cdec(icand)%nsnr,cdec(icand)%xdt,                 &
+          cdec(icand)%nfreq,cdec(icand)%msg,cdec(icand)%idec)
+     ! Save some details on good decodes, to avoid duplicated effort
+     found(ndecodes)%f=f0
+     found(ndecodes)%ntrperiod=ntrperiod
+     found(ndecodes)%iseq=iseq
+  enddo
+  call timer('q65_rept',1)
 
   return
 end subroutine qmapa
@@ -0,0 +1,294 @@
+//
+// Decoder regression and timing benchmark
+//
+// Generates synthetic bands with bandsim, decodes them with the real
+// decoder executables (jt9 or wsprd) and compares the decodes with what
+// was transmitted. Reports signals decoded, false decodes, wall and CPU
+// time per cycle and writes the results as JSON for trend tracking.
+// The exit status is non-zero if the decode rate falls below
+// --min-rate or there are more than --max-false false decodes.
+//
+#include <stdexcept>
+#include <locale>
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QProcess>
+#include <QElapsedTimer>
+#include <QTemporaryDir>
+#include <QFile>
+#include <QDir>
+#include <QTextStream>
+#include <QRegularExpression>
+#include <QStringList>
+#include <QSet>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#if !defined (Q_OS_WIN)
+#include <sys/time.h>
+#include <sys/resource.h>
+#endif
+
+namespace
+{
+  QTextStream qtout {stdout};
+
+  struct Mode
+  {
+    char const * name;
+    QStringList decoder_args;   // before the file name
+    char const * file_name;     // what the decoder expects to be given
+    char const * decode_pattern;
+  };
+
+  // jt9 decode lines are "hhmmss snr dt freq marker message ..." and
+  // wsprd lines are "hhmm snr dt freq-MHz drift message"
+  char const * const jt9_pattern {R"(^\d{4,6}\s+-?\d+\s+-?\d+\.\d\s+-?\d+\s+\S\s+(.+)$)"};
+  char const * const wsprd_pattern {R"(^\d{4}\s+-?\d+\s+-?\d+\.\d\s+\d+\.\d+\s+-?\d+\s+(.+)$)"};
+
+  Mode const modes[] = {
+    {"FT8", {"-8", "-d", "3", "-L", "200", "-H", "3000"}, "000000_000001", jt9_pattern},
+    {"FT4", {"-5", "-d", "3", "-L", "200", "-H", "3000"}, "000000_000001", jt9_pattern},
+    {"FT2", {"-2", "-d", "3", "-L", "200", "-H", "3000"}, "000000_000001", jt9_pattern},
+    {"Q65", {"-3", "-p", "30", "-b", "A", "-d", "3", "-L", "200", "-H", "3000", "-f", "1500", "-F", "1000"},
+     "000000_000001", jt9_pattern},
+    {"WSPR", {"-f", "14.0956"}, "000000_0000", wsprd_pattern},
+  };
+
+  // CPU time used by terminated child processes so far, -1 if the
+  // platform does not tell us
+  double children_cpu_ms ()
+  {
+#if !defined (Q_OS_WIN)
+    struct rusage usage;
+    if (!getrusage (RUSAGE_CHILDREN, &usage))
+      {
+        return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.
+          + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.;
+      }
+#endif
+    return -1.;
+  }
+
+  QByteArray run (QString const& program, QStringList const& args, QString const& dir)
+  {
+    QProcess process;
+    process.setWorkingDirectory (dir);
+    process.setProcessChannelMode (QProcess::MergedChannels);
+    process.start (program, args);
+    if (!process.waitForStarted ())
+      {
+        throw std::runtime_error {("failed to start " + program).toStdString ()};
+      }
+    if (!process.waitForFinished (-1) || QProcess::NormalExit != process.exitStatus ())
+      {
+        throw std::runtime_error {(program + " did not finish normally").toStdString ()};
+      }
+    return process.readAll ();
+  }
+
+  struct Cycle
+  {
+    int expected {0};
+    int decoded {0};
+    int false_decodes {0};
+    double wall_ms {0.};
+    double cpu_ms {-1.};
+    QStringList missed;
+    QStringList bogus;
+  };
+
+  Cycle run_cycle (Mode const& mode, QString const& bandsim, QString const& decoder
+                   , QStringList const& bandsim_args, QString const& dir)
+  {
+    Cycle cycle;
+    run (bandsim, QStringList {mode.name} << bandsim_args << mode.file_name, dir);
+
+    QFile truth_file {QDir {dir}.filePath (QString {mode.file_name} + ".txt")};
+    if (!truth_file.open (QIODevice::ReadOnly | QIODevice::Text))
+      {
+        throw std::runtime_error {"bandsim wrote no truth file"};
+      }
+    QStringList truth;
+    while (!truth_file.atEnd ())
+      {
+        // f0 DT SNR message
+        auto fields = QString::fromLatin1 (truth_file.readLine ()).simplified ().split (' ');
+        if (fields.size () > 3)
+          {
+            truth << QStringList {fields.mid (3)}.join (' ');
+          }
+      }
+    cycle.expected = truth.size ();
+
+    auto cpu_before = children_cpu_ms ();
+    QElapsedTimer timer;
+    timer.start ();
+    auto output = run (decoder, QStringList {mode.decoder_args} << QString {mode.file_name} + ".wav", dir);
+    cycle.wall_ms = timer.nsecsElapsed () / 1.e6;
+    auto cpu_after = children_cpu_ms ();
+    if (cpu_before >= 0. && cpu_after >= 0.)
+      {
+        cycle.cpu_ms = cpu_after - cpu_before;
+      }
+
+    QRegularExpression decode_re {mode.decode_pattern};
+    QSet<QString> found;
+    for (auto const& line : QString::fromLatin1 (output).split ('\n'))
+      {
+        auto match = decode_re.match (line.trimmed ());
+        if (!match.hasMatch ()) continue;
+        auto message = match.captured (1).simplified ();
+        bool matched {false};
+        for (auto const& sent : truth)
+          {
+            // decoders may append AP or quality annotations
+            if (message == sent || message.startsWith (sent + ' '))
+              {
+                found << sent;
+                matched = true;
+                break;
+              }
+          }
+        if (!matched)
+          {
+            ++cycle.false_decodes;
+            cycle.bogus << message;
+          }
+      }
+    cycle.decoded = found.size ();
+    for (auto const& sent : truth)
+      {
+        if (!found.contains (sent)) cycle.missed << sent;
+      }
+    return cycle;
+  }
+}
+
+int main (int argc, char * argv[])
+{
+  QCoreApplication app {argc, argv};
+  try
+    {
+      std::locale::global (std::locale::classic ());
+      app.setApplicationName ("decode_bench");
+      qtout.setRealNumberNotation (QTextStream::FixedNotation);
+
+      QCommandLineParser parser;
+      parser.setApplicationDescription ("\nDecoder regression and timing benchmark on synthetic bands");
+      parser.addHelpOption ();
+      parser.addOptions ({
+          {"mode", "FT8, FT4, FT2, Q65 or WSPR", "mode"},
+          {"bandsim", "Path to the bandsim executable", "path"},
+          {"decoder", "Path to the decoder executable, jt9 or wsprd for WSPR", "path"},
+          {"signals", "Signals per cycle, default 10", "n", "10"},
+          {"snr", "SNR range in dB as low:high, default -20:-5", "range", "-20:-5"},
+          {"fspread", "Watterson Doppler spread in Hz, default 0", "Hz", "0"},
+          {"delay", "Watterson path delay in ms, default 0", "ms", "0"},
+          {"seed", "Seed for the first cycle, default 1", "seed", "1"},
+          {"cycles", "Number of cycles, default 3", "n", "3"},
+          {"json", "Write the results to <file>", "file"},
+          {"min-rate", "Fail if fewer than this fraction of signals decode, default 0", "rate", "0"},
+          {"max-false", "Fail if there are more false decodes than this, default -1 (no limit)", "n", "-1"},
+        });
+      parser.process (app);
+
+      auto const mode_name = parser.value ("mode").toUpper ();
+      Mode const * mode {nullptr};
+      for (auto const& m : modes)
+        {
+          if (mode_name == m.name) mode = &m;
+        }
+      if (!mode) throw std::invalid_argument {"unknown or missing --mode"};
+      if (!parser.isSet ("bandsim") || !parser.isSet ("decoder"))
+        {
+          throw std::invalid_argument {"--bandsim and --decoder are required"};
+        }
+      auto snr = parser.value ("snr").split (':');
+      if (snr.size () != 2) throw std::invalid_argument {"--snr must be low:high"};
+      int const cycles = parser.value ("cycles").toInt ();
+      int const seed = parser.value ("seed").toInt ();
+      double const min_rate = parser.value ("min-rate").toDouble ();
+      int const max_false = parser.value ("max-false").toInt ();
+
+      QTemporaryDir dir;
+      if (!dir.isValid ()) throw std::runtime_error {"cannot create a temporary directory"};
+
+      QJsonArray cycle_results;
+      int expected {0};
+      int decoded {0};
+      int false_decodes {0};
+      double wall_ms {0.};
+      double cpu_ms {0.};
+      for (int i = 0; i < cycles; ++i)
+        {
+          QStringList bandsim_args {parser.value ("signals"), snr[0], snr[1]
+              , parser.value ("fspread"), parser.value ("delay"), QString::number (seed + i)};
+          auto cycle = run_cycle (*mode, parser.value ("bandsim"), parser.value ("decoder")
+                                  , bandsim_args, dir.path ());
+          expected += cycle.expected;
+          decoded += cycle.decoded;
+          false_decodes += cycle.false_decodes;
+          wall_ms += cycle.wall_ms;
+          if (cpu_ms >= 0. && cycle.cpu_ms >= 0.) cpu_ms += cycle.cpu_ms; else cpu_ms = -1.;
+          cycle_results.append (QJsonObject {
+              {"seed", seed + i},
+              {"expected", cycle.expected},
+              {"decoded", cycle.decoded},
+              {"false", cycle.false_decodes},
+              {"wall_ms", cycle.wall_ms},
+              {"cpu_ms", cycle.cpu_ms},
+              {"missed", QJsonArray::fromStringList (cycle.missed)},
+              {"false_messages", QJsonArray::fromStringList (cycle.bogus)},
+            });
+          qtout << mode->name << " cycle " << i + 1 << ": " << cycle.decoded << '/' << cycle.expected
+                << " decoded, " << cycle.false_decodes << " false, "
+                << qSetRealNumberPrecision (1) << cycle.wall_ms << " ms wall, "
+                << cycle.cpu_ms << " ms CPU\n";
+        }
+
+      double const rate = expected ? static_cast<double> (decoded) / expected : 0.;
+      QJsonObject result {
+        {"mode", mode->name},
+        {"signals", parser.value ("signals").toInt ()},
+        {"snr_low", snr[0].toDouble ()},
+        {"snr_high", snr[1].toDouble ()},
+        {"fspread", parser.value ("fspread").toDouble ()},
+        {"delay", parser.value ("delay").toDouble ()},
+        {"cycles", cycles},
+        {"expected", expected},
+        {"decoded", decoded},
+        {"false", false_decodes},
+        {"decode_rate", rate},
+        {"wall_ms_per_cycle", cycles ? wall_ms / cycles : 0.},
+        {"cpu_ms_per_cycle", cycles && cpu_ms >= 0. ? cpu_ms / cycles : -1.},
+        {"results", cycle_results},
+      };
+      if (parser.isSet ("json"))
+        {
+          QFile json_file {parser.value ("json")};
+          if (!json_file.open (QIODevice::WriteOnly | QIODevice::Truncate))
+            {
+              throw std::runtime_error {"cannot write the JSON file"};
+            }
+          json_file.write (QJsonDocument {result}.toJson ());
+        }
+
+      qtout << mode->name << ": " << decoded << '/' << expected << " decoded ("
+            << qSetRealNumberPrecision (3) << rate << "), " << false_decodes << " false\n";
+      qtout.flush ();
+      if (rate < min_rate || (max_false >= 0 && false_decodes > max_false))
+        {
+          return 1;
+        }
+    }
+  catch (std::exception const& e)
+    {
+      qtout << "Error: " << e.what () << '\n';
+      qtout.flush ();
+      return 2;
+    }
+  return 0;
+}
@@ -0,0 +1,130 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "Audio/AudioClock.hpp"
+
+class TestAudioClock
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  // a 48 kHz sound card running fast by drift_ppm delivering blocks
+  // of block frames, each arriving up to jitter_ms late
+  struct Source
+  {
+    double drift_ppm;
+    int block;
+    int jitter_ms;
+    double start_ms;
+    qint64 frames;
+
+    double capture_ms (qint64 frame) const
+    {
+      return start_ms + frame * 1000. / (48000. * (1. + drift_ppm * 1e-6));
+    }
+
+    // deliver the next block to clock, returns its arrival time
+    double deliver (AudioClock& clock)
+    {
+      frames += block;
+      auto const arrival = capture_ms (frames - 1) + (jitter_ms ? qrand () % (jitter_ms * 1000) / 1000. : 0.);
+      clock.update (frames, arrival);
+      return arrival;
+    }
+
+    void run (AudioClock& clock, double seconds)
+    {
+      auto const blocks = static_cast<int> (seconds * 48000. / block);
+      for (int i = 0; i < blocks; ++i) deliver (clock);
+    }
+  };
+
+  Q_SLOT void init ()
+  {
+    qsrand (1);
+  }
+
+  Q_SLOT void follows_a_steady_clock ()
+  {
+    AudioClock clock;
+    QVERIFY (!clock.valid ());
+    Source source {0., 1024, 0, 1.6e12, 0};
+    source.run (clock, 20.);
+    QVERIFY (clock.valid ());
+    QVERIFY (clock.locked ());
+    QVERIFY (std::abs (clock.drift_ppm ()) < 1.);
+    QVERIFY (std::abs (clock.utc (source.frames) - source.capture_ms (source.frames)) < .1);
+  }
+
+  Q_SLOT void measures_drift_through_jitter ()
+  {
+    AudioClock clock;
+    Source source {150., 1024, 8, 1.6e12, 0};
+    source.run (clock, 60.);
+    QVERIFY (clock.locked ());
+    QVERIFY2 (std::abs (clock.drift_ppm () - 150.) < 20., qPrintable (QString::number (clock.drift_ppm ())));
+
+    // the mean arrival lag is half the jitter, the time stamps should
+    // be far steadier than the arrivals themselves
+    double worst {0.};
+    for (int i = 0; i < 200; ++i)
+      {
+        source.deliver (clock);
+        auto const error = clock.utc (source.frames) - source.capture_ms (source.frames) - 4.;
+        worst = qMax (worst, std::abs (error));
+      }
+    QVERIFY2 (worst < 2., qPrintable (QString::number (worst)));
+
+    // uniform over 8 ms has a standard deviation of 2.3 ms
+    QVERIFY2 (clock.jitter_ms () > 1.5 && clock.jitter_ms () < 3.5, qPrintable (QString::number (clock.jitter_ms ())));
+  }
+
+  Q_SLOT void block_size_does_not_matter ()
+  {
+    for (auto block : {256, 4800})
+      {
+        AudioClock clock;
+        Source source {-80., block, 4, 1.6e12, 0};
+        source.run (clock, 60.);
+        QVERIFY2 (std::abs (clock.drift_ppm () + 80.) < 20., qPrintable (QString::number (clock.drift_ppm ())));
+      }
+  }
+
+  Q_SLOT void relocks_after_a_step ()
+  {
+    AudioClock clock;
+    Source source {50., 1024, 2, 1.6e12, 0};
+    source.run (clock, 20.);
+    QVERIFY (clock.locked ());
+    QCOMPARE (clock.relocks (), 0);
+
+    // the system clock steps forward half a second
+    source.start_ms += 500.;
+    source.deliver (clock);
+    QCOMPARE (clock.relocks (), 1);
+    QVERIFY (!clock.locked ());
+    QVERIFY (std::abs (clock.utc (source.frames) - source.capture_ms (source.frames)) < 5.);
+    QVERIFY (std::abs (clock.drift_ppm () - 50.) < 20.); // rate is kept
+
+    source.run (clock, 15.);
+    QVERIFY (clock.locked ());
+  }
+
+  Q_SLOT void reset_forgets ()
+  {
+    AudioClock clock;
+    Source source {100., 1024, 0, 1.6e12, 0};
+    source.run (clock, 20.);
+    clock.reset (12000.);
+    QVERIFY (!clock.valid ());
+    QVERIFY (!clock.locked ());
+    QCOMPARE (clock.rate (), 12000.);
+    QCOMPARE (clock.drift_ppm (), 0.);
+  }
+};
+
+QTEST_MAIN (TestAudioClock);
+
+#include "test_audio_clock.moc"
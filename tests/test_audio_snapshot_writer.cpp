@@ -0,0 +1,127 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include <QAudioFormat>
+#include <QFile>
+#include <QFileInfo>
+#include <QSignalSpy>
+#include <QTemporaryDir>
+#include <QVector>
+
+#include "Audio/AudioSnapshotWriter.hpp"
+
+class TestAudioSnapshotWriter
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+  QVector<short> samples_;
+  BWFFile::InfoDictionary info_;
+
+  QString base_name (QString const& name) const
+  {
+    return temp_dir_.filePath (name);
+  }
+
+  Q_SLOT void initTestCase ()
+  {
+    // a tone with some noise, 15 s at 12000 Hz
+    qsrand (1);
+    samples_.resize (15 * 12000);
+    for (int i = 0; i < samples_.size (); ++i)
+      {
+        samples_[i] = static_cast<short> (3000. * std::sin (i * 0.3) + qrand () % 400 - 200);
+      }
+    info_[{{'I','S','R','C'}}] = "K1ABC; FN42";
+    info_[{{'I','C','M','T'}}] = "Mode=FT8; Freq=14.074 000";
+  }
+
+  Q_SLOT void flac_round_trip ()
+  {
+    AudioSnapshotWriter writer;
+    QVERIFY (writer.save (base_name ("120000"), samples_.constData (), samples_.size ()
+                          , info_, AudioSnapshotWriter::Container::FLAC));
+    writer.flush ();
+    auto const file_name = base_name ("120000.flac");
+    QVERIFY (QFile::exists (file_name));
+    QVERIFY (QFileInfo {file_name}.size () < samples_.size () * 2);
+
+    QVector<short> read (samples_.size () + 100);
+    int count {0};
+    int rate {0};
+    BWFFile::InfoDictionary info;
+    QCOMPARE (AudioSnapshotWriter::read_flac (file_name, read.data (), read.size (), &count, &rate, &info), QString {});
+    QCOMPARE (count, samples_.size ());
+    QCOMPARE (rate, 12000);
+    read.resize (count);
+    QCOMPARE (read, samples_);
+    QCOMPARE (info, info_);
+  }
+
+  Q_SLOT void writes_wav ()
+  {
+    AudioSnapshotWriter writer;
+    QVERIFY (writer.save (base_name ("120015"), samples_.constData (), samples_.size ()
+                          , info_, AudioSnapshotWriter::Container::WAV));
+    writer.flush ();
+    BWFFile file {QAudioFormat {}, base_name ("120015.wav")};
+    QVERIFY (file.open (BWFFile::ReadOnly));
+    QCOMPARE (file.format ().sampleRate (), 12000);
+    QVector<short> read (samples_.size ());
+    QCOMPARE (file.read (reinterpret_cast<char *> (read.data ()), read.size () * 2), qint64 (read.size () * 2));
+    QCOMPARE (read, samples_);
+  }
+
+  Q_SLOT void remove_follows_save ()
+  {
+    AudioSnapshotWriter writer;
+    QVERIFY (writer.save (base_name ("120030"), samples_.constData (), samples_.size ()
+                          , info_, AudioSnapshotWriter::Container::FLAC));
+    writer.remove (base_name ("120030"));
+    writer.flush ();
+    QVERIFY (!QFile::exists (base_name ("120030.flac")));
+  }
+
+  Q_SLOT void refuses_beyond_queue_limit ()
+  {
+    AudioSnapshotWriter writer {1};
+    int accepted {0};
+    for (int i = 0; i < 20; ++i)
+      {
+        if (writer.save (base_name (QString {"limit_%1"}.arg (i)), samples_.constData (), samples_.size ()
+                         , info_, AudioSnapshotWriter::Container::FLAC))
+          {
+            ++accepted;
+          }
+        QVERIFY (writer.queued () <= 1);
+      }
+    QVERIFY (accepted >= 1);
+    writer.flush ();
+    QCOMPARE (writer.queued (), 0);
+    QVERIFY (writer.save (base_name ("limit_last"), samples_.constData (), samples_.size ()
+                          , info_, AudioSnapshotWriter::Container::WAV));
+  }
+
+  Q_SLOT void reports_errors ()
+  {
+    AudioSnapshotWriter writer;
+    QSignalSpy spy {&writer, &AudioSnapshotWriter::error};
+    QVERIFY (writer.save (base_name ("missing/120045"), samples_.constData (), samples_.size ()
+                          , info_, AudioSnapshotWriter::Container::FLAC));
+    writer.flush ();
+    QTRY_COMPARE (spy.count (), 1);
+
+    int count {0};
+    int rate {0};
+    short sample;
+    QVERIFY (!AudioSnapshotWriter::read_flac (base_name ("missing/120045.flac"), &sample, 1, &count, &rate).isEmpty ());
+    QCOMPARE (count, 0);
+  }
+};
+
+QTEST_MAIN (TestAudioSnapshotWriter);
+
+#include "test_audio_snapshot_writer.moc"
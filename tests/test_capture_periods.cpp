@@ -0,0 +1,107 @@
+#include <QtTest>
+
+#include <cmath>
+
+#include "Audio/AudioClock.hpp"
+#include "Detector/CapturePeriods.hpp"
+
+class TestCapturePeriods
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  static double constexpr day_ms {86400000.};
+  static double constexpr midnight {18628 * day_ms};
+
+  // a 48 kHz sound card delivering blocks the moment their last frame
+  // is captured
+  struct Source
+  {
+    double drift_ppm;
+    int block;
+    double start_ms;
+    qint64 frames;
+
+    double capture_ms (qint64 frame) const
+    {
+      return start_ms + frame * 1000. / (48000. * (1. + drift_ppm * 1e-6));
+    }
+
+    void deliver (AudioClock& clock)
+    {
+      frames += block;
+      clock.update (frames, capture_ms (frames - 1));
+    }
+  };
+
+  Q_SLOT void periods_align_to_midnight ()
+  {
+    CapturePeriods periods {15.};
+    auto const first = periods.index (midnight);
+    QCOMPARE (periods.start (first), midnight);
+    QCOMPARE (periods.index (midnight + 14999.9), first);
+    QCOMPARE (periods.index (midnight + 15000.), first + 1);
+    QCOMPARE (periods.start (first + 1) - periods.start (first), 15000.);
+  }
+
+  Q_SLOT void last_period_of_a_day_is_short ()
+  {
+    CapturePeriods periods {7.};
+    auto const last = periods.index (midnight - 1.);
+    QCOMPARE (periods.start (last), midnight - 6000.);
+    QCOMPARE (periods.index (midnight), last + 1);
+    QCOMPARE (periods.start (last + 1), midnight);
+  }
+
+  Q_SLOT void split_is_bounded_by_the_block ()
+  {
+    AudioClock clock;
+    Source source {0., 1024, midnight - 20000., 0};
+    while (source.capture_ms (source.frames) < midnight - 5000.) source.deliver (clock);
+    CapturePeriods periods {15.};
+    auto const next = periods.index (midnight);
+    QCOMPARE (periods.split (clock, source.frames, 1024, next), qint64 {1024});
+    QCOMPARE (periods.split (clock, source.frames, 1024, next - 1), qint64 {0});
+  }
+
+  Q_SLOT void new_period_starts_on_the_boundary_frame ()
+  {
+    AudioClock clock;
+    Source source {50., 1024, midnight + 1234.5, 0};
+    for (int i = 0; i < 20 * 48000 / 1024; ++i) source.deliver (clock);
+    QVERIFY (clock.locked ());
+
+    // as the Detector does, split each block whose last frame falls in
+    // a new period
+    CapturePeriods periods {15.};
+    qint64 current {-1};
+    int boundaries {0};
+    for (int i = 0; i < 40 * 48000 / 1024; ++i)
+      {
+        auto const first = source.frames;
+        source.deliver (clock);
+        auto const index = periods.index (clock.utc (source.frames - 1));
+        if (current >= 0 && index > current)
+          {
+            auto const split = periods.split (clock, first, source.block, index);
+            auto const boundary = periods.start (index);
+            QVERIFY (split > 0 && split < source.block);
+            // within a few frames, arrival times alone would put it
+            // up to a block (21 ms) late
+            QVERIFY2 (std::abs (source.capture_ms (first + split) - boundary) < .1
+                      , qPrintable (QString::number (source.capture_ms (first + split) - boundary)));
+            ++boundaries;
+          }
+        current = index;
+      }
+    QCOMPARE (boundaries, 3);
+  }
+};
+
+double constexpr TestCapturePeriods::day_ms;
+double constexpr TestCapturePeriods::midnight;
+
+QTEST_MAIN (TestCapturePeriods);
+
+#include "test_capture_periods.moc"
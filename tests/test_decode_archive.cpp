@@ -0,0 +1,197 @@
+#include <QtTest>
+
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QTemporaryDir>
+
+#include "Decoder/DecodeArchive.hpp"
+
+class TestDecodeArchive
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+  QDateTime today_;
+
+  QDir directory () const
+  {
+    return QDir {temp_dir_.filePath ("decode_archive")};
+  }
+
+  static DecodeEvent event (QString const& line, QDateTime const& received, QString const& band = "20m")
+  {
+    DecodeEvent event;
+    DecodeEvent::parse (line, &event);
+    event.received = received;
+    event.mode = "FT8";
+    event.band = band;
+    event.dial_frequency = band == "20m" ? 14074000 : 7074000;
+    return event;
+  }
+
+  static DecodeArchive::Record record (QString const& message)
+  {
+    DecodeArchive::Record record;
+    record.call = "none";
+    DecodeArchive::record (event ("1200 -10  0.2 1500 ~  " + message, QDateTime::currentDateTimeUtc ()), &record);
+    return record;
+  }
+
+  // up to an hour after noon today
+  DecodeArchive::Query query () const
+  {
+    DecodeArchive::Query query;
+    query.to = today_.addSecs (3600);
+    return query;
+  }
+
+  Q_SLOT void initTestCase ()
+  {
+    // noon today and on the days before
+    today_ = QDateTime {QDateTime::currentDateTimeUtc ().date (), QTime {12, 0, 30}, Qt::UTC};
+    DecodeArchiveSink sink {directory ()};
+    sink.open ();
+    sink.write (event ("1200 -10  0.2 1500 ~  CQ K1ABC FN42", today_.addDays (-40)));
+    sink.flush ();
+    sink.write (event ("1200 -12  0.3 1510 ~  CQ K1ABC FN42", today_.addDays (-2)));
+    sink.write (event ("1200  -5 -0.1  900 ~  CQ DX W9XYZ EN52", today_.addDays (-2)));
+    sink.flush ();
+    sink.write (event ("1200  -8  0.1 1520 ~  W9XYZ K1ABC -11", today_.addDays (-1), "40m"));
+    sink.write (event ("1200  -7  0.1 1520 ~  K1ABC W9XYZ R-09", today_.addDays (-1), "40m"));
+    sink.flush ();
+    auto replay = event ("1200 -12  0.3 1510 ~  CQ K1ABC FN42", today_);
+    replay.is_new = false;
+    sink.write (replay);
+    auto off_air = replay;
+    off_air.is_new = true;
+    off_air.off_air = true;
+    sink.write (off_air);
+    sink.write (event ("1200 -15  0.4 1530 ~  W9XYZ K1ABC RR73", today_));
+    sink.flush ();
+  }
+
+  Q_SLOT void extracts_call_grid_and_type ()
+  {
+    auto r = record ("CQ K1ABC FN42");
+    QCOMPARE (r.type, DecodeArchive::MessageType::CQ);
+    QCOMPARE (r.call, QString {"K1ABC"});
+    QCOMPARE (r.grid, QString {"FN42"});
+
+    r = record ("CQ POTA PJ4/K1ABC FK52");
+    QCOMPARE (r.call, QString {"PJ4/K1ABC"});
+    QCOMPARE (r.grid, QString {"FK52"});
+
+    r = record ("W9XYZ <K1ABC/P> R-11");
+    QCOMPARE (r.type, DecodeArchive::MessageType::RogerReport);
+    QCOMPARE (r.call, QString {"K1ABC/P"});
+    QVERIFY (r.grid.isEmpty ());
+
+    QCOMPARE (record ("K1ABC W9XYZ EN52").type, DecodeArchive::MessageType::Grid);
+    QCOMPARE (record ("K1ABC W9XYZ RR73").type, DecodeArchive::MessageType::RR73);
+    QCOMPARE (record ("K1ABC W9XYZ RR73").grid, QString {});
+    QCOMPARE (record ("K1ABC W9XYZ -03").type, DecodeArchive::MessageType::Report);
+    QCOMPARE (record ("K1ABC W9XYZ 73").type, DecodeArchive::MessageType::SeventyThree);
+    QCOMPARE (record ("TNX BOB 73 GL").call, QString {});
+    QCOMPARE (record ("CQ K1ABC FN42          ? a2").message, QString {"CQ K1ABC FN42"});
+  }
+
+  Q_SLOT void queries_by_call_newest_first ()
+  {
+    DecodeArchive archive {directory ()};
+    auto query = this->query ();
+    query.call = "k1abc";
+    auto const records = archive.query (query);
+    QCOMPARE (records.size (), 3);     // the 40 day old one is out of range
+    QCOMPARE (records[0].message, QString {"W9XYZ K1ABC RR73"});
+    QCOMPARE (records[0].time, today_.addSecs (-30));
+    QCOMPARE (records[1].band, QString {"40m"});
+    QCOMPARE (records[1].dial_frequency, quint64 {7074000});
+    QCOMPARE (records[2].snr, -12);
+    QCOMPARE (records[2].dt, 0.3f);
+    QCOMPARE (records[2].frequency, 1510u);
+    QCOMPARE (records[2].grid, QString {"FN42"});
+
+    query.from = today_.addDays (-60);
+    QCOMPARE (archive.query (query).size (), 4);
+  }
+
+  Q_SLOT void queries_by_grid_band_and_mode ()
+  {
+    DecodeArchive archive {directory ()};
+    auto query = this->query ();
+    query.grid = "EN";
+    auto records = archive.query (query);
+    QCOMPARE (records.size (), 1);
+    QCOMPARE (records[0].call, QString {"W9XYZ"});
+
+    query = this->query ();
+    query.band = "40m";
+    records = archive.query (query);
+    QCOMPARE (records.size (), 2);
+    QCOMPARE (records[0].type, DecodeArchive::MessageType::RogerReport);
+
+    query.mode = "FT4";
+    QVERIFY (archive.query (query).isEmpty ());
+
+    query.band = "40M";
+    query.mode = "ft8";
+    QCOMPARE (archive.query (query).size (), 2);
+  }
+
+  Q_SLOT void limits_results ()
+  {
+    DecodeArchive archive {directory ()};
+    auto query = this->query ();
+    query.limit = 2;
+    bool truncated {false};
+    QCOMPARE (archive.query (query, &truncated).size (), 2);
+    QVERIFY (truncated);
+  }
+
+  Q_SLOT void indexes_past_days ()
+  {
+    auto const day = today_.addDays (-2).date ().toString ("yyyyMMdd");
+    QFile::remove (directory ().absoluteFilePath (day + ".idx"));
+    DecodeArchive archive {directory ()};
+    auto query = this->query ();
+    query.call = "W9XYZ";
+    QCOMPARE (archive.query (query).size (), 2);
+    QVERIFY (QFile::exists (directory ().absoluteFilePath (day + ".idx")));
+    QCOMPARE (archive.query (query).size (), 2);
+  }
+
+  Q_SLOT void indexes_blocks_as_written ()
+  {
+    QFileInfo index {directory ().absoluteFilePath (today_.date ().toString ("yyyyMMdd") + ".idx")};
+    QVERIFY (index.exists ());
+    auto const size = index.size ();
+    {
+      DecodeArchiveSink sink {directory ()};
+      sink.open ();
+      sink.write (event ("1200 -11  0.2 1700 ~  CQ G4ABC IO91", today_));
+      sink.flush ();
+    }
+    index.refresh ();
+    QVERIFY (index.size () > size);
+
+    DecodeArchive archive {directory ()};
+    auto query = this->query ();
+    query.call = "G4ABC";
+    QCOMPARE (archive.query (query).size (), 1);
+
+    // a block written but not yet indexed is read from the segment,
+    // and today's index is left to the writer
+    QFile file {index.filePath ()};
+    QVERIFY (file.resize (size));
+    QCOMPARE (archive.query (query).size (), 1);
+    index.refresh ();
+    QCOMPARE (index.size (), size);
+  }
+};
+
+QTEST_MAIN (TestDecodeArchive);
+
+#include "test_decode_archive.moc"
@@ -0,0 +1,143 @@
+#include <QtTest>
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLocalSocket>
+#include <QTemporaryDir>
+
+#include "Decoder/DecodeEventBus.hpp"
+
+class TestDecodeEventBus
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  static DecodeEvent event (QString const& line, bool is_new = true)
+  {
+    DecodeEvent event;
+    DecodeEvent::parse (line, &event);
+    event.is_new = is_new;
+    event.mode = "FT8";
+    event.dial_frequency = 14074000;
+    return event;
+  }
+
+  static QList<QByteArray> lines_in (QString const& path)
+  {
+    QFile file {path};
+    if (!file.open (QIODevice::ReadOnly)) return {};
+    auto lines = file.readAll ().split ('\n');
+    lines.removeAll (QByteArray {});
+    return lines;
+  }
+
+  Q_SLOT void parses_decode_lines ()
+  {
+    DecodeEvent event;
+    QVERIFY (DecodeEvent::parse ("2343 -11  0.8 1259 #  CQ VP2X/GM4WJS GL33", &event));
+    QCOMPARE (event.time, QTime (23, 43));
+    QCOMPARE (event.snr, -11);
+    QCOMPARE (event.dt, 0.8f);
+    QCOMPARE (event.frequency, 1259u);
+    QCOMPARE (event.marker, QString {"#"});
+    QCOMPARE (event.message, QString {"CQ VP2X/GM4WJS GL33"});
+
+    QVERIFY (DecodeEvent::parse ("234315  -7 -0.3  815 ~  KK4DSD W7VP -16", &event));
+    QCOMPARE (event.time, QTime (23, 43, 15));
+    QCOMPARE (event.snr, -7);
+    QCOMPARE (event.dt, -0.3f);
+    QCOMPARE (event.marker, QString {"~"});
+    QCOMPARE (event.message, QString {"KK4DSD W7VP -16"});
+
+    QVERIFY (!DecodeEvent::parse ("------------------------- 20m", &event));
+  }
+
+  Q_SLOT void parses_fst4_marker ()
+  {
+    DecodeEvent event;
+    QVERIFY (DecodeEvent::parse ("2343 -21  0.5 1500 `  CQ K1ABC FN42", &event));
+    QCOMPARE (event.marker, QString {"`"});
+    QCOMPARE (event.message, QString {"CQ K1ABC FN42"});
+  }
+
+  Q_SLOT void falls_back_to_fixed_columns ()
+  {
+    // the usual layout has a whole number frequency
+    DecodeEvent event;
+    QVERIFY (DecodeEvent::parse ("2343 -11  0.8 1259.5 ~ CQ K1ABC FN42", &event));
+    QCOMPARE (event.time, QTime (23, 43));
+    QCOMPARE (event.snr, -11);
+    QCOMPARE (event.marker, QString {"~"});
+    QCOMPARE (event.message, QString {"CQ K1ABC FN42"});
+  }
+
+  Q_SLOT void subscribers_see_every_event ()
+  {
+    DecodeEventBus bus;
+    QStringList seen;
+    bus.subscribe ([&seen] (DecodeEvent const& event) {seen << event.message;});
+    bus.publish (event ("2343 -11  0.8 1259 ~  CQ K1ABC FN42"));
+    bus.publish (event ("2343 -13  0.1 1627 ~  W9XYZ K1ABC -15", false));
+    QCOMPARE (seen, (QStringList {"CQ K1ABC FN42", "W9XYZ K1ABC -15"}));
+    QCOMPARE (bus.published (), quint64 {2});
+  }
+
+  Q_SLOT void file_sink_writes_new_decodes ()
+  {
+    auto const path = temp_dir_.filePath ("decodes.jsonl");
+    {
+      DecodeEventBus bus;
+      bus.add_sink (new JsonLinesFileSink {path});
+      bus.publish (event ("2343 -11  0.8 1259 ~  CQ K1ABC FN42"));
+      bus.publish (event ("2343 -13  0.1 1627 ~  W9XYZ K1ABC -15", false));
+      bus.publish (event ("2344 -13  0.1 1627 ~  K1ABC W9XYZ R-09"));
+    }                           // flushed and closed
+
+    auto const lines = lines_in (path);
+    QCOMPARE (lines.size (), 2);
+    auto const json = QJsonDocument::fromJson (lines.first ()).object ();
+    QCOMPARE (json["message"].toString (), QString {"CQ K1ABC FN42"});
+    QCOMPARE (json["time"].toString (), QString {"234300"});
+    QCOMPARE (json["snr"].toInt (), -11);
+    QCOMPARE (json["freq"].toInt (), 1259);
+    QCOMPARE (json["mode"].toString (), QString {"FT8"});
+    QCOMPARE (json["dial"].toDouble (), 14074000.);
+    QCOMPARE (QJsonDocument::fromJson (lines.last ()).object ()["message"].toString ()
+              , QString {"K1ABC W9XYZ R-09"});
+  }
+
+  Q_SLOT void stream_sink_serves_local_clients ()
+  {
+    auto const name = QString {"test_decode_events_%1"}.arg (QCoreApplication::applicationPid ());
+    DecodeEventBus bus;
+    bus.add_sink (new DecodeStreamSink {name, 0});
+
+    QLocalSocket client;
+    for (int i = 0; i < 100 && client.state () != QLocalSocket::ConnectedState; ++i)
+      {
+        client.connectToServer (name);
+        if (!client.waitForConnected (50)) QTest::qWait (20);
+      }
+    QCOMPARE (client.state (), QLocalSocket::ConnectedState);
+
+    // the sink accepts on its own thread, keep publishing until the
+    // connection has been picked up
+    for (int i = 0; i < 100 && !client.canReadLine (); ++i)
+      {
+        bus.publish (event ("2343 -11  0.8 1259 ~  CQ K1ABC FN42"));
+        client.waitForReadyRead (50);
+      }
+    QVERIFY (client.canReadLine ());
+    auto const json = QJsonDocument::fromJson (client.readLine ()).object ();
+    QCOMPARE (json["message"].toString (), QString {"CQ K1ABC FN42"});
+    QCOMPARE (json["new"].toBool (), true);
+  }
+};
+
+QTEST_MAIN (TestDecodeEventBus);
+
+#include "test_decode_event_bus.moc"
@@ -0,0 +1,152 @@
+#include <QtTest>
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include <QFile>
+#include <QTemporaryDir>
+#include <QTextStream>
+
+#include "Audio/Equalizer.hpp"
+
+class TestEqualizer
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  // a reference spectrum file as refspectrum() writes it, gain (f)
+  // gives the correction at each frequency
+  template<typename F>
+  QString write_refspec (QString const& name, F gain)
+  {
+    auto const file_name = temp_dir_.filePath (name);
+    QFile file {file_name};
+    file.open (QFile::WriteOnly | QFile::Text);
+    QTextStream stream {&file};
+    stream << "  400 2600    5";
+    for (int i = 0; i < 5; ++i) stream << "   0.1000000000000000E+01";
+    stream << '\n';
+    for (int i = 1; i <= 3456; ++i)
+      {
+        auto const freq = i * 12000. / 6912.;
+        auto const fil = gain (freq);
+        stream << QString::asprintf ("%10.3f%12.3e%12.6f%12.3e%12.6f\n", freq, 1., 0., fil, 20. * std::log10 (fil));
+      }
+    return file_name;
+  }
+
+  // a few seconds of tones
+  std::vector<short> tones (std::initializer_list<double> frequencies)
+  {
+    std::vector<short> samples (3 * 12000);
+    for (std::size_t i = 0; i < samples.size (); ++i)
+      {
+        double sum {0.};
+        for (auto f : frequencies) sum += 4000. * std::sin (2. * M_PI * f * i / 12000.);
+        samples[i] = static_cast<short> (std::lround (sum));
+      }
+    return samples;
+  }
+
+  void process (Equalizer& equalizer, std::vector<short>& samples, int block)
+  {
+    for (std::size_t i = 0; i < samples.size (); i += block)
+      {
+        equalizer.process (&samples[i], qMin (block, static_cast<int> (samples.size () - i)));
+      }
+  }
+
+  // amplitude of a tone in the second half of samples
+  double amplitude (std::vector<short> const& samples, double f)
+  {
+    double re {0.}, im {0.};
+    auto const start = samples.size () / 2;
+    for (auto i = start; i < samples.size (); ++i)
+      {
+        re += samples[i] * std::cos (2. * M_PI * f * i / 12000.);
+        im += samples[i] * std::sin (2. * M_PI * f * i / 12000.);
+      }
+    return 2. * std::hypot (re, im) / (samples.size () - start);
+  }
+
+  Q_SLOT void missing_file_gives_no_filter ()
+  {
+    QVERIFY (Equalizer::design (temp_dir_.filePath ("none.dat")).isEmpty ());
+  }
+
+  Q_SLOT void no_taps_passes_audio_unchanged ()
+  {
+    Equalizer equalizer;
+    QVERIFY (!equalizer.active ());
+    auto samples = tones ({1000.});
+    auto const original = samples;
+    process (equalizer, samples, 3456);
+    QVERIFY (samples == original);
+  }
+
+  Q_SLOT void flat_response_only_delays ()
+  {
+    auto const taps = Equalizer::design (write_refspec ("flat.dat", [] (double) {return 1.;}));
+    QCOMPARE (taps.size (), Equalizer::taps);
+    Equalizer equalizer;
+    equalizer.set_taps (taps);
+    QVERIFY (equalizer.active ());
+    auto samples = tones ({700., 1500.});
+    auto const original = samples;
+    process (equalizer, samples, 3456);
+    int const delay {Equalizer::taps / 2};
+    for (std::size_t i = 6000; i < samples.size (); ++i)
+      {
+        QVERIFY2 (std::abs (samples[i] - original[i - delay]) <= 4, qPrintable (QString::number (i)));
+      }
+  }
+
+  Q_SLOT void corrects_a_sloping_response ()
+  {
+    // a receiver that rolls off towards the top of the pass band
+    auto const taps = Equalizer::design (write_refspec ("slope.dat", [] (double f) {return .5 + f / 2000.;}));
+    Equalizer equalizer;
+    equalizer.set_taps (taps);
+    auto samples = tones ({500., 2500.});
+    process (equalizer, samples, 3456);
+    QVERIFY (std::abs (amplitude (samples, 500.) / 4000. - .75) < .01);
+    QVERIFY (std::abs (amplitude (samples, 2500.) / 4000. - 1.75) < .01);
+  }
+
+  Q_SLOT void block_size_does_not_matter ()
+  {
+    auto const taps = Equalizer::design (write_refspec ("slope.dat", [] (double f) {return .5 + f / 2000.;}));
+    Equalizer large;
+    large.set_taps (taps);
+    Equalizer small;
+    small.set_taps (taps);
+    auto a = tones ({500., 1200., 2500.});
+    auto b = a;
+    process (large, a, 3456);
+    process (small, b, 896);
+    for (std::size_t i = 0; i < a.size (); ++i)
+      {
+        QVERIFY (std::abs (a[i] - b[i]) <= 1);
+      }
+  }
+
+  Q_SLOT void reset_forgets_the_overlap ()
+  {
+    Equalizer equalizer;
+    equalizer.set_taps (Equalizer::design (write_refspec ("flat.dat", [] (double) {return 1.;})));
+    auto samples = tones ({1000.});
+    process (equalizer, samples, 3456);
+    equalizer.reset ();
+    std::vector<short> silence (3456, 0);
+    equalizer.process (silence.data (), static_cast<int> (silence.size ()));
+    QVERIFY (std::all_of (silence.begin (), silence.end (), [] (short s) {return s == 0;}));
+  }
+};
+
+QTEST_MAIN (TestEqualizer);
+
+#include "test_equalizer.moc"
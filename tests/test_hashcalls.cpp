@@ -0,0 +1,153 @@
+#include <QtTest>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+#include <QByteArray>
+#include <QTemporaryDir>
+
+#include "lib/hashcalls.h"
+#include "lib/wsprd/nhash.h"
+
+class TestHashCalls
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  static int hash (QByteArray const& call, int bits)
+  {
+    return hashcalls_ihashcall (call.constData (), call.size (), bits);
+  }
+
+  static QByteArray lookup (int hash, int bits)
+  {
+    char call[HASHCALLS_CALL_CAP - 1];
+    if (!hashcalls_lookup (hash, bits, call)) return {};
+    return QByteArray {call, sizeof call}.trimmed ();
+  }
+
+  QByteArray path () const
+  {
+    return temp_dir_.filePath ("hashcalls.dat").toLocal8Bit ();
+  }
+
+  Q_SLOT void init ()
+  {
+    hashcalls_close ();
+    QFile::remove (path ());
+  }
+
+  Q_SLOT void cleanupTestCase ()
+  {
+    hashcalls_close ();
+  }
+
+  Q_SLOT void matches_packjt77_hashes ()
+  {
+    // values from packjt77 ihashcall
+    QCOMPARE (hash ("PJ4/K1ABC", 22), 1420834);
+    QCOMPARE (hash ("PJ4/K1ABC", 12), 1387);
+    QCOMPARE (hash ("PJ4/K1ABC", 10), 346);
+    QCOMPARE (hash ("3D2AG/P", 22), 2323875);
+  }
+
+  Q_SLOT void resolves_all_hash_lengths ()
+  {
+    hashcalls_save ("<PJ4/K1ABC>  ", 13);
+    QCOMPARE (lookup (hash ("PJ4/K1ABC", 22), 22), QByteArray {"PJ4/K1ABC"});
+    QCOMPARE (lookup (hash ("PJ4/K1ABC", 12), 12), QByteArray {"PJ4/K1ABC"});
+    QCOMPARE (lookup (hash ("PJ4/K1ABC", 10), 10), QByteArray {"PJ4/K1ABC"});
+    QCOMPARE (lookup (nhash ("PJ4/K1ABC", 9, 146), 15), QByteArray {"PJ4/K1ABC"});
+    QVERIFY (lookup (hash ("K1ABC", 22), 22).isEmpty ());
+  }
+
+  Q_SLOT void ignores_unresolved_and_short_calls ()
+  {
+    hashcalls_save ("<...>        ", 13);
+    hashcalls_save ("K1", 2);
+    QVERIFY (lookup (hash ("...", 22), 22).isEmpty ());
+    QVERIFY (lookup (hash ("K1", 22), 22).isEmpty ());
+  }
+
+  Q_SLOT void shared_through_file ()
+  {
+    QCOMPARE (hashcalls_open (path ().constData ()), 0);
+    hashcalls_save ("VK9XYZ/MM", 9);
+    hashcalls_close ();
+
+    // a private table until opened, as in another process
+    QVERIFY (lookup (hash ("VK9XYZ/MM", 22), 22).isEmpty ());
+    QCOMPARE (hashcalls_open (path ().constData ()), 0);
+    QCOMPARE (lookup (hash ("VK9XYZ/MM", 22), 22), QByteArray {"VK9XYZ/MM"});
+  }
+
+  Q_SLOT void evicts_least_recently_saved ()
+  {
+    hashcalls_save ("PJ4/K1ABC", 9);
+    for (int i = 0; i < 5000; ++i)
+      {
+        auto const call = QByteArray {"K"} + QByteArray::number (i) + "XYZ";
+        hashcalls_save (call.constData (), call.size ());
+      }
+    QVERIFY (lookup (hash ("PJ4/K1ABC", 22), 22).isEmpty ());
+    QCOMPARE (lookup (hash ("K4999XYZ", 22), 22), QByteArray {"K4999XYZ"});
+  }
+
+  Q_SLOT void forgets_wspr_hashes_only ()
+  {
+    hashcalls_save ("PJ4/K1ABC", 9);
+    hashcalls_forget_wspr ();
+    QVERIFY (lookup (nhash ("PJ4/K1ABC", 9, 146), 15).isEmpty ());
+    QCOMPARE (lookup (hash ("PJ4/K1ABC", 22), 22), QByteArray {"PJ4/K1ABC"});
+  }
+
+  Q_SLOT void forgotten_wspr_hashes_stay_forgotten ()
+  {
+    QCOMPARE (hashcalls_open (path ().constData ()), 0);
+    hashcalls_save ("PJ4/K1ABC", 9);
+    hashcalls_forget_wspr ();
+    hashcalls_close ();
+
+    // opening rebuilds the table as wsprd does every period
+    QCOMPARE (hashcalls_open (path ().constData ()), 0);
+    QVERIFY (lookup (nhash ("PJ4/K1ABC", 9, 146), 15).isEmpty ());
+    QCOMPARE (lookup (hash ("PJ4/K1ABC", 22), 22), QByteArray {"PJ4/K1ABC"});
+
+    // until the call is heard again
+    hashcalls_save ("PJ4/K1ABC", 9);
+    QCOMPARE (lookup (nhash ("PJ4/K1ABC", 9, 146), 15), QByteArray {"PJ4/K1ABC"});
+  }
+
+  Q_SLOT void reopening_while_in_use ()
+  {
+    std::atomic<bool> stop {false};
+    std::vector<std::thread> users;
+    for (int i = 0; i < 4; ++i)
+      {
+        users.emplace_back ([&stop] {
+            while (!stop)
+              {
+                hashcalls_save ("K1ABC", 5);
+                lookup (hash ("K1ABC", 22), 22);
+              }
+          });
+      }
+    bool opened {true};
+    for (int i = 0; i < 200; ++i)
+      {
+        opened = !hashcalls_open (path ().constData ()) && opened;
+        hashcalls_close ();
+      }
+    stop = true;
+    for (auto& user : users) user.join ();
+    QVERIFY (opened);
+  }
+};
+
+QTEST_MAIN (TestHashCalls);
+
+#include "test_hashcalls.moc"
@@ -0,0 +1,207 @@
+#include <QtTest>
+
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <QFile>
+#include <QTemporaryDir>
+
+#include <boost/log/core.hpp>
+#include <boost/log/sinks/async_frontend.hpp>
+#include <boost/log/sinks/basic_sink_backend.hpp>
+#include <boost/log/sources/logger.hpp>
+#include <boost/log/sources/record_ostream.hpp>
+#include <boost/log/expressions.hpp>
+#include <boost/make_shared.hpp>
+
+#include "Logger.hpp"
+#include "LogSinks.hpp"
+
+namespace logging = boost::log;
+namespace sinks = logging::sinks;
+namespace keywords = logging::keywords;
+
+namespace
+{
+  // collects the messages it is fed
+  class collector
+    : public sinks::basic_sink_backend<sinks::synchronized_feeding>
+  {
+  public:
+    void consume (logging::record_view const& record)
+    {
+      messages.push_back (*logging::extract<std::string> ("Message", record));
+    }
+
+    std::vector<std::string> messages;
+  };
+
+  using sink_type = sinks::asynchronous_sink<collector, Logger::bounded_queue>;
+}
+
+class TestLogSinks
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  // a sink whose queue is only emptied by feed_records ()
+  boost::shared_ptr<sink_type> idle_sink (std::size_t queue_size, Logger::Overflow overflow)
+  {
+    auto sink = boost::make_shared<sink_type> (boost::make_shared<collector> (), keywords::start_thread = false);
+    sink->set_capacity (queue_size, overflow);
+    return sink;
+  }
+
+  void log_numbers (boost::shared_ptr<sink_type> const& sink, int count)
+  {
+    auto core = logging::core::get ();
+    core->add_sink (sink);
+    logging::sources::logger log;
+    for (int i = 0; i < count; ++i)
+      {
+        BOOST_LOG (log) << i;
+      }
+    core->remove_sink (sink);
+  }
+
+  Q_SLOT void init ()
+  {
+    logging::core::get ()->remove_all_sinks ();
+  }
+
+  Q_SLOT void drop_newest_keeps_the_first ()
+  {
+    auto sink = idle_sink (4, Logger::Overflow::DropNewest);
+    auto const dropped = Logger::dropped_records ();
+    log_numbers (sink, 10);
+    QCOMPARE (sink->dropped (), std::uint64_t {6});
+    QCOMPARE (Logger::dropped_records () - dropped, std::uint64_t {6});
+    sink->feed_records ();
+    QCOMPARE (sink->locked_backend ()->messages, (std::vector<std::string> {"0", "1", "2", "3"}));
+    QCOMPARE (sink->take_unreported (), std::uint64_t {6});
+    QCOMPARE (sink->take_unreported (), std::uint64_t {0});
+  }
+
+  Q_SLOT void drop_oldest_keeps_the_last ()
+  {
+    auto sink = idle_sink (4, Logger::Overflow::DropOldest);
+    log_numbers (sink, 10);
+    QCOMPARE (sink->dropped (), std::uint64_t {6});
+    sink->feed_records ();
+    QCOMPARE (sink->locked_backend ()->messages, (std::vector<std::string> {"6", "7", "8", "9"}));
+  }
+
+  Q_SLOT void default_drops_the_oldest ()
+  {
+    // as the default sys_sink is made, it must never hold up logging
+    auto sink = boost::make_shared<sink_type> (boost::make_shared<collector> (), keywords::start_thread = false);
+    log_numbers (sink, 4106);
+    QCOMPARE (sink->dropped (), std::uint64_t {10});
+    sink->feed_records ();
+    QCOMPARE (sink->locked_backend ()->messages.front (), std::string {"10"});
+    QCOMPARE (sink->locked_backend ()->messages.size (), std::size_t {4096});
+  }
+
+  Q_SLOT void try_consume_counts_drops ()
+  {
+    auto sink = idle_sink (4, Logger::Overflow::DropNewest);
+    auto core = logging::core::get ();
+    core->add_sink (sink);
+    logging::sources::logger log;
+    auto record = log.open_record ();
+    QVERIFY (record);
+    {
+      logging::record_ostream stream {record};
+      stream << "x";
+    }
+    auto const view = record.lock ();
+    core->remove_sink (sink);
+
+    auto const dropped = Logger::dropped_records ();
+    for (int i = 0; i < 10; ++i)
+      {
+        QVERIFY (sink->try_consume (view)); // dropped is as good as queued
+      }
+    QCOMPARE (sink->dropped (), std::uint64_t {6});
+    QCOMPARE (Logger::dropped_records () - dropped, std::uint64_t {6});
+
+    // only a queue that would block refuses
+    sink->set_capacity (4, Logger::Overflow::Block);
+    QVERIFY (!sink->try_consume (view));
+    QCOMPARE (sink->dropped (), std::uint64_t {6});
+  }
+
+  Q_SLOT void block_loses_nothing ()
+  {
+    auto sink = boost::make_shared<sink_type> (boost::make_shared<collector> ());
+    sink->set_capacity (2, Logger::Overflow::Block);
+    log_numbers (sink, 1000);
+    sink->flush ();
+    QCOMPARE (sink->dropped (), std::uint64_t {0});
+    QCOMPARE (sink->locked_backend ()->messages.size (), std::size_t {1000});
+    QCOMPARE (sink->locked_backend ()->messages.back (), std::string {"999"});
+    sink->stop ();
+  }
+
+  Q_SLOT void flight_recorder_writes_on_error ()
+  {
+    auto const file_name = temp_dir_.filePath ("recorder.log");
+    std::wstringstream config;
+    config << L"[Sinks.Recorder]\n"
+           << L"Destination=FlightRecorder\n"
+           << L"FileName=\"" << file_name.toStdWString () << L"\"\n"
+           << L"Capacity=3\n"
+           << L"Format=\"[%Severity%] %Message%\"\n";
+    Logger::init_from_config (config);
+
+    for (int i = 0; i < 5; ++i)
+      {
+        LOG_INFO ("record " << i);
+      }
+    logging::core::get ()->flush ();
+    QVERIFY (!QFile::exists (file_name)); // nothing is written until needed
+    LOG_ERROR ("failure");
+    logging::core::get ()->flush ();
+
+    QFile file {file_name};
+    QVERIFY (file.open (QFile::ReadOnly | QFile::Text));
+    auto const lines = QString {file.readAll ()}.split ('\n', QString::SkipEmptyParts);
+    QCOMPARE (lines.size (), 4);
+    QVERIFY (lines[0].contains ("last 3 records"));
+    QCOMPARE (lines[1], QString {"[info] record 3"});
+    QCOMPARE (lines[2], QString {"[info] record 4"});
+    QCOMPARE (lines[3], QString {"[error] failure"});
+  }
+
+  Q_SLOT void rejects_unknown_overflow_policy ()
+  {
+    std::wstringstream config;
+    config << L"[Sinks.Trace]\n"
+           << L"Destination=BoundedTextFile\n"
+           << L"FileName=\"" << temp_dir_.filePath ("trace.log").toStdWString () << L"\"\n"
+           << L"Overflow=Sometimes\n";
+    bool threw {false};
+    try
+      {
+        Logger::init_from_config (config);
+      }
+    catch (std::exception const&)
+      {
+        threw = true;
+      }
+    QVERIFY (threw);
+  }
+
+  Q_SLOT void cleanupTestCase ()
+  {
+    logging::core::get ()->remove_all_sinks ();
+  }
+};
+
+QTEST_MAIN (TestLogSinks);
+
+#include "test_log_sinks.moc"
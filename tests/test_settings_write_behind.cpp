@@ -0,0 +1,75 @@
+#include <QtTest>
+
+#include <QFile>
+#include <QSettings>
+#include <QTemporaryDir>
+
+#include "SettingsWriteBehind.hpp"
+
+class TestSettingsWriteBehind
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  QString file_name (QString const& name) const
+  {
+    return temp_dir_.filePath (name + ".ini");
+  }
+
+  static QByteArray contents (QString const& path)
+  {
+    QFile file {path};
+    return file.open (QFile::ReadOnly) ? file.readAll () : QByteArray {};
+  }
+
+  Q_SLOT void coalesces_changes ()
+  {
+    QSettings settings {file_name ("coalesce"), QSettings::IniFormat};
+    SettingsWriteBehind write_behind {&settings, 200};
+    for (int i = 0; i < 100; ++i)
+      {
+        settings.setValue (QString {"key%1"}.arg (i), i);
+        QCoreApplication::processEvents ();
+      }
+    QVERIFY (write_behind.pending ());
+    QCOMPARE (write_behind.writes (), 0);
+    QVERIFY (!contents (file_name ("coalesce")).contains ("key99"));
+
+    QTRY_VERIFY (!write_behind.pending ());
+    QCOMPARE (write_behind.writes (), 1);
+    QVERIFY (contents (file_name ("coalesce")).contains ("key99=99"));
+  }
+
+  Q_SLOT void flush_writes_now ()
+  {
+    QSettings settings {file_name ("flush"), QSettings::IniFormat};
+    SettingsWriteBehind write_behind {&settings, 60000};
+    settings.setValue ("call", "K1ABC");
+    QCoreApplication::processEvents ();
+    write_behind.flush ();
+    QCOMPARE (write_behind.writes (), 1);
+    QVERIFY (contents (file_name ("flush")).contains ("call=K1ABC"));
+
+    // nothing new to write
+    write_behind.flush ();
+    QCOMPARE (write_behind.writes (), 1);
+  }
+
+  Q_SLOT void writes_on_destruction ()
+  {
+    QSettings settings {file_name ("destroy"), QSettings::IniFormat};
+    {
+      SettingsWriteBehind write_behind {&settings, 60000};
+      settings.setValue ("grid", "FN42");
+      QCoreApplication::processEvents ();
+    }
+    QVERIFY (contents (file_name ("destroy")).contains ("grid=FN42"));
+  }
+};
+
+QTEST_MAIN (TestSettingsWriteBehind);
+
+#include "test_settings_write_behind.moc"
@@ -0,0 +1,254 @@
+#include <QtTest>
+
+#include <QFile>
+#include <QHash>
+#include <QNetworkAccessManager>
+#include <QPointer>
+#include <QSignalSpy>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <QTimer>
+#include <QUrl>
+#include <QUrlQuery>
+#include <functional>
+
+#include "Network/wsprnet.h"
+
+namespace
+{
+  // stand in for wsprnet.org/post/, answers each POST after a short
+  // delay so that concurrent requests overlap
+  class TestWsprNetServer final
+    : public QObject
+  {
+  public:
+    struct Response
+    {
+      int status {200};
+      QByteArray reason {"OK"};
+      QByteArray body {"1 spot(s) added"};
+    };
+    using Handler = std::function<Response (QUrlQuery const& spot)>;
+
+    explicit TestWsprNetServer (QObject * parent = nullptr)
+      : QObject {parent}
+    {
+      connect (&server_, &QTcpServer::newConnection, this, &TestWsprNetServer::on_new_connection);
+    }
+
+    bool listen ()
+    {
+      return server_.listen (QHostAddress::LocalHost, 0);
+    }
+
+    QUrl url () const
+    {
+      return QUrl {QStringLiteral ("http://127.0.0.1:%1/post/").arg (server_.serverPort ())};
+    }
+
+    void set_handler (Handler handler)
+    {
+      handler_ = std::move (handler);
+    }
+
+    QList<QUrlQuery> spots;
+    int max_pending {0};
+
+  private:
+    void on_new_connection ()
+    {
+      while (auto * socket = server_.nextPendingConnection ())
+        {
+          connect (socket, &QTcpSocket::readyRead, this, [this, socket] () { on_ready_read (socket); });
+          connect (socket, &QTcpSocket::disconnected, this, [this, socket] () {
+            buffers_.remove (socket);
+            socket->deleteLater ();
+          });
+        }
+    }
+
+    void on_ready_read (QTcpSocket * socket)
+    {
+      auto& buffer = buffers_[socket];
+      buffer += socket->readAll ();
+      auto const header_end = buffer.indexOf ("\r\n\r\n");
+      if (header_end < 0)
+        {
+          return;
+        }
+      int content_length {0};
+      for (auto const& line : buffer.left (header_end).split ('\n'))
+        {
+          if (line.toLower ().startsWith ("content-length:"))
+            {
+              content_length = line.mid (15).trimmed ().toInt ();
+            }
+        }
+      if (buffer.size () < header_end + 4 + content_length)
+        {
+          return;
+        }
+      QUrlQuery spot {QString::fromUtf8 (buffer.mid (header_end + 4, content_length))};
+      buffer.remove (0, header_end + 4 + content_length);
+      spots << spot;
+      Response response;
+      if (handler_)
+        {
+          response = handler_ (spot);
+        }
+
+      max_pending = qMax (max_pending, ++pending_);
+      QPointer<QTcpSocket> guard {socket};
+      QTimer::singleShot (100, this, [this, guard, response] () {
+        --pending_;
+        if (!guard) return;
+        QByteArray payload;
+        payload += "HTTP/1.1 " + QByteArray::number (response.status) + ' ' + response.reason + "\r\n";
+        payload += "Content-Type: text/plain\r\n";
+        payload += "Content-Length: " + QByteArray::number (response.body.size ()) + "\r\n";
+        payload += "\r\n";
+        payload += response.body;
+        guard->write (payload);
+        guard->flush ();
+      });
+    }
+
+    QTcpServer server_;
+    Handler handler_;
+    QHash<QTcpSocket *, QByteArray> buffers_;
+    int pending_ {0};
+  };
+}
+
+class TestWsprNet
+  : public QObject
+{
+  Q_OBJECT
+
+private:
+  QTemporaryDir temp_dir_;
+
+  // wspr_spots.txt as written by wsprd, n spots near 14.0971 MHz
+  QString write_spots_file (int n) const
+  {
+    auto const path = temp_dir_.filePath (QStringLiteral ("wspr_spots.txt"));
+    QFile file {path};
+    if (!file.open (QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text))
+      {
+        return {};
+      }
+    QTextStream out {&file};
+    for (int i = 0; i < n; ++i)
+      {
+        out << "130223 2256 7    -21 -0.3  14.09709" << i << "  K1A" << char ('A' + i)
+            << " FN42 37          0    40    0\n";
+      }
+    return path;
+  }
+
+  void upload (WSPRNet& wsprnet, QString const& spots_file)
+  {
+    wsprnet.upload (QStringLiteral ("W1XYZ"), QStringLiteral ("FN31"), QStringLiteral ("14.097100")
+                    , QStringLiteral ("14.097100"), QStringLiteral ("WSPR"), 120.f, QStringLiteral ("0")
+                    , QStringLiteral ("37"), QStringLiteral ("test"), spots_file);
+  }
+
+  static int lines_in (QString const& path)
+  {
+    QFile file {path};
+    if (!file.open (QIODevice::ReadOnly | QIODevice::Text))
+      {
+        return 0;
+      }
+    return file.readAll ().count ('\n');
+  }
+
+  Q_SLOT void posts_spots_concurrently ()
+  {
+    TestWsprNetServer server;
+    QVERIFY (server.listen ());
+    QNetworkAccessManager manager;
+    WSPRNet wsprnet {&manager};
+    wsprnet.set_url (server.url ());
+    wsprnet.set_max_concurrent (3);
+    QSignalSpy status_spy (&wsprnet, SIGNAL (uploadStatus (QString)));
+
+    upload (wsprnet, write_spots_file (5));
+
+    QTRY_COMPARE_WITH_TIMEOUT (static_cast<int> (wsprnet.statistics ().sent), 5, 5000);
+    QCOMPARE (server.spots.size (), 5);
+    QCOMPARE (server.max_pending, 3);
+    QCOMPARE (server.spots.first ().queryItemValue ("function"), QStringLiteral ("wspr"));
+    QCOMPARE (server.spots.first ().queryItemValue ("rcall"), QStringLiteral ("W1XYZ"));
+    QCOMPARE (wsprnet.statistics ().backlog, 0);
+    QTRY_VERIFY (status_spy.size () && status_spy.last ().at (0).toString () == QStringLiteral ("done"));
+  }
+
+  Q_SLOT void backlog_survives_outage_and_restart ()
+  {
+    auto const queue_file = temp_dir_.filePath (QStringLiteral ("wsprnet_queue.txt"));
+    TestWsprNetServer server;
+    QVERIFY (server.listen ());
+    bool down {true};
+    server.set_handler ([&down] (QUrlQuery const&) {
+      TestWsprNetServer::Response response;
+      if (down)
+        {
+          response.status = 503;
+          response.reason = "Service Unavailable";
+          response.body = "down for maintenance";
+        }
+      return response;
+    });
+
+    QNetworkAccessManager manager;
+    {
+      WSPRNet wsprnet {&manager};
+      wsprnet.set_url (server.url ());
+      wsprnet.set_queue_file (queue_file);
+      upload (wsprnet, write_spots_file (4));
+
+      QTRY_VERIFY_WITH_TIMEOUT (wsprnet.statistics ().retries > 0, 5000);
+      QCOMPARE (wsprnet.statistics ().sent, quint64 {0});
+      QCOMPARE (wsprnet.statistics ().backlog, 4);
+      QTRY_COMPARE_WITH_TIMEOUT (lines_in (queue_file), 4, 5000);
+    }
+
+    // a new session picks up where the old one left off
+    down = false;
+    server.spots.clear ();
+    WSPRNet wsprnet {&manager};
+    wsprnet.set_url (server.url ());
+    wsprnet.set_queue_file (queue_file);
+    QCOMPARE (wsprnet.statistics ().backlog, 4);
+    QTRY_COMPARE_WITH_TIMEOUT (static_cast<int> (wsprnet.statistics ().sent), 4, 5000);
+    QCOMPARE (server.spots.size (), 4);
+    QTRY_VERIFY_WITH_TIMEOUT (!QFile::exists (queue_file), 5000);
+  }
+
+  Q_SLOT void rejected_spots_are_not_retried ()
+  {
+    TestWsprNetServer server;
+    QVERIFY (server.listen ());
+    server.set_handler ([] (QUrlQuery const&) {
+      TestWsprNetServer::Response response;
+      response.body = "invalid callsign";
+      return response;
+    });
+    QNetworkAccessManager manager;
+    WSPRNet wsprnet {&manager};
+    wsprnet.set_url (server.url ());
+
+    upload (wsprnet, write_spots_file (2));
+
+    QTRY_COMPARE_WITH_TIMEOUT (static_cast<int> (wsprnet.statistics ().rejected), 2, 5000);
+    QCOMPARE (wsprnet.statistics ().retries, quint64 {0});
+    QCOMPARE (wsprnet.statistics ().backlog, 0);
+  }
+};
+
+QTEST_MAIN (TestWsprNet);
+
+#include "test_wsprnet.moc"
@@ -13,32 +13,25 @@
 #include <QHeaderView>
 #include <QHBoxLayout>
 #include <QLabel>
-#include <QLocale>
-#include <QNetworkAccessManager>
-#include <QNetworkReply>
-#include <QNetworkRequest>
 #include <QPushButton>
-#include <QRegularExpression>
 #include <QSettings>
-#include <QTcpSocket>
-#include <QElapsedTimer>
 #include <QShowEvent>
 #include <QHideEvent>
 #include <QSignalBlocker>
-#include <QTableWidget>
-#include <QTextStream>
+#include <QSortFilterProxyModel>
+#include <QTableView>
 #include <QUrl>
-#include <QUrlQuery>
 #include <QVBoxLayout>
-#include <functional>
+
+#include "Network/DXClusterClient.hpp"
+#include "models/DXClusterSpotModel.hpp"
 
 namespace
 {
 QString const kDefaultClusterHost {QStringLiteral ("iq8do.aricaserta.it")};
 int const kDefaultClusterPort = 7300;
-int const kRefreshMs = 15 * 1000;
-int const kMaxSpots = 120;
-qint64 const kMaxDxClusterReplyBytes = 256 * 1024;
+int const kMaxSpots = 120;          // show/dx backfill size
+int const kExpiryMs = 60 * 1000;
 
 QString configured_cluster_host (QSettings * settings)
 {
@@ -126,339 +119,64 @@ QString feed_summary_text (QSettings * settings)
   return QObject::tr ("Cluster feed + AutoSpot submit: %1").arg (configured_cluster_endpoint (settings));
 }
 
-bool contains_cluster_prompt (QByteArray const& buffer)
-{
-  auto const text = QString::fromLatin1 (buffer).simplified ();
-  auto const lower = text.toLower ();
-  return lower.contains (QStringLiteral ("login:"))
-      || lower.contains (QStringLiteral ("call:"))
-      || lower.contains (QStringLiteral ("callsign"))
-      || lower.contains (QStringLiteral ("enter your"))
-      || lower.contains (QStringLiteral ("please enter"))
-      || text.endsWith (QLatin1Char (':'))
-      || text.endsWith (QLatin1Char ('>'))
-      || (lower.contains (QStringLiteral (" de ")) && text.endsWith (QLatin1Char ('>')));
-}
-
-bool contains_cluster_error_payload (QByteArray const& buffer)
-{
-  auto const lower = QString::fromUtf8 (buffer).toLower ();
-  return lower.contains (QStringLiteral ("need a callsign"))
-      || lower.contains (QStringLiteral ("usage:"))
-      || lower.contains (QStringLiteral ("invalid callsign"))
-      || lower.contains (QStringLiteral ("unknown command"))
-      || lower.contains (QStringLiteral ("sorry"));
 }
 
-bool contains_cluster_spot_payload (QByteArray const& buffer)
+// band and mode filter in front of the spot store
+class DXClusterSpotFilter final
+  : public QSortFilterProxyModel
 {
-  if (buffer.contains ("DX de "))
-    {
-      return true;
-    }
-
-  static auto const snapshotLineRe = QRegularExpression {
-    QStringLiteral (R"((?:^|[\r\n])\s*[0-9.]+\s+\S+\s+\d{2}-[A-Za-z]{3}-\d{4}\s+[0-9]{4}Z)")
-  };
-  return snapshotLineRe.match (QString::fromUtf8 (buffer)).hasMatch ();
-}
-
-void append_cluster_payload (QTcpSocket * socket, QByteArray * telnet_pending, QByteArray * buffer, QByteArray raw)
-{
-  if (!socket || !buffer) return;
-
-  if (telnet_pending && !telnet_pending->isEmpty ())
-    {
-      raw.prepend (*telnet_pending);
-      telnet_pending->clear ();
-    }
-
-  for (int i = 0; i < raw.size ();)
-    {
-      auto const byte = static_cast<unsigned char> (raw.at (i));
-      if (byte != 0xFF)
-        {
-          buffer->append (raw.at (i));
-          ++i;
-          continue;
-        }
-
-      if (i + 1 >= raw.size ())
-        {
-          if (telnet_pending) *telnet_pending = raw.mid (i);
-          break;
-        }
-
-      auto const cmd = static_cast<unsigned char> (raw.at (i + 1));
-      if (cmd == 0xFF)
-        {
-          buffer->append (char (0xFF));
-          i += 2;
-          continue;
-        }
-
-      if (cmd == 0xFA)
-        {
-          int end = -1;
-          for (int j = i + 2; j + 1 < raw.size (); ++j)
-            {
-              if (static_cast<unsigned char> (raw.at (j)) == 0xFF
-                  && static_cast<unsigned char> (raw.at (j + 1)) == 0xF0)
-                {
-                  end = j + 2;
-                  break;
-                }
-            }
-          if (end < 0)
-            {
-              if (telnet_pending) *telnet_pending = raw.mid (i);
-              break;
-            }
-          i = end;
-          continue;
-        }
-
-      if (cmd >= 0xFB && cmd <= 0xFE)
-        {
-          if (i + 2 >= raw.size ())
-            {
-              if (telnet_pending) *telnet_pending = raw.mid (i);
-              break;
-            }
-
-          auto const opt = static_cast<unsigned char> (raw.at (i + 2));
-          char reply[3] = {char (0xFF), 0, char (opt)};
-          bool const accepted = (opt == 1 || opt == 3);
-
-          if (cmd == 0xFB)
-            {
-              reply[1] = accepted ? char (0xFD) : char (0xFE);
-            }
-          else if (cmd == 0xFD)
-            {
-              reply[1] = accepted ? char (0xFB) : char (0xFC);
-            }
-          else
-            {
-              i += 3;
-              continue;
-            }
-
-          socket->write (reply, 3);
-          socket->flush ();
-          i += 3;
-          continue;
-        }
-
-      i += 2;
-    }
-}
-
-bool wait_for_cluster_condition (QTcpSocket * socket, QByteArray * buffer, QByteArray * telnet_pending, int total_ms,
-                                 std::function<bool (QByteArray const&)> const& done)
-{
-  if (!socket || !buffer || !done) return false;
-
-  QElapsedTimer totalTimer;
-  totalTimer.start ();
-
-  while (totalTimer.elapsed () < total_ms)
-    {
-      auto const remaining = qMax (0, total_ms - int (totalTimer.elapsed ()));
-      if (socket->bytesAvailable () > 0 || socket->waitForReadyRead (qMin (250, remaining)))
-        {
-          append_cluster_payload (socket, telnet_pending, buffer, socket->readAll ());
-          if (done (*buffer))
-            {
-              return true;
-            }
-          continue;
-        }
-      if (done (*buffer))
-        {
-          return true;
-        }
-    }
-
-  if (socket->bytesAvailable () > 0)
-    {
-      append_cluster_payload (socket, telnet_pending, buffer, socket->readAll ());
-    }
-  return done (*buffer);
-}
-
-bool wait_for_cluster_quiet (QTcpSocket * socket, QByteArray * buffer, QByteArray * telnet_pending, int total_ms, int idle_ms)
-{
-  if (!socket || !buffer) return false;
-
-  QElapsedTimer totalTimer;
-  QElapsedTimer idleTimer;
-  totalTimer.start ();
-  idleTimer.start ();
-
-  while (totalTimer.elapsed () < total_ms)
-    {
-      if (socket->bytesAvailable () > 0 || socket->waitForReadyRead (qMin (250, total_ms - int (totalTimer.elapsed ()))))
-        {
-          append_cluster_payload (socket, telnet_pending, buffer, socket->readAll ());
-          idleTimer.restart ();
-          continue;
-        }
-      if (!buffer->isEmpty () && idleTimer.elapsed () >= idle_ms)
-        {
-          return true;
-        }
-    }
-
-  if (socket->bytesAvailable () > 0)
-    {
-      append_cluster_payload (socket, telnet_pending, buffer, socket->readAll ());
-    }
-  return !buffer->isEmpty ();
-}
-
-QByteArray fetch_cluster_snapshot (QSettings * settings, QString const& activeMyCall, QString const& band, QString * error)
-{
-  auto const host = configured_cluster_host (settings).trimmed ();
-  auto const port = configured_cluster_port (settings);
-  auto const login = configured_cluster_login (settings, activeMyCall);
-  if (host.isEmpty ())
-    {
-      if (error) *error = QObject::tr ("empty cluster host");
-      return {};
-    }
-  if (login.isEmpty ())
-    {
-      if (error) *error = QObject::tr ("empty MyCall setting");
-      return {};
-    }
-
-  QTcpSocket socket;
-  socket.connectToHost (host, static_cast<quint16> (port));
-  if (!socket.waitForConnected (4000))
-    {
-      if (error) *error = socket.errorString ();
-      return {};
-    }
-
-  QByteArray buffer;
-  QByteArray telnet_pending;
-  wait_for_cluster_condition (&socket, &buffer, &telnet_pending, 2500, contains_cluster_prompt);
-
-  socket.write ((login + QStringLiteral ("\r\n")).toUtf8 ());
-  socket.flush ();
-  buffer.clear ();
-  if (!wait_for_cluster_condition (&socket, &buffer, &telnet_pending, 3500, contains_cluster_prompt))
-    {
-      if (error) *error = QObject::tr ("cluster login prompt not received");
-      socket.abort ();
-      return {};
-    }
-
-  socket.write (QByteArrayLiteral ("set/page 0\r\n"));
-  socket.flush ();
-  buffer.clear ();
-  if (!wait_for_cluster_condition (&socket, &buffer, &telnet_pending, 1500, contains_cluster_prompt))
-    {
-      if (error) *error = QObject::tr ("cluster page setup failed");
-      socket.abort ();
-      return {};
-    }
-
-  socket.write (QByteArrayLiteral ("unset/dx\r\n"));
-  socket.flush ();
-  buffer.clear ();
-  if (!wait_for_cluster_condition (&socket, &buffer, &telnet_pending, 1500, contains_cluster_prompt))
-    {
-      if (error) *error = QObject::tr ("cluster quiet mode setup failed");
-      socket.abort ();
-      return {};
-    }
-
-  buffer.clear ();
-  socket.write (QStringLiteral ("show/dx %1 on %2 real\r\n")
-                  .arg (QString::number (kMaxSpots), spider_band_argument (band)).toUtf8 ());
-  socket.flush ();
-  wait_for_cluster_condition (&socket, &buffer, &telnet_pending, 4500,
-                              [] (QByteArray const& data)
-                              {
-                                return contains_cluster_spot_payload (data)
-                                    || contains_cluster_error_payload (data);
-                              });
-  wait_for_cluster_quiet (&socket, &buffer, &telnet_pending, 2500, 900);
-  if (!contains_cluster_spot_payload (buffer) && error && error->isEmpty ())
-    {
-      *error = QObject::tr ("cluster returned no data");
-    }
-
-  socket.write (QByteArrayLiteral ("bye\r\n"));
-  socket.flush ();
-  socket.disconnectFromHost ();
-  socket.waitForDisconnected (500);
-
-  if (buffer.size () > kMaxDxClusterReplyBytes)
-    {
-      buffer = buffer.left (kMaxDxClusterReplyBytes);
-    }
-  return buffer;
-}
-
-QString band_from_frequency_khz (QString const& frequencyText)
-{
-  bool ok {false};
-  auto const khz = frequencyText.trimmed ().toDouble (&ok);
-  if (!ok || khz <= 0.0)
-    {
-      return {};
-    }
-
-  if (khz >= 1800.0 && khz <= 2000.0) return QStringLiteral ("160M");
-  if (khz >= 3500.0 && khz <= 4000.0) return QStringLiteral ("80M");
-  if (khz >= 5300.0 && khz <= 5407.0) return QStringLiteral ("60M");
-  if (khz >= 7000.0 && khz <= 7300.0) return QStringLiteral ("40M");
-  if (khz >= 10100.0 && khz <= 10150.0) return QStringLiteral ("30M");
-  if (khz >= 14000.0 && khz <= 14350.0) return QStringLiteral ("20M");
-  if (khz >= 18068.0 && khz <= 18168.0) return QStringLiteral ("17M");
-  if (khz >= 21000.0 && khz <= 21450.0) return QStringLiteral ("15M");
-  if (khz >= 24890.0 && khz <= 24990.0) return QStringLiteral ("12M");
-  if (khz >= 28000.0 && khz <= 29700.0) return QStringLiteral ("10M");
-  if (khz >= 50000.0 && khz <= 54000.0) return QStringLiteral ("6M");
-  if (khz >= 70000.0 && khz <= 71000.0) return QStringLiteral ("4M");
-  if (khz >= 144000.0 && khz <= 148000.0) return QStringLiteral ("2M");
-  if (khz >= 420000.0 && khz <= 450000.0) return QStringLiteral ("70CM");
-  return {};
-}
+public:
+  explicit DXClusterSpotFilter(QObject * parent)
+    : QSortFilterProxyModel {parent}
+  {
+    setSortRole(Qt::UserRole);
+    setDynamicSortFilter(true);
+  }
 
-QByteArray read_reply_payload_limited (QNetworkReply * reply, qint64 max_bytes, QString * error = nullptr)
-{
-  if (!reply)
-    {
-      if (error) *error = QObject::tr ("empty reply");
-      return {};
-    }
+  void setBand(QString const& band)
+  {
+    if (band != band_)
+      {
+        band_ = band;
+        invalidateFilter();
+      }
+  }
 
-  auto const length_header = reply->header (QNetworkRequest::ContentLengthHeader);
-  if (length_header.isValid () && length_header.toLongLong () > max_bytes)
-    {
-      if (error) *error = QObject::tr ("reply too large");
-      return {};
-    }
+  void setMode(QString const& mode)
+  {
+    auto m = mode.trimmed().toUpper();
+    if (m == "ALL") m.clear();
+    if (m != mode_)
+      {
+        mode_ = m;
+        invalidateFilter();
+      }
+  }
 
-  auto const payload = reply->read (max_bytes + 1);
-  if (payload.size () > max_bytes || !reply->atEnd ())
-    {
-      if (error) *error = QObject::tr ("reply exceeds limit");
-      return {};
-    }
+protected:
+  bool filterAcceptsRow(int source_row, QModelIndex const& source_parent) const override
+  {
+    auto const index = sourceModel()->index(source_row, 0, source_parent);
+    auto const band = index.data(DXClusterSpotModel::BandRole).toString();
+    if (!band_.isEmpty() && !band.isEmpty() && band != band_)
+      {
+        return false;
+      }
+    return mode_.isEmpty()
+      || index.data(DXClusterSpotModel::ModeRole).toString().toUpper() == mode_;
+  }
 
-  return payload;
-}
-}
+private:
+  QString band_;
+  QString mode_;
+};
 
 DXClusterWindow::DXClusterWindow(QSettings * settings, QWidget * parent)
   : QDialog {parent}
   , settings_ {settings}
-  , network_ {new QNetworkAccessManager {this}}
+  , model_ {new DXClusterSpotModel {this}}
+  , filter_ {new DXClusterSpotFilter {this}}
+  , client_ {new DXClusterClient}
 {
   setWindowTitle(QApplication::applicationName() + " - " + tr("DX Cluster"));
   setWindowFlags(Qt::Dialog | Qt::WindowCloseButtonHint | Qt::WindowMinMaxButtonsHint);
@@ -517,19 +235,11 @@ DXClusterWindow::DXClusterWindow(QSettings * settings, QWidget * parent)
   controlsRow->addStretch(1);
   root->addLayout(controlsRow);
 
-  table_ = new QTableWidget {this};
-  table_->setColumnCount(10);
-  table_->setHorizontalHeaderLabels(QStringList {}
-                                    << tr("UTC")
-                                    << tr("Freq (kHz)")
-                                    << tr("DX Call")
-                                    << tr("Spotter")
-                                    << tr("Mode")
-                                    << tr("Comment")
-                                    << tr("Cont")
-                                    << tr("Country")
-                                    << tr("LoTW")
-                                    << tr("eQSL"));
+  filter_->setSourceModel(model_);
+  table_ = new QTableView {this};
+  table_->setModel(filter_);
+  table_->setSortingEnabled(true);
+  table_->sortByColumn(DXClusterSpotModel::utc, Qt::DescendingOrder);
   table_->setSelectionBehavior(QAbstractItemView::SelectRows);
   table_->setSelectionMode(QAbstractItemView::SingleSelection);
   table_->setEditTriggers(QAbstractItemView::NoEditTriggers);
@@ -547,7 +257,7 @@ DXClusterWindow::DXClusterWindow(QSettings * settings, QWidget * parent)
   applyDefaultColumnWidths();
   root->addWidget(table_, 1);
 
-  statusLabel_ = new QLabel {tr("Waiting for first update..."), this};
+  statusLabel_ = new QLabel {tr("Not connected"), this};
   statusLabel_->setTextInteractionFlags(Qt::TextSelectableByMouse);
   root->addWidget(statusLabel_);
 
@@ -558,11 +268,28 @@ DXClusterWindow::DXClusterWindow(QSettings * settings, QWidget * parent)
   connect(bandFilter_, SIGNAL(currentIndexChanged(int)), this, SLOT(onBandFilterChanged(int)));
   connect(followAppBandCheck_, &QCheckBox::toggled, this, &DXClusterWindow::onFollowAppBandChanged);
   connect(modeFilter_, SIGNAL(currentIndexChanged(int)), this, SLOT(onModeFilterChanged(int)));
-  connect(network_, &QNetworkAccessManager::finished, this, &DXClusterWindow::onNetworkFinished);
-  connect(&refreshTimer_, &QTimer::timeout, this, &DXClusterWindow::refreshNow);
 
-  refreshTimer_.setInterval(kRefreshMs);
-  refreshTimer_.start();
+  // the cluster session runs on its own thread so that nothing the
+  // node does, or does not do, can stall the GUI
+  clientThread_.setObjectName("DX cluster");
+  client_->moveToThread(&clientThread_);
+  connect(&clientThread_, &QThread::finished, client_, &QObject::deleteLater);
+  connect(client_, &DXClusterClient::spotsReceived, model_, &DXClusterSpotModel::addSpots);
+  connect(client_, &DXClusterClient::statusChanged, this, [this] (QString const& status, bool error) {
+      connectionStatus_ = status;
+      connectionError_ = error;
+      updateStatus();
+    });
+  connect(filter_, &QAbstractItemModel::rowsInserted, this, &DXClusterWindow::updateStatus);
+  connect(filter_, &QAbstractItemModel::rowsRemoved, this, &DXClusterWindow::updateStatus);
+  connect(filter_, &QAbstractItemModel::modelReset, this, &DXClusterWindow::updateStatus);
+  clientThread_.start();
+
+  connect(&expiryTimer_, &QTimer::timeout, this, [this] {
+      model_->expire(QDateTime::currentDateTimeUtc());
+    });
+  expiryTimer_.setInterval(kExpiryMs);
+  expiryTimer_.start();
 
   read_settings();
   if (width() < 1000 || height() < 620)
@@ -574,6 +301,9 @@ DXClusterWindow::DXClusterWindow(QSettings * settings, QWidget * parent)
 DXClusterWindow::~DXClusterWindow()
 {
   write_settings();
+  QMetaObject::invokeMethod(client_, "stop", Qt::QueuedConnection);
+  clientThread_.quit();
+  clientThread_.wait();
 }
 
 void DXClusterWindow::applyDefaultColumnWidths()
@@ -597,17 +327,36 @@ void DXClusterWindow::applyDefaultColumnWidths()
 
 void DXClusterWindow::setMyCall(QString const& myCall)
 {
-  myCall_ = myCall.trimmed ().toUpper ();
+  auto const call = myCall.trimmed ().toUpper ();
+  if (call != myCall_)
+    {
+      myCall_ = call;
+      if (isVisible())
+        {
+          startClient();
+        }
+    }
 }
 
 void DXClusterWindow::suspendRefresh(int ms)
 {
-  refreshTimer_.stop();
-  if (ms > 0)
+  // another session is about to log in with our call, most nodes
+  // would drop one of them so step aside for a while
+  QMetaObject::invokeMethod(client_, "pause", Qt::QueuedConnection, Q_ARG(int, ms));
+}
+
+void DXClusterWindow::startClient()
+{
+  sourceLabel_->setText (feed_summary_text (settings_));
+  QMetaObject::invokeMethod(client_, "start", Qt::QueuedConnection
+                            , Q_ARG(QString, configured_cluster_host (settings_))
+                            , Q_ARG(int, configured_cluster_port (settings_))
+                            , Q_ARG(QString, configured_cluster_login (settings_, myCall_)));
+  if (!currentBand_.isEmpty())
     {
-      QTimer::singleShot(ms, this, [this] {
-          refreshTimer_.start();
-        });
+      QMetaObject::invokeMethod(client_, "requestSpots", Qt::QueuedConnection
+                                , Q_ARG(QString, spider_band_argument (currentBand_))
+                                , Q_ARG(int, kMaxSpots));
     }
 }
 
@@ -620,12 +369,20 @@ void DXClusterWindow::closeEvent(QCloseEvent * event)
 void DXClusterWindow::showEvent(QShowEvent * event)
 {
   QDialog::showEvent(event);
+  if (!event->spontaneous())
+    {
+      startClient();
+    }
   Q_EMIT windowVisibleChanged(isVisible());
 }
 
 void DXClusterWindow::hideEvent(QHideEvent * event)
 {
   QDialog::hideEvent(event);
+  if (!event->spontaneous())
+    {
+      QMetaObject::invokeMethod(client_, "stop", Qt::QueuedConnection);
+    }
   Q_EMIT windowVisibleChanged(isVisible());
 }
 
@@ -656,188 +413,22 @@ QString DXClusterWindow::normalizeBand(QString const& bandName)
   return b;
 }
 
-QString DXClusterWindow::normalizeMode(QString const& comment)
-{
-  auto c = comment.simplified().toUpper();
-  if (c.contains("FT8")) return "FT8";
-  if (c.contains("FT4")) return "FT4";
-  if (c.contains("FT2")) return "FT2";
-  if (c.contains("Q65")) return "Q65";
-  if (c.contains("FST4")) return "FST4";
-  if (c.contains("JT65")) return "JT65";
-  if (c.contains("JT9")) return "JT9";
-  if (c.contains("MSK144") || c.contains(" MSK")) return "MSK144";
-  if (c.contains("RTTY")) return "RTTY";
-  if (c.contains("PSK")) return "PSK";
-  if (c.contains("CW")) return "CW";
-  if (c.contains("SSB") || c.contains("USB") || c.contains("LSB") || c.contains("PHONE")) return "SSB";
-  if (c.contains(" AM")) return "AM";
-  if (c.contains(" FM")) return "FM";
-  return "Other";
-}
-
-QString DXClusterWindow::yesNoFlag(QString const& flag)
-{
-  auto f = flag.trimmed().toUpper();
-  if (f == "L" || f == "E" || f == "Y" || f == "YES" || f == "1")
-    {
-      return "Yes";
-    }
-  return QString {};
-}
-
-bool DXClusterWindow::matchesModeFilter(Spot const& spot) const
+void DXClusterWindow::updateStatus()
 {
-  if (!modeFilter_)
-    {
-      return true;
-    }
-  auto selected = modeFilter_->currentText().trimmed().toUpper();
-  if (selected.isEmpty() || selected == "ALL")
-    {
-      return true;
-    }
-  return spot.mode.toUpper() == selected;
-}
-
-bool DXClusterWindow::parsePayload(QByteArray const& payload, QVector<Spot> * out, QString * error) const
-{
-  if (!out)
-    {
-      if (error) *error = "Invalid output buffer";
-      return false;
-    }
-
-  QVector<Spot> parsed;
-  auto const nowUtc = QDateTime::currentDateTimeUtc ();
-  auto const realTimeRe = QRegularExpression {
-    QStringLiteral (R"(^DX de\s+([^:]+):\s+([0-9.]+)\s+(\S+)\s*(.*?)\s+([0-9]{4})Z\s*$)")
-  };
-  auto const snapshotRe = QRegularExpression {
-    QStringLiteral (R"(^\s*([0-9.]+)\s+(\S+)\s+(\d{2}-[A-Za-z]{3}-\d{4})\s+([0-9]{4})Z\s*(.*?)\s+<([^>]+)>\s*$)")
-  };
-  QString text = QString::fromUtf8(payload);
-  auto lines = text.split(QRegularExpression {"[\\r\\n]+"}, Qt::SkipEmptyParts);
-  for (auto const& rawLine : lines)
-    {
-      auto line = rawLine.trimmed();
-      if (line.isEmpty())
-        {
-          continue;
-        }
-      if (line.startsWith("<") || line.startsWith("ERROR", Qt::CaseInsensitive))
-        {
-          continue;
-        }
-
-      Spot spot;
-      auto match = realTimeRe.match (line);
-      if (match.hasMatch ())
-        {
-          auto const hhmm = match.captured (5);
-          auto dt = QDateTime (nowUtc.date (),
-                               QTime::fromString (hhmm, QStringLiteral ("hhmm")),
-                               Qt::UTC);
-          if (dt.isValid () && dt > nowUtc.addSecs (300))
-            {
-              dt = dt.addDays (-1);
-            }
-          spot.spotter = match.captured (1).trimmed();
-          spot.frequency = match.captured (2).trimmed();
-          spot.dxCall = match.captured (3).trimmed();
-          spot.comment = match.captured (4).trimmed();
-          spot.dateTime = dt.isValid () ? dt.toString (QStringLiteral ("yyyy-MM-dd HH:mm")) : hhmm;
-          spot.band = band_from_frequency_khz (spot.frequency);
-          spot.mode = normalizeMode (spot.comment);
-          if (!currentBand_.isEmpty () && spot.band != currentBand_)
-            {
-              continue;
-            }
-          parsed.push_back (spot);
-          continue;
-        }
-
-      match = snapshotRe.match (line);
-      if (match.hasMatch ())
-        {
-          auto const date = QLocale::c ().toDate (match.captured (3), QStringLiteral ("dd-MMM-yyyy"));
-          auto const time = QTime::fromString (match.captured (4), QStringLiteral ("hhmm"));
-          auto dt = QDateTime (date, time, Qt::UTC);
-          spot.frequency = match.captured (1).trimmed();
-          spot.dxCall = match.captured (2).trimmed();
-          spot.dateTime = dt.isValid () ? dt.toString (QStringLiteral ("yyyy-MM-dd HH:mm")) : line;
-          spot.comment = match.captured (5).trimmed();
-          spot.spotter = match.captured (6).trimmed();
-          spot.band = band_from_frequency_khz (spot.frequency);
-          spot.mode = normalizeMode (spot.comment);
-          if (!currentBand_.isEmpty () && spot.band != currentBand_)
-            {
-              continue;
-            }
-          parsed.push_back (spot);
-        }
-    }
-
-  if (parsed.isEmpty())
-    {
-      if (error) *error = "No spots returned by source";
-      return false;
-    }
-
-  *out = parsed;
-  return true;
-}
-
-void DXClusterWindow::rebuildTable()
-{
-  if (!table_)
+  if (currentBand_.isEmpty())
     {
       return;
     }
-
-  table_->setSortingEnabled(false);
-  table_->setRowCount(0);
-
-  for (auto const& spot : spots_)
+  QString status = tr("%1 | Spots: %2 | Band: %3 | Node: %4")
+    .arg(connectionStatus_.isEmpty() ? tr("Not connected") : connectionStatus_)
+    .arg(filter_->rowCount())
+    .arg(currentBand_)
+    .arg(configured_cluster_endpoint (settings_));
+  if (modeFilter_)
     {
-      if (!currentBand_.isEmpty () && !spot.band.isEmpty () && spot.band != currentBand_)
-        {
-          continue;
-        }
-      if (!matchesModeFilter(spot))
-        {
-          continue;
-        }
-
-      int row = table_->rowCount();
-      table_->insertRow(row);
-
-      auto * dateItem = new QTableWidgetItem {spot.dateTime};
-      auto * freqItem = new QTableWidgetItem {spot.frequency};
-      auto * dxItem = new QTableWidgetItem {spot.dxCall};
-      auto * spotterItem = new QTableWidgetItem {spot.spotter};
-      auto * modeItem = new QTableWidgetItem {spot.mode};
-      auto * commentItem = new QTableWidgetItem {spot.comment};
-      auto * contItem = new QTableWidgetItem {spot.continent};
-      auto * countryItem = new QTableWidgetItem {spot.country};
-      auto * lotwItem = new QTableWidgetItem {yesNoFlag(spot.lotw)};
-      auto * eqslItem = new QTableWidgetItem {yesNoFlag(spot.eqsl)};
-
-      QFont dxFont = dxItem->font();
-      dxFont.setBold(true);
-      dxItem->setFont(dxFont);
-
-      table_->setItem(row, 0, dateItem);
-      table_->setItem(row, 1, freqItem);
-      table_->setItem(row, 2, dxItem);
-      table_->setItem(row, 3, spotterItem);
-      table_->setItem(row, 4, modeItem);
-      table_->setItem(row, 5, commentItem);
-      table_->setItem(row, 6, contItem);
-      table_->setItem(row, 7, countryItem);
-      table_->setItem(row, 8, lotwItem);
-      table_->setItem(row, 9, eqslItem);
+      status += tr(" | Mode: %1").arg(modeFilter_->currentText());
     }
+  setStatus(status, connectionError_);
 }
 
 void DXClusterWindow::applyBand(QString const& bandName, bool refresh)
@@ -848,8 +439,7 @@ void DXClusterWindow::applyBand(QString const& bandName, bool refresh)
       currentBand_.clear();
       bandLabel_->setText(tr("Band: -"));
       titleLabel_->setText(tr("DX Cluster Spots"));
-      spots_.clear();
-      rebuildTable();
+      filter_->setBand(QStringLiteral ("-"));  // matches nothing
       setStatus(tr("DX cluster disabled: out of band"), true);
       return;
     }
@@ -869,23 +459,16 @@ void DXClusterWindow::applyBand(QString const& bandName, bool refresh)
         }
     }
 
-  if (currentBand_ == normalized && !spots_.isEmpty())
-    {
-      if (refresh)
-        {
-          refreshNow();
-        }
-      return;
-    }
-
+  bool const changed = currentBand_ != normalized;
   currentBand_ = normalized;
   bandLabel_->setText(tr("Band: %1").arg(currentBand_));
   titleLabel_->setText(tr("DX Cluster Spots - %1").arg(currentBand_));
 
-  spots_.clear();
-  rebuildTable();
-  setStatus(tr("Band changed to %1: refreshing...").arg(currentBand_));
-  if (refresh)
+  // spots already held for the new band show at once, the backfill
+  // fills in whatever arrived while we were elsewhere
+  filter_->setBand(currentBand_);
+  updateStatus();
+  if (refresh && (changed || !filter_->rowCount()))
     {
       refreshNow();
     }
@@ -937,127 +520,21 @@ void DXClusterWindow::onFollowAppBandChanged(bool checked)
 
 void DXClusterWindow::refreshNow()
 {
-  if (requestInFlight_)
-    {
-      return;
-    }
   if (currentBand_.isEmpty())
     {
       setStatus(tr("No active band selected"), true);
       return;
     }
-
-  requestInFlight_ = true;
-  refreshButton_->setEnabled(false);
-  sourceLabel_->setText (feed_summary_text (settings_));
-  setStatus(tr("Updating %1 ...").arg(configured_cluster_endpoint (settings_)));
-
-  QString fetchError;
-  auto payload = fetch_cluster_snapshot (settings_, myCall_, currentBand_, &fetchError);
-
-  requestInFlight_ = false;
-  refreshButton_->setEnabled(true);
-
-  if (!fetchError.isEmpty() && payload.isEmpty())
-    {
-      setStatus(tr("Update failed: %1").arg(fetchError), true);
-      return;
-    }
-
-  QVector<Spot> parsed;
-  QString parseError;
-  if (!parsePayload(payload, &parsed, &parseError))
-    {
-      setStatus(tr("Update failed: %1").arg(parseError), true);
-      return;
-    }
-
-  spots_ = parsed;
-  rebuildTable();
-
-  int shown = table_ ? table_->rowCount() : 0;
-  QString status = tr("Updated: %1 UTC | Spots: %2 | Band: %3 | Node: %4")
-                   .arg(QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd HH:mm:ss"))
-                   .arg(shown)
-                   .arg(currentBand_)
-                   .arg(configured_cluster_endpoint (settings_));
-  if (modeFilter_)
-    {
-      status += tr(" | Mode: %1").arg(modeFilter_->currentText());
-    }
-  setStatus(status);
-}
-
-void DXClusterWindow::onNetworkFinished(QNetworkReply * reply)
-{
-  if (!reply)
-    {
-      setStatus(tr("Update failed: empty network reply"), true);
-      return;
-  }
-
-  auto replyBand = reply->property("band").toString();
-  auto err = reply->error();
-  auto errText = reply->errorString();
-  QString payloadError;
-  auto payload = (err == QNetworkReply::NoError)
-      ? read_reply_payload_limited(reply, kMaxDxClusterReplyBytes, &payloadError)
-      : QByteArray {};
-  reply->deleteLater();
-
-  requestInFlight_ = false;
-  refreshButton_->setEnabled(true);
-
-  if (!replyBand.isEmpty() && replyBand != currentBand_)
-    {
-      return;
-    }
-
-  if (err != QNetworkReply::NoError)
+  if (isVisible())
     {
-      setStatus(tr("Update failed: %1").arg(errText), true);
-      return;
+      startClient();
     }
-  if (!payloadError.isEmpty())
-    {
-      setStatus(tr("Update failed: %1").arg(payloadError), true);
-      return;
-    }
-
-  QVector<Spot> parsed;
-  QString parseError;
-  if (!parsePayload(payload, &parsed, &parseError))
-    {
-      setStatus(tr("Update failed: %1").arg(parseError), true);
-      return;
-    }
-
-  spots_ = parsed;
-  rebuildTable();
-
-  int shown = table_ ? table_->rowCount() : 0;
-  QString status = tr("Updated: %1 UTC | Spots: %2 | Band: %3")
-                   .arg(QDateTime::currentDateTimeUtc().toString("yyyy-MM-dd HH:mm:ss"))
-                   .arg(shown)
-                   .arg(currentBand_);
-  if (modeFilter_)
-    {
-      status += tr(" | Mode: %1").arg(modeFilter_->currentText());
-    }
-  setStatus(status);
 }
 
 void DXClusterWindow::onModeFilterChanged(int)
 {
-  rebuildTable();
-  if (!currentBand_.isEmpty())
-    {
-      int shown = table_ ? table_->rowCount() : 0;
-      setStatus(tr("Filter applied: %1 | Spots: %2 | Band: %3")
-                .arg(modeFilter_->currentText())
-                .arg(shown)
-                .arg(currentBand_));
-    }
+  filter_->setMode(modeFilter_->currentText());
+  updateStatus();
 }
 
 void DXClusterWindow::read_settings()
@@ -3,20 +3,21 @@
 #define DXCLUSTERWINDOW_H
 
 #include <QDialog>
+#include <QThread>
 #include <QTimer>
-#include <QVector>
 
 class QCloseEvent;
 class QComboBox;
 class QCheckBox;
 class QLabel;
-class QNetworkAccessManager;
-class QNetworkReply;
 class QPushButton;
 class QSettings;
-class QTableWidget;
+class QTableView;
 class QShowEvent;
 class QHideEvent;
+class DXClusterClient;
+class DXClusterSpotModel;
+class DXClusterSpotFilter;
 
 class DXClusterWindow final : public QDialog
 {
@@ -40,35 +41,15 @@ protected:
 
 private Q_SLOTS:
   void refreshNow();
-  void onNetworkFinished(QNetworkReply * reply);
   void onBandFilterChanged(int);
   void onFollowAppBandChanged(bool checked);
   void onModeFilterChanged(int);
 
 private:
-  struct Spot
-  {
-    QString spotter;
-    QString frequency;
-    QString dxCall;
-    QString comment;
-    QString dateTime;
-    QString lotw;
-    QString eqsl;
-    QString continent;
-    QString band;
-    QString country;
-    QString adif;
-    QString mode;
-  };
-
   static QString normalizeBand(QString const& bandName);
-  static QString normalizeMode(QString const& comment);
-  static QString yesNoFlag(QString const& flag);
   void applyBand(QString const& bandName, bool refresh);
-  bool matchesModeFilter(Spot const& spot) const;
-  void rebuildTable();
-  bool parsePayload(QByteArray const& payload, QVector<Spot> * out, QString * error) const;
+  void startClient();
+  void updateStatus();
   void setStatus(QString const& status, bool error = false);
   void read_settings();
   void write_settings();
@@ -82,15 +63,18 @@ private:
   QComboBox * bandFilter_ {nullptr};
   QComboBox * modeFilter_ {nullptr};
   QPushButton * refreshButton_ {nullptr};
-  QTableWidget * table_ {nullptr};
+  QTableView * table_ {nullptr};
   QLabel * statusLabel_ {nullptr};
-  QTimer refreshTimer_;
-  QNetworkAccessManager * network_ {nullptr};
-  bool requestInFlight_ {false};
+  DXClusterSpotModel * model_ {nullptr};
+  DXClusterSpotFilter * filter_ {nullptr};
+  QThread clientThread_;
+  DXClusterClient * client_ {nullptr};  // lives on clientThread_
+  QTimer expiryTimer_;
+  QString connectionStatus_;
+  bool connectionError_ {false};
   QString appBand_;
   QString currentBand_;
   QString myCall_;
-  QVector<Spot> spots_;
 };
 
 #endif // DXCLUSTERWINDOW_H
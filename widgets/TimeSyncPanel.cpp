@@ -144,6 +144,22 @@ void TimeSyncPanel::updateSoundcardDrift(double driftMsPerPeriod, double driftPp
   (void)driftPpm;
 }
 
+void TimeSyncPanel::updateCaptureClock(double jitterMs, bool locked)
+{
+  // RMS scatter of audio block arrivals about the sample clock fit
+  ui->lblCaptureJitter->setText(QString("%1 ms%2")
+    .arg(jitterMs, 0, 'f', 1)
+    .arg(locked ? "" : " (acquiring)"));
+  if (!locked)
+    ui->lblCaptureJitter->setStyleSheet("color:#888;");
+  else if (jitterMs < 10.0)
+    ui->lblCaptureJitter->setStyleSheet("color:#00ff00;");
+  else if (jitterMs < 50.0)
+    ui->lblCaptureJitter->setStyleSheet("color:#ffff00;");
+  else
+    ui->lblCaptureJitter->setStyleSheet("color:#ff4444;");
+}
+
 void TimeSyncPanel::updateDecodeTiming(QVector<double> const& dtSamples,
                                         double avgDt,
                                         double dtCorrectionMs,
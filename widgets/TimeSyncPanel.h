@@ -25,6 +25,7 @@ public:
   void updateNtpOffset(double offsetMs, int serverCount);
   void updateNtpSyncStatus(bool synced, QString const& statusText);
   void updateSoundcardDrift(double driftMsPerPeriod, double driftPpm);
+  void updateCaptureClock(double jitterMs, bool locked);
   void updateDecodeTiming(QVector<double> const& dtSamples,
                           double avgDt,
                           double dtCorrectionMs,
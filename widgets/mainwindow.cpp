@@ -109,8 +109,11 @@
 #include "colorhighlighting.h"
 #include "widegraph.h"
 #include "sleep.h"
+#include "lib/hashcalls.h"
 #include "logqso.h"
 #include "Decoder/decodedtext.h"
+#include "Decoder/DecodeEventBus.hpp"
+#include "Decoder/DecodeArchive.hpp"
 #include "Radio.hpp"
 #include "models/Bands.hpp"
 #include "Transceiver/TransceiverFactory.hpp"
@@ -124,6 +127,8 @@
 #include "HelpTextWindow.hpp"
 #include "SampleDownloader.hpp"
 #include "Audio/BWFFile.hpp"
+#include "Audio/AudioSnapshotWriter.hpp"
+#include "Audio/Equalizer.hpp"
 #include "MultiSettings.hpp"
 #include "validators/MaidenheadLocatorValidator.hpp"
 #include "validators/CallsignValidator.hpp"
@@ -366,7 +371,7 @@ QList<FoxVerifier *> m_verifications;
 int itone[MAX_NUM_SYMBOLS];   //Audio tones for all Tx symbols
 int itone0[MAX_NUM_SYMBOLS];  //Dummy array, data not actually used
 int icw[NUM_CW_SYMBOLS];      //Dits for CW ID
-dec_data_t dec_data;                   //For sharing with Fortran
+dec_data_t * dec_data {nullptr};       //The jt9 shared memory segment, for sharing with Fortran
 int outBufSize;
 int rc;
 qint32  g_iptt {0};
@@ -903,7 +908,10 @@ namespace
   // In AutoCQ, keep RR73/73 on air up to 5 cycles before forced close.
   constexpr int kAutoCqSignoffRetryCount {5};
   constexpr int kLateAutoLogGraceWindowSeconds {45};
-  constexpr int kDecDataSampleCount {static_cast<int> (sizeof (dec_data.d2) / sizeof (dec_data.d2[0]))};
+  // MSK144 audio reaches hspec() in blocks of this many samples, 75 ms,
+  // so pings are decoded as they arrive
+  constexpr int kMsk144BlockSize {7 * 128};
+  constexpr int kDecDataSampleCount {static_cast<int> (sizeof (dec_data->d2) / sizeof (dec_data->d2[0]))};
   constexpr int kMaxCwSymbols {static_cast<int> (sizeof (icw) / sizeof (icw[0]))};
   constexpr int kFoxWaveSampleCount {static_cast<int> (sizeof (foxcom_.wave) / sizeof (foxcom_.wave[0]))};
 
@@ -1563,6 +1571,7 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   m_bRefSpec {false},
   m_bClearRefSpec {false},
   m_bTrain {false},
+  m_bUseRef {false},
   m_bAutoReply {false},
   m_lastloggedcall {""},
   m_incrLogCount {0},     //avt 9/23/25
@@ -1901,7 +1910,15 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
 
   // hook up the detector signals, slots and disposal
   connect (this, &MainWindow::FFTSize, m_detector, &Detector::setBlockSize);
+  connect (this, &MainWindow::equalizerChanged, m_detector, &Detector::setEqualizer);
+  updateEqualizer ();
   connect(m_detector, &Detector::framesWritten, this, &MainWindow::dataSink);
+  connect (m_detector, &Detector::clockStatistics, this, [this] (double drift_ppm, double jitter_ms, bool locked) {
+      if (locked) onSoundcardDriftUpdated (drift_ppm * 1e-6 * 1000. * m_TRperiod, drift_ppm);
+      m_captureJitterMs = jitter_ms;
+      m_captureClockLocked = locked;
+      if (m_timeSyncPanel) m_timeSyncPanel->updateCaptureClock (jitter_ms, locked);
+    });
   connect (&m_audioThread, &QThread::finished, m_detector, &QObject::deleteLater);
 
   // setup the waterfall
@@ -2425,6 +2442,53 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
       }
   }
 
+  // Decodes are published on the decode event bus by postDecode(). The
+  // UDP and remote clients subscribe here; JSON lines sinks are optional:
+  //   WSJT_DECODE_EVENTS_FILE    file, relative to the data directory
+  //   WSJT_DECODE_EVENTS_SOCKET  local socket / named pipe name
+  //   WSJT_DECODE_EVENTS_PORT    TCP port on localhost
+  m_decodeBus = new DecodeEventBus {this};
+  m_decodeBus->subscribe ([this] (DecodeEvent const& event) {
+      if (!is_externalCtrlMode () || event.standard)    //avt
+        {
+          m_messageClient->decode (event.is_new, event.time, event.snr, event.dt, event.frequency
+                                   , event.marker, event.message, event.low_confidence, event.off_air);
+        }
+      if (event.is_new && m_remoteCommandServer)
+        {
+          m_remoteCommandServer->publishBandActivityLine (event.line);
+        }
+    });
+  {
+    auto const eventsFile = m_env.value ("WSJT_DECODE_EVENTS_FILE").trimmed ();
+    if (!eventsFile.isEmpty ())
+      {
+        m_decodeBus->add_sink (new JsonLinesFileSink {m_config.writeable_data_dir ().absoluteFilePath (eventsFile)});
+      }
+    auto const eventsSocket = m_env.value ("WSJT_DECODE_EVENTS_SOCKET").trimmed ();
+    bool portOk {false};
+    auto eventsPort = m_env.value ("WSJT_DECODE_EVENTS_PORT").trimmed ().toUInt (&portOk);
+    if (!portOk || eventsPort > 65535u) eventsPort = 0;
+    if (!eventsSocket.isEmpty () || eventsPort)
+      {
+        m_decodeBus->add_sink (new DecodeStreamSink {eventsSocket, static_cast<quint16> (eventsPort)});
+      }
+  }
+
+  // Decodes are archived by day for history queries, set
+  // WSJT_DECODE_ARCHIVE=0 to stop archiving
+  {
+    DecodeArchive decodeArchive {m_config.writeable_data_dir ().absoluteFilePath ("decode_archive")};
+    if (m_env.value ("WSJT_DECODE_ARCHIVE", "1").trimmed () != "0")
+      {
+        m_decodeBus->add_sink (new DecodeArchiveSink {decodeArchive.directory ()});
+      }
+    if (m_remoteCommandServer)
+      {
+        m_remoteCommandServer->setDecodeArchive (decodeArchive);
+      }
+  }
+
   // Hook up WSPR band hopping
   connect (ui->band_hopping_schedule_push_button, &QPushButton::clicked
            , &m_WSPR_band_hopping, &WSPRBandHopping::show_dialog);
@@ -2647,15 +2711,11 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
               }
           });
 
-  // hook up save WAV file exit handling
-  connect (&m_saveWAVWatcher, &QFutureWatcher<QString>::finished, [this] {
-      // extract the promise from the future
-      auto const& result = m_saveWAVWatcher.future ().result ();
-      if (!result.isEmpty ())   // error
-        {
-          MessageBox::critical_message (this, tr("Error Writing WAV File"), result);
-        }
-    });
+  // hook up saved audio error handling
+  m_snapshotWriter = new AudioSnapshotWriter {8, this};
+  connect (m_snapshotWriter, &AudioSnapshotWriter::error, this, [this] (QString const& message) {
+      MessageBox::critical_message (this, tr("Error Writing Audio File"), message);
+    }, Qt::QueuedConnection);
 
   // Hook up working frequencies.
   ui->bandComboBox->setModel (m_config.frequencies ());
@@ -2882,9 +2942,7 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   connect (&m_wav_future_watcher, &QFutureWatcher<void>::finished, this, &MainWindow::diskDat);
 
   connect(&watcher3, SIGNAL(finished()),this,SLOT(fast_decode_done()));
-  connect(&m_asyncDecodeWatcher, &QFutureWatcher<void>::finished, this, &MainWindow::asyncDecodeDone);
   std::memset (m_asyncAudio, 0, sizeof (m_asyncAudio));
-  std::memset (m_asyncMsg, 0, sizeof (m_asyncMsg));
 
   // FT2 D-CW: blink TX NOW when a message is preloaded and waiting for manual fire.
   m_txRdyBlinkTimer.setInterval(500);
@@ -2933,7 +2991,19 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
     ui->autoButton->setText("E&nable Tx");
   });
 
+  // ft2_triggered_decode is reentrant in the OpenMP build of the
+  // Fortran library, where its saved tables are threadprivate and the
+  // packjt77 hash tables sit behind a critical section, so overlapping
+  // windows may be decoded at once. Without OpenMP those directives are
+  // ignored and async decodes must run one at a time. Threads are kept
+  // so that four2a's plans, which are keyed by buffer address, are
+  // reused rather than made again for each new thread stack.
+#if defined (_OPENMP)
+  m_asyncDecodeThreadPool.setMaxThreadCount (qBound (1, QThread::idealThreadCount () / 2, 4));
+#else
   m_asyncDecodeThreadPool.setMaxThreadCount (1);
+#endif
+  m_asyncDecodeThreadPool.setExpiryTimeout (-1);
 #if defined(Q_OS_LINUX)
   // Fortran/OpenMP path in async L2 is stack hungry on some Linux distros.
   m_asyncDecodeThreadPool.setStackSize (16 * 1024 * 1024);
@@ -2943,16 +3013,25 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   connect(&m_asyncDecodeTimer, &QTimer::timeout, this, [this]() {
     if (m_mode != "FT2" || !ui->cbAsyncDecode || !ui->cbAsyncDecode->isChecked()) return;
     if (m_transmitting) return;
-    if (m_bAsyncDecoding) return;  // previous decode still running
     if (m_decoderBusy) return;     // avoid overlap with main decoder path
     if (m_asyncAudioPos < 45000) return;  // not enough audio yet
 
+    // Start a decode when a thread is free, spreading concurrent ones
+    // evenly over the 3.75 s window so that each sees different audio
+    int const maxJobs = m_asyncDecodeThreadPool.maxThreadCount ();
+    if (m_asyncJobs.size () >= maxJobs) return;
+    qint64 const nowMs = QDateTime::currentMSecsSinceEpoch ();
+    if (!m_asyncJobs.isEmpty () && nowMs - m_asyncLastLaunchMs < 3750 / maxJobs) return;
+
+    // Each decode gets its own job so nothing is shared with the worker
+    // thread but the job itself
+    auto job = QSharedPointer<AsyncDecodeJob>::create ();
+
     // Extract last 45000 samples from ring buffer
-    static short int asyncBuf[45000];
     int pos = m_asyncAudioPos;
     int start = (pos - 45000 + 90000) % 90000;
     for (int i = 0; i < 45000; i++) {
-      asyncBuf[i] = m_asyncAudio[(start + i) % 90000];
+      job->audio[i] = m_asyncAudio[(start + i) % 90000];
     }
 
     // Clear dedup set every 10 seconds
@@ -2972,18 +3051,26 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
     }
     int ndepth = qBound (1, m_ndepth, 4);
     int ncontest = qBound (0, int(m_specOp), 16);
-    std::memset (m_asyncMsg, 0, sizeof (m_asyncMsg));
-    m_asyncMsgCount = 0;
-    m_bAsyncDecoding = true;
-
-    m_asyncDecodeWatcher.setFuture(QtConcurrent::run(&m_asyncDecodeThreadPool, [=]() mutable {
+    std::memset (job->msg, 0, sizeof (job->msg));
+    char mycall[12];
+    char hiscall[12];
+    std::memcpy (mycall, dec_data->params.mycall, sizeof (mycall));
+    std::memcpy (hiscall, dec_data->params.hiscall, sizeof (hiscall));
+    m_asyncJobs << job;
+    m_asyncLastLaunchMs = nowMs;
+
+    auto watcher = new QFutureWatcher<void> {this};
+    connect (watcher, &QFutureWatcher<void>::finished, this, [this, watcher, job] () {
+      watcher->deleteLater ();
+      asyncDecodeDone (job);
+    });
+    watcher->setFuture(QtConcurrent::run(&m_asyncDecodeThreadPool, [=]() mutable {
       int nout = 0;
-      ft2_triggered_decode_(asyncBuf, &nqsoprogress, &nfqso, &nfa, &nfb,
-                            &ndepth, &ncontest,
-                            dec_data.params.mycall, dec_data.params.hiscall,
-                            &m_asyncMsg[0][0], &nout,
+      ft2_triggered_decode_(job->audio, &nqsoprogress, &nfqso, &nfa, &nfb,
+                            &ndepth, &ncontest, mycall, hiscall,
+                            &job->msg[0][0], &nout,
                             (FCL)12, (FCL)12, (FCL)(100*80));
-      m_asyncMsgCount = qBound (0, nout, 100);
+      job->count = qBound (0, nout, 100);
     }));
   });
   
@@ -3120,6 +3207,8 @@ MainWindow::MainWindow(QDir const& temp_directory, bool multiple,
   m_wideGraph->setVHF(m_config.enable_VHF_features());
 
   connect( wsprNet, SIGNAL(uploadStatus(QString)), this, SLOT(uploadResponse(QString)));
+  connect (wsprNet, &WSPRNet::statisticsChanged, this, &MainWindow::updateWsprNetStatistics);
+  wsprNet->set_queue_file (m_config.writeable_data_dir ().absoluteFilePath ("wsprnet_queue.txt"));
 
   statusChanged();
 
@@ -3266,10 +3355,8 @@ void MainWindow::on_the_minute ()
 MainWindow::~MainWindow()
 {
   m_asyncDecodeTimer.stop ();
-  if (m_asyncDecodeWatcher.isRunning ()) {
-    m_asyncDecodeWatcher.waitForFinished ();
-  }
-  m_asyncDecodeThreadPool.waitForDone (1000);
+  m_asyncJobs.clear ();
+  m_asyncDecodeThreadPool.waitForDone ();
 
   if(m_astroWidget) m_astroWidget.reset ();
   if(m_QSYMessageCreatorWidget) m_QSYMessageCreatorWidget.reset ();
@@ -3436,6 +3523,7 @@ void MainWindow::writeSettings()
   m_settings->setValue("SaveDecoded",ui->actionSave_decoded->isChecked());
   m_settings->setValue("SaveAll",ui->actionSave_all->isChecked());
   m_settings->setValue("RemoveAudioFiles",ui->actionRemove_after_30days->isChecked());
+  m_settings->setValue("SaveCompressed",ui->actionSave_compressed->isChecked());
   m_settings->setValue("NDepth",m_ndepth);
 
   //ft8md
@@ -3800,6 +3888,7 @@ void MainWindow::readSettings()
   ui->actionSave_decoded->setChecked(m_settings->value("SaveDecoded",false).toBool());
   ui->actionSave_all->setChecked(m_settings->value("SaveAll",false).toBool());
   ui->actionRemove_after_30days->setChecked(m_settings->value("RemoveAudioFiles",false).toBool());
+  ui->actionSave_compressed->setChecked(m_settings->value("SaveCompressed",false).toBool());
   ui->RxFreqSpinBox->setValue(0); // ensure a change is signaled
   ui->RxFreqSpinBox->setValue(m_settings->value("RxFreq",1500).toInt());
   ui->sbFST4W_RxFreq->setValue(0);
@@ -3843,7 +3932,7 @@ void MainWindow::readSettings()
   //ft8md
   ui->actionUse_multithreaded_FT8_decoder->setChecked(m_settings->value("MultithreadedFT8decoder", false).toBool());
   m_multithreadFT8 = ui->actionUse_multithreaded_FT8_decoder->isChecked();
-  dec_data.params.lmultift8 = m_multithreadFT8;
+  dec_data->params.lmultift8 = m_multithreadFT8;
 
   m_nFT8Cycles=m_settings->value("NFT8Cycles",3).toInt(); if(!(m_nFT8Cycles>=1 && m_nFT8Cycles<=3)) m_nFT8Cycles=3;
   if(m_nFT8Cycles==1) ui->actionDecFT8cycles1->setChecked(true);
@@ -3871,7 +3960,7 @@ void MainWindow::readSettings()
   else if(m_ft8threads==11) ui->actionMT11->setChecked(true);
   else if(m_ft8threads==12) ui->actionMT12->setChecked(true);
   qDebug() << "m_ft8threads is " << m_ft8threads;
-  dec_data.params.nmt = m_ft8threads;
+  dec_data->params.nmt = m_ft8threads;
 
   ui->actionHide_FT8_dupe_messages->setChecked(m_settings->value("HideFT8Dupes",true).toBool());
 
@@ -4220,23 +4309,26 @@ void MainWindow::dataSink(qint64 frames)
     int nsamples = qMin(k, 90000);
     int src_start = qMax(0, k - nsamples);
     for (int i = 0; i < nsamples; i++) {
-      m_asyncAudio[m_asyncAudioPos % 90000] = dec_data.d2[src_start + i];
+      m_asyncAudio[m_asyncAudioPos % 90000] = dec_data->d2[src_start + i];
       m_asyncAudioPos++;
     }
   }
 
-  auto fname {QDir::toNativeSeparators(m_config.writeable_data_dir ().absoluteFilePath ("refspec.dat")).toLocal8Bit ()};
+  auto fname {QDir::toNativeSeparators(m_refspecFile).toLocal8Bit ()};
 
   if(m_diskData) {
-    dec_data.params.ndiskdat=1;
+    dec_data->params.ndiskdat=1;
   } else {
-    dec_data.params.ndiskdat=0;
+    dec_data->params.ndiskdat=0;
     m_wideGraph->setDiskUTC(-1);
   }
 
-  m_bUseRef=m_wideGraph->useRef();
+  if(m_wideGraph->useRef() != m_bUseRef) {
+    m_bUseRef=m_wideGraph->useRef();
+    updateEqualizer ();
+  }
   if(!m_diskData) {
-    refspectrum_(&dec_data.d2[k-m_nsps/2],&m_bClearRefSpec,&m_bRefSpec,
+    refspectrum_(&dec_data->d2[k-m_nsps/2],&m_bClearRefSpec,&m_bRefSpec,
                  &m_bUseRef, fname.constData (), (FCL)fname.size ());
   }
   m_bClearRefSpec=false;
@@ -4247,11 +4339,11 @@ void MainWindow::dataSink(qint64 frames)
   }
 
 // Get power, spectrum, and ihsym
-  dec_data.params.nfa=m_wideGraph->nStartFreq();
-  dec_data.params.nfb=m_wideGraph->Fmax();
+  dec_data->params.nfa=m_wideGraph->nStartFreq();
+  dec_data->params.nfb=m_wideGraph->Fmax();
   if(m_mode=="FST4") {
-    dec_data.params.nfa=ui->sbF_Low->value();
-    dec_data.params.nfb=ui->sbF_High->value();
+    dec_data->params.nfa=ui->sbF_Low->value();
+    dec_data->params.nfb=ui->sbF_High->value();
   }
   int nsps=m_nsps;
   if(m_bFastMode) nsps=6912;
@@ -4259,9 +4351,9 @@ void MainWindow::dataSink(qint64 frames)
   bool bLowSidelobes=m_config.lowSidelobes();
   int npct=0;
   if(m_mode.startsWith("FST4")) npct=ui->sbNB->value();
-  symspec_(&dec_data,&k,&m_TRperiod,&nsps,&m_inGain,&bLowSidelobes,&nsmo,&m_px,s,
+  symspec_(dec_data,&k,&m_TRperiod,&nsps,&m_inGain,&bLowSidelobes,&nsmo,&m_px,s,
            &m_df3,&m_ihsym,&m_npts8,&m_pxmax,&npct);
-  if(m_mode=="WSPR" or m_mode=="FST4W") wspr_downsample_(dec_data.d2,&k);
+  if(m_mode=="WSPR" or m_mode=="FST4W") wspr_downsample_(dec_data->d2,&k);
   if(m_ihsym <=0) return;
   if(ui) ui->signal_meter_widget->setValue(m_px,m_pxmax); // Update thermometer
   if(m_monitoring || m_diskData) {
@@ -4277,7 +4369,7 @@ void MainWindow::dataSink(qint64 frames)
     int RxFreq=ui->RxFreqSpinBox->value ();
     int nkhz=(m_freqNominal+RxFreq)/1000;
     int ftol = ui->sbFtol->value ();
-    freqcal_(&dec_data.d2[0], &k, &nkhz, &RxFreq, &ftol, &line[0], (FCL)80);
+    freqcal_(&dec_data->d2[0], &k, &nkhz, &RxFreq, &ftol, &line[0], (FCL)80);
     QString t=QString::fromLatin1(line);
     DecodedText decodedtext {t};
     ui->decodedTextBrowser->displayDecodedText (decodedtext, m_config.my_callsign(),
@@ -4381,11 +4473,11 @@ void MainWindow::dataSink(qint64 frames)
       int idir=1;
       if(!ui->rbFixedTone->isChecked() and !m_diskData) {
         ndf=ui->sbToneSpacing->value();
-        save_echo_params_(&nDopTotal,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data.d2,&idir);
+        save_echo_params_(&nDopTotal,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data->d2,&idir);
       }
       if(m_diskData) {
         idir=-1;
-        save_echo_params_(&nDopTotal,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data.d2,&idir);
+        save_echo_params_(&nDopTotal,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data->d2,&idir);
         if(ndf==0 and ui->rbEchoMessage->isChecked()) ui->rbFixedTone->setChecked(true);
       }
 
@@ -4393,7 +4485,7 @@ void MainWindow::dataSink(qint64 frames)
       QString txcall=ui->leEchoMessage->text();
       static char crxcall[7];
       float xdt=0.0;
-      avecho_(dec_data.d2,&nDop,&nfrit,&nauto,&ndf,&navg,&nqual,&f1,&xlevel,&sigdb,
+      avecho_(dec_data->d2,&nDop,&nfrit,&nauto,&ndf,&navg,&nqual,&f1,&xlevel,&sigdb,
           &dBerr,&dfreq,&width,&m_diskData,&bEchoCall,txcall.toLatin1().constData(),
           &crxcall[0],&xdt,(FCL)6,(FCL)6);
       crxcall[6]=0;
@@ -4440,7 +4532,7 @@ void MainWindow::dataSink(qint64 frames)
       if(m_saveAll and !m_diskData) {
         if(ui->rbEchoMessage->isChecked()) ndf=ui->sbToneSpacing->value();
         int idir=1;
-        save_echo_params_(&m_fDop,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data.d2,&idir);
+        save_echo_params_(&m_fDop,&nDop,&nfrit,&f1,&width,&ndf,&itone[0],dec_data->d2,&idir);
         m_fSpread=width;
       }
       m_nclearave=0;
@@ -4450,13 +4542,13 @@ void MainWindow::dataSink(qint64 frames)
 
     if(m_dialFreqRxWSPR==0) m_dialFreqRxWSPR=m_freqNominal;
     m_dataAvailable=true;
-    dec_data.params.npts8=(m_ihsym*m_nsps)/16;
-    dec_data.params.newdat=1;
-    dec_data.params.nagain=0;
-    dec_data.params.nagainfil=0;	
-    dec_data.params.nzhsym=m_hsymStop;
-    if(m_mode=="FT8" and m_ihsym==m_earlyDecode and !m_diskData && !(m_multithreadFT8 && m_ft8DecoderStart>1)) dec_data.params.nzhsym=m_earlyDecode;
-    if(m_mode=="FT8" and m_ihsym==m_earlyDecode2 and !m_diskData && !(m_multithreadFT8 && m_ft8DecoderStart!=1)) dec_data.params.nzhsym=m_earlyDecode2;
+    dec_data->params.npts8=(m_ihsym*m_nsps)/16;
+    dec_data->params.newdat=1;
+    dec_data->params.nagain=0;
+    dec_data->params.nagainfil=0;	
+    dec_data->params.nzhsym=m_hsymStop;
+    if(m_mode=="FT8" and m_ihsym==m_earlyDecode and !m_diskData && !(m_multithreadFT8 && m_ft8DecoderStart>1)) dec_data->params.nzhsym=m_earlyDecode;
+    if(m_mode=="FT8" and m_ihsym==m_earlyDecode2 and !m_diskData && !(m_multithreadFT8 && m_ft8DecoderStart!=1)) dec_data->params.nzhsym=m_earlyDecode2;
     QDateTime now {QDateTime::currentDateTimeUtc ()};
     m_dateTime = now.toString ("yyyy-MMM-dd hh:mm");
     if(m_mode!="WSPR") {
@@ -4487,11 +4579,7 @@ void MainWindow::dataSink(qint64 frames)
       int samples=m_TRperiod*12000;
       if(m_mode=="FT2") samples=45000;
       if(m_mode=="FT4") samples=21*3456;
-      // the following is potential a threading hazard - not a good
-      // idea to pass pointer to be processed in another thread
-      m_saveWAVWatcher.setFuture (QtConcurrent::run (std::bind (&MainWindow::save_wave_file,
-            this, m_fnameWE, &dec_data.d2[0], samples, m_config.my_callsign(),
-            m_config.my_grid(), m_mode, m_nSubMode, m_freqNominalPeriod, m_hisCall, m_hisGrid)));
+      save_audio_snapshot (m_fnameWE, &dec_data->d2[0], samples, m_mode, m_nSubMode, m_freqNominalPeriod);
       if (m_mode=="WSPR") {
         auto c2name {(m_fnameWE + ".c2").toLocal8Bit ()};
         int nsec=120;
@@ -4530,25 +4618,16 @@ void MainWindow::dataSink(qint64 frames)
 
 void MainWindow::startP1()
 {
+  m_snapshotWriter->flush ();   // the .wav file wsprd reads
   p1.start (QDir::toNativeSeparators (QDir {QApplication::applicationDirPath ()}.absoluteFilePath ("wsprd")), m_cmndP1);
 }
 
-QString MainWindow::save_wave_file (QString const& name, short const * data, int samples,
-        QString const& my_callsign, QString const& my_grid, QString const& mode, qint32 sub_mode,
-        Frequency frequency, QString const& his_call, QString const& his_grid) const
+void MainWindow::save_audio_snapshot (QString const& name, short const * data, int samples,
+        QString const& mode, qint32 sub_mode, Frequency frequency)
 {
-  //
-  // This member function runs in a thread and should not access
-  // members that may be changed in the GUI thread or any other thread
-  // without suitable synchronization.
-  //
-  QAudioFormat format;
-  format.setCodec ("audio/pcm");
-  format.setSampleRate (12000);
-  format.setChannelCount (1);
-  format.setSampleSize (16);
-  format.setSampleType (QAudioFormat::SignedInt);
-  auto source = QString {"%1; %2"}.arg (my_callsign).arg (my_grid);
+  // The samples are copied before returning, the file is written on
+  // the snapshot writer's thread.
+  auto source = QString {"%1; %2"}.arg (m_config.my_callsign ()).arg (m_config.my_grid ());
   auto comment = QString {"Mode=%1%2; Freq=%3%4"}
                    .arg (mode)
                    .arg (QString {(mode.contains ('J') && !mode.contains ('+'))
@@ -4557,8 +4636,8 @@ QString MainWindow::save_wave_file (QString const& name, short const * data, int
                        : QString {}})
                    .arg (Radio::frequency_MHz_string (frequency))
                    .arg (QString {mode!="WSPR" ? QString {"; DXCall=%1; DXGrid=%2"}
-         .arg (his_call)
-         .arg (his_grid).toLocal8Bit () : ""});
+         .arg (m_hisCall)
+         .arg (m_hisGrid).toLocal8Bit () : ""});
   BWFFile::InfoDictionary list_info {
       {{{'I','S','R','C'}}, source.toLocal8Bit ()},
       {{{'I','S','F','T'}}, program_title (revision ()).simplified ().toLocal8Bit ()},
@@ -4566,15 +4645,13 @@ QString MainWindow::save_wave_file (QString const& name, short const * data, int
                           .toString ("yyyy-MM-ddTHH:mm:ss.zzzZ").toLocal8Bit ()},
       {{{'I','C','M','T'}}, comment.toLocal8Bit ()},
         };
-  auto file_name = name + ".wav";
-  BWFFile wav {format, file_name, list_info};
-  if (!wav.open (BWFFile::WriteOnly)
-      || 0 > wav.write (reinterpret_cast<char const *> (data)
-                        , sizeof (short) * samples))
+  // wsprd reads the .wav file
+  auto container = ui->actionSave_compressed->isChecked () && mode != "WSPR"
+    ? AudioSnapshotWriter::Container::FLAC : AudioSnapshotWriter::Container::WAV;
+  if (!m_snapshotWriter->save (name, data, samples, list_info, container))
     {
-      return file_name + ": " + wav.errorString ();
+      showStatusMessage (tr ("Audio file not saved, disk writes are falling behind"));
     }
-  return QString {};
 }
 
 //-------------------------------------------------------------- fastSink()
@@ -4589,7 +4666,7 @@ void MainWindow::fastSink(qint64 frames)
     memcpy(fast_green2,fast_green,4*703);        //Copy fast_green[] to fast_green2[]
     memcpy(fast_s2,fast_s,4*703*64);             //Copy fast_s[] into fast_s2[]
     fast_jh2=fast_jh;
-    if(!m_diskData) memset(dec_data.d2,0,2*30*12000);   //Zero the d2[] array
+    if(!m_diskData) memset(dec_data->d2,0,2*30*12000);   //Zero the d2[] array
     m_bFastDecodeCalled=false;
     m_bDecoded=false;
   }
@@ -4608,21 +4685,21 @@ void MainWindow::fastSink(qint64 frames)
   int RxFreq=ui->RxFreqSpinBox->value ();
   int nTRpDepth=m_TRperiod + 1000*(m_ndepth & 3);
   qint64 ms0 = QDateTime::currentMSecsSinceEpoch();
-//  ::memcpy(dec_data.params.mycall, (m_baseCall+"            ").toLatin1(),sizeof dec_data.params.mycall);
-  ::memcpy(dec_data.params.mycall,(m_config.my_callsign () + "            ").toLatin1(),sizeof dec_data.params.mycall);
+//  ::memcpy(dec_data->params.mycall, (m_baseCall+"            ").toLatin1(),sizeof dec_data->params.mycall);
+  ::memcpy(dec_data->params.mycall,(m_config.my_callsign () + "            ").toLatin1(),sizeof dec_data->params.mycall);
   QString hisCall {ui->dxCallEntry->text ()};
   bool bshmsg=ui->cbShMsgs->isChecked();
   bool bswl=ui->cbSWL->isChecked();
-//  ::memcpy(dec_data.params.hiscall,(Radio::base_callsign (hisCall) +  "            ").toLatin1 ().constData (), sizeof dec_data.params.hiscall);
-  ::memcpy(dec_data.params.hiscall,(hisCall + "            ").toLatin1 ().constData (), sizeof dec_data.params.hiscall);
-  ::memcpy(dec_data.params.mygrid, (m_config.my_grid()+"      ").toLatin1(), sizeof dec_data.params.mygrid);
+//  ::memcpy(dec_data->params.hiscall,(Radio::base_callsign (hisCall) +  "            ").toLatin1 ().constData (), sizeof dec_data->params.hiscall);
+  ::memcpy(dec_data->params.hiscall,(hisCall + "            ").toLatin1 ().constData (), sizeof dec_data->params.hiscall);
+  ::memcpy(dec_data->params.mygrid, (m_config.my_grid()+"      ").toLatin1(), sizeof dec_data->params.mygrid);
   auto data_dir {m_config.writeable_data_dir ().absolutePath ().toLocal8Bit ()};
   float pxmax = 0;
   float rmsNoGain = 0;
   int ftol = ui->sbFtol->value ();
-  hspec_(dec_data.d2,&k,&nutc0,&nTRpDepth,&RxFreq,&ftol,&bmsk144,
-      &m_bTrain,m_phaseEqCoefficients.constData(),&m_inGain,&dec_data.params.mycall[0],
-      &dec_data.params.hiscall[0],&bshmsg,&bswl,
+  hspec_(dec_data->d2,&k,&nutc0,&nTRpDepth,&RxFreq,&ftol,&bmsk144,
+      &m_bTrain,m_phaseEqCoefficients.constData(),&m_inGain,&dec_data->params.mycall[0],
+      &dec_data->params.hiscall[0],&bshmsg,&bswl,
       data_dir.constData (),fast_green,fast_s,&fast_jh,&pxmax,&rmsNoGain,&line[0],(FCL)12,
       (FCL)12,(FCL)data_dir.size (),(FCL)80);
   float px = fast_green[fast_jh];
@@ -5396,7 +5473,7 @@ void MainWindow::fastSink(qint64 frames)
   }
 
   m_k0=k;
-  if(m_diskData and m_k0 >= dec_data.params.kin - 7 * 512) decodeNow=true;
+  if(m_diskData and m_k0 >= dec_data->params.kin - 7 * 512) decodeNow=true;
   if(!m_diskData and m_tRemaining<0.35 and !m_bFastDecodeCalled) decodeNow=true;
   if(m_mode=="MSK144") decodeNow=false;
 
@@ -5405,7 +5482,7 @@ void MainWindow::fastSink(qint64 frames)
     m_t0=0.0;
     m_t1=k/12000.0;
     m_kdone=k;
-    dec_data.params.newdat=1;
+    dec_data->params.newdat=1;
     if(!m_decoderBusy) {
       m_bFastDecodeCalled=true;
       decode();
@@ -5421,11 +5498,7 @@ void MainWindow::fastSink(qint64 frames)
       m_fnameWE = m_config.save_directory ().absoluteFilePath (period_start.toString ("yyMMdd_hhmmss"));
       if(m_saveAll or m_bAltV or (m_bDecoded and m_saveDecoded) or (m_mode!="MSK144")) {
         m_bAltV=false;
-        // the following is potential a threading hazard - not a good
-        // idea to pass pointer to be processed in another thread
-        m_saveWAVWatcher.setFuture (QtConcurrent::run (std::bind (&MainWindow::save_wave_file,
-           this, m_fnameWE, &dec_data.d2[0], int(m_TRperiod*12000.0), m_config.my_callsign(),
-           m_config.my_grid(), m_mode, m_nSubMode, m_freqNominal, m_hisCall, m_hisGrid)));
+        save_audio_snapshot (m_fnameWE, &dec_data->d2[0], int(m_TRperiod*12000.0), m_mode, m_nSubMode, m_freqNominal);
       }
       if(m_mode!="MSK144") {
         killFileTimer.start (int(750.0*m_TRperiod)); //Kill 3/4 period from now
@@ -5765,6 +5838,7 @@ void MainWindow::on_actionSettings_triggered()           // Setup Dialog (Settin
   auto psk_on = m_config.spot_to_psk_reporter ();
   if (QDialog::Accepted == m_config.exec ()) {
     checkMSK144ContestType();
+    updateEqualizer ();         // the rig may have changed
     if (m_config.my_callsign () != callsign) {
       m_baseCall = Radio::base_callsign (m_config.my_callsign ());
       ui->tx1->setEnabled (elide_tx1_not_allowed () || ui->tx1->isEnabled ());
@@ -5794,6 +5868,7 @@ void MainWindow::on_actionSettings_triggered()           // Setup Dialog (Settin
       {
         m_psk_Reporter.sendReport (true);
       }
+    updatePskStatistics ();
 
     m_tci_audio = (m_config.tci_audio() && m_config.is_tci());  // update m_tci_audio
     bool was_monitoring = m_monitoring;
@@ -6730,8 +6805,8 @@ void MainWindow::keyPressEvent (QKeyEvent * e)
       }
       if(m_mode != "WSPR" && e->modifiers() & Qt::ShiftModifier) {
         if(!m_decoderBusy) {
-          dec_data.params.newdat=0;
-          dec_data.params.nagain=0;
+          dec_data->params.newdat=0;
+          dec_data->params.nagain=0;
           decode();
           return;
         }
@@ -7018,6 +7093,7 @@ void MainWindow::displayDialFrequency ()
         ui->bandComboBox->setCurrentText (band_name.size () ? band_name : m_config.bands ()->oob ());
         m_wideGraph->setRxBand (band_name);
         m_lastBand = band_name;
+        updateEqualizer ();
         band_changed(dial_frequency);
       }
       // prevent wrong frequencies for all.txt, PSK Reporter and highlighting for late decodes after band changes
@@ -7262,6 +7338,27 @@ bool MainWindow::eventFilter (QObject * object, QEvent * event)
   return QObject::eventFilter(object, event);
 }
 
+void MainWindow::updatePskStatistics ()
+{
+  psk_label.setVisible (m_config.spot_to_psk_reporter ());
+  auto const& stats = m_psk_Reporter.statistics ();
+  psk_label.setText (tr ("PSK: %1").arg (stats.sent));
+  psk_label.setToolTip (tr ("Spots to PSK Reporter\n"
+                            "Queued: %1\nDuplicates suppressed: %2\nSent: %3\nDropped: %4")
+                        .arg (stats.queued).arg (stats.deduplicated).arg (stats.sent).arg (stats.dropped));
+}
+
+void MainWindow::updateWsprNetStatistics ()
+{
+  auto const& stats = wsprNet->statistics ();
+  ui->cbUploadWSPR_Spots->setToolTip (tr ("Upload decoded messages to WSPRnet.org.\n\n"
+                                          "Queued: %1\nSent: %2 (%3 per minute)\n"
+                                          "Rejected: %4\nRetries: %5\nDropped: %6")
+                                      .arg (stats.backlog).arg (stats.sent)
+                                      .arg (stats.per_minute, 0, 'f', 1)
+                                      .arg (stats.rejected).arg (stats.retries).arg (stats.dropped));
+}
+
 void MainWindow::createStatusBar()                           //createStatusBar
 {
   tx_status_label.setAlignment (Qt::AlignHCenter);
@@ -7299,6 +7396,13 @@ void MainWindow::createStatusBar()                           //createStatusBar
   statusBar()->addWidget (&decodium_cert_label);
   updateDecodiumCertificateStatus ();
 
+  psk_label.setAlignment (Qt::AlignHCenter);
+  psk_label.setMinimumSize (QSize {80, 18});
+  psk_label.setFrameStyle (QFrame::Panel | QFrame::Sunken);
+  statusBar()->addWidget (&psk_label);
+  connect (&m_psk_Reporter, &PSKReporter::statisticsChanged, this, &MainWindow::updatePskStatistics);
+  updatePskStatistics ();
+
   ntp_checkbox.setText("NTP");
   ntp_checkbox.setToolTip("Enable/disable internal NTP time synchronization");
   ntp_checkbox.setChecked(m_ntpEnabled);
@@ -7532,6 +7636,8 @@ void MainWindow::closeEvent(QCloseEvent * e)
   int irow=-99;
   plotsave_(&sw,&nw,&nh,&irow);
   to_jt9(m_ihsym,999,-1);          //Tell jt9 to terminate
+  // dec_data points into the segment, nothing captures into it now
+  // that the audio thread and the rig have been stopped
   mem_jt9->detach();
   Q_EMIT finished ();
   QMainWindow::closeEvent (e);
@@ -7545,6 +7651,8 @@ void MainWindow::on_stopButton_clicked()                       //stopButton
   if(m_bRefSpec) {
     MessageBox::information_message (this, tr ("Reference spectrum saved"));
     m_bRefSpec=false;
+    m_equalizers.remove (m_refspecFile);
+    updateEqualizer ();
   }
   if (ui->DX_Call_Button->isChecked()) ui->DX_Call_Button->click ();
   stopWRTimer.stop();           // Stop any Wait & Reply timeout
@@ -8200,6 +8308,9 @@ void MainWindow::on_actionTime_Sync_triggered()
     m_timeSyncPanel->updateNtpSyncStatus(
       m_ntpClient ? m_ntpClient->isSynced() : false,
       m_ntpEnabled ? "Initializing..." : "NTP disabled");
+    if (m_captureJitterMs >= 0.0) {
+      m_timeSyncPanel->updateCaptureClock(m_captureJitterMs, m_captureClockLocked);
+    }
   }
   m_timeSyncPanel->showNormal();
   m_timeSyncPanel->raise();
@@ -8293,7 +8404,7 @@ void MainWindow::on_actionOpen_triggered()                     //Open File
 
   QString fname;
   fname=QFileDialog::getOpenFileName(this, "Open File", m_path,
-                                     "Audio Files (*.wav)");
+                                     "Audio Files (*.wav *.flac)");
   if(!fname.isEmpty ()) {
     m_path=fname;
     int i1=fname.lastIndexOf("/");
@@ -8314,11 +8425,13 @@ void MainWindow::read_wav_file (QString const& fname)
     earlyDecodes = "";             // reset dupe check
   }
   // call diskDat() when done
+  bool const flac = fname.endsWith (".flac", Qt::CaseInsensitive);
+  QString const extension {flac ? ".flac" : ".wav"};
   int i0=fname.lastIndexOf("_");
-  int i1=fname.indexOf(".wav");
+  int i1=fname.indexOf(extension);
   int i3=fname.lastIndexOf("/");
   QString baseName=fname.mid(i3+1);
-  int i4=baseName.indexOf(".wav");
+  int i4=baseName.indexOf(extension);
   m_nutc0=m_UTCdisk;
   if (i1-i3 > 13) {
     m_UTCdisk=baseName.mid(7, 6).toInt();
@@ -8346,51 +8459,68 @@ void MainWindow::read_wav_file (QString const& fname)
     }
   }
 
-  m_wav_future_watcher.setFuture (QtConcurrent::run ([this, fname] {
+  m_wav_future_watcher.setFuture (QtConcurrent::run ([this, fname, flac, extension] {
     auto basename = fname.mid (fname.lastIndexOf ('/') + 1);
-    auto pos = fname.indexOf (".wav", 0, Qt::CaseInsensitive);
-    int i1=fname.indexOf(".wav");
+    auto pos = fname.indexOf (extension, 0, Qt::CaseInsensitive);
+    int i1=fname.indexOf(extension);
     int i3=fname.lastIndexOf("/");
     // global variables and threads do not mix well, this needs changing
-    dec_data.params.nutc = 0;
+    dec_data->params.nutc = 0;
     if (pos > 0) {
       if (i1-i3 > 13) {
-        dec_data.params.nutc = basename.mid(7, 6).toInt();
+        dec_data->params.nutc = basename.mid(7, 6).toInt();
         m_fileDateTime=basename.mid(0, 13);
       } else {
-        if (pos == fname.indexOf ('_', -11) + 7) {
-          dec_data.params.nutc = fname.mid (pos - 6, 6).toInt ();
+        if (pos == fname.indexOf ('_', -7 - extension.size ()) + 7) {
+          dec_data->params.nutc = fname.mid (pos - 6, 6).toInt ();
           m_fileDateTime=fname.mid(pos-13,13);
         } else {
-          dec_data.params.nutc = 100 * fname.mid (pos - 4, 4).toInt ();
+          dec_data->params.nutc = 100 * fname.mid (pos - 4, 4).toInt ();
           m_fileDateTime=fname.mid(pos-11,11);
         }
       }
     }
+    int nsamples=m_TRperiod * RX_SAMPLE_RATE;
+    if (flac) {
+      int max_samples = std::min (std::size_t (nsamples), sizeof (dec_data->d2) / sizeof (dec_data->d2[0]));
+      int frames_read {0};
+      int sample_rate {0};
+      restart_capture (dec_data);
+      bool ok = AudioSnapshotWriter::read_flac (fname, dec_data->d2, max_samples, &frames_read, &sample_rate).isEmpty ();
+      std::fill (&dec_data->d2[frames_read], &dec_data->d2[max_samples], 0);
+      if (ok && 11025 == sample_rate) {
+        short sample_size = 16;
+        wav12_ (dec_data->d2, dec_data->d2, &frames_read, &sample_size);
+      }
+      dec_data->params.kin = ok ? frames_read : 0;
+      dec_data->params.newdat = ok ? 1 : 0;
+      dec_data->params.yymmdd=basename.left(6).toInt();
+      return;
+    }
     BWFFile file {QAudioFormat {}, fname};
     bool ok=file.open (BWFFile::ReadOnly);
     if(ok) {
       auto bytes_per_frame = file.format ().bytesPerFrame ();
-      int nsamples=m_TRperiod * RX_SAMPLE_RATE;
       qint64 max_bytes = std::min (std::size_t (nsamples),
-          sizeof (dec_data.d2) / sizeof (dec_data.d2[0]))* bytes_per_frame;
-      auto n = file.read (reinterpret_cast<char *> (dec_data.d2),
+          sizeof (dec_data->d2) / sizeof (dec_data->d2[0]))* bytes_per_frame;
+      restart_capture (dec_data);
+      auto n = file.read (reinterpret_cast<char *> (dec_data->d2),
                         std::min (max_bytes, file.size ()));
       int frames_read = n / bytes_per_frame;
     // zero unfilled remaining sample space
-      std::memset(&dec_data.d2[frames_read],0,max_bytes - n);
+      std::memset(&dec_data->d2[frames_read],0,max_bytes - n);
       if (11025 == file.format ().sampleRate ()) {
         short sample_size = file.format ().sampleSize ();
-        wav12_ (dec_data.d2, dec_data.d2, &frames_read, &sample_size);
+        wav12_ (dec_data->d2, dec_data->d2, &frames_read, &sample_size);
       }
-      dec_data.params.kin = frames_read;
-      dec_data.params.newdat = 1;
+      dec_data->params.kin = frames_read;
+      dec_data->params.newdat = 1;
     } else {
-      dec_data.params.kin = 0;
-      dec_data.params.newdat = 0;
+      dec_data->params.kin = 0;
+      dec_data->params.newdat = 0;
     }
 
-    dec_data.params.yymmdd=basename.left(6).toInt();
+    dec_data->params.yymmdd=basename.left(6).toInt();
   }));
 }
 
@@ -8401,7 +8531,7 @@ void MainWindow::on_actionOpen_next_in_directory_triggered()   //Open Next
   int i,len;
   QFileInfo fi(m_path);
   QStringList list;
-  list= fi.dir().entryList().filter(".wav",Qt::CaseInsensitive);
+  list= fi.dir().entryList({"*.wav", "*.flac"}, QDir::Files, QDir::Name | QDir::IgnoreCase);
   for (i = 0; i < list.size()-1; ++i) {
     len=list.at(i).length();
     if(list.at(i)==m_path.right(len)) {
@@ -8432,19 +8562,21 @@ void MainWindow::on_actionDecode_remaining_files_in_directory_triggered()
 
 void MainWindow::diskDat()                                   //diskDat()
 {
-  m_wideGraph->setDiskUTC(dec_data.params.nutc);
-  if(dec_data.params.kin>0) {
+  m_wideGraph->setDiskUTC(dec_data->params.nutc);
+  if(dec_data->params.kin>0) {
     int k;
     int kstep=m_FFTSize;
     m_diskData=true;
     float db=m_config.degrade();
     float bw=m_config.RxBandwidth();
-    if(db > 0.0) degrade_snr_(dec_data.d2,&dec_data.params.kin,&db,&bw);
-    for(int n=1; n<=m_hsymStop; n++) {                      // Do the waterfall spectra
+    if(db > 0.0) degrade_snr_(dec_data->d2,&dec_data->params.kin,&db,&bw);
+    int nstop=m_hsymStop;
+    if(m_mode=="MSK144") nstop=dec_data->params.kin/kstep;  // all of it, in small blocks
+    for(int n=1; n<=nstop; n++) {                           // Do the waterfall spectra
 //      k=(n+1)*kstep;           //### Why was this (n+1) ??? ###
       k=n*kstep;
-      if(k > dec_data.params.kin) break;
-      dec_data.params.npts8=k/8;
+      if(k > dec_data->params.kin) break;
+      dec_data->params.npts8=k/8;
       dataSink(k);
       QCoreApplication::processEvents (QEventLoop::ExcludeUserInputEvents); // Update the waterfall
     }
@@ -8453,15 +8585,15 @@ void MainWindow::diskDat()                                   //diskDat()
   }
 }
 
-//Delete ../save/*.wav
+//Delete ../save/*.wav and *.flac
 void MainWindow::on_actionDelete_all_wav_files_in_SaveDir_triggered()
 {
   auto button = MessageBox::query_message (this, tr ("Confirm Delete"),
-                                             tr ("Are you sure you want to delete all *.wav and *.c2 files in \"%1\"?")
+                                             tr ("Are you sure you want to delete all *.wav, *.flac and *.c2 files in \"%1\"?")
                                              .arg (QDir::toNativeSeparators (m_config.save_directory ().absolutePath ())));
   if (MessageBox::Yes == button) {
     Q_FOREACH (auto const& file
-               , m_config.save_directory ().entryList ({"*.wav", "*.c2"}, QDir::Files | QDir::Writable)) {
+               , m_config.save_directory ().entryList ({"*.wav", "*.flac", "*.c2"}, QDir::Files | QDir::Writable)) {
       m_config.save_directory ().remove (file);
     }
   }
@@ -8681,8 +8813,8 @@ void MainWindow::on_DecodeButton_clicked (bool /* checked */) //Decode request
   } else {
     if(m_mode!="WSPR" && !m_decoderBusy) {
       m_manualDecode=true;
-      dec_data.params.newdat=0;
-      dec_data.params.nagain=1;
+      dec_data->params.newdat=0;
+      dec_data->params.nagain=1;
       decode();
     }
   }
@@ -8723,28 +8855,28 @@ void MainWindow::decode()                                       //decode()
   QDateTime now = QDateTime::currentDateTimeUtc ();
   if( m_dateTimeLastTX.isValid () ) {
     qint64 isecs_since_tx = m_dateTimeLastTX.secsTo(now);
-    dec_data.params.lapcqonly= (isecs_since_tx > 300); 
+    dec_data->params.lapcqonly= (isecs_since_tx > 300); 
   } else { 
     m_dateTimeLastTX = now.addSecs(-900);
-    dec_data.params.lapcqonly=true;
+    dec_data->params.lapcqonly=true;
   }
   if(m_diskData) {
-    dec_data.params.lapcqonly=false;
+    dec_data->params.lapcqonly=false;
   } else {
-    dec_data.params.yymmdd=-1;
+    dec_data->params.yymmdd=-1;
   }
   if(!m_dataAvailable or m_TRperiod==0.0) return;
   ui->DecodeButton->setChecked (true);
-  if(!dec_data.params.nagain && m_diskData && m_TRperiod >= 60.) {
-    dec_data.params.nutc=dec_data.params.nutc/100;
+  if(!dec_data->params.nagain && m_diskData && m_TRperiod >= 60.) {
+    dec_data->params.nutc=dec_data->params.nutc/100;
   }
-  if(dec_data.params.nagain==0 && dec_data.params.newdat==1 && (!m_diskData)) {
+  if(dec_data->params.nagain==0 && dec_data->params.newdat==1 && (!m_diskData)) {
     // m_dateTimeSeqStart already set by dataSink() before calling decode()
     auto t = m_dateTimeSeqStart.time ();
-    dec_data.params.nutc = t.hour () * 100 + t.minute ();
+    dec_data->params.nutc = t.hour () * 100 + t.minute ();
     if (m_TRperiod < 60.)
       {
-        dec_data.params.nutc = dec_data.params.nutc * 100 + t.second ();
+        dec_data->params.nutc = dec_data->params.nutc * 100 + t.second ();
       }
   }
 
@@ -8754,97 +8886,97 @@ void MainWindow::decode()                                       //decode()
     int imin=t.toString("mm").toInt();
     int isec=t.toString("ss").toInt();
     isec=isec - fmod(double(isec),m_TRperiod);
-    dec_data.params.nutc=10000*ihr + 100*imin + isec;
+    dec_data->params.nutc=10000*ihr + 100*imin + isec;
   }
-  if(m_nPick==2) dec_data.params.nutc=m_nutc0;
-  dec_data.params.nQSOProgress = m_QSOProgress;
-  dec_data.params.nfqso=m_wideGraph->rxFreq();
-  dec_data.params.nftx = ui->TxFreqSpinBox->value ();
+  if(m_nPick==2) dec_data->params.nutc=m_nutc0;
+  dec_data->params.nQSOProgress = m_QSOProgress;
+  dec_data->params.nfqso=m_wideGraph->rxFreq();
+  dec_data->params.nftx = ui->TxFreqSpinBox->value ();
   qint32 depth {m_ndepth};
   if (!ui->actionInclude_averaging->isVisible ()) depth &= ~16;
   if (!ui->actionInclude_correlation->isVisible ()) depth &= ~32;
   if (!ui->actionEnable_AP_DXcall->isVisible ()) depth &= ~64;
   if (!ui->actionAuto_Clear_Avg->isVisible()) depth &= ~128;
-  dec_data.params.ndepth=depth;
-  dec_data.params.n2pass=1;
-  if(m_config.twoPass()) dec_data.params.n2pass=2;
-  dec_data.params.nranera=m_config.ntrials();
-  dec_data.params.naggressive=m_config.aggressive();
-  dec_data.params.nrobust=0;
-  dec_data.params.ndiskdat=0;
-  if(m_diskData) dec_data.params.ndiskdat=1;
-  dec_data.params.nfa=m_wideGraph->nStartFreq();
-  dec_data.params.nfSplit=m_wideGraph->Fmin();  // Not used any more?
-  if(dec_data.params.nfSplit==8) dec_data.params.nfSplit=1;
-
-  dec_data.params.nfb=m_wideGraph->Fmax();
+  dec_data->params.ndepth=depth;
+  dec_data->params.n2pass=1;
+  if(m_config.twoPass()) dec_data->params.n2pass=2;
+  dec_data->params.nranera=m_config.ntrials();
+  dec_data->params.naggressive=m_config.aggressive();
+  dec_data->params.nrobust=0;
+  dec_data->params.ndiskdat=0;
+  if(m_diskData) dec_data->params.ndiskdat=1;
+  dec_data->params.nfa=m_wideGraph->nStartFreq();
+  dec_data->params.nfSplit=m_wideGraph->Fmin();  // Not used any more?
+  if(dec_data->params.nfSplit==8) dec_data->params.nfSplit=1;
+
+  dec_data->params.nfb=m_wideGraph->Fmax();
   if((m_mode=="FT8" or m_mode=="FT2") and SpecOp::HOUND==m_specOp and !ui->cbRxAll->isChecked() and
-     !m_config.superFox()) dec_data.params.nfb=1000;
-  if((m_mode=="FT8" or m_mode=="FT2") and SpecOp::FOX == m_specOp ) dec_data.params.nfqso=200;
-  dec_data.params.b_even_seq=(dec_data.params.nutc%10)==0;
-  dec_data.params.b_superfox=(m_config.superFox() and (SpecOp::FOX == m_specOp or SpecOp::HOUND == m_specOp));
-  if(m_mode=="FT8" and dec_data.params.b_superfox and dec_data.params.b_even_seq and m_ihsym<50) return;
+     !m_config.superFox()) dec_data->params.nfb=1000;
+  if((m_mode=="FT8" or m_mode=="FT2") and SpecOp::FOX == m_specOp ) dec_data->params.nfqso=200;
+  dec_data->params.b_even_seq=(dec_data->params.nutc%10)==0;
+  dec_data->params.b_superfox=(m_config.superFox() and (SpecOp::FOX == m_specOp or SpecOp::HOUND == m_specOp));
+  if(m_mode=="FT8" and dec_data->params.b_superfox and dec_data->params.b_even_seq and m_ihsym<50) return;
 
-  dec_data.params.ntol=ui->sbFtol->value ();
+  dec_data->params.ntol=ui->sbFtol->value ();
   if(m_mode=="FST4") {
-    dec_data.params.ntol=ui->sbFtol->value();
+    dec_data->params.ntol=ui->sbFtol->value();
     if(m_config.single_decode()) {
-      dec_data.params.nfa=m_wideGraph->rxFreq() - ui->sbFtol->value();
-      dec_data.params.nfb=m_wideGraph->rxFreq() + ui->sbFtol->value();
+      dec_data->params.nfa=m_wideGraph->rxFreq() - ui->sbFtol->value();
+      dec_data->params.nfb=m_wideGraph->rxFreq() + ui->sbFtol->value();
     } else {
-      dec_data.params.nfa=ui->sbF_Low->value();
-      dec_data.params.nfb=ui->sbF_High->value();
+      dec_data->params.nfa=ui->sbF_Low->value();
+      dec_data->params.nfb=ui->sbF_High->value();
     }
   }
-  if(m_mode=="FST4W") dec_data.params.ntol=ui->sbFST4W_FTol->value();
-  if(dec_data.params.nutc < m_nutc0) m_RxLog = 1;       //Date and Time to file "ALL.TXT".
-  if(dec_data.params.newdat==1 and !m_diskData) m_nutc0=dec_data.params.nutc;
-  dec_data.params.ntxmode=9;
-  dec_data.params.nmode=9;
-  if(m_mode=="JT65") dec_data.params.nmode=65;
-  if(m_mode=="JT65") dec_data.params.ljt65apon = ui->actionEnable_AP_JT65->isVisible () &&
+  if(m_mode=="FST4W") dec_data->params.ntol=ui->sbFST4W_FTol->value();
+  if(dec_data->params.nutc < m_nutc0) m_RxLog = 1;       //Date and Time to file "ALL.TXT".
+  if(dec_data->params.newdat==1 and !m_diskData) m_nutc0=dec_data->params.nutc;
+  dec_data->params.ntxmode=9;
+  dec_data->params.nmode=9;
+  if(m_mode=="JT65") dec_data->params.nmode=65;
+  if(m_mode=="JT65") dec_data->params.ljt65apon = ui->actionEnable_AP_JT65->isVisible () &&
       ui->actionEnable_AP_JT65->isChecked ();
-  if(m_mode=="Q65") dec_data.params.nmode=66;
-  if(m_mode=="Q65") dec_data.params.ntxmode=66;
+  if(m_mode=="Q65") dec_data->params.nmode=66;
+  if(m_mode=="Q65") dec_data->params.ntxmode=66;
   if(m_mode=="JT4") {
-    dec_data.params.nmode=4;
-    dec_data.params.ntxmode=4;
+    dec_data->params.nmode=4;
+    dec_data->params.ntxmode=4;
   }
-  if(m_mode=="FT8") dec_data.params.nmode=8;
-  if(m_mode=="FT8") dec_data.params.lft8apon = ui->actionEnable_AP_FT8->isVisible () &&
+  if(m_mode=="FT8") dec_data->params.nmode=8;
+  if(m_mode=="FT8") dec_data->params.lft8apon = ui->actionEnable_AP_FT8->isVisible () &&
       ui->actionEnable_AP_FT8->isChecked ();
-  if(m_mode=="FT8") dec_data.params.napwid=50;
+  if(m_mode=="FT8") dec_data->params.napwid=50;
   if(m_mode=="FT2") {
-    dec_data.params.nmode=2;
+    dec_data->params.nmode=2;
     m_BestCQpriority="";
   }
   if(m_mode=="FT4") {
-    dec_data.params.nmode=5;
+    dec_data->params.nmode=5;
     m_BestCQpriority="";
   }
-  if(m_mode=="FST4") dec_data.params.nmode=240;
-  if(m_mode=="FST4W") dec_data.params.nmode=241;
-  dec_data.params.ntxmode=dec_data.params.nmode;   // Is this used any more?
-  dec_data.params.ntrperiod=m_TRperiod;
-  dec_data.params.nsubmode=m_nSubMode;
-  dec_data.params.minw=0;
-  dec_data.params.nclearave=m_nclearave;
+  if(m_mode=="FST4") dec_data->params.nmode=240;
+  if(m_mode=="FST4W") dec_data->params.nmode=241;
+  dec_data->params.ntxmode=dec_data->params.nmode;   // Is this used any more?
+  dec_data->params.ntrperiod=m_TRperiod;
+  dec_data->params.nsubmode=m_nSubMode;
+  dec_data->params.minw=0;
+  dec_data->params.nclearave=m_nclearave;
   if(m_nclearave!=0) {
     QFile f(m_config.temp_dir ().absoluteFilePath ("avemsg.txt"));
     f.remove();
   }
-  dec_data.params.dttol=m_DTtol;
-  dec_data.params.emedelay=0.0;
-  if(m_config.decode_at_52s()) dec_data.params.emedelay=2.5;
-  dec_data.params.minSync=ui->syncSpinBox->isVisible () ? m_minSync : 0;
-  dec_data.params.nexp_decode=int(m_specOp);
-  if(dec_data.params.nexp_decode==5) dec_data.params.nexp_decode=1;  //NA VHF, WW Digi, ARRL Digi contests
-  if(dec_data.params.nexp_decode==8) dec_data.params.nexp_decode=1;  //and Q65 Pileup all use 4-character
-  if(dec_data.params.nexp_decode==9) dec_data.params.nexp_decode=1;  //grid exchange
-  if(m_config.single_decode()) dec_data.params.nexp_decode += 32;
-  if(m_config.enable_VHF_features()) dec_data.params.nexp_decode += 64;
-  if(m_mode.startsWith("FST4")) dec_data.params.nexp_decode += 256*(ui->sbNB->value()+3);
-  dec_data.params.max_drift=ui->sbMaxDrift->value();
+  dec_data->params.dttol=m_DTtol;
+  dec_data->params.emedelay=0.0;
+  if(m_config.decode_at_52s()) dec_data->params.emedelay=2.5;
+  dec_data->params.minSync=ui->syncSpinBox->isVisible () ? m_minSync : 0;
+  dec_data->params.nexp_decode=int(m_specOp);
+  if(dec_data->params.nexp_decode==5) dec_data->params.nexp_decode=1;  //NA VHF, WW Digi, ARRL Digi contests
+  if(dec_data->params.nexp_decode==8) dec_data->params.nexp_decode=1;  //and Q65 Pileup all use 4-character
+  if(dec_data->params.nexp_decode==9) dec_data->params.nexp_decode=1;  //grid exchange
+  if(m_config.single_decode()) dec_data->params.nexp_decode += 32;
+  if(m_config.enable_VHF_features()) dec_data->params.nexp_decode += 64;
+  if(m_mode.startsWith("FST4")) dec_data->params.nexp_decode += 256*(ui->sbNB->value()+3);
+  dec_data->params.max_drift=ui->sbMaxDrift->value();
   QString hisGrid;
   hisGrid=ui->dxGridEntry->text ();
   QString hisCall;
@@ -8853,97 +8985,91 @@ void MainWindow::decode()                                       //decode()
   if(m_mode=="FT8" && m_multithreadFT8)
   {
     //FT8 block of parameters for multithreaded FT8 decoder
-    dec_data.params.nstophint = 0;  // stophint should be false to avoid truncating decode process
-    dec_data.params.nQSOProgress = m_QSOProgress;
-    dec_data.params.nftx = ui->TxFreqSpinBox->value ();
-    if(m_freqNominal < 30000000) dec_data.params.napwid=5; // FT8AP decoding bandwidth for 'mycall hiscall ???' and RRR,RR73,73 messages
-    else if(m_freqNominal < 100000000) dec_data.params.napwid=15;
-    else dec_data.params.napwid=50;
-    dec_data.params.nmt=m_ft8threads;
-    dec_data.params.ncandthin=m_ncandthin;
-    dec_data.params.ndtcenter=0;  // ft8mod was 100 * ui->DTCenterSpinBox->value();
+    dec_data->params.nstophint = 0;  // stophint should be false to avoid truncating decode process
+    dec_data->params.nQSOProgress = m_QSOProgress;
+    dec_data->params.nftx = ui->TxFreqSpinBox->value ();
+    if(m_freqNominal < 30000000) dec_data->params.napwid=5; // FT8AP decoding bandwidth for 'mycall hiscall ???' and RRR,RR73,73 messages
+    else if(m_freqNominal < 100000000) dec_data->params.napwid=15;
+    else dec_data->params.napwid=50;
+    dec_data->params.nmt=m_ft8threads;
+    dec_data->params.ncandthin=m_ncandthin;
+    dec_data->params.ndtcenter=0;  // ft8mod was 100 * ui->DTCenterSpinBox->value();
     if (m_ihsym==m_earlyDecode or m_ihsym==m_earlyDecode2) {
-      dec_data.params.nft8cycles=2;
+      dec_data->params.nft8cycles=2;
     } else {
-      dec_data.params.nft8cycles=m_nFT8Cycles;
-    }
-    if(m_houndMode) { dec_data.params.nft8rxfsens=1; } else { dec_data.params.nft8rxfsens=m_nFT8RXfSens; }
-    dec_data.params.nft4depth=m_nFT4depth;
-    if(m_ft8Sensitivity==1) dec_data.params.lft8lowth=false;
-    else  dec_data.params.lft8lowth=true;
-    if(m_ft8Sensitivity==3) dec_data.params.lft8subpass=true;
-    else dec_data.params.lft8subpass=false;
-    dec_data.params.ltxing=(m_auto && (QDateTime::currentMSecsSinceEpoch()-m_mslastTX) < 26000) ? 1 : 0;  // ft8mdwas ( m_enableTx and jtdxTime etc.
-    dec_data.params.lhideft8dupes=ui->actionHide_FT8_dupe_messages->isChecked() ? 1 : 0; //ft8md ui->actionHide_FT8_dupe_messages->isChecked() ? 1 : 0;
-    dec_data.params.lhound=m_houndMode ? 1 : 0;
-    dec_data.params.lcommonft8b=m_commonFT8b;    
+      dec_data->params.nft8cycles=m_nFT8Cycles;
+    }
+    if(m_houndMode) { dec_data->params.nft8rxfsens=1; } else { dec_data->params.nft8rxfsens=m_nFT8RXfSens; }
+    dec_data->params.nft4depth=m_nFT4depth;
+    if(m_ft8Sensitivity==1) dec_data->params.lft8lowth=false;
+    else  dec_data->params.lft8lowth=true;
+    if(m_ft8Sensitivity==3) dec_data->params.lft8subpass=true;
+    else dec_data->params.lft8subpass=false;
+    dec_data->params.ltxing=(m_auto && (QDateTime::currentMSecsSinceEpoch()-m_mslastTX) < 26000) ? 1 : 0;  // ft8mdwas ( m_enableTx and jtdxTime etc.
+    dec_data->params.lhideft8dupes=ui->actionHide_FT8_dupe_messages->isChecked() ? 1 : 0; //ft8md ui->actionHide_FT8_dupe_messages->isChecked() ? 1 : 0;
+    dec_data->params.lhound=m_houndMode ? 1 : 0;
+    dec_data->params.lcommonft8b=m_commonFT8b;    
     m_bMyCallStd=stdCall(m_config.my_callsign ()); //ft8md
     m_bHisCallStd=stdCall(m_hisCall); //ft8md
-    dec_data.params.lmycallstd=m_bMyCallStd;
-    dec_data.params.lhiscallstd=m_bHisCallStd;
-    dec_data.params.lapmyc=m_lapmyc;
-    dec_data.params.lmodechanged=false; // m_modeChanged ? 1 : 0; m_modeChanged=false;
-    dec_data.params.lbandchanged=m_band_changed ? 1 : 0; // m_band_changed=false;
-    dec_data.params.lmultinst=m_multInst ? 1 : 0;
-    dec_data.params.lskiptx1=m_skipTx1 ? 1 : 0;
-    dec_data.params.nlasttx=m_nlasttx;
-    //ft8md dec_data.params.lforcesync=ui->syncButton->isChecked() && m_mode=="FT8";
-    dec_data.params.ndecoderstart=m_ft8DecoderStart;
-    dec_data.params.nsecbandchanged=m_nsecBandChanged; m_nsecBandChanged=0;
-    dec_data.params.nhint=m_hint ? 1 : 0;
-    dec_data.params.ndelay=m_delay;
-    dec_data.params.nfqso=m_wideGraph->rxFreq();
-    dec_data.params.ndepth=m_ndepth;
-    dec_data.params.nranera=m_config.ntrials();
-    dec_data.params.lmultift8=m_multithreadFT8; //ft8md
-    dec_data.params.ntrials10=0; //ft8md was =m_config.ntrials10();
-    dec_data.params.ntrialsrxf10=0; //ft8md was m_config.ntrialsrxf10();
-    dec_data.params.nprepass=4; //ft8md was m_config.npreampass();
-    dec_data.params.naggressive=1; //ft8md was m_config.aggressive();
-    dec_data.params.nharmonicsdepth=0;  //ft8md was m_config.harmonicsdepth();
-    dec_data.params.ntopfreq65=3000; //ft8md was m_config.ntopfreq65();
-    dec_data.params.nsdecatt=1; //ft8md was m_config.nsingdecatt();
-    dec_data.params.fmaskact=true; //ft8md was m_config.fmaskact();
+    dec_data->params.lmycallstd=m_bMyCallStd;
+    dec_data->params.lhiscallstd=m_bHisCallStd;
+    dec_data->params.lapmyc=m_lapmyc;
+    dec_data->params.lmodechanged=false; // m_modeChanged ? 1 : 0; m_modeChanged=false;
+    dec_data->params.lbandchanged=m_band_changed ? 1 : 0; // m_band_changed=false;
+    dec_data->params.lmultinst=m_multInst ? 1 : 0;
+    dec_data->params.lskiptx1=m_skipTx1 ? 1 : 0;
+    dec_data->params.nlasttx=m_nlasttx;
+    //ft8md dec_data->params.lforcesync=ui->syncButton->isChecked() && m_mode=="FT8";
+    dec_data->params.ndecoderstart=m_ft8DecoderStart;
+    dec_data->params.nsecbandchanged=m_nsecBandChanged; m_nsecBandChanged=0;
+    dec_data->params.nhint=m_hint ? 1 : 0;
+    dec_data->params.ndelay=m_delay;
+    dec_data->params.nfqso=m_wideGraph->rxFreq();
+    dec_data->params.ndepth=m_ndepth;
+    dec_data->params.nranera=m_config.ntrials();
+    dec_data->params.lmultift8=m_multithreadFT8; //ft8md
+    dec_data->params.ntrials10=0; //ft8md was =m_config.ntrials10();
+    dec_data->params.ntrialsrxf10=0; //ft8md was m_config.ntrialsrxf10();
+    dec_data->params.nprepass=4; //ft8md was m_config.npreampass();
+    dec_data->params.naggressive=1; //ft8md was m_config.aggressive();
+    dec_data->params.nharmonicsdepth=0;  //ft8md was m_config.harmonicsdepth();
+    dec_data->params.ntopfreq65=3000; //ft8md was m_config.ntopfreq65();
+    dec_data->params.nsdecatt=1; //ft8md was m_config.nsingdecatt();
+    dec_data->params.fmaskact=true; //ft8md was m_config.fmaskact();
     if (m_ihsym==m_earlyDecode or m_ihsym==m_earlyDecode2 or (m_specOp==SpecOp::HOUND && m_config.superFox())) {
-      dec_data.params.lmultift8 = false; // use the standard FT8 decoder for early decoding step
-      if (m_ihsym==m_earlyDecode2) dec_data.params.ndepth=2;
-    }
-    dec_data.params.ndiskdat=0;
-    if(m_diskData) dec_data.params.ndiskdat=1;
-    dec_data.params.nfa=m_wideGraph->nStartFreq();
-    dec_data.params.nfSplit=m_wideGraph->Fmin();
-    dec_data.params.nfb=m_wideGraph->Fmax();
-    dec_data.params.ntol=50; // this value is not being used
-    dec_data.params.ntrperiod=int(m_TRperiod);
-    dec_data.params.lwidedxcsearch=m_FT8WideDxCallSearch ? 1 : 0;
-  }
-  ::memcpy(dec_data.params.datetime, m_dateTime.toLatin1()+"    ", sizeof dec_data.params.datetime);
-  ::memcpy(dec_data.params.mycall, (m_config.my_callsign()+"            ").toLatin1(),12);
+      dec_data->params.lmultift8 = false; // use the standard FT8 decoder for early decoding step
+      if (m_ihsym==m_earlyDecode2) dec_data->params.ndepth=2;
+    }
+    dec_data->params.ndiskdat=0;
+    if(m_diskData) dec_data->params.ndiskdat=1;
+    dec_data->params.nfa=m_wideGraph->nStartFreq();
+    dec_data->params.nfSplit=m_wideGraph->Fmin();
+    dec_data->params.nfb=m_wideGraph->Fmax();
+    dec_data->params.ntol=50; // this value is not being used
+    dec_data->params.ntrperiod=int(m_TRperiod);
+    dec_data->params.lwidedxcsearch=m_FT8WideDxCallSearch ? 1 : 0;
+  }
+  ::memcpy(dec_data->params.datetime, m_dateTime.toLatin1()+"    ", sizeof dec_data->params.datetime);
+  ::memcpy(dec_data->params.mycall, (m_config.my_callsign()+"            ").toLatin1(),12);
   
-  ::memcpy(dec_data.params.mybcall, (Radio::base_callsign(m_config.my_callsign())+"            ").toLatin1(),12);
-  ::memcpy(dec_data.params.hiscall,(hisCall+"            ").toLatin1(),12);
+  ::memcpy(dec_data->params.mybcall, (Radio::base_callsign(m_config.my_callsign())+"            ").toLatin1(),12);
+  ::memcpy(dec_data->params.hiscall,(hisCall+"            ").toLatin1(),12);
   if(hisCall.length()<3) { 
     hisCall.clear();
-    ::memcpy(dec_data.params.hisbcall,(hisCall+"            ").toLatin1(),12); 
+    ::memcpy(dec_data->params.hisbcall,(hisCall+"            ").toLatin1(),12); 
   } else {
-    ::memcpy(dec_data.params.hisbcall,(Radio::base_callsign(hisCall)+"            ").toLatin1(),12);
+    ::memcpy(dec_data->params.hisbcall,(Radio::base_callsign(hisCall)+"            ").toLatin1(),12);
   }
-  ::memcpy(dec_data.params.hisgrid,(hisGrid+"      ").toLatin1(),6);    
-  ::memcpy(dec_data.params.mygrid, (m_config.my_grid()+"      ").toLatin1(),6);
+  ::memcpy(dec_data->params.hisgrid,(hisGrid+"      ").toLatin1(),6);    
+  ::memcpy(dec_data->params.mygrid, (m_config.my_grid()+"      ").toLatin1(),6);
   
-  if(!hisCall.isEmpty() && !m_auto && hisCall != m_lastloggedcall) dec_data.params.lenabledxcsearch=true;  //ft8md was && !m_enableTx
-  else dec_data.params.lenabledxcsearch=false;
+  if(!hisCall.isEmpty() && !m_auto && hisCall != m_lastloggedcall) dec_data->params.lenabledxcsearch=true;  //ft8md was && !m_enableTx
+  else dec_data->params.lenabledxcsearch=false;
 
-  if (auto * to = reinterpret_cast<char *> (mem_jt9->data()))
+  if (mem_jt9->data())
     {
-      char *from = (char*) dec_data.ipc;
-      int size=sizeof(struct dec_data);
-      if(dec_data.params.newdat==0) {
-        int noffset {offsetof (struct dec_data, params.nutc)};
-        to += noffset;
-        from += noffset;
-        size -= noffset;
-      }
+      // the capture, spectra and parameters above are already in the
+      // shared segment, jt9 takes its own copy of what it needs
       if(m_mode=="MSK144" or m_bFast9) {
         float t0=m_t0;
         float t1=m_t1;
@@ -8953,19 +9079,19 @@ void MainWindow::decode()                                       //decode()
           t1=m_t1Pick;
         }
         static short int d2b[360000];
-        narg[0]=dec_data.params.nutc;
+        narg[0]=dec_data->params.nutc;
         if(m_kdone>int(12000.0*m_TRperiod)) {
           m_kdone=int(12000.0*m_TRperiod);
         }
         narg[1]=m_kdone;
         narg[2]=m_nSubMode;
-        narg[3]=dec_data.params.newdat;
-        narg[4]=dec_data.params.minSync;
+        narg[3]=dec_data->params.newdat;
+        narg[4]=dec_data->params.minSync;
         narg[5]=m_nPick;
         narg[6]=1000.0*t0;
         narg[7]=1000.0*t1;
         narg[8]=2;                                //Max decode lines per decode attempt
-        if(dec_data.params.minSync<0) narg[8]=50;
+        if(dec_data->params.minSync<0) narg[8]=50;
         if(m_mode=="JT9") narg[9]=102;            //Fast JT9
         if(m_mode=="MSK144") narg[9]=104;         //MSK144
         narg[10]=ui->RxFreqSpinBox->value();
@@ -8973,14 +9099,12 @@ void MainWindow::decode()                                       //decode()
         narg[12]=0;
         narg[13]=-1;
         narg[14]=m_config.aggressive();
-        memcpy(d2b,dec_data.d2,2*360000);
+        // MSK144 was decoded as it arrived, fast_decode_ does not read it
+        if(m_mode!="MSK144") memcpy(d2b,dec_data->d2,2*360000);
         watcher3.setFuture (QtConcurrent::run (std::bind (fast_decode_, &d2b[0],
-            &narg[0],&m_TRperiod, &m_msg[0][0], dec_data.params.mycall,
-            dec_data.params.hiscall, (FCL)8000, (FCL)12, (FCL)12)));
+            &narg[0],&m_TRperiod, &m_msg[0][0], dec_data->params.mycall,
+            dec_data->params.hiscall, (FCL)8000, (FCL)12, (FCL)12)));
       } else {
-        mem_jt9->lock ();
-        memcpy(to, from, qMin(mem_jt9->size(), size));
-        mem_jt9->unlock ();
         to_jt9(m_ihsym,1,-1);                //Send m_ihsym to jt9[.exe] and start decoding
         m_decodeStartMs = QDateTime::currentMSecsSinceEpoch();
         decodeBusy(true);
@@ -9071,8 +9195,8 @@ bool MainWindow::asyncConfirmDecode(QString const& message, int freq, int snr)
 void::MainWindow::fast_decode_done()
 {
   float t,tmax=-99.0;
-  dec_data.params.nagain=false;
-  dec_data.params.ndiskdat=false;
+  dec_data->params.nagain=false;
+  dec_data->params.ndiskdat=false;
 //  if(m_msg[0][0]==0) m_bDecoded=false;
   for(int i=0; m_msg[i][0] && i<100; i++) {
     QString message=QString::fromLatin1(m_msg[i]);
@@ -9130,6 +9254,7 @@ void MainWindow::to_jt9(qint32 n, qint32 istart, qint32 idone)
 void MainWindow::decodeDone ()
 {
   if(m_mode=="Q65") m_wideGraph->drawRed(0,0);
+  m_messageClient->flush_decodes ();     // send this pass's batched UDP decodes now
   if ("FST4W" == m_mode)
     {
       if (m_uploadWSPRSpots
@@ -9156,8 +9281,8 @@ void MainWindow::decodeDone ()
     }
   }
 
-  dec_data.params.nagain=0;
-  dec_data.params.ndiskdat=0;
+  dec_data->params.nagain=0;
+  dec_data->params.ndiskdat=0;
   m_nclearave=0;
   ui->DecodeButton->setChecked (false);
   decodeBusy(false);
@@ -9169,8 +9294,8 @@ void MainWindow::decodeDone ()
 
   bool const autoCqRxSequenceComplete =
       (m_mode != "FT8")
-      || dec_data.params.nzhsym == 50
-      || (m_mode == "FT8" && m_multithreadFT8 && (m_hsymStop == dec_data.params.nzhsym));
+      || dec_data->params.nzhsym == 50
+      || (m_mode == "FT8" && m_multithreadFT8 && (m_hsymStop == dec_data->params.nzhsym));
 
   // Auto CQ timeout is measured per real RX period, not per intermediate decode pass.
   // FT8 can run early/multi-stage decodes inside the same 15 s slot; counting every
@@ -9208,7 +9333,7 @@ void MainWindow::decodeDone ()
     ARRL_Digi_Display();  // Update the ARRL_DIGI display
   }
 
-  if(m_mode!="FT8" or dec_data.params.nzhsym==50 or (m_mode=="FT8" and m_multithreadFT8 and (m_hsymStop==dec_data.params.nzhsym))) m_nDecodes=0; //ft8md
+  if(m_mode!="FT8" or dec_data->params.nzhsym==50 or (m_mode=="FT8" and m_multithreadFT8 and (m_hsymStop==dec_data->params.nzhsym))) m_nDecodes=0; //ft8md
 
   if(m_mode=="Q65" and (m_specOp==SpecOp::NA_VHF or m_specOp==SpecOp::ARRL_DIGI
                         or m_specOp==SpecOp::WW_DIGI or m_specOp==SpecOp::Q65_PILEUP)
@@ -11708,8 +11833,7 @@ void MainWindow::pskPost (DecodedText const& decodedtext)
 void MainWindow::killFile ()
 {
   if (m_fnameWE.size () && !(m_saveAll || (m_saveDecoded && m_bDecoded))) {
-    QFile f1 {m_fnameWE + ".wav"};
-    if(f1.exists()) f1.remove();
+    m_snapshotWriter->remove (m_fnameWE);
     if(m_mode=="WSPR" or m_mode=="FST4W") {
       QFile f2 {m_fnameWE + ".c2"};
       if(f2.exists()) f2.remove();
@@ -12964,7 +13088,7 @@ void MainWindow::guiUpdate()
           tx_status_label.setStyleSheet ("QLabel{color: #000000; background-color: #00ff00}");
         }
         if(m_mode=="MSK144") {
-          int npct=int(100.0*m_fCPUmskrtd/0.298667);
+          int npct=int(100.0*m_fCPUmskrtd/(kMsk144BlockSize/12000.0));
           if(npct>90) tx_status_label.setStyleSheet("QLabel{color: #000000; background-color: #ff0000}");
           t += QString {"   %1%"}.arg (npct, 2);
         }
@@ -18145,7 +18269,7 @@ void MainWindow::on_actionMSK144_triggered()
   ui->actionMSK144->setChecked(true);
   switch_mode (Modes::MSK144);
   m_nsps=6;
-  m_FFTSize = 7 * 512;
+  m_FFTSize = kMsk144BlockSize;
   if (m_tci_audio) Q_EMIT m_config.transceiver_blocksize (m_FFTSize);
   else Q_EMIT FFTSize (m_FFTSize);
   setup_status_bar (true);
@@ -18564,7 +18688,7 @@ void MainWindow::on_actionFT8WidebandDXCallSearch_toggled(bool checked) { m_FT8W
 void MainWindow::on_actionUse_multithreaded_FT8_decoder_triggered(bool checked)
 {
   m_multithreadFT8 = checked;
-  dec_data.params.lmultift8 = m_multithreadFT8;
+  dec_data->params.lmultift8 = m_multithreadFT8;
   if (checked && !(m_specOp==SpecOp::HOUND && m_config.superFox())) {
     if (m_ft8DecoderStart==0) m_hsymStop=49;
     else if (m_ft8DecoderStart==1) {
@@ -18684,6 +18808,12 @@ void MainWindow::on_actionErase_WSPR_hashtable_triggered()
   if(ret==MessageBox::Yes) {
     QFile f {m_config.writeable_data_dir().absoluteFilePath("hashtable.txt")};
     f.remove();
+    // the shared table would otherwise keep resolving WSPR hashes
+    if (!hashcalls_open (QDir::toNativeSeparators (m_config.writeable_data_dir ().absoluteFilePath ("hashcalls.dat")).toLocal8Bit ().constData ()))
+      {
+        hashcalls_forget_wspr ();
+        hashcalls_close ();
+      }
   }
 }
 
@@ -18827,7 +18957,7 @@ void MainWindow::band_changed (Frequency f)
   else if(m_mode=="FT4") TRperiod=7.5;
   int nseqmod = fmod(double(nsec),TRperiod);
   m_nsecBandChanged=nseqmod;
-  dec_data.params.nsecbandchanged=m_nsecBandChanged;
+  dec_data->params.nsecbandchanged=m_nsecBandChanged;
   //ft8md end
 */
   if (m_config.erase_BandActivity () && !not_erase) {
@@ -19475,7 +19605,7 @@ void MainWindow::transmit (double snr)
       f0=ui->TxFreqSpinBox->value () - m_XIT - 0.5*m_toneSpacing;
     }
     m_toneSpacing=6000.0/m_nsps;
-    m_FFTSize = 7 * 512;
+    m_FFTSize = kMsk144BlockSize;
     if (m_tci_audio) Q_EMIT m_config.transceiver_blocksize (m_FFTSize);
     else Q_EMIT FFTSize (m_FFTSize);
     int nsym;
@@ -20526,26 +20656,18 @@ void MainWindow::replayDecodes ()
 
 void MainWindow::postDecode (bool is_new, DecodedText decoded_text)      //avt 12/5/20
 {
-  QString message = decoded_text.string();      //avt 1/5/24
-  auto const& decode = message.trimmed ();
-  auto const message_text = udp_decode_message_text (decode);
-  auto const& parts = decode.left (22).split (' ', SkipEmptyParts);
-  if (parts.size () >= 5 && (!is_externalCtrlMode() || decoded_text.isStandardMessage()))    //avt
+  // parsed once here, the UDP and remote clients and any JSON lines
+  // sinks take it from the decode event bus
+  DecodeEvent event;
+  if (m_decodeBus && DecodeEvent::parse (decoded_text.string ().trimmed (), &event))
     {
-      //QApplication::beep();    //avt
-      auto has_seconds = parts[0].size () > 4;
-      m_messageClient->decode (is_new
-                               , QTime::fromString (parts[0], has_seconds ? "hhmmss" : "hhmm")
-                               , parts[1].toInt ()
-                               , parts[2].toFloat (), parts[3].toUInt (), parts[4]
-                               , message_text
-                               , QChar {'?'} == decode.mid (has_seconds ? 24 + 36 : 22 + 36, 1)
-                               , m_diskData);
-    }
-
-  if (is_new && m_remoteCommandServer)
-    {
-      m_remoteCommandServer->publishBandActivityLine(decode);
+      event.standard = decoded_text.isStandardMessage ();
+      event.is_new = is_new;
+      event.off_air = m_diskData;
+      event.mode = m_mode;
+      event.band = m_config.bands ()->find (m_freqNominal);
+      event.dial_frequency = m_freqNominal;
+      m_decodeBus->publish (event);
     }
 
   if (!is_new) return;    //avt 8/22/23
@@ -20826,9 +20948,8 @@ void MainWindow::uploadWSPRSpots (bool direct_post, QString const& decode_text)
   // do not spot if disabled, replays, or if rig control not working
   if(!m_uploadWSPRSpots || m_diskData || !m_config.is_transceiver_online ()) return;
   if(m_uploading && !decode_text.size ()) {
-    qDebug() << "Previous upload has not completed, spots were lost";
-    wsprNet->abortOutstandingRequests ();
-    m_uploading = false;
+    // spots stay queued until WSPRnet.org takes them
+    qDebug() << "Previous upload has not completed, new spots are queued behind it";
   }
   QString rfreq = QString("%1").arg((m_dialFreqRxWSPR + 1500) / 1e6, 0, 'f', 6);
   QString tfreq = QString("%1").arg((m_dialFreqRxWSPR +
@@ -21087,8 +21208,8 @@ void MainWindow::fastPick(int x0, int x1, int y)
   if(m_TRperiod<30.0) pixPerSecond=12000.0/256.0;
   if(m_mode!="MSK144") return;
   if(!m_decoderBusy) {
-    dec_data.params.newdat=0;
-    dec_data.params.nagain=1;
+    dec_data->params.newdat=0;
+    dec_data->params.nagain=1;
     m_nPick=1;
     if(y > 120) m_nPick=2;
     m_t0Pick=x0/pixPerSecond;
@@ -21102,6 +21223,7 @@ void MainWindow::on_actionMeasure_reference_spectrum_triggered()
 {
   if(!m_monitoring) on_monitorButton_clicked (true);
   m_bRefSpec=true;
+  updateEqualizer ();           // measure the unequalized response
 }
 
 void MainWindow::on_actionMeasure_phase_response_triggered()
@@ -21120,6 +21242,36 @@ void MainWindow::on_actionErase_reference_spectrum_triggered()
   m_bClearRefSpec=true;
 }
 
+// reference spectra are kept per rig and band, refspec.dat is used
+// where none has been measured
+QString MainWindow::refspecProfile () const
+{
+  auto name = QString {"refspec_%1_%2.dat"}.arg (m_config.rig_name (), m_lastBand);
+  name.replace (QRegularExpression {"[^A-Za-z0-9._-]"}, "_");
+  return m_config.writeable_data_dir ().absoluteFilePath (name);
+}
+
+void MainWindow::updateEqualizer ()
+{
+  auto const profile = refspecProfile ();
+  m_refspecFile = m_bRefSpec || QFileInfo::exists (profile) ? profile
+    : m_config.writeable_data_dir ().absoluteFilePath ("refspec.dat");
+  QVector<float> taps;
+  if (m_bUseRef && !m_bRefSpec)
+    {
+      // designing the FIR takes a while, so do it once per file
+      // unless the file changes
+      auto const modified = QFileInfo {m_refspecFile}.lastModified ();
+      auto& cached = m_equalizers[m_refspecFile];
+      if (!cached.first.isValid () || cached.first != modified)
+        {
+          cached = qMakePair (modified, Equalizer::design (m_refspecFile));
+        }
+      taps = cached.second;
+    }
+  Q_EMIT equalizerChanged (taps);
+}
+
 void MainWindow::freqCalStep()
 {
   if (m_frequency_list_fcal_iter == m_config.frequencies ()->end ()
@@ -22869,8 +23021,7 @@ void MainWindow::on_cbAsyncDecode_toggled (bool checked)
 
   if (checked && m_mode == "FT2") {
     m_asyncAudioPos = 0;
-    m_asyncMsgCount = 0;
-    std::memset (m_asyncMsg, 0, sizeof (m_asyncMsg));
+    m_asyncJobs.clear ();
     qint64 const nowMs = QDateTime::currentMSecsSinceEpoch ();
     if (m_transmitting) {
       m_asyncTxStartMs = nowMs;
@@ -22898,9 +23049,7 @@ void MainWindow::on_cbAsyncDecode_toggled (bool checked)
     }
   } else {
     m_asyncDecodeTimer.stop();
-    m_bAsyncDecoding = false;
-    m_asyncMsgCount = 0;
-    std::memset (m_asyncMsg, 0, sizeof (m_asyncMsg));
+    m_asyncJobs.clear ();
     if (ui->labelAsyncL2Active) {
       ui->labelAsyncL2Active->setVisible(false);
     }
@@ -22961,9 +23110,9 @@ void MainWindow::on_cbDigitalMorse_toggled (bool checked)
     }
 }
 
-void MainWindow::asyncDecodeDone()
+void MainWindow::asyncDecodeDone (QSharedPointer<AsyncDecodeJob> const& job)
 {
-    m_bAsyncDecoding = false;
+    if (!m_asyncJobs.removeOne (job)) return; // results discarded while decoding
     auto now = QDateTime::currentDateTimeUtc();
     auto hhmmss = now.toString("hhmmss");
     struct DeferredDecode
@@ -22974,10 +23123,9 @@ void MainWindow::asyncDecodeDone()
     QList<DeferredDecode> deferred;
     int bestSnr = -99;
 
-    int const maxRows = qBound (0, m_asyncMsgCount, 100);
+    int const maxRows = qBound (0, job->count, 100);
     for (int i = 0; i < maxRows; ++i) {
-      QByteArray rowBytes {m_asyncMsg[i], int (sizeof (m_asyncMsg[i]))};
-      std::memset (m_asyncMsg[i], 0, sizeof (m_asyncMsg[i]));
+      QByteArray rowBytes {job->msg[i], int (sizeof (job->msg[i]))};
 
       int end = rowBytes.size ();
       while (end > 0) {
@@ -23130,7 +23278,6 @@ void MainWindow::asyncDecodeDone()
         }
       });
     }
-    m_asyncMsgCount = 0;
 }
 
 void MainWindow::on_ft8Button_clicked()
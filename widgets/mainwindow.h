@@ -18,6 +18,7 @@
 #include <QAudioDeviceInfo>
 #include <QStringList>
 #include <QScopedPointer>
+#include <QSharedPointer>
 #include <QDir>
 #include <QProgressDialog>
 #include <QAbstractSocket>
@@ -133,6 +134,8 @@ class SharedMemorySegment;
 class IonosphericForecastWindow;
 class DXClusterWindow;
 class RemoteCommandServer;
+class DecodeEventBus;
+class AudioSnapshotWriter;
 class AsyncModeWidget;
 
 class MainWindow
@@ -239,7 +242,6 @@ private slots:
   void on_cbManualTx_toggled (bool checked);
   void on_cbSpeedyContest_toggled (bool checked);
   void on_cbDigitalMorse_toggled (bool checked);
-  void asyncDecodeDone ();
   void on_ft8Button_clicked();
   void on_ft4Button_clicked();
   void on_ft2Button_clicked();
@@ -572,6 +574,7 @@ private:
   Q_SIGNAL void resumeAudioInputStream () const;
   Q_SIGNAL void startDetector (AudioDevice::Channel) const;
   Q_SIGNAL void FFTSize (unsigned) const;
+  Q_SIGNAL void equalizerChanged (QVector<float> const& taps) const;
   Q_SIGNAL void detectorClose () const;
   Q_SIGNAL void finished () const;
   Q_SIGNAL void transmitFrequency (double) const;
@@ -1013,13 +1016,13 @@ private:
   QLabel ndecodes_label;
   QLabel dt_correction_label;
   QLabel decodium_cert_label;
+  QLabel psk_label;
   QProgressBar progressBar;
   QLabel watchdog_label;
 
   QFuture<void> m_wav_future;
   QFutureWatcher<void> m_wav_future_watcher;
   QFutureWatcher<void> watcher3;
-  QFutureWatcher<void> m_asyncDecodeWatcher;
   QThreadPool m_asyncDecodeThreadPool;
   QTimer m_asyncDecodeTimer;
   QTimer m_asyncTxGuardTimer;
@@ -1029,9 +1032,15 @@ private:
   bool m_asyncL2DefaultAppliedForCurrentFt2 {false};
   short int m_asyncAudio[90000];     // ring buffer ~7.5s at 12kHz
   int m_asyncAudioPos {0};           // write position in ring buffer
-  bool m_bAsyncDecoding {false};     // async decode in progress
-  char m_asyncMsg[100][80];          // async decode results
-  int m_asyncMsgCount {0};           // number of valid async decode rows
+  struct AsyncDecodeJob              // input and results of one async decode
+  {
+    short int audio[45000];
+    char msg[100][80];
+    int count {0};                   // number of valid rows in msg
+  };
+  QList<QSharedPointer<AsyncDecodeJob>> m_asyncJobs; // jobs in flight, emptied to discard
+  qint64 m_asyncLastLaunchMs {0};
+  void asyncDecodeDone (QSharedPointer<AsyncDecodeJob> const&);
   QSet<QString> m_asyncDedupeSet;    // deduplication within sliding window
   QDateTime m_asyncDedupeLastCleared;
   // Unified async dedup cache: key -> strongest SNR seen in the recent window.
@@ -1067,7 +1076,7 @@ private:
   QTimer m_manualTxWindowTimer;       // countdown timer for TX window
   QTimer m_txRdyBlinkTimer;           // blink timer for FT2 D-CW TX NOW button
   qint64 m_manualTxWindowStartMs {0}; // when the TX window opened
-  QFutureWatcher<QString> m_saveWAVWatcher;
+  AudioSnapshotWriter * m_snapshotWriter {nullptr};
 
   NonInheritingProcess proc_jt9;
   NonInheritingProcess p1;
@@ -1260,6 +1269,7 @@ private:
   QTimer m_heartbeat;
   MessageClient * m_messageClient;
   QPointer<RemoteCommandServer> m_remoteCommandServer;
+  DecodeEventBus * m_decodeBus {nullptr};
   QCheckBox * m_autoSpotCheckBox {nullptr};
   bool m_remoteWaterfallStreamingEnabled {false};
   QString m_mapLastClickCall;
@@ -1276,6 +1286,8 @@ private:
   QHash<QString, QVariant> m_pwrBandTuneMemory; // Remembers power level by band for tuning
   QByteArray m_geometryNoControls;
   QVector<double> m_phaseEqCoefficients;
+  QString m_refspecFile;        // reference spectrum in use
+  QHash<QString, QPair<QDateTime, QVector<float>>> m_equalizers; // FIRs by file
   bool m_block_udp_status_updates;
   bool m_useDarkStyle;
   bool m_externalCtrl;         //avt  10/1/25
@@ -1294,6 +1306,8 @@ private:
   double m_avgDtValue {0.0};          // EMA of DT values across periods
   int m_totalDecodesForDt {0};        // total decodes used for DT calculation
   int m_ntpDtDivergenceCount {0};     // consecutive NTP/DT divergence periods
+  double m_captureJitterMs {-1.0};    // from the Detector's sample clock, < 0 until known
+  bool m_captureClockLocked {false};
 
   // NTP Time Synchronization
   NtpClient *m_ntpClient {nullptr};
@@ -1311,6 +1325,8 @@ private:
   void writeSettings();
   void createStatusBar();
   void updateStatusBar();
+  void updatePskStatistics ();
+  void updateWsprNetStatistics ();
   void genStdMsgs(QString rpt, bool unconditional = false);
   void genCQMsg();
   void clearDX ();
@@ -1339,6 +1355,8 @@ private:
   void switch_mode (Mode);
   void WSPR_scheduling ();
   void freqCalStep();
+  QString refspecProfile () const;
+  void updateEqualizer ();
   void setRig (Frequency = 0);  // zero frequency means no change
   void WSPR_history(Frequency dialFreq, int ndecodes);
   QString beacon_start_time (int n = 0);
@@ -1351,16 +1369,12 @@ private:
   void write_all(QString txRx, QString message);
   bool isWorked(int itype, QString key, float fMHz=0, QString="");
 
-  QString save_wave_file (QString const& name
-                          , short const * data
-                          , int samples
-                          , QString const& my_callsign
-                          , QString const& my_grid
-                          , QString const& mode
-                          , qint32 sub_mode
-                          , Frequency frequency
-                          , QString const& his_call
-                          , QString const& his_grid) const;
+  void save_audio_snapshot (QString const& name
+                            , short const * data
+                            , int samples
+                            , QString const& mode
+                            , qint32 sub_mode
+                            , Frequency frequency);
   void hound_reply ();
   QString sortHoundCalls(QString t, int isort, int max_dB);
   void rm_tb4(QString houndCall);
@@ -20,7 +20,7 @@ extern "C" {
   void plotsave_(float swide[], int* m_w , int* m_h1, int* irow);
 }
 
-extern dec_data dec_data;
+extern dec_data_t * dec_data;
 
 CPlotter::CPlotter(QWidget *parent) :                  //CPlotter Constructor
   QFrame {parent},
@@ -195,7 +195,7 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
   m_fMax=FreqfromX(iz);
   if(bScroll and swide[0]<1.e29) {
     flat4_(swide,&iz,&m_Flatten);
-    if(!m_bReplot) flat4_(&dec_data.savg[j0],&jz,&m_Flatten);
+    if(!m_bReplot) flat4_(&dec_data->savg[j0],&jz,&m_Flatten);
   }
 
   ymin=1.e30;
@@ -241,7 +241,7 @@ void CPlotter::draw(float swide[], bool bScroll, bool bRed)
       float sum=0.0;
       int j=j0+m_binsPerPixel*i;
       for(int k=0; k<m_binsPerPixel; k++) {
-        sum+=dec_data.savg[j++];
+        sum+=dec_data->savg[j++];
       }
       m_sum[i]=sum;
     }
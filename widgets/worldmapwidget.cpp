@@ -8,6 +8,7 @@
 #include <QElapsedTimer>
 #include <QFileInfo>
 #include <QFontMetricsF>
+#include <QImage>
 #include <QLineF>
 #include <QLinearGradient>
 #include <QPainter>
@@ -30,6 +31,11 @@ int const kRoleDowngradeHoldSeconds = 75;
 int const kPostTxQueueMs = 10 * 1000;
 int const kPostTxQueueMaxVisible = 6;
 int const kClickHighlightMs = 1600;
+int const kArcSteps = 72;
+int const kNightMaskWidth = 720;        // half degree cells
+int const kNightMaskHeight = 360;
+double constexpr kBaseCacheMargin = 1.25; // cached base layer span / viewport span
+double constexpr kBaseCacheMaxScaleError = 0.08;
 double constexpr kEarthRadiusKm = 6371.0;
 
 qint64 monotonicNowMs()
@@ -151,6 +157,43 @@ QPointF projectedPathMidpoint(QVector<QPointF> const& projected, QRectF const& b
   return segments.last().b;
 }
 
+// draw an equirectangular world image, repeated east and west as
+// needed, into bounds for the given viewport
+void drawWorldTiles(QPainter * painter, QRectF const& bounds, double centerLon, double centerLat,
+                    double spanLon, double spanLat, QPixmap const& image)
+{
+  double topLat = qBound(-90.0, centerLat + 0.5 * spanLat, 90.0);
+  double bottomLat = qBound(-90.0, centerLat - 0.5 * spanLat, 90.0);
+  qreal texW = static_cast<qreal>(image.width());
+  qreal texH = static_cast<qreal>(image.height());
+  qreal srcY0 = static_cast<qreal>((90.0 - topLat) / 180.0) * texH;
+  qreal srcY1 = static_cast<qreal>((90.0 - bottomLat) / 180.0) * texH;
+  QRectF sourceRect {0.0, srcY0, texW, qMax<qreal>(1.0, srcY1 - srcY0)};
+  double leftLon = centerLon - 0.5 * spanLon;
+
+  for (int k = -2; k <= 2; ++k)
+    {
+      double lonStart = -180.0 + 360.0 * k;
+      double lonEnd = lonStart + 360.0;
+      qreal x1 = bounds.left() + static_cast<qreal>((lonStart - leftLon) / spanLon) * bounds.width();
+      qreal x2 = bounds.left() + static_cast<qreal>((lonEnd - leftLon) / spanLon) * bounds.width();
+      QRectF tileRect {x1, bounds.top(), x2 - x1, bounds.height()};
+      if (tileRect.right() < bounds.left() || tileRect.left() > bounds.right())
+        {
+          continue;
+        }
+      painter->drawPixmap(tileRect, image, sourceRect);
+    }
+}
+
+QString normalizedCallsign(QString call)
+{
+  call = call.trimmed().toUpper();
+  call.remove('<');
+  call.remove('>');
+  return call;
+}
+
 QString formatDistanceLabel(double distanceKm, bool miles)
 {
   double const value = miles ? distanceKm * 0.621371192 : distanceKm;
@@ -227,6 +270,7 @@ void WorldMapWidget::setGreylineEnabled(bool enabled)
     }
 
   m_greylineEnabled = enabled;
+  m_baseCacheValid = false;
   update();
 }
 
@@ -288,6 +332,7 @@ void WorldMapWidget::setTransmitState(bool transmitting, QString const& targetCa
             {
               it.value().queuedDuringTx = false;
             }
+          m_paintOrderDirty = true;
         }
       m_txTargetCall = normalizedCall;
       m_txTargetGrid = normalizedGrid;
@@ -330,6 +375,7 @@ void WorldMapWidget::setTransmitState(bool transmitting, QString const& targetCa
 
   if (removedOutgoing)
     {
+      m_paintOrderDirty = true;
       updateViewportTargets();
     }
 
@@ -338,18 +384,13 @@ void WorldMapWidget::setTransmitState(bool transmitting, QString const& targetCa
 
 void WorldMapWidget::downgradeContactToBand(QString const& call)
 {
-  auto normalizedCall = call.trimmed().toUpper();
-  normalizedCall.remove('<');
-  normalizedCall.remove('>');
+  auto normalizedCall = normalizedCallsign(call);
   if (normalizedCall.isEmpty())
     {
       return;
     }
 
-  auto sameStation = [&normalizedCall] (QString contactCall) {
-      contactCall = contactCall.trimmed().toUpper();
-      contactCall.remove('<');
-      contactCall.remove('>');
+  auto sameStation = [&normalizedCall] (QString const& contactCall) {
       if (contactCall.isEmpty())
         {
           return false;
@@ -367,7 +408,7 @@ void WorldMapWidget::downgradeContactToBand(QString const& call)
   auto const nowMs = monotonicNowMs();
   for (auto it = m_contacts.begin(); it != m_contacts.end(); ++it)
     {
-      if (!sameStation(it.value().call))
+      if (!sameStation(it.value().normalizedCall))
         {
           continue;
         }
@@ -382,6 +423,7 @@ void WorldMapWidget::downgradeContactToBand(QString const& call)
 
   if (changed)
     {
+      m_paintOrderDirty = true;
       updateViewportTargets();
       update();
     }
@@ -431,6 +473,7 @@ void WorldMapWidget::addContact(QString const& call, QString const& sourceGrid,
           return;
         }
     }
+  prepareContact(&contact);
   m_contacts.insert(key, contact);
 
   while (m_contacts.size() > kMaxContacts)
@@ -453,6 +496,7 @@ void WorldMapWidget::addContact(QString const& call, QString const& sourceGrid,
         }
     }
 
+  m_paintOrderDirty = true;
   updateViewportTargets();
   update();
 }
@@ -502,6 +546,7 @@ void WorldMapWidget::addContactByLonLat(QString const& call, QPointF const& sour
           return;
         }
     }
+  prepareContact(&contact);
   m_contacts.insert(key, contact);
 
   while (m_contacts.size() > kMaxContacts)
@@ -524,6 +569,7 @@ void WorldMapWidget::addContactByLonLat(QString const& call, QPointF const& sour
         }
     }
 
+  m_paintOrderDirty = true;
   updateViewportTargets();
   update();
 }
@@ -552,39 +598,42 @@ void WorldMapWidget::paintEvent(QPaintEvent * event)
   painter.save();
   painter.setClipPath(clipPath);
 
-  drawBackground(&painter, mapBounds);
-  drawGeoOverlay(&painter, mapBounds);
-  drawDayNightMask(&painter, mapBounds);
-  drawGrid(&painter, mapBounds);
-
-  QList<Contact> contacts = m_contacts.values();
-  std::sort(contacts.begin(), contacts.end(), [] (Contact const& a, Contact const& b) {
-    int pa = rolePriority(a.role);
-    int pb = rolePriority(b.role);
-    if (pa != pb)
-      {
-        return pa > pb;
-      }
-    return a.lastSeenMonotonicMs > b.lastSeenMonotonicMs;
-  });
+  if (m_greylineEnabled)
+    {
+      updateNightMask();
+    }
+  drawBaseLayer(&painter, mapBounds);
+  if (m_greylineEnabled)
+    {
+      drawSun(&painter, mapBounds);
+    }
+
+  if (m_paintOrderDirty)
+    {
+      m_paintOrder = m_contacts.values().toVector();
+      std::sort(m_paintOrder.begin(), m_paintOrder.end(), [] (Contact const& a, Contact const& b) {
+        int pa = rolePriority(a.role);
+        int pb = rolePriority(b.role);
+        if (pa != pb)
+          {
+            return pa > pb;
+          }
+        return a.lastSeenMonotonicMs > b.lastSeenMonotonicMs;
+      });
+      m_paintOrderDirty = false;
+    }
+  auto const& contacts = m_paintOrder;
   int visiblePaths = 0;
   int visibleBand = 0;
 
   QVector<QRectF> usedLabelAreas;
-  auto normalizeCall = [] (QString call)
-    {
-      call = call.trimmed().toUpper();
-      call.remove('<');
-      call.remove('>');
-      return call;
-    };
 
   if (m_transmitting)
     {
       int selectedIndex = -1;
       int bestScore = std::numeric_limits<int>::min();
       auto const nowMs = monotonicNowMs();
-      QString targetCall = normalizeCall(m_txTargetCall);
+      QString targetCall = normalizedCallsign(m_txTargetCall);
       QString targetGrid = m_txTargetGrid.trimmed().toUpper();
       bool const hasExplicitTxTarget = !targetCall.isEmpty() || !targetGrid.isEmpty();
 
@@ -596,7 +645,7 @@ void WorldMapWidget::paintEvent(QPaintEvent * event)
               continue;
             }
 
-          QString contactCall = normalizeCall(c.call);
+          QString const& contactCall = c.normalizedCall;
           QString contactGrid = c.destinationGrid.trimmed().toUpper();
 
           bool callMatch = targetCall.isEmpty()
@@ -890,9 +939,24 @@ bool WorldMapWidget::maidenheadToLonLat(QString const& locator, QPointF * lonLat
   return true;
 }
 
+WorldMapWidget::Viewport WorldMapWidget::currentViewport() const
+{
+  Viewport view;
+  view.centerLon = m_viewCenterLon;
+  view.centerLat = m_viewCenterLat;
+  view.spanLon = m_viewSpanLon;
+  view.spanLat = m_viewSpanLat;
+  return view;
+}
+
 QPointF WorldMapWidget::projectLonLatToPoint(QPointF const& lonLat, QRectF const& bounds) const
 {
-  double leftLon = m_viewCenterLon - 0.5 * m_viewSpanLon;
+  return projectLonLatToPoint(lonLat, bounds, currentViewport());
+}
+
+QPointF WorldMapWidget::projectLonLatToPoint(QPointF const& lonLat, QRectF const& bounds, Viewport const& view) const
+{
+  double leftLon = view.centerLon - 0.5 * view.spanLon;
   double lon = lonLat.x();
   while (lon < leftLon)
     {
@@ -904,10 +968,10 @@ QPointF WorldMapWidget::projectLonLatToPoint(QPointF const& lonLat, QRectF const
     }
 
   double lat = qBound(-90.0, static_cast<double>(lonLat.y()), 90.0);
-  double topLat = m_viewCenterLat + 0.5 * m_viewSpanLat;
+  double topLat = view.centerLat + 0.5 * view.spanLat;
 
-  qreal x = bounds.left() + static_cast<qreal>((lon - leftLon) / m_viewSpanLon) * bounds.width();
-  qreal y = bounds.top() + static_cast<qreal>((topLat - lat) / m_viewSpanLat) * bounds.height();
+  qreal x = bounds.left() + static_cast<qreal>((lon - leftLon) / view.spanLon) * bounds.width();
+  qreal y = bounds.top() + static_cast<qreal>((topLat - lat) / view.spanLat) * bounds.height();
   return QPointF {x, y};
 }
 
@@ -959,7 +1023,71 @@ QVector<QPointF> WorldMapWidget::greatCircle(QPointF const& startLonLat, QPointF
   return points;
 }
 
-void WorldMapWidget::drawBackground(QPainter * painter, QRectF const& bounds) const
+void WorldMapWidget::prepareContact(Contact * contact) const
+{
+  contact->normalizedCall = normalizedCallsign(contact->call);
+  contact->distanceKm = greatCircleDistanceKm(contact->sourceLonLat, contact->destinationLonLat);
+  contact->arc = greatCircle(contact->sourceLonLat, contact->destinationLonLat, kArcSteps);
+}
+
+void WorldMapWidget::drawBaseLayer(QPainter * painter, QRectF const& bounds)
+{
+  auto const view = currentViewport();
+  auto const dpr = devicePixelRatioF();
+
+  // where the cached layer lands in bounds for the current viewport
+  auto placement = [&] (Viewport const& cached) {
+    qreal const width = static_cast<qreal>(cached.spanLon / view.spanLon) * bounds.width();
+    qreal const height = static_cast<qreal>(cached.spanLat / view.spanLat) * bounds.height();
+    qreal const left = bounds.center().x()
+      + static_cast<qreal>((wrapLongitude(cached.centerLon - view.centerLon) - 0.5 * cached.spanLon) / view.spanLon) * bounds.width();
+    qreal const top = bounds.center().y()
+      - static_cast<qreal>((cached.centerLat - view.centerLat + 0.5 * cached.spanLat) / view.spanLat) * bounds.height();
+    return QRectF {left, top, width, height};
+  };
+
+  QRectF target;
+  bool valid = m_baseCacheValid && !m_baseCache.isNull() && qFuzzyCompare(m_baseCache.devicePixelRatioF(), dpr);
+  if (valid)
+    {
+      target = placement(m_baseCacheView);
+      auto const cachedSize = QSizeF {m_baseCache.size()} / dpr;
+      valid = target.adjusted(-0.5, -0.5, 0.5, 0.5).contains(bounds)
+        && qAbs(target.width() / cachedSize.width() - 1.0) < kBaseCacheMaxScaleError
+        && qAbs(target.height() / cachedSize.height() - 1.0) < kBaseCacheMaxScaleError;
+    }
+
+  if (!valid)
+    {
+      Viewport cached = view;
+      cached.spanLon = view.spanLon * kBaseCacheMargin;
+      cached.spanLat = qMin(180.0, view.spanLat * kBaseCacheMargin);
+      cached.centerLat = qBound(-90.0 + 0.5 * cached.spanLat, view.centerLat, 90.0 - 0.5 * cached.spanLat);
+      target = placement(cached);
+
+      QSize const pixels {qMax(1, qCeil(target.width() * dpr)), qMax(1, qCeil(target.height() * dpr))};
+      m_baseCache = QPixmap {pixels};
+      m_baseCache.setDevicePixelRatio(dpr);
+      m_baseCache.fill(QColor(8, 25, 46));
+      QRectF const cacheBounds {QPointF {}, QSizeF {pixels} / dpr};
+      QPainter cachePainter {&m_baseCache};
+      cachePainter.setRenderHint(QPainter::Antialiasing, true);
+      cachePainter.setRenderHint(QPainter::SmoothPixmapTransform, true);
+      drawBackground(&cachePainter, cacheBounds, cached);
+      drawGeoOverlay(&cachePainter, cacheBounds, cached);
+      drawDayNightMask(&cachePainter, cacheBounds, cached);
+      drawGrid(&cachePainter, cacheBounds, cached);
+      m_baseCacheView = cached;
+      m_baseCacheValid = true;
+    }
+
+  painter->save();
+  painter->setRenderHint(QPainter::SmoothPixmapTransform, true);
+  painter->drawPixmap(target, m_baseCache, QRectF {QPointF {}, QSizeF {m_baseCache.size()}});
+  painter->restore();
+}
+
+void WorldMapWidget::drawBackground(QPainter * painter, QRectF const& bounds, Viewport const& view) const
 {
   if (m_worldTexture.isNull())
     {
@@ -970,112 +1098,72 @@ void WorldMapWidget::drawBackground(QPainter * painter, QRectF const& bounds) co
       return;
     }
 
-  double topLat = qBound(-90.0, m_viewCenterLat + 0.5 * m_viewSpanLat, 90.0);
-  double bottomLat = qBound(-90.0, m_viewCenterLat - 0.5 * m_viewSpanLat, 90.0);
-  qreal texW = static_cast<qreal>(m_worldTexture.width());
-  qreal texH = static_cast<qreal>(m_worldTexture.height());
-  qreal srcY0 = static_cast<qreal>((90.0 - topLat) / 180.0) * texH;
-  qreal srcY1 = static_cast<qreal>((90.0 - bottomLat) / 180.0) * texH;
-  QRectF sourceRect {0.0, srcY0, texW, qMax<qreal>(1.0, srcY1 - srcY0)};
-  double leftLon = m_viewCenterLon - 0.5 * m_viewSpanLon;
-
   painter->save();
   painter->setOpacity(0.98);
-  for (int k = -2; k <= 2; ++k)
-    {
-      double lonStart = -180.0 + 360.0 * k;
-      double lonEnd = lonStart + 360.0;
-      qreal x1 = bounds.left() + static_cast<qreal>((lonStart - leftLon) / m_viewSpanLon) * bounds.width();
-      qreal x2 = bounds.left() + static_cast<qreal>((lonEnd - leftLon) / m_viewSpanLon) * bounds.width();
-      QRectF tileRect {x1, bounds.top(), x2 - x1, bounds.height()};
-      if (tileRect.right() < bounds.left() || tileRect.left() > bounds.right())
-        {
-          continue;
-        }
-      painter->drawPixmap(tileRect, m_worldTexture, sourceRect);
-    }
+  drawWorldTiles(painter, bounds, view.centerLon, view.centerLat, view.spanLon, view.spanLat, m_worldTexture);
   painter->restore();
 
   painter->fillRect(bounds, QColor(0, 14, 24, 18));
 }
 
-void WorldMapWidget::drawGeoOverlay(QPainter * painter, QRectF const& bounds) const
+void WorldMapWidget::drawGeoOverlay(QPainter * painter, QRectF const& bounds, Viewport const& view) const
 {
   if (m_worldOverlay.isNull())
     {
       return;
     }
 
-  double topLat = qBound(-90.0, m_viewCenterLat + 0.5 * m_viewSpanLat, 90.0);
-  double bottomLat = qBound(-90.0, m_viewCenterLat - 0.5 * m_viewSpanLat, 90.0);
-  qreal texW = static_cast<qreal>(m_worldOverlay.width());
-  qreal texH = static_cast<qreal>(m_worldOverlay.height());
-  qreal srcY0 = static_cast<qreal>((90.0 - topLat) / 180.0) * texH;
-  qreal srcY1 = static_cast<qreal>((90.0 - bottomLat) / 180.0) * texH;
-  QRectF sourceRect {0.0, srcY0, texW, qMax<qreal>(1.0, srcY1 - srcY0)};
-  double leftLon = m_viewCenterLon - 0.5 * m_viewSpanLon;
-
   painter->save();
   painter->setCompositionMode(QPainter::CompositionMode_Screen);
   painter->setOpacity(0.44);
-  for (int k = -2; k <= 2; ++k)
-    {
-      double lonStart = -180.0 + 360.0 * k;
-      double lonEnd = lonStart + 360.0;
-      qreal x1 = bounds.left() + static_cast<qreal>((lonStart - leftLon) / m_viewSpanLon) * bounds.width();
-      qreal x2 = bounds.left() + static_cast<qreal>((lonEnd - leftLon) / m_viewSpanLon) * bounds.width();
-      QRectF tileRect {x1, bounds.top(), x2 - x1, bounds.height()};
-      if (tileRect.right() < bounds.left() || tileRect.left() > bounds.right())
-        {
-          continue;
-        }
-      painter->drawPixmap(tileRect, m_worldOverlay, sourceRect);
-    }
+  drawWorldTiles(painter, bounds, view.centerLon, view.centerLat, view.spanLon, view.spanLat, m_worldOverlay);
   painter->restore();
 }
 
-void WorldMapWidget::drawGrid(QPainter * painter, QRectF const& bounds) const
+void WorldMapWidget::drawGrid(QPainter * painter, QRectF const& bounds, Viewport const& view) const
 {
   painter->setBrush(Qt::NoBrush);
 
   double lonStep = 30.0;
-  if (m_viewSpanLon < 220.0) lonStep = 20.0;
-  if (m_viewSpanLon < 130.0) lonStep = 10.0;
-  if (m_viewSpanLon < 75.0) lonStep = 5.0;
+  if (view.spanLon < 220.0) lonStep = 20.0;
+  if (view.spanLon < 130.0) lonStep = 10.0;
+  if (view.spanLon < 75.0) lonStep = 5.0;
 
   double latStep = 20.0;
-  if (m_viewSpanLat < 110.0) latStep = 10.0;
-  if (m_viewSpanLat < 55.0) latStep = 5.0;
+  if (view.spanLat < 110.0) latStep = 10.0;
+  if (view.spanLat < 55.0) latStep = 5.0;
 
   painter->setPen(QPen(QColor(170, 210, 225, 42), 1.0));
 
-  double leftLon = m_viewCenterLon - 0.5 * m_viewSpanLon;
-  double rightLon = m_viewCenterLon + 0.5 * m_viewSpanLon;
+  double leftLon = view.centerLon - 0.5 * view.spanLon;
+  double rightLon = view.centerLon + 0.5 * view.spanLon;
   double startLon = std::floor(leftLon / lonStep) * lonStep;
   for (double lon = startLon; lon <= rightLon; lon += lonStep)
     {
-      qreal x = bounds.left() + static_cast<qreal>((lon - leftLon) / m_viewSpanLon) * bounds.width();
+      qreal x = bounds.left() + static_cast<qreal>((lon - leftLon) / view.spanLon) * bounds.width();
       painter->drawLine(QPointF {x, bounds.top()}, QPointF {x, bounds.bottom()});
     }
 
-  double topLat = m_viewCenterLat + 0.5 * m_viewSpanLat;
-  double bottomLat = m_viewCenterLat - 0.5 * m_viewSpanLat;
+  double topLat = view.centerLat + 0.5 * view.spanLat;
+  double bottomLat = view.centerLat - 0.5 * view.spanLat;
   double startLat = std::floor(bottomLat / latStep) * latStep;
   for (double lat = startLat; lat <= topLat; lat += latStep)
     {
-      qreal y = bounds.top() + static_cast<qreal>((topLat - lat) / m_viewSpanLat) * bounds.height();
+      qreal y = bounds.top() + static_cast<qreal>((topLat - lat) / view.spanLat) * bounds.height();
       painter->drawLine(QPointF {bounds.left(), y}, QPointF {bounds.right(), y});
     }
 }
 
-void WorldMapWidget::drawDayNightMask(QPainter * painter, QRectF const& bounds) const
+void WorldMapWidget::updateNightMask()
 {
-  if (!m_greylineEnabled)
+  auto now = QDateTime::currentDateTimeUtc();
+  auto const minute = now.toMSecsSinceEpoch() / 60000;
+  if (minute == m_nightMaskMinute && !m_nightMask.isNull())
     {
       return;
     }
+  m_nightMaskMinute = minute;
 
-  auto now = QDateTime::currentDateTimeUtc();
   auto t = now.time();
   double utcHours = t.hour() + (t.minute() / 60.0) + (t.second() / 3600.0);
   double subSolarLon = wrapLongitude((12.0 - utcHours) * 15.0);
@@ -1086,93 +1174,58 @@ void WorldMapWidget::drawDayNightMask(QPainter * painter, QRectF const& bounds)
                               - 0.006758 * std::cos(2.0 * fractionalYear) + 0.000907 * std::sin(2.0 * fractionalYear)
                               - 0.002697 * std::cos(3.0 * fractionalYear) + 0.00148 * std::sin(3.0 * fractionalYear);
   double subSolarLat = qRadiansToDegrees(declinationRadians);
+  m_subSolarLonLat = QPointF {subSolarLon, subSolarLat};
 
-  double leftLon = m_viewCenterLon - 0.5 * m_viewSpanLon;
-  double topLat = m_viewCenterLat + 0.5 * m_viewSpanLat;
-
-  int width = qMax(1, static_cast<int>(bounds.width()));
-  int height = qMax(1, static_cast<int>(bounds.height()));
-
-  double subLatRad = qDegreesToRadians(subSolarLat);
-
-  painter->save();
-  painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
-  painter->setPen(Qt::NoPen);
-
-  for (int x = 0; x < width; ++x)
+  // night where the sun altitude is below zero:
+  // sin(decl)*sin(lat) + cos(decl)*cos(lat)*cos(dlon) < 0
+  double const sinDecl = std::sin(declinationRadians);
+  double const cosDecl = std::cos(declinationRadians);
+  QVector<double> cosDLon(kNightMaskWidth);
+  for (int x = 0; x < kNightMaskWidth; ++x)
     {
-      double lon = leftLon + m_viewSpanLon * static_cast<double>(x) / static_cast<double>(width);
-      double dLon = qDegreesToRadians(lon - subSolarLon);
-      double cosDLon = std::cos(dLon);
-
-      // Find terminator latitude for this column (where sun altitude = 0)
-      // sin(decl)*sin(lat) + cos(decl)*cos(lat)*cos(dlon) = 0
-      // => tan(lat) = -cos(dlon)/tan(decl)
-      // Then find which pixels above/below are in night
-
-      // Scan top-to-bottom to find transition
-      int nightStartY = -1;
-      int nightEndY = height;
-      bool inNight = false;
-
-      // Sample at top pixel
-      {
-        double lat = topLat - m_viewSpanLat * 0.0;
-        double latRad = qDegreesToRadians(lat);
-        double alt = std::sin(subLatRad) * std::sin(latRad) + std::cos(subLatRad) * std::cos(latRad) * cosDLon;
-        inNight = (alt < 0.0);
-      }
-
-      if (inNight)
-        {
-          nightStartY = 0;
-        }
+      double lon = -180.0 + 360.0 * (x + 0.5) / kNightMaskWidth;
+      cosDLon[x] = std::cos(qDegreesToRadians(lon - subSolarLon));
+    }
 
-      for (int y = 1; y < height; ++y)
+  QImage mask {kNightMaskWidth, kNightMaskHeight, QImage::Format_ARGB32_Premultiplied};
+  QRgb const night = qPremultiply(qRgba(0, 5, 30, 145));
+  for (int y = 0; y < kNightMaskHeight; ++y)
+    {
+      double latRad = qDegreesToRadians(90.0 - 180.0 * (y + 0.5) / kNightMaskHeight);
+      double const a = sinDecl * std::sin(latRad);
+      double const b = cosDecl * std::cos(latRad);
+      auto * line = reinterpret_cast<QRgb *>(mask.scanLine(y));
+      for (int x = 0; x < kNightMaskWidth; ++x)
         {
-          double lat = topLat - m_viewSpanLat * static_cast<double>(y) / static_cast<double>(height);
-          double latRad = qDegreesToRadians(lat);
-          double alt = std::sin(subLatRad) * std::sin(latRad) + std::cos(subLatRad) * std::cos(latRad) * cosDLon;
-          bool nowNight = (alt < 0.0);
-
-          if (!inNight && nowNight)
-            {
-              nightStartY = y;
-              inNight = true;
-            }
-          else if (inNight && !nowNight)
-            {
-              nightEndY = y;
-              inNight = false;
-              // partial column done - draw it
-              if (nightStartY >= 0 && nightEndY > nightStartY)
-                {
-                  painter->setBrush(QColor(0, 5, 30, 145));
-                  painter->drawRect(QRectF(bounds.left() + x, bounds.top() + nightStartY,
-                                          1.0, nightEndY - nightStartY));
-                }
-              nightStartY = -1;
-              nightEndY = height;
-            }
+          line[x] = (a + b * cosDLon[x] < 0.0) ? night : 0;
         }
+    }
+  m_nightMask = QPixmap::fromImage(mask);
+  m_baseCacheValid = false;
+}
 
-      // Close any open night region
-      if (inNight && nightStartY >= 0)
-        {
-          painter->setBrush(QColor(0, 5, 30, 145));
-          painter->drawRect(QRectF(bounds.left() + x, bounds.top() + nightStartY,
-                                  1.0, height - nightStartY));
-        }
+void WorldMapWidget::drawDayNightMask(QPainter * painter, QRectF const& bounds, Viewport const& view) const
+{
+  if (!m_greylineEnabled || m_nightMask.isNull())
+    {
+      return;
     }
 
-  // Draw the sun indicator
-  QPointF sunPoint = projectLonLatToPoint(QPointF{subSolarLon, subSolarLat}, bounds);
+  painter->save();
+  painter->setCompositionMode(QPainter::CompositionMode_SourceOver);
+  drawWorldTiles(painter, bounds, view.centerLon, view.centerLat, view.spanLon, view.spanLat, m_nightMask);
+  painter->restore();
+}
+
+void WorldMapWidget::drawSun(QPainter * painter, QRectF const& bounds) const
+{
+  QPointF sunPoint = projectLonLatToPoint(m_subSolarLonLat, bounds);
+  painter->save();
   painter->setPen(Qt::NoPen);
   painter->setBrush(QColor(255, 240, 80, 220));
   painter->drawEllipse(sunPoint, 5.0, 5.0);
   painter->setBrush(QColor(255, 210, 50, 90));
   painter->drawEllipse(sunPoint, 9.0, 9.0);
-
   painter->restore();
 }
 
@@ -1180,12 +1233,6 @@ void WorldMapWidget::drawContact(QPainter * painter, QRectF const& bounds, Conta
                                  QVector<QRectF> * usedLabelAreas, bool drawLabel,
                                  bool drawArrow, qreal forcedProgress) const
 {
-  auto arc = greatCircle(contact.sourceLonLat, contact.destinationLonLat, 72);
-  if (arc.size() < 2)
-    {
-      return;
-    }
-
   qint64 ageSecs = ageSecondsFromMonotonic(monotonicNowMs(), contact.lastSeenMonotonicMs);
 
   auto const source = projectLonLatToPoint(contact.sourceLonLat, bounds);
@@ -1252,6 +1299,12 @@ void WorldMapWidget::drawContact(QPainter * painter, QRectF const& bounds, Conta
       return;
     }
 
+  auto const& arc = contact.arc;
+  if (arc.size() < 2)
+    {
+      return;
+    }
+
   QColor txColor {235, 110, 98};
   QColor rxColor {130, 190, 255};
   QColor arrowColor {255, 244, 196};
@@ -1296,16 +1349,10 @@ void WorldMapWidget::drawContact(QPainter * painter, QRectF const& bounds, Conta
       previous = p;
     }
 
-  auto normalizeCall = [] (QString call) {
-    call = call.trimmed().toUpper();
-    call.remove('<');
-    call.remove('>');
-    return call;
-  };
   qint64 nowMs = monotonicNowMs();
   bool clickedActive = !m_lastClickedCall.isEmpty()
     && m_lastClickedUntilMs > nowMs
-    && normalizeCall(contact.call) == m_lastClickedCall;
+    && contact.normalizedCall == m_lastClickedCall;
   bool txActive = (forcedProgress >= 0.0);
 
   QLinearGradient grad {source, destination};
@@ -1328,8 +1375,7 @@ void WorldMapWidget::drawContact(QPainter * painter, QRectF const& bounds, Conta
 
   if (contact.role != PathRole::BandOnly && (txActive || clickedActive))
     {
-      double const distanceKm = greatCircleDistanceKm(contact.sourceLonLat, contact.destinationLonLat);
-      QString const distanceText = formatDistanceLabel(distanceKm, m_distanceInMiles);
+      QString const distanceText = formatDistanceLabel(contact.distanceKm, m_distanceInMiles);
       QPointF anchor = projectedPathMidpoint(projected, bounds);
 
       painter->save();
@@ -1363,7 +1409,7 @@ void WorldMapWidget::drawContact(QPainter * painter, QRectF const& bounds, Conta
 
   // Brief visual feedback for the selected marker.
   if (!m_lastClickedCall.isEmpty() && m_lastClickedUntilMs > nowMs
-      && normalizeCall(contact.call) == m_lastClickedCall)
+      && contact.normalizedCall == m_lastClickedCall)
     {
       qreal remaining = qBound<qreal>(0.0,
                                       static_cast<qreal>(m_lastClickedUntilMs - nowMs) / static_cast<qreal>(kClickHighlightMs),
@@ -1759,6 +1805,7 @@ void WorldMapWidget::pruneExpiredContacts()
       if (ageMs > lifetimeMs)
         {
           it = m_contacts.erase(it);
+          m_paintOrderDirty = true;
         }
       else
         {
@@ -1766,6 +1813,7 @@ void WorldMapWidget::pruneExpiredContacts()
             {
               it.value().role = PathRole::BandOnly;
               it.value().queuedDuringTx = false;
+              m_paintOrderDirty = true;
             }
           ++it;
         }
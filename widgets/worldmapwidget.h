@@ -47,6 +47,14 @@ protected:
   QSize minimumSizeHint() const override;
 
 private:
+  struct Viewport
+  {
+    double centerLon {0.0};
+    double centerLat {0.0};
+    double spanLon {360.0};
+    double spanLat {180.0};
+  };
+
   struct Contact
   {
     QString call;
@@ -57,15 +65,26 @@ private:
     qint64 lastSeenMonotonicMs {0};
     PathRole role {PathRole::Generic};
     bool queuedDuringTx {false};
+
+    // derived once in prepareContact()
+    QString normalizedCall;
+    QVector<QPointF> arc;               // great circle path in lon/lat
+    double distanceKm {0.0};
   };
 
   bool maidenheadToLonLat(QString const& locator, QPointF * lonLat) const;
+  Viewport currentViewport() const;
   QPointF projectLonLatToPoint(QPointF const& lonLat, QRectF const& bounds) const;
+  QPointF projectLonLatToPoint(QPointF const& lonLat, QRectF const& bounds, Viewport const& view) const;
   QVector<QPointF> greatCircle(QPointF const& startLonLat, QPointF const& endLonLat, int steps) const;
-  void drawBackground(QPainter * painter, QRectF const& bounds) const;
-  void drawGeoOverlay(QPainter * painter, QRectF const& bounds) const;
-  void drawGrid(QPainter * painter, QRectF const& bounds) const;
-  void drawDayNightMask(QPainter * painter, QRectF const& bounds) const;
+  void prepareContact(Contact * contact) const;
+  void drawBaseLayer(QPainter * painter, QRectF const& bounds);
+  void drawBackground(QPainter * painter, QRectF const& bounds, Viewport const& view) const;
+  void drawGeoOverlay(QPainter * painter, QRectF const& bounds, Viewport const& view) const;
+  void drawGrid(QPainter * painter, QRectF const& bounds, Viewport const& view) const;
+  void drawDayNightMask(QPainter * painter, QRectF const& bounds, Viewport const& view) const;
+  void drawSun(QPainter * painter, QRectF const& bounds) const;
+  void updateNightMask();
   void drawContact(QPainter * painter, QRectF const& bounds, Contact const& contact,
                    QVector<QRectF> * usedLabelAreas, bool drawLabel,
                    bool drawArrow = true, qreal forcedProgress = -1.0) const;
@@ -81,6 +100,21 @@ private:
   QHash<QString, Contact> m_contacts;
   QPixmap m_worldTexture;
   QPixmap m_worldOverlay;
+
+  // Cached layers. The base layer (texture, overlay, greyline and
+  // grid) is rendered for a viewport somewhat larger than the one
+  // shown and is re-rendered only when the animated viewport drifts
+  // outside it or zooms too far. The night mask is in world
+  // coordinates and is recomputed at most once a minute.
+  QPixmap m_baseCache;
+  Viewport m_baseCacheView;
+  bool m_baseCacheValid {false};
+  QPixmap m_nightMask;
+  qint64 m_nightMaskMinute {-1};
+  QPointF m_subSolarLonLat;
+  QVector<Contact> m_paintOrder;
+  bool m_paintOrderDirty {true};
+
   QTimer m_animationTimer;
   qreal m_animationPhase {0.0};
   QString m_lastClickedCall;
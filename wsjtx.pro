@@ -60,7 +60,7 @@ include(Transceiver/Transceiver.pri)
 include(Network/Network.pri)
 
 SOURCES += \
-  ExceptionCatchingApplication.cpp Logger.cpp WSJTXLogging.cpp \
+  ExceptionCatchingApplication.cpp Logger.cpp LogSinks.cpp WSJTXLogging.cpp \
   Radio.cpp NetworkServerLookup.cpp revision_utils.cpp \
   Configuration.cpp PSK_Reporter.cpp NonInheritingProcess.cpp \
   Transceiver/DXLabSuiteCommanderTransceiver.cpp \
@@ -79,7 +79,7 @@ SOURCES += \
   helper_functions.cpp \
   main.cpp decodedtext.cpp wsprnet.cpp \
   WSPRBandHopping.cpp MessageAggregator.cpp SampleDownloader.cpp qt_helpers.cpp\
-  MultiSettings.cpp PhaseEqualizationDialog.cpp \
+  MultiSettings.cpp SettingsWriteBehind.cpp PhaseEqualizationDialog.cpp \
   EqualizationToolsDialog.cpp \
   LotWUsers.cpp TraceFile.cpp
 
@@ -97,14 +97,14 @@ HEADERS  += qt_helpers.hpp qt_db_helpers.hpp \
   Transceiver/TransceiverFactory.hpp \
   helper_functions.h \
   pimpl_h.hpp pimpl_impl.hpp \
-  ExceptionCatchingApplication.hpp Logger.hpp WSJTXLogging.hpp \
+  ExceptionCatchingApplication.hpp Logger.hpp LogSinks.hpp WSJTXLogging.hpp \
   Radio.hpp NetworkServerLookup.hpp revision_utils.hpp \
   WFPalette.hpp getfile.h decodedtext.h \
   commons.h sleep.h \
   PSK_Reporter.hpp \
   Configuration.hpp wsprnet.h \
   WSPRBandHopping.hpp \
-  WsprTxScheduler.h SampleDownloader.hpp MultiSettings.hpp PhaseEqualizationDialog.hpp \
+  WsprTxScheduler.h SampleDownloader.hpp MultiSettings.hpp SettingsWriteBehind.hpp PhaseEqualizationDialog.hpp \
   EqualizationToolsDialog.hpp \
   LotWUsers.h TraceFile.hpp NonInheritingProcess.hpp
 